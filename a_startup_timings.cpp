@@ -0,0 +1,142 @@
+#include "a_startup_timings.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QTimer>
+#include <QVector>
+#include <QtGlobal>
+
+namespace {
+
+/**
+ * @brief End of one startup phase
+ */
+struct Phase
+{
+    const char *Name = nullptr;      // Phase name - a string literal
+    qint64 Nanoseconds = 0;          // Time since Start
+};
+
+QElapsedTimer Clock;                 // Started in main before anything else
+QVector<Phase> Phases;               // Recorded phases in order
+bool IsReportEnabled = false;        // Set by --startup-timings
+bool IsInteractive = false;          // Set once the interactive point is recorded
+int DeferredCount = 0;               // Deferred phases still running - the report waits for them
+
+}
+
+void A_StartupTimings::Start()
+{
+    /**
+     * Starts the monotonic clock all phases are measured against
+     */
+
+    Clock.start();
+    Phases.reserve(16);                                   // A dozen phases - no growth while measuring
+}
+
+void A_StartupTimings::SetEnabled(bool enabled)
+{
+    /**
+     * Sets whether the report is printed
+     */
+
+    IsReportEnabled = enabled;
+}
+
+void A_StartupTimings::Mark(const char *phase)
+{
+    /**
+     * Appends the phase with the current clock reading; a few bytes, so it is always on
+     */
+
+    if (!Clock.isValid()) {
+        return;
+    }
+    Phase _phase;
+    _phase.Name = phase;
+    _phase.Nanoseconds = Clock.nsecsElapsed();
+    Phases.append(_phase);
+}
+
+void A_StartupTimings::WatchFirstPaint(QWidget *window)
+{
+    /**
+     * Paint events go to the child widgets that paint, so the filter is installed on the application
+     * and removed again with the watcher after the first one
+     */
+
+    if (!window || !QCoreApplication::instance()) {
+        return;
+    }
+    QCoreApplication::instance()->installEventFilter(new A_StartupTimings(window));
+}
+
+void A_StartupTimings::BeginDeferredPhase()
+{
+    /**
+     * Counts the phase as running
+     */
+
+    DeferredCount++;
+}
+
+void A_StartupTimings::EndDeferredPhase(const char *phase)
+{
+    /**
+     * Marks the phase; the last deferred phase after the interactive point prints the report
+     */
+
+    Mark(phase);
+    if (--DeferredCount == 0 && IsInteractive) {
+        Report();
+    }
+}
+
+A_StartupTimings::A_StartupTimings(QWidget *window)
+    : QObject(window)
+    , Window(window)                // Watched window - paint events of its widgets end the watch
+{
+}
+
+bool A_StartupTimings::eventFilter(QObject *watched, QEvent *event)
+{
+    /**
+     * Marks the first paint, then marks interactive once the event loop is idle again - the frame and
+     * all events queued during startup have been handled by then
+     */
+
+    if (event->type() != QEvent::Paint || !watched->isWidgetType()
+        || static_cast<QWidget*>(watched)->window() != Window) {
+        return false;
+    }
+
+    Mark("first paint");
+    QCoreApplication::instance()->removeEventFilter(this);
+    QTimer::singleShot(0, this, [this]() {
+        Mark("interactive");
+        IsInteractive = true;
+        if (DeferredCount == 0) {
+            Report();                                     // Otherwise the last deferred phase reports
+        }
+        deleteLater();                                    // Watch is over
+    });
+    return false;
+}
+
+void A_StartupTimings::Report()
+{
+    /**
+     * One line per phase: total milliseconds since start and the phase's own share
+     */
+
+    if (!IsReportEnabled) {
+        return;
+    }
+    qint64 _previous = 0;                                 // End of the previous phase
+    for (const Phase &_phase : std::as_const(Phases)) {
+        qInfo("startup: %-18s %8.1f ms  (+%.1f ms)", _phase.Name,
+              _phase.Nanoseconds / 1000000.0, (_phase.Nanoseconds - _previous) / 1000000.0);
+        _previous = _phase.Nanoseconds;
+    }
+}
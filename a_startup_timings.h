@@ -0,0 +1,69 @@
+#ifndef A_STARTUP_TIMINGS_H
+#define A_STARTUP_TIMINGS_H
+
+#include <QObject>
+#include <QWidget>
+
+class A_StartupTimings : public QObject
+{
+public:
+    /**
+     * @brief Starts the startup clock - call first thing in main, before QApplication exists
+     */
+    static void Start();
+
+    /**
+     * @brief Turns printing of the report on or off - phases are recorded either way
+     * @param enabled True to print the report once the window is interactive
+     */
+    static void SetEnabled(bool enabled);
+
+    /**
+     * @brief Records the end of a startup phase
+     * @param phase Phase name - a string literal
+     */
+    static void Mark(const char *phase);
+
+    /**
+     * @brief Records the first paint of a window and, one event loop pass later, the interactive point
+     * The report is printed to stderr after the interactive point and all deferred phases if enabled
+     * @param window Top-level window being shown
+     */
+    static void WatchFirstPaint(QWidget *window);
+
+    /**
+     * @brief Holds the report back until EndDeferredPhase - for work that continues after the first paint
+     */
+    static void BeginDeferredPhase();
+
+    /**
+     * @brief Records the end of a deferred phase and prints the report if the window is interactive already
+     * @param phase Phase name - a string literal
+     */
+    static void EndDeferredPhase(const char *phase);
+
+protected:
+    /**
+     * @brief Catches the first paint event of a widget in the watched window
+     * @param watched Object receiving the event
+     * @param event Event being delivered
+     * @return Always false - events are only observed
+     */
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    /**
+     * @brief Constructor for the paint watcher
+     * @param window Top-level window being shown
+     */
+    explicit A_StartupTimings(QWidget *window);
+
+    /**
+     * @brief Prints every phase with its time since start and since the previous phase
+     */
+    static void Report();
+
+    QWidget *Window;                 // Watched window - not owned
+};
+
+#endif // A_STARTUP_TIMINGS_H
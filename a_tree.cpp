@@ -1,4 +1,257 @@
 #include "a_tree.h"
+#include <QTimer>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QThread>
+#include <QStyledItemDelegate>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+const int FilterAsyncThreshold = 50000;   // Node count above which filter evaluation runs on a worker thread
+const int ParallelSortThreshold = 65536;  // Sibling count above which sorting is split across worker threads
+const int SubtreeJobSliceMilliseconds = 8;  // Time a subtree job may run per event loop turn
+const int SharedPollMilliseconds = 200;     // Interval at which viewers check the shared store for a new version
+const int SnapshotBlockNodes = 4096;        // Node count a snapshot block is kept within - bounds the rebuild per change
+
+const qint64 ItemDataBytesEstimate = 96;      // Qt's allocations per item - private data, column value and display arrays
+const qint64 StringHeaderBytes = 16;          // Heap header of a string buffer
+const qint64 HashEntryOverheadBytes = 16;     // Bucket and chaining overhead of one hash entry
+const qint64 SortKeyBytesEstimate = 64;       // Collation key with its private data
+const qint64 ViewRowBytesEstimate = 40;       // View layout entry of one row below expanded items
+const qint64 ExpandedIndexBytesEstimate = 64; // Persistent index and set entry of one expanded item
+
+/**
+ * @brief Item delegate that remembers the text an inline edit started from
+ * closeEditor is emitted for cancelled and unchanged edits too, so the text is compared on close.
+ * While a journal is being restored, items can be browsed but neither edited nor checked
+ */
+class EditStartDelegate : public QStyledItemDelegate
+{
+public:
+    /**
+     * @brief Constructor for the delegate
+     * @param tree Tree whose items are shown - must outlive the delegate
+     * @param startText Receives the item text whenever an editor opens - must outlive the delegate
+     * @param parent Parent object
+     */
+    EditStartDelegate(const A_Tree *tree, QString *startText, QObject *parent)
+        : QStyledItemDelegate(parent)
+        , Tree(tree)                 // Owning tree - asked whether a restore is running
+        , StartText(startText)       // Text of the item being edited - owned by A_Tree
+    {
+    }
+
+    QWidget* createEditor(QWidget *parent, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        if (Tree->IsJournalRestoring()) {
+            return nullptr;                               // Replayed records may still rename the item
+        }
+        *StartText = index.data(Qt::EditRole).toString();
+        return QStyledItemDelegate::createEditor(parent, option, index);
+    }
+
+    bool editorEvent(QEvent *event, QAbstractItemModel *model, const QStyleOptionViewItem &option, const QModelIndex &index) override
+    {
+        if (Tree->IsJournalRestoring()) {
+            return false;                                 // Check clicks and keys would not be journaled
+        }
+        return QStyledItemDelegate::editorEvent(event, model, option, index);
+    }
+
+private:
+    const A_Tree *Tree;
+    QString *StartText;
+};
+
+/**
+ * @brief Hashes an item text for the path index
+ * @param text Item text
+ * @return Hash - equal texts give equal hashes, collisions are resolved by comparing texts
+ */
+uint PathTextHash(const QString &text)
+{
+    return uint(qHash(text));
+}
+const quint32 CheckedStateMagic = 0x41544353;  // "ATCS" - exported check selection header
+const quint32 CheckedStateVersion = 1;         // Check selection format version
+
+/**
+ * @brief Hashes tree shape and texts in pre-order (64-bit FNV-1a)
+ * @param items Items in pre-order
+ * @return Hash that changes when an item is added, removed, moved or renamed
+ */
+quint64 StructureHash(const QVector<QTreeWidgetItem*> &items)
+{
+    quint64 _hash = 14695981039346656037ULL;             // FNV offset basis
+    auto _addBytes = [&_hash](const void *data, size_t size) {
+        const uchar *_bytes = static_cast<const uchar*>(data);
+        for (size_t _index = 0; _index < size; ++_index) {
+            _hash = (_hash ^ _bytes[_index]) * 1099511628211ULL;  // FNV prime
+        }
+    };
+
+    for (QTreeWidgetItem *_item : items) {
+        const quint32 _childCount = quint32(_item->childCount());  // Shape of the subtree
+        const QString _text = _item->text(0);
+        const quint32 _textLength = quint32(_text.size());
+        _addBytes(&_childCount, sizeof(_childCount));
+        _addBytes(&_textLength, sizeof(_textLength));
+        _addBytes(_text.constData(), size_t(_text.size()) * sizeof(QChar));
+    }
+
+    return _hash;
+}
+
+/**
+ * @brief Gets the subtree hashes of a snapshot node from the hashes stored in its block
+ * An open top item's stored hash covers only its leading children, so its hash is folded from all
+ * of its children once per comparison and kept in openHashes
+ * @param snapshot Snapshot holding the node
+ * @param index Node position in pre-order
+ * @param openHashes Folded hashes of open top items by position
+ * @return Subtree hashes - equal to A_Tree's hashes of the same items
+ */
+A_TreeHashes::Values GetSnapshotHashes(const A_TreeSnapshot &snapshot, int index, QHash<int, A_TreeHashes::Values> *openHashes)
+{
+    const int _blockNumber = snapshot.FindBlock(index);  // Block holding the node
+    const A_TreeSnapshot::Block &_block = *snapshot.GetBlocks().at(_blockNumber);
+    const int _position = index - snapshot.GetBlockOffset(_blockNumber);  // Block-local position
+    if (!_block.IsOpen || _position > 0) {
+        A_TreeHashes::Values _values;                     // Stored when the block was built
+        _values.ContentHash = _block.ContentHashes.at(_position);
+        _values.StateHash = _block.StateHashes.at(_position);
+        return _values;
+    }
+
+    const QHash<int, A_TreeHashes::Values>::const_iterator _folded = openHashes->constFind(index);
+    if (_folded != openHashes->constEnd()) {
+        return _folded.value();
+    }
+    A_TreeHashes::Values _values = A_TreeHashes::Begin(_block.Texts.first(), Qt::CheckState(_block.CheckStates.first()));
+    int _childCount = 0;                                  // Children folded in
+    for (int _child = index + 1; _child < snapshot.GetSubtreeEnd(index); _child = snapshot.GetSubtreeEnd(_child)) {
+        A_TreeHashes::AddChild(_values, GetSnapshotHashes(snapshot, _child, openHashes));
+        _childCount++;
+    }
+    A_TreeHashes::Finish(_values, _childCount);
+    openHashes->insert(index, _values);
+    return _values;
+}
+
+/**
+ * @brief Stable sort that sorts chunks on worker threads and merges them pairwise in parallel rounds
+ * @param entries Entries to sort in place
+ * @param lessThan Strict weak ordering - must be safe to call concurrently
+ */
+template <typename Entry, typename LessThan>
+void ParallelStableSort(QVector<Entry> &entries, LessThan lessThan)
+{
+    struct MergeTask
+    {
+        int Begin;                                        // First element of left run
+        int Middle;                                       // First element of right run
+        int End;                                          // One past last element of right run
+    };
+
+    const int _entryCount = entries.size();               // Number of entries to sort
+    const int _chunkCount = qMax(1, QThread::idealThreadCount());  // One chunk per core
+    const int _chunkSize = (_entryCount + _chunkCount - 1) / _chunkCount;
+    Entry *_data = entries.data();                        // Detach once on calling thread
+
+    QVector<QPair<int, int>> _runs;                       // Sorted runs as [begin, end)
+    for (int _begin = 0; _begin < _entryCount; _begin += _chunkSize) {
+        _runs.append(qMakePair(_begin, qMin(_begin + _chunkSize, _entryCount)));
+    }
+
+    QtConcurrent::blockingMap(_runs, [_data, lessThan](const QPair<int, int> &run) {
+        std::stable_sort(_data + run.first, _data + run.second, lessThan);  // Sort chunk independently
+    });
+
+    while (_runs.size() > 1) {
+        QVector<MergeTask> _merges;                       // Independent merges of this round
+        QVector<QPair<int, int>> _nextRuns;               // Runs left after this round
+        for (int _runIndex = 0; _runIndex < _runs.size(); _runIndex += 2) {
+            if (_runIndex + 1 < _runs.size()) {
+                MergeTask _merge = {_runs.at(_runIndex).first, _runs.at(_runIndex).second, _runs.at(_runIndex + 1).second};
+                _merges.append(_merge);                   // Merge neighbouring runs
+                _nextRuns.append(qMakePair(_runs.at(_runIndex).first, _runs.at(_runIndex + 1).second));
+            } else {
+                _nextRuns.append(_runs.at(_runIndex));    // Odd run carried to next round
+            }
+        }
+
+        QtConcurrent::blockingMap(_merges, [_data, lessThan](const MergeTask &merge) {
+            std::inplace_merge(_data + merge.Begin, _data + merge.Middle, _data + merge.End, lessThan);
+        });
+        _runs = _nextRuns;
+    }
+}
+
+/**
+ * @brief Gets the position of an item among its siblings
+ * Newly appended items are found without scanning the sibling list
+ * @param container Parent item or invisible root item
+ * @param item Child of container
+ * @return Child index - -1 if item is not a child of container
+ */
+int IndexInParent(QTreeWidgetItem *container, QTreeWidgetItem *item)
+{
+    const int _childCount = container->childCount();      // Number of siblings
+    if (_childCount > 0 && container->child(_childCount - 1) == item) {
+        return _childCount - 1;                           // Appended item - common case
+    }
+
+    return container->indexOfChild(item);
+}
+
+/**
+ * @brief Counts the nodes of a subtree, stopping as soon as the count exceeds a limit
+ * @param item Subtree root
+ * @param limit Largest count of interest
+ * @return Node count - limit + 1 for larger subtrees
+ */
+int CountSubtreeNodes(QTreeWidgetItem *item, int limit)
+{
+    int _count = 0;                                       // Visited nodes
+    QVector<QTreeWidgetItem*> _pending;                   // Nodes still to visit - each counts at least once
+    _pending.append(item);
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_item = _pending.takeLast();
+        _count++;
+        if (_count + _pending.size() + _item->childCount() > limit) {
+            return limit + 1;                             // Known to be too large without visiting the rest
+        }
+        for (int _childIndex = 0; _childIndex < _item->childCount(); ++_childIndex) {
+            _pending.append(_item->child(_childIndex));
+        }
+    }
+
+    return _count;
+}
+
+/**
+ * @brief Splits a path into trimmed, non-empty segments
+ * @param path Path from root item
+ * @param separator Separator between path segments
+ * @return Segments from root to item
+ */
+QStringList SplitPath(const QString &path, const QString &separator)
+{
+    QStringList _segments;                                // Trimmed segments
+    for (const QString &_segment : path.split(separator, Qt::SkipEmptyParts)) {
+        QString _trimmed = _segment.trimmed();
+        if (!_trimmed.isEmpty()) {
+            _segments.append(_trimmed);
+        }
+    }
+
+    return _segments;
+}
+}
 
 A_Tree::A_Tree(QWidget *parent)
     : QWidget(parent)
@@ -9,20 +262,74 @@ A_Tree::A_Tree(QWidget *parent)
     , AddChildAction(nullptr)       // Add child action pointer - initialized to null, will add child items
     , EditAction(nullptr)           // Edit action pointer - initialized to null, will edit selected items
     , DeleteAction(nullptr)         // Delete action pointer - initialized to null, will delete selected items
+    , SortMenu(nullptr)             // Sort submenu pointer - initialized to null, will sort children of selected items
     , CurrentItem(nullptr)          // Current item pointer - initialized to null, tracks right-clicked item
     , IsEditModeEnabled(false)      // Edit mode flag - starts disabled to prevent accidental modifications
     , IsInternalUpdate(false)       // Internal update flag - starts false, prevents recursive signal handling
+    , FilterWatcher(nullptr)        // Filter watcher pointer - initialized to null, will track background filter runs
+    , FilterRequestId(0)            // Filter request counter - starts at 0, increments with every filter run
+    , IsFilterIndexDirty(true)      // Filter index flag - starts dirty, index is built on first filter use
+    , IsFilterRefreshPending(false) // Filter refresh flag - starts false, no re-filter scheduled yet
+    , IsTreeSorted(false)           // Tree-wide sort flag - starts false, items keep insertion order
+    , SortingContainer(nullptr)     // Sorting container - initialized to null, no reorder running
+    , IsCompact(false)              // Compact mode flag - starts false, optional per-node state is kept
+    , IsAggregatesStale(false)      // Aggregate recompute flag - starts false, nothing to recompute while disabled
+    , BulkUpdateDepth(0)            // Bulk update depth - starts at 0, inserts expand immediately
+    , IsApplyingExpandState(false)  // Expand restore flag - starts false, expand signals are recorded
+    , IsSubtreeSlicePending(false)  // Subtree slice flag - starts false, no job queued
+    , Journal(nullptr)              // Journal pointer - initialized to null, journaling is off until enabled
+    , PublishedSnapshot(std::make_shared<const A_TreeSnapshot>())  // Published snapshot - starts empty
+    , SnapshotVersion(0)            // Snapshot version - starts at 0, increments with every publish
+    , IsSnapshotAllDirty(true)      // Snapshot rebuild flag - starts true, nothing to reuse yet
+    , IsSnapshotStale(true)         // Snapshot stale flag - starts true, no snapshot of the tree published yet
+    , IsSnapshotPublishPending(false)  // Snapshot publish flag - starts false, no publish scheduled yet
+    , IsSnapshotRequested(false)    // Snapshot tracking flag - starts false, changes are not tracked until first request
+    , ExportWatcher(nullptr)        // Export watcher pointer - initialized to null, will track background exports
+    , SharedPollTimer(nullptr)      // Shared poll timer pointer - initialized to null, created with the signal connections
+    , SharedSequence(1)             // Shared sequence - starts odd, no store content loaded
+    , IsSharedReader(false)         // Shared reader flag - starts false, items are local
+    , FrozenModel(nullptr)          // Frozen model pointer - initialized to null, created when the tree is frozen
+    , FrozenView(nullptr)           // Frozen view pointer - initialized to null, created when the tree is frozen
+    , FrozenPageSize(0)             // Frozen page size - starts at 0, wide parents show all children
 {
+    TextCollator.setCaseSensitivity(Qt::CaseInsensitive);     // Text order ignores case
+    NaturalCollator.setCaseSensitivity(Qt::CaseInsensitive);  // Natural order ignores case
+    NaturalCollator.setNumericMode(true);                     // Compare digit runs by numeric value
+    NodeTable.append(nullptr);                                // Identifier 0 is reserved for "no item"
+    ItemContext.Attributes = &Attributes;                     // Items read attribute columns through the context
+    ItemContext.Aggregates = &Aggregates;                     // Items read roll-ups through the context
+
+    SetTreeWidgetStyle();                                     // Before the views exist - they are polished once
     SetupUserInterface();
-    SetTreeWidgetStyle();
-    SetupContextMenu();
-    ConnectSignalsAndSlots();
+    ConnectSignalsAndSlots();                                 // Context menu is created on first use
 }
 
 A_Tree::~A_Tree()
 {
     // Qt handles cleanup automatically through parent-child relationships
-    // No manual cleanup needed for UI components
+    // Background filter evaluations only hold copies of the index, wait so no worker outlives the widget
+    if (FrozenTree && !FrozenJournalPath.isEmpty()) {
+        ResumeJournal(FrozenJournalPath);                 // Encoding becomes the journal's snapshot - check changes survive
+    }
+    DisableJournal();                                     // Commit records that are still buffered
+    for (const SubtreeJob &_job : std::as_const(SubtreeJobs)) {
+        QTreeWidgetItem *_root = _job.Type == DeleteSubtreeJob ? GetItemById(_job.RootId) : nullptr;
+        if (_root) {
+            ReleaseSubtree(_root);                        // Also drops roots of later jobs inside it
+            delete _root;                                 // Detached subtree - not owned by the view
+        }
+    }
+    if (PendingRestore) {
+        delete PendingRestore->PendingRoot;               // Detached subtree - not owned by the view yet
+    }
+    if (FilterWatcher) {
+        FilterWatcher->waitForFinished();
+    }
+    if (ExportWatcher) {
+        ExportWatcher->waitForFinished();                 // Let the output file be committed
+    }
+    delete FrozenView;                                    // Both read FrozenTree, which members destroy before child objects
+    delete FrozenModel;
 }
 
 void A_Tree::SetupUserInterface()
@@ -45,6 +352,7 @@ void A_Tree::SetupUserInterface()
     TreeWidget->setRootIsDecorated(true);                 // Show expand/collapse decorations for root items
     TreeWidget->setAlternatingRowColors(true);            // Alternate row colors for better readability
     TreeWidget->setAnimated(true);                        // Enable smooth animations for expand/collapse
+    TreeWidget->setItemDelegate(new EditStartDelegate(this, &EditStartText, TreeWidget));  // Inline edits report their starting text
 
     MainLayout->addWidget(TreeWidget);                    // Add tree widget to layout
 }
@@ -52,12 +360,12 @@ void A_Tree::SetupUserInterface()
 void A_Tree::SetTreeWidgetStyle()
 {
     /**
-     * Applies consistent dark theme styling to the tree widget
-     * Ensures visual consistency with the main application theme
+     * Applies consistent dark theme styling to the tree views
+     * Ensures visual consistency with the main application theme; QTreeView rules also match QTreeWidget
      */
 
     QString _treeStyle =
-        "QTreeWidget {"
+        "QTreeView {"
         "    background-color: #2D2D2D;"                  // Dark background for tree area
         "    color: #FFFFFF;"                             // White text color
         "    border: 2px solid #3F3F3F;"                  // Subtle border around tree
@@ -69,24 +377,24 @@ void A_Tree::SetTreeWidgetStyle()
         "    outline: none;"                              // Remove focus outline
         "}"
 
-        "QTreeWidget::item {"
+        "QTreeView::item {"
         "    padding: 6px 4px;"                           // Padding inside each item
         "    border: none;"                               // No individual item borders
         "    min-height: 24px;"                           // Minimum height for touch-friendly interface
         "}"
 
-        "QTreeWidget::item:selected {"
+        "QTreeView::item:selected {"
         "    background-color: #FF8C00;"                  // Selected item background
         "    color: #FFFFFF;"                             // Selected item text color
         "    border-radius: 4px;"                         // Rounded selection
         "}"
 
-        "QTreeWidget::item:hover {"
+        "QTreeView::item:hover {"
         "    background-color: #3A3A3A;"                  // Hover background color
         "    border-radius: 4px;"                         // Rounded hover effect
         "}"
 
-        "QTreeWidget::item:selected:hover {"
+        "QTreeView::item:selected:hover {"
         "    background-color: #FF8C00;"                  // Selected + hover background
         "}"
 
@@ -100,7 +408,7 @@ void A_Tree::SetTreeWidgetStyle()
         "    font-size: 12px;"                            // Slightly larger header font
         "}";
 
-    TreeWidget->setStyleSheet(_treeStyle);                // Apply styling to tree widget
+    setStyleSheet(_treeStyle);                            // Inherited by TreeWidget and the frozen view
 }
 
 void A_Tree::SetupContextMenu()
@@ -124,12 +432,20 @@ void A_Tree::SetupContextMenu()
     ContextMenu->addSeparator();                          // Visual separator between action groups
     ContextMenu->addAction(EditAction);
     ContextMenu->addAction(DeleteAction);
+    ContextMenu->addSeparator();
+
+    // Create sort submenu - each action carries its SortMode
+    SortMenu = ContextMenu->addMenu("Sort Children");     // Sort submenu - orders children of selected item
+    SortMenu->addAction("By Text")->setData(int(SortByText));
+    SortMenu->addAction("By Check State")->setData(int(SortByCheckState));
+    SortMenu->addAction("Natural Order")->setData(int(SortNatural));
 
     // Connect menu actions to slots
     connect(AddRootAction, &QAction::triggered, this, &A_Tree::OnAddRootAction);
     connect(AddChildAction, &QAction::triggered, this, &A_Tree::OnAddChildAction);
     connect(EditAction, &QAction::triggered, this, &A_Tree::OnEditAction);
     connect(DeleteAction, &QAction::triggered, this, &A_Tree::OnDeleteAction);
+    connect(SortMenu, &QMenu::triggered, this, &A_Tree::OnSortAction);
 }
 
 void A_Tree::ConnectSignalsAndSlots()
@@ -142,6 +458,184 @@ void A_Tree::ConnectSignalsAndSlots()
     // Connect tree widget signals to internal slots
     connect(TreeWidget, &QTreeWidget::itemChanged, this, &A_Tree::OnItemChanged);
     connect(TreeWidget, &QTreeWidget::customContextMenuRequested, this, &A_Tree::ShowContextMenu);
+    connect(TreeWidget, &QTreeWidget::itemExpanded, this, &A_Tree::OnItemExpanded);
+    connect(TreeWidget, &QTreeWidget::itemCollapsed, this, &A_Tree::OnItemCollapsed);
+
+    // Inline edits change item text without passing through EditItem
+    connect(TreeWidget->itemDelegate(), &QAbstractItemDelegate::closeEditor, this, [this]() {
+        QTreeWidgetItem *_item = TreeWidget->currentItem();  // Item that was edited
+        if (!_item || _item->text(0) == EditStartText) {
+            return;                                       // Cancelled or unchanged - nothing to persist
+        }
+        JournalItemRecord(A_TreeJournal::SetText, _item); // Persist edited text
+        RepositionSortedItem(_item);                      // Edited item may belong elsewhere in a sorted list
+        InvalidateFilterIndex();                          // Edited text must be re-tested against filter
+    });
+
+    // Track which snapshot blocks change so snapshots can share unchanged blocks
+    QAbstractItemModel *_model = TreeWidget->model();     // Model behind the tree widget
+    connect(_model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        for (int _row = topLeft.row(); _row <= bottomRight.row(); ++_row) {
+            MarkSnapshotDirty(topLeft.sibling(_row, 0));  // Block holding each changed item
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first) {
+        if (!IsSnapshotRequested.load(std::memory_order_relaxed) || IsCompact) {
+            return;
+        }
+        QTreeWidgetItem *_container = ContainerFromIndex(parent);  // Owner of the inserted rows
+        MarkSnapshotDirty(_container);
+        if (_container && first > 0) {
+            MarkSnapshotDirty(_container->child(first - 1));  // Preceding run takes the new rows in
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        if (!IsSnapshotRequested.load(std::memory_order_relaxed) || IsCompact) {
+            return;
+        }
+        QTreeWidgetItem *_container = ContainerFromIndex(parent);  // Owner of the rows being removed
+        for (int _row = first; _container && _row <= last; ++_row) {
+            MarkSnapshotDirty(_container->child(_row));   // Blocks starting or holding the removed rows
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &parent) {
+        MarkSnapshotDirty(parent);
+    });
+    connect(_model, &QAbstractItemModel::layoutChanged, this, [this](const QList<QPersistentModelIndex> &parents) {
+        if (parents.isEmpty() && SortingContainer) {
+            MarkSnapshotChildrenDirty(SortingContainer);  // Sibling reorder reported without its parent
+            return;
+        }
+        if (parents.isEmpty()) {
+            MarkSnapshotAllDirty();                       // Unknown extent - rebuild everything
+            return;
+        }
+        for (const QPersistentModelIndex &_parent : parents) {
+            MarkSnapshotChildrenDirty(ContainerFromIndex(_parent));
+        }
+    });
+    connect(_model, &QAbstractItemModel::modelReset, this, &A_Tree::MarkSnapshotAllDirty);
+
+    // Invalidate subtree hashes of changed items and their ancestors - rehashed when next requested
+    connect(_model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &topLeft, const QModelIndex &bottomRight) {
+        if (!Hashes.IsEnabled()) {
+            return;
+        }
+        for (int _row = topLeft.row(); _row <= bottomRight.row(); ++_row) {
+            InvalidateSubtreeHash(ContainerFromIndex(topLeft.sibling(_row, 0)));
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent) {
+        if (Hashes.IsEnabled()) {
+            InvalidateSubtreeHash(ContainerFromIndex(parent));  // Inserted subtrees keep valid hashes of moved items
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsRemoved, this, [this](const QModelIndex &parent) {
+        if (Hashes.IsEnabled()) {
+            InvalidateSubtreeHash(ContainerFromIndex(parent));
+        }
+    });
+    connect(_model, &QAbstractItemModel::layoutChanged, this, [this](const QList<QPersistentModelIndex> &parents) {
+        if (!Hashes.IsEnabled()) {
+            return;
+        }
+        if (parents.isEmpty() && SortingContainer) {
+            InvalidateSubtreeHash(SortingContainer);      // Sibling reorder reported without its parent
+            return;
+        }
+        if (parents.isEmpty()) {
+            // Unknown sibling lists were reordered - subtrees keep their content, only parents fold children in a new order
+            for (A_TreeItem *_item : std::as_const(NodeTable)) {
+                if (_item && _item->childCount() > 0) {
+                    Hashes.Invalidate(GetItemId(_item));
+                }
+            }
+            return;
+        }
+        for (const QPersistentModelIndex &_parent : parents) {
+            InvalidateSubtreeHash(ContainerFromIndex(_parent));
+        }
+    });
+    connect(_model, &QAbstractItemModel::modelReset, this, [this]() {
+        if (Hashes.IsEnabled()) {
+            Hashes.InvalidateAll();                       // All items are gone
+        }
+    });
+
+    // Keep the path index in step with inserted and renamed items - entries of removed items are dropped when seen
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last) {
+        if (PathIndexedBits.isEmpty()) {
+            return;                                       // No path lookups yet
+        }
+        QTreeWidgetItem *_container = ContainerFromIndex(parent);  // Owner of the inserted rows
+        if (!_container || !IsPathContainerIndexed(_container == TreeWidget->invisibleRootItem() ? 0 : GetItemId(_container))) {
+            return;                                       // Sibling list is indexed on its first lookup
+        }
+        for (int _row = first; _row <= last; ++_row) {
+            AddPathIndexEntry(_container->child(_row));
+        }
+    });
+    connect(TreeWidget, &QTreeWidget::itemChanged, this, [this](QTreeWidgetItem *item, int column) {
+        quint32 _parentId = item->parent() ? GetItemId(item->parent()) : 0;  // Sibling list owner
+        if (column != 0 || !IsPathContainerIndexed(_parentId)) {
+            return;                                       // Sibling list not indexed
+        }
+        AddPathIndexEntry(item);                          // File under new text - old entry is dropped on its next lookup
+    });
+    connect(_model, &QAbstractItemModel::modelReset, this, [this]() {
+        PathIndex.clear();                                // All items are gone
+        PathIndexedBits.clear();
+        if (Aggregates.IsEnabled()) {
+            Aggregates.Invalidate();                      // Empty tree has nothing to roll up
+        }
+    });
+
+    // Roll subtree aggregates up the ancestor chain when subtrees are attached or detached
+    connect(_model, &QAbstractItemModel::rowsInserted, this, [this](const QModelIndex &parent, int first, int last) {
+        if (!CanApplyAggregateDelta()) {
+            return;
+        }
+        QTreeWidgetItem *_container = ContainerFromIndex(parent);  // Owner of the inserted rows
+        if (!_container) {
+            return;
+        }
+        for (int _row = first; _row <= last; ++_row) {
+            A_TreeAggregates::Values _delta = GetSubtreeAggregate(_container->child(_row));  // Computes new subtrees once
+            _delta.DescendantCount++;                     // Inserted item itself
+            ApplyAggregateDelta(_container, _delta, false);
+        }
+    });
+    connect(_model, &QAbstractItemModel::rowsAboutToBeRemoved, this, [this](const QModelIndex &parent, int first, int last) {
+        if (!CanApplyAggregateDelta()) {
+            return;
+        }
+        QTreeWidgetItem *_container = ContainerFromIndex(parent);  // Owner of the rows being removed
+        if (!_container) {
+            return;
+        }
+        for (int _row = first; _row <= last; ++_row) {
+            quint32 _childId = GetItemId(_container->child(_row));
+            if (!Aggregates.IsValid(_childId)) {
+                continue;                                 // Never counted
+            }
+            A_TreeAggregates::Values _delta = Aggregates.Get(_childId);  // Subtree keeps its roll-up for a later insert
+            _delta.DescendantCount++;                     // Removed item itself
+            ApplyAggregateDelta(_container, _delta, true);
+        }
+    });
+
+    // Connect background filter evaluation to result handler
+    FilterWatcher = new QFutureWatcher<FilterResult>(this);  // Watcher for worker-thread filter runs
+    connect(FilterWatcher, &QFutureWatcher<FilterResult>::finished, this, &A_Tree::OnFilterFinished);
+
+    // Poll the shared store while attached as reader
+    SharedPollTimer = new QTimer(this);                   // Cheap counter check - items reload only on change
+    SharedPollTimer->setInterval(SharedPollMilliseconds);
+    connect(SharedPollTimer, &QTimer::timeout, this, &A_Tree::PollSharedTree);
+
+    // Connect background export to result handler
+    ExportWatcher = new QFutureWatcher<qint64>(this);    // Watcher for worker-thread exports
+    connect(ExportWatcher, &QFutureWatcher<qint64>::finished, this, &A_Tree::OnExportFinished);
 }
 
 QTreeWidgetItem* A_Tree::AddRootItem(const QString &text)
@@ -156,19 +650,11 @@ QTreeWidgetItem* A_Tree::AddRootItem(const QString &text)
         return nullptr;                                   // Return null for empty text
     }
 
-    QTreeWidgetItem *_newItem = new QTreeWidgetItem();    // Create new tree item
-    _newItem->setText(0, text.trimmed());                 // Set item text (trimmed)
-    _newItem->setCheckState(0, Qt::Unchecked);            // Set initial checkbox state to unchecked
-
-    // Set flags based on current edit mode state
-    Qt::ItemFlags _flags = _newItem->flags() | Qt::ItemIsUserCheckable;
-    if (IsEditModeEnabled) {
-        _flags |= Qt::ItemIsEditable;                     // Add editable flag only if edit mode is enabled
-    }
-    _newItem->setFlags(_flags);                           // Apply the flags
-
-    TreeWidget->addTopLevelItem(_newItem);                // Add item to tree as root level
-    TreeWidget->expandItem(_newItem);                     // Expand the new item to show potential children
+    A_TreeItem *_newItem = CreateItem(text.trimmed());    // Create new tree item
+    InsertSortedOrAppend(TreeWidget->invisibleRootItem(), _newItem);  // Add item to tree as root level
+    JournalAddedSubtree(_newItem);                        // Persist new item
+    ExpandNewItem(_newItem);                              // Expand the new item to show potential children
+    InvalidateFilterIndex();                              // New item must be tested against active filter
 
     return _newItem;                                      // Return pointer to created item
 }
@@ -186,22 +672,15 @@ QTreeWidgetItem* A_Tree::AddChildItem(QTreeWidgetItem *parent, const QString &te
         return nullptr;                                   // Return null for invalid input
     }
 
-    QTreeWidgetItem *_newChild = new QTreeWidgetItem();   // Create new child item
-    _newChild->setText(0, text.trimmed());                // Set child text (trimmed)
-    _newChild->setCheckState(0, Qt::Unchecked);           // Set initial checkbox state to unchecked
-
-    // Set flags based on current edit mode state
-    Qt::ItemFlags _flags = _newChild->flags() | Qt::ItemIsUserCheckable;
-    if (IsEditModeEnabled) {
-        _flags |= Qt::ItemIsEditable;                     // Add editable flag only if edit mode is enabled
-    }
-    _newChild->setFlags(_flags);                          // Apply the flags
-
-    parent->addChild(_newChild);                          // Add child to parent item
-    parent->setExpanded(true);                            // Expand parent to show new child
+    A_TreeItem *_newChild = CreateItem(text.trimmed());   // Create new child item
+    InsertSortedOrAppend(parent, _newChild);              // Add child to parent item
+    JournalAddedSubtree(_newChild);                       // Persist new item
+    SyncCheckedLeafBit(parent);                           // Parent is no longer a leaf
+    ExpandNewItem(parent);                                // Expand parent to show new child
 
     // Update parent's check state based on new child
     UpdateParentCheckState(_newChild);                    // Update parent state
+    InvalidateFilterIndex();                              // New item must be tested against active filter
 
     return _newChild;                                     // Return pointer to created child
 }
@@ -218,22 +697,250 @@ void A_Tree::DeleteItem(QTreeWidgetItem *item)
     }
 
     QString _itemText = item->text(0);                    // Capture item text before deletion
-    QTreeWidgetItem *_parent = item->parent();            // Get parent item for state update
 
-    // Remove item from tree
-    if (_parent) {
-        _parent->removeChild(item);                       // Remove from parent if it has one
-        // Update parent state after child removal
-        if (_parent->childCount() > 0) {
-            UpdateParentCheckState(_parent->child(0));    // Update using first remaining child
+    UnregisterSubtree(item);                              // Release identifiers and auxiliary state of subtree
+    DetachItem(item);                                     // Remove item from tree
+    delete item;                                          // Delete the item object
+    InvalidateFilterIndex();                              // Flattened index holds pointers into removed subtree
+    emit ItemDeleted(_itemText);                          // Emit signal with deleted item text
+}
+
+bool A_Tree::DeleteItemAsync(QTreeWidgetItem *item)
+{
+    /**
+     * Queues a time-sliced deletion of a subtree
+     * @param item Tree item to delete
+     * @return True if queued
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return false;
+    }
+
+    JournalItemRecord(A_TreeJournal::RemoveNode, item);   // One record - replay removes the whole subtree
+    if (!PathIndex.isEmpty()) {
+        PathIndex.remove(qMakePair(GetItemId(item->parent()), PathTextHash(item->text(0))), GetItemId(item));  // Only the root is reachable by path
+    }
+    for (QTreeWidgetItem *_ancestor = CurrentItem; _ancestor; _ancestor = _ancestor->parent()) {
+        if (_ancestor == item) {
+            CurrentItem = nullptr;                        // Context menu target leaves the view
+            break;
         }
-    } else {
-        int _index = TreeWidget->indexOfTopLevelItem(item);  // Find index of root item
-        TreeWidget->takeTopLevelItem(_index);             // Remove root item from tree
     }
+    DetachItem(item);                                     // One model change - the slices work on the detached subtree
+    InvalidateFilterIndex();                              // Flattened index holds pointers into the detached subtree
 
-    delete item;                                          // Delete the item object
-    emit ItemDeleted(_itemText);                          // Emit signal with deleted item text
+    SubtreeJob _job;                                      // Deletion of item's subtree
+    _job.Type = DeleteSubtreeJob;
+    _job.RootId = GetItemId(item);
+    _job.RootText = item->text(0);
+    StartSubtreeJob(_job);
+    return true;
+}
+
+bool A_Tree::SetItemCheckedStateAsync(QTreeWidgetItem *item, bool checked)
+{
+    /**
+     * Queues a time-sliced check state change of a subtree
+     * @param item Tree item to modify
+     * @param checked New checked state
+     * @return True if queued
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return false;
+    }
+
+    SubtreeJob _job;                                      // Check state change of item's subtree
+    _job.Type = CheckSubtreeJob;
+    _job.RootId = GetItemId(item);
+    _job.RootText = item->text(0);
+    _job.State = checked ? Qt::Checked : Qt::Unchecked;
+    StartSubtreeJob(_job);
+    return true;
+}
+
+void A_Tree::CancelSubtreeJobs()
+{
+    /**
+     * Drops all queued jobs - a scheduled slice finds the queue empty and returns
+     */
+
+    if (SubtreeJobs.isEmpty()) {
+        return;
+    }
+
+    for (const SubtreeJob &_job : std::as_const(SubtreeJobs)) {
+        QTreeWidgetItem *_root = _job.Type == DeleteSubtreeJob ? GetItemById(_job.RootId) : nullptr;  // Detached remainder
+        if (_root) {
+            ReleaseSubtree(_root);                        // Removal was journaled when the job was queued
+            delete _root;
+        }
+    }
+    SubtreeJobs.clear();
+    emit SubtreeJobFinished(true);
+}
+
+bool A_Tree::IsSubtreeJobRunning() const
+{
+    /**
+     * Gets whether the job queue is non-empty
+     * @return True if a job is queued
+     */
+
+    return !SubtreeJobs.isEmpty();
+}
+
+void A_Tree::StartSubtreeJob(const SubtreeJob &job)
+{
+    /**
+     * Appends a job to the queue
+     * An idle queue runs the first slice immediately, so small subtrees finish before this returns
+     * @param job Job to queue
+     */
+
+    SubtreeJobs.append(job);
+    SubtreeJobs.last().Pending.append(job.RootId);        // Collection starts at the root
+
+    if (SubtreeJobs.size() == 1 && !IsSubtreeSlicePending) {
+        RunSubtreeJobSlice();
+    }
+}
+
+void A_Tree::RunSubtreeJobSlice()
+{
+    /**
+     * Advances the first job for one time slice, then yields to the event loop
+     */
+
+    IsSubtreeSlicePending = false;
+    if (SubtreeJobs.isEmpty()) {
+        return;                                           // Cancelled
+    }
+
+    QElapsedTimer _timer;                                 // Budget of this slice
+    _timer.start();
+
+    SubtreeJob &_job = SubtreeJobs.first();               // Running job - no signal is emitted while this is held
+    const bool _isDone = (_job.IsCollected || CollectSubtreeJob(_job, _timer)) && ProcessSubtreeJob(_job, _timer);
+    const int _processedCount = _job.ProcessedCount;      // Read before the queue changes
+    const int _totalCount = _job.IsCollected ? _job.NodeIds.size() : 0;
+    const SubtreeJobType _type = _job.Type;
+    const QString _rootText = _job.RootText;
+    const Qt::CheckState _state = _job.State;
+    const bool _isRootDone = _job.IsRootDone;
+    if (_isDone && !SubtreeJobs.isEmpty()) {
+        SubtreeJobs.removeFirst();                        // Handlers below may cancel or queue jobs
+    }
+
+    if (_isRootDone) {
+        if (_type == DeleteSubtreeJob) {
+            emit ItemDeleted(_rootText);
+        } else {
+            emit ItemCheckStateChanged(_rootText, _state == Qt::Checked);
+        }
+    }
+    emit SubtreeJobProgress(_processedCount, _totalCount);
+    if (_isDone) {
+        emit SubtreeJobFinished(false);
+    }
+
+    if (!SubtreeJobs.isEmpty() && !IsSubtreeSlicePending) {
+        IsSubtreeSlicePending = true;
+        QTimer::singleShot(0, this, &A_Tree::RunSubtreeJobSlice);  // Let input and painting run first
+    }
+}
+
+bool A_Tree::CollectSubtreeJob(SubtreeJob &job, const QElapsedTimer &timer)
+{
+    /**
+     * Walks the subtree by identifier; pushing children in order and processing the list from
+     * the back yields children-first order with siblings in view order
+     * @return True if collected
+     */
+
+    int _stepCount = 0;                                   // Items visited in this slice
+    while (!job.Pending.isEmpty()) {
+        if ((++_stepCount & 1023) == 0 && timer.elapsed() >= SubtreeJobSliceMilliseconds) {
+            return false;                                 // Continue in the next slice
+        }
+
+        const quint32 _nodeId = job.Pending.takeLast();
+        QTreeWidgetItem *_item = GetItemById(_nodeId);    // Null if deleted between slices
+        if (!_item) {
+            continue;
+        }
+        job.NodeIds.append(_nodeId);
+        for (int _childIndex = 0; _childIndex < _item->childCount(); ++_childIndex) {
+            job.Pending.append(GetItemId(_item->child(_childIndex)));
+        }
+    }
+
+    job.IsCollected = true;
+    return true;
+}
+
+bool A_Tree::ProcessSubtreeJob(SubtreeJob &job, const QElapsedTimer &timer)
+{
+    /**
+     * Frees or updates collected items children-first
+     * Deleted subtrees are detached already, so nothing in the view changes. For check jobs only the
+     * ancestor chain of the last processed item can be out of date at the end of a slice
+     * (every earlier item's parent is on it), so recalculating that chain keeps the tree consistent
+     * @return True if finished
+     */
+
+    const int _totalCount = job.NodeIds.size();           // Items collected
+    quint32 _lastId = 0;                                  // Last updated item of a check job
+    bool _isRootDone = false;                             // Root was processed in this slice
+    int _stepCount = 0;                                   // Items processed in this slice
+
+    const bool _wasInternalUpdate = IsInternalUpdate;     // Slices may start inside a change handler
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+
+    while (job.ProcessedCount < _totalCount) {
+        if (_stepCount++ > 0 && (_stepCount & 63) == 0 && timer.elapsed() >= SubtreeJobSliceMilliseconds) {
+            break;                                        // Continue in the next slice
+        }
+
+        const quint32 _nodeId = job.NodeIds.at(_totalCount - 1 - job.ProcessedCount++);
+        QTreeWidgetItem *_item = GetItemById(_nodeId);    // Null if deleted between slices
+        if (!_item) {
+            continue;
+        }
+        _isRootDone = (_nodeId == job.RootId);
+        job.IsRootDone = _isRootDone;
+
+        if (job.Type == DeleteSubtreeJob) {
+            ReleaseSubtree(_item);                        // Journaled with the root when the job was queued
+            delete _item;                                 // Leaf of the detached subtree - no model signals
+            continue;
+        }
+
+        const bool _isLeaf = _item->childCount() == 0;    // Leaves take the target state
+        const Qt::CheckState _state = _isLeaf ? job.State : CalculateParentCheckState(_item);
+        if (_item->checkState(0) != _state) {
+            _item->setCheckState(0, _state);
+            if (_isLeaf) {
+                JournalItemRecord(A_TreeJournal::SetCheckState, _item);  // Cancelled jobs replay exactly
+            }
+        }
+        SyncCheckedLeafBit(_item);
+        _lastId = _nodeId;
+    }
+
+    QTreeWidgetItem *_lastItem = GetItemById(_lastId);    // Start of the chain to recalculate - none for deletions
+    if (_lastItem) {
+        UpdateParentCheckState(_lastItem);
+    }
+
+    IsInternalUpdate = _wasInternalUpdate;                // Restore flag
+
+    if (_isRootDone && job.Type != DeleteSubtreeJob) {
+        RepositionCheckSortedItems(GetItemById(job.RootId));  // Lists sorted by check state follow the change
+    }
+
+    return job.ProcessedCount >= _totalCount;
 }
 
 void A_Tree::EditItem(QTreeWidgetItem *item)
@@ -261,6 +968,9 @@ void A_Tree::EditItem(QTreeWidgetItem *item)
         IsInternalUpdate = true;                          // Set flag to prevent recursive signals
         item->setText(0, _newText.trimmed());             // Update item text
         IsInternalUpdate = false;                         // Clear flag
+        JournalItemRecord(A_TreeJournal::SetText, item);  // Persist new text
+        RepositionSortedItem(item);                       // Keep sorted siblings in order
+        InvalidateFilterIndex();                          // Changed text must be re-tested against filter
 
         emit ItemEdited(_newText.trimmed());              // Emit signal with new text
     }
@@ -274,6 +984,7 @@ void A_Tree::LoadDemoData()
      */
 
     ClearAllItems();                                      // Clear any existing items
+    BeginBulkUpdate();                                    // Expand once after all items exist
 
     // Create sample tree structure
     QTreeWidgetItem *_documentsRoot = AddRootItem("Documents");     // Documents root item
@@ -312,6 +1023,39 @@ void A_Tree::LoadDemoData()
         AddChildItem(_settingsRoot, "System Configuration");  // System config child
         AddChildItem(_settingsRoot, "Security Settings");     // Security settings child
     }
+
+    EndBulkUpdate();                                      // Apply expand state in one layout
+}
+
+A_Tree::SyntheticLoadReport A_Tree::LoadSyntheticData(const A_TreeGenerator::Parameters &parameters)
+{
+    /**
+     * Generates the tree and feeds it through SyncFromSource, which builds each root's subtree
+     * detached from the view and inserts it in one step
+     * @param parameters Generator settings
+     * @return Node count and timings
+     */
+
+    SyntheticLoadReport _report;                          // Result
+    QElapsedTimer _timer;                                 // Phase duration
+    _timer.start();
+
+    const QVector<A_TreeGenerator::Node> _generated = A_TreeGenerator(parameters).Generate();
+    QVector<SourceNode> _nodes(_generated.size());        // Same layout as the generated list
+    for (int _nodeIndex = 0; _nodeIndex < _generated.size(); ++_nodeIndex) {
+        _nodes[_nodeIndex].Text = _generated.at(_nodeIndex).Text;
+        _nodes[_nodeIndex].ParentIndex = _generated.at(_nodeIndex).ParentIndex;
+    }
+    _report.NodeCount = _nodes.size();
+    _report.GenerateMilliseconds = _timer.restart();
+
+    ClearAllItems();                                      // Sync into an empty tree only adds
+    BeginBulkUpdate();                                    // Expand once after all items exist
+    SyncFromSource(_nodes);
+    EndBulkUpdate();
+    _report.BuildMilliseconds = _timer.elapsed();
+
+    return _report;
 }
 
 void A_Tree::ClearAllItems()
@@ -320,107 +1064,4382 @@ void A_Tree::ClearAllItems()
      * Removes all items from the tree and resets internal state
      */
 
+    CancelSubtreeJobs();                                  // Identifiers are reused after clearing
+
+    if (Journal) {
+        A_TreeJournal::Record _record;                    // Single record replaces per-item removals
+        _record.Type = A_TreeJournal::ClearAll;
+        Journal->Append(_record);
+    }
+
     TreeWidget->clear();                                  // Clear all items from tree widget
     CurrentItem = nullptr;                                // Reset current item pointer
+    NodeTable.resize(1);                                  // Keep only reserved identifier 0
+    CheckedLeafBits.clear();                              // No leaves left
+    ExpandedBits.clear();                                 // No expanded items left
+    Attributes.ClearValues();                             // Keep columns, drop values of removed items
+
+    // Keep root level sort configuration, drop entries of removed parents
+    bool _hasRootSort = SortedParents.contains(TreeWidget->invisibleRootItem());
+    SortSpec _rootSpec = SortedParents.value(TreeWidget->invisibleRootItem());
+    SortedParents.clear();
+    if (_hasRootSort) {
+        SortedParents.insert(TreeWidget->invisibleRootItem(), _rootSpec);
+    }
+    InvalidateFilterIndex();                              // Drop flattened index of removed items
 }
 
-void A_Tree::SetEditMode(bool enabled)
+void A_Tree::BeginBulkUpdate()
 {
     /**
-     * Sets the edit mode state for the tree widget
-     * @param enabled True to enable editing, false to make read-only
+     * Starts a bulk update
+     * Inserts only record expansion, so the view does not re-layout per item
      */
 
-    IsEditModeEnabled = enabled;                          // Update internal edit mode flag
+    BulkUpdateDepth++;
+}
 
-    // Update item flags for all items in tree
-    QTreeWidgetItemIterator _iterator(TreeWidget);        // Iterator for all tree items
-    while (*_iterator) {
-        QTreeWidgetItem *_item = *_iterator;              // Current item in iteration
+void A_Tree::EndBulkUpdate()
+{
+    /**
+     * Ends a bulk update
+     * The outermost call applies the recorded expand state with one layout
+     */
+
+    if (BulkUpdateDepth == 0) {
+        return;                                           // Unbalanced call
+    }
+
+    if (--BulkUpdateDepth == 0) {
+        ApplyExpandedState();                             // One layout for the whole batch
+        if (IsAggregatesStale) {
+            RecomputeAggregates();                        // One parallel pass instead of per-item deltas
+        }
+    }
+}
+
+QBitArray A_Tree::GetExpandedState() const
+{
+    /**
+     * Gets the expand state bitmap
+     * @return Bits indexed by node identifier
+     */
+
+    return ExpandedBits;                                  // Implicitly shared copy
+}
+
+void A_Tree::SetExpandedState(const QBitArray &expandedBits)
+{
+    /**
+     * Replaces the expand state of all items and applies it in one batch
+     * @param expandedBits Bits indexed by node identifier
+     */
+
+    QBitArray _bits(ExpandedBits.size());                 // New state restricted to existing items
+    const int _bitCount = qMin(expandedBits.size(), NodeTable.size());
+    for (int _nodeId = 1; _nodeId < _bitCount; ++_nodeId) {
+        if (expandedBits.testBit(_nodeId) && NodeTable.at(_nodeId)) {
+            _bits.setBit(_nodeId);
+        }
+    }
+
+    if (Journal) {
+        for (int _nodeId = 1; _nodeId < NodeTable.size(); ++_nodeId) {
+            if (NodeTable.at(_nodeId) && _bits.testBit(_nodeId) != ExpandedBits.testBit(_nodeId)) {
+                ExpandedBits.setBit(_nodeId, _bits.testBit(_nodeId));
+                JournalItemRecord(A_TreeJournal::SetExpanded, NodeTable.at(_nodeId));  // Persist changed bits only
+            }
+        }
+    }
+
+    ExpandedBits = _bits;
+    ApplyExpandedState();
+}
+
+void A_Tree::ExpandNewItem(QTreeWidgetItem *item)
+{
+    /**
+     * Expands an item that just received content
+     * During bulk updates only the bit is recorded, the view is updated by EndBulkUpdate
+     * @param item Item to expand
+     */
+
+    if (BulkUpdateDepth == 0) {
+        item->setExpanded(true);                          // Interactive insert - expand now
+        return;
+    }
+
+    const int _nodeId = int(GetItemId(item));             // Bit to record
+    if (!ExpandedBits.testBit(_nodeId)) {
+        ExpandedBits.setBit(_nodeId);
+        JournalItemRecord(A_TreeJournal::SetExpanded, item);
+    }
+}
+
+void A_Tree::ApplyExpandedState()
+{
+    /**
+     * Resets view expansion to the recorded bits
+     * All items are collapsed, a full relayout is scheduled, and only root items
+     * are expanded here; the view merely stores those expansions until the deferred
+     * layout runs. Deeper levels follow through OnItemExpanded, which descends only
+     * into expanded items, so the cost is proportional to what ends up visible.
+     */
+
+    IsApplyingExpandState = true;                         // Collapse signals must not clear recorded bits
+    TreeWidget->collapseAll();                            // Drop current view expansion
+    TreeWidget->setRootIndex(TreeWidget->rootIndex());    // Schedules one deferred relayout
+    IsApplyingExpandState = false;
+
+    for (int _rootIndex = 0; _rootIndex < TreeWidget->topLevelItemCount(); ++_rootIndex) {
+        QTreeWidgetItem *_root = TreeWidget->topLevelItem(_rootIndex);  // Root item to restore
+        if (ExpandedBits.testBit(int(GetItemId(_root)))) {
+            _root->setExpanded(true);                     // Cascades through OnItemExpanded
+        }
+    }
+}
+
+void A_Tree::OnItemExpanded(QTreeWidgetItem *item)
+{
+    /**
+     * Records an expanded item and restores expansion of its children
+     * Children expanded earlier (or by a restored state) are expanded as soon as they become visible
+     * @param item Expanded item
+     */
+
+    if (!item || IsApplyingExpandState) {
+        return;                                           // View reset in progress
+    }
+
+    const int _nodeId = int(GetItemId(item));             // Bit of expanded item
+    if (!ExpandedBits.testBit(_nodeId)) {
+        ExpandedBits.setBit(_nodeId);
+        JournalItemRecord(A_TreeJournal::SetExpanded, item);  // Persist user expansion
+    }
+
+    for (int _childIndex = 0; _childIndex < item->childCount(); ++_childIndex) {
+        QTreeWidgetItem *_child = item->child(_childIndex);  // Child that just became visible
+        if (_child->childCount() > 0 && !_child->isExpanded() && ExpandedBits.testBit(int(GetItemId(_child)))) {
+            _child->setExpanded(true);                    // Recurses through this slot
+        }
+    }
+}
+
+void A_Tree::OnItemCollapsed(QTreeWidgetItem *item)
+{
+    /**
+     * Records a collapsed item - descendants keep their recorded state
+     * @param item Collapsed item
+     */
+
+    if (!item || IsApplyingExpandState) {
+        return;                                           // View reset in progress
+    }
+
+    const int _nodeId = int(GetItemId(item));             // Bit of collapsed item
+    if (ExpandedBits.testBit(_nodeId)) {
+        ExpandedBits.clearBit(_nodeId);
+        JournalItemRecord(A_TreeJournal::SetExpanded, item);  // Persist user collapse
+    }
+}
+
+void A_Tree::SetEditMode(bool enabled)
+{
+    /**
+     * Sets the edit mode state for the tree widget
+     * @param enabled True to enable editing, false to make read-only
+     */
+
+    IsEditModeEnabled = enabled && !IsSharedReader;       // Update internal edit mode flag - viewers stay read-only
+
+    // Update item flags for all items in tree
+    QTreeWidgetItemIterator _iterator(TreeWidget);        // Iterator for all tree items
+    while (*_iterator) {
+        QTreeWidgetItem *_item = *_iterator;              // Current item in iteration
         if (IsEditModeEnabled) {
             _item->setFlags(_item->flags() | Qt::ItemIsEditable);  // Enable editing
         } else {
             _item->setFlags(_item->flags() & ~Qt::ItemIsEditable); // Disable editing
         }
-        ++_iterator;                                      // Move to next item
+        ++_iterator;                                      // Move to next item
+    }
+}
+
+bool A_Tree::GetEditMode() const
+{
+    /**
+     * Gets the current edit mode state
+     * @return True if editing is enabled, false if read-only
+     */
+
+    return IsEditModeEnabled;                             // Return current edit mode state
+}
+
+bool A_Tree::GetItemCheckedState(QTreeWidgetItem *item) const
+{
+    /**
+     * Gets the checked state of specified item
+     * @param item Tree item to check
+     * @return True if item is checked, false if unchecked or item invalid
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return false;                                     // Return false for invalid item
+    }
+
+    return item->checkState(0) == Qt::Checked;            // Return true if item is checked
+}
+
+void A_Tree::SetItemCheckedState(QTreeWidgetItem *item, bool checked)
+{
+    /**
+     * Sets the checked state of specified item
+     * @param item Tree item to modify
+     * @param checked New checked state
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return;                                           // Exit if item is invalid
+    }
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    item->setCheckState(0, checked ? Qt::Checked : Qt::Unchecked);  // Set checkbox state
+    PropagateCheckState(item);                            // Update children and parent chain
+    IsInternalUpdate = false;                             // Clear flag
+    JournalItemRecord(A_TreeJournal::SetCheckState, item);  // Persist state - replay propagates it again
+    RepositionCheckSortedItems(item);                     // Lists sorted by check state follow the change
+
+    emit ItemCheckStateChanged(item->text(0), checked);   // Emit signal with state change
+}
+
+void A_Tree::SetFilterText(const QString &text)
+{
+    /**
+     * Requests filtering of the tree by case-insensitive substring
+     * @param text Filter query, empty to show all items
+     */
+
+    QString _query = text.trimmed();                      // Normalized query text
+    if (_query == FilterText && !IsFilterIndexDirty) {    // Skip if nothing changed since last run
+        return;
+    }
+
+    FilterText = _query;                                  // Store requested query
+    RunFilter();                                          // Evaluate and apply
+}
+
+QString A_Tree::GetFilterText() const
+{
+    /**
+     * Gets the currently requested filter query
+     * @return Filter text, empty if no filter is active
+     */
+
+    return FilterText;                                    // Return requested query
+}
+
+A_Tree::FilterResult A_Tree::EvaluateFilter(const QStringList &texts, const QVector<int> &parents,
+                                            const QString &query, const QBitArray &candidates, int requestId)
+{
+    /**
+     * Tests node texts against the query and derives ancestor visibility
+     * Works only on copied data so it can run on any thread
+     * @return Match and visibility bits in pre-order
+     */
+
+    const int _nodeCount = texts.size();                  // Number of flattened nodes
+
+    FilterResult _result;                                 // Result being built
+    _result.MatchBits = QBitArray(_nodeCount, false);     // No node matches yet
+    _result.VisibleBits = QBitArray(_nodeCount, false);   // No node visible yet
+    _result.Query = query;
+    _result.RequestId = requestId;
+
+    const bool _hasCandidates = !candidates.isEmpty();    // Narrowing run - only previous matches can still match
+    for (int _nodeIndex = 0; _nodeIndex < _nodeCount; ++_nodeIndex) {
+        if (_hasCandidates && !candidates.testBit(_nodeIndex)) {
+            continue;                                     // Failed a weaker query, cannot match a stronger one
+        }
+        if (texts.at(_nodeIndex).contains(query, Qt::CaseInsensitive)) {
+            _result.MatchBits.setBit(_nodeIndex);         // Node text contains query
+        }
+    }
+
+    // Reverse pre-order visits children before parents, so one pass propagates visibility upwards
+    for (int _nodeIndex = _nodeCount - 1; _nodeIndex >= 0; --_nodeIndex) {
+        if (_result.MatchBits.testBit(_nodeIndex) || _result.VisibleBits.testBit(_nodeIndex)) {
+            _result.VisibleBits.setBit(_nodeIndex);       // Node matches or has a matching descendant
+            int _parentIndex = parents.at(_nodeIndex);    // Parent position in pre-order
+            if (_parentIndex >= 0) {
+                _result.VisibleBits.setBit(_parentIndex); // Keep ancestor visible
+            }
+        }
+    }
+
+    return _result;
+}
+
+void A_Tree::RebuildFilterIndex()
+{
+    /**
+     * Flattens the tree into pre-order arrays used by filter evaluation
+     * Previous match bits are dropped because node positions may have changed
+     */
+
+    FilterItems.clear();
+    FilterParents.clear();
+    FilterTexts.clear();
+
+    QVector<QPair<QTreeWidgetItem*, int>> _stack;         // Pending items with their parent index
+    for (int _rootIndex = TreeWidget->topLevelItemCount() - 1; _rootIndex >= 0; --_rootIndex) {
+        _stack.append(qMakePair(TreeWidget->topLevelItem(_rootIndex), -1));
+    }
+
+    while (!_stack.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> _entry = _stack.takeLast();  // Next item in pre-order
+        int _nodeIndex = FilterItems.size();              // Position of this item in the index
+
+        FilterItems.append(_entry.first);
+        FilterParents.append(_entry.second);
+        FilterTexts.append(_entry.first->text(0));
+
+        for (int _childIndex = _entry.first->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            _stack.append(qMakePair(_entry.first->child(_childIndex), _nodeIndex));  // Reverse push keeps child order
+        }
+    }
+
+    FilterMatchBits.clear();                              // Old matches refer to old positions
+    FilterMatchQuery.clear();
+    FilterVisibleBits.clear();                            // Unknown applied state - compare with item visibility
+    IsFilterIndexDirty = false;
+}
+
+void A_Tree::InvalidateFilterIndex()
+{
+    /**
+     * Marks the flattened index as stale and discards in-flight results
+     * Re-filtering is coalesced into one run per event loop turn
+     */
+
+    IsFilterIndexDirty = true;                            // Index must be rebuilt before next evaluation
+    FilterItems.clear();                                  // Drop pointers that may be dangling
+    FilterRequestId++;                                    // Outstanding results belong to the old index
+
+    if (FilterText.isEmpty() || IsFilterRefreshPending) { // Nothing to refresh or refresh already scheduled
+        return;
+    }
+
+    IsFilterRefreshPending = true;
+    QTimer::singleShot(0, this, [this]() {
+        IsFilterRefreshPending = false;
+        RunFilter();                                      // Re-apply active filter to changed tree
+    });
+}
+
+void A_Tree::ReleaseFilterIndex()
+{
+    /**
+     * Frees the flattened index and everything positioned by it
+     */
+
+    FilterItems = QVector<QTreeWidgetItem*>();
+    FilterParents = QVector<int>();
+    FilterTexts = QStringList();
+    FilterMatchBits = QBitArray();                        // Positions refer to the released index
+    FilterVisibleBits = QBitArray();
+    FilterMatchQuery.clear();
+    IsFilterIndexDirty = true;                            // Rebuilt by the next run
+}
+
+void A_Tree::RunFilter()
+{
+    /**
+     * Evaluates the requested query, narrowing from previous matches when possible
+     * Small trees are evaluated inline, large trees on a worker thread
+     */
+
+    if (IsFilterIndexDirty) {
+        RebuildFilterIndex();                             // Flatten current tree
+    }
+
+    int _requestId = ++FilterRequestId;                   // Identify this run
+
+    if (FilterText.isEmpty()) {
+        FilterResult _showAll;                            // Empty query shows every item
+        _showAll.VisibleBits = QBitArray(FilterItems.size(), true);
+        _showAll.RequestId = _requestId;
+        ApplyFilterResult(_showAll);
+        return;
+    }
+
+    QBitArray _candidates;                                // Nodes that can still match - empty tests all
+    if (!FilterMatchQuery.isEmpty() && FilterText.contains(FilterMatchQuery, Qt::CaseInsensitive)) {
+        _candidates = FilterMatchBits;                    // Narrowed query - only survivors need re-testing
+    }
+
+    if (FilterItems.size() < FilterAsyncThreshold) {
+        ApplyFilterResult(EvaluateFilter(FilterTexts, FilterParents, FilterText, _candidates, _requestId));
+        return;
+    }
+
+    // Worker receives implicitly shared copies, so later index rebuilds never race with it
+    QStringList _texts = FilterTexts;
+    QVector<int> _parents = FilterParents;
+    QString _query = FilterText;
+    FilterWatcher->setFuture(QtConcurrent::run([_texts, _parents, _query, _candidates, _requestId]() {
+        return EvaluateFilter(_texts, _parents, _query, _candidates, _requestId);
+    }));
+}
+
+void A_Tree::ApplyFilterResult(const FilterResult &result)
+{
+    /**
+     * Applies a filter result to item visibility
+     * Only items whose visibility differs from the applied state are touched
+     * @param result Filter evaluation result
+     */
+
+    if (result.RequestId != FilterRequestId || result.VisibleBits.size() != FilterItems.size()) {
+        return;                                           // Outdated result or index changed meanwhile
+    }
+
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole batch
+    const bool _hasAppliedState = (FilterVisibleBits.size() == FilterItems.size());
+    for (int _nodeIndex = 0; _nodeIndex < FilterItems.size(); ++_nodeIndex) {
+        bool _isVisible = result.VisibleBits.testBit(_nodeIndex);  // New visibility
+        bool _wasVisible = _hasAppliedState ? FilterVisibleBits.testBit(_nodeIndex)
+                                            : !FilterItems.at(_nodeIndex)->isHidden();
+        if (_isVisible != _wasVisible) {
+            FilterItems.at(_nodeIndex)->setHidden(!_isVisible);
+        }
+    }
+    TreeWidget->setUpdatesEnabled(true);
+
+    FilterVisibleBits = result.VisibleBits;               // Remember applied state for next diff
+    FilterMatchBits = result.MatchBits;                   // Basis for narrowing next query
+    FilterMatchQuery = result.Query;
+    const int _matchCount = result.MatchBits.count(true); // Number of direct matches
+    if (IsCompact) {
+        ReleaseFilterIndex();                             // Next run flattens the tree again
+    }
+
+    emit FilterApplied(_matchCount);                      // Report number of direct matches
+}
+
+void A_Tree::OnFilterFinished()
+{
+    /**
+     * Handles completion of a background filter evaluation
+     */
+
+    ApplyFilterResult(FilterWatcher->result());           // Apply unless superseded
+}
+
+void A_Tree::SortChildren(QTreeWidgetItem *parent, SortMode mode, Qt::SortOrder order)
+{
+    /**
+     * Sorts the children of an item and keeps them sorted afterwards
+     * @param parent Item whose children are sorted, nullptr for root items
+     * @param mode Sort criterion
+     * @param order Sort direction
+     */
+
+    QTreeWidgetItem *_container = parent ? parent : TreeWidget->invisibleRootItem();  // Sibling list owner
+
+    SortSpec _spec;                                       // Sort configuration to keep
+    _spec.Mode = mode;
+    _spec.Order = order;
+    SortedParents.insert(_container, _spec);              // New children are placed by binary search
+    JournalSortSpec(_container, _spec);                   // Replay keeps the list sorted as well
+
+    SortContainer(_container, _spec);                     // Reorder existing children
+    InvalidateFilterIndex();                              // Flattened positions changed
+}
+
+void A_Tree::SortChildrenByAttribute(QTreeWidgetItem *parent, int column, Qt::SortOrder order)
+{
+    /**
+     * Sorts the children of an item by an attribute column and keeps them sorted afterwards
+     * @param parent Item whose children are sorted, nullptr for root items
+     * @param column Attribute column index
+     * @param order Sort direction
+     */
+
+    if (column < 0 || column >= Attributes.GetColumnCount()) {
+        return;                                           // Unknown column
+    }
+
+    QTreeWidgetItem *_container = parent ? parent : TreeWidget->invisibleRootItem();  // Sibling list owner
+
+    SortSpec _spec;                                       // Sort configuration to keep
+    _spec.Mode = SortByAttribute;
+    _spec.Order = order;
+    _spec.AttributeColumn = column;
+    _spec.AttributeType = Attributes.GetColumnType(column);
+    SortedParents.insert(_container, _spec);              // New children are placed by binary search
+    JournalSortSpec(_container, _spec);                   // Replay keeps the list sorted as well
+
+    SortContainer(_container, _spec);                     // Reorder existing children
+    InvalidateFilterIndex();                              // Flattened positions changed
+}
+
+void A_Tree::SortAllItems(SortMode mode, Qt::SortOrder order)
+{
+    /**
+     * Sorts every sibling list and keeps the whole tree sorted
+     * @param mode Sort criterion
+     * @param order Sort direction
+     */
+
+    TreeSortSpec.Mode = mode;
+    TreeSortSpec.Order = order;
+    IsTreeSorted = true;                                  // Applies to every parent from now on
+    SortedParents.clear();                                // Per-parent configurations are superseded
+    JournalSortSpec(nullptr, TreeSortSpec);               // Replay keeps the tree sorted as well
+
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole tree
+    QVector<QTreeWidgetItem*> _pending;                   // Containers still to sort
+    _pending.append(TreeWidget->invisibleRootItem());
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_container = _pending.takeLast();  // Next sibling list owner
+        SortContainer(_container, TreeSortSpec);
+        for (int _childIndex = 0; _childIndex < _container->childCount(); ++_childIndex) {
+            if (_container->child(_childIndex)->childCount() > 1) {
+                _pending.append(_container->child(_childIndex));  // Only lists with 2+ items need sorting
+            }
+        }
+    }
+    TreeWidget->setUpdatesEnabled(true);
+
+    InvalidateFilterIndex();                              // Flattened positions changed
+}
+
+void A_Tree::ClearSortOrder()
+{
+    /**
+     * Stops keeping sibling lists sorted
+     * Current order is left as is, new items are appended again
+     */
+
+    SortedParents.clear();                                // Drop per-parent configurations
+    IsTreeSorted = false;                                 // Drop tree-wide configuration
+
+    if (Journal) {
+        A_TreeJournal::Record _record;                    // Configuration is not part of snapshots
+        _record.Type = A_TreeJournal::ClearSortOrder;
+        Journal->Append(_record);
+    }
+}
+
+A_TreeItem* A_Tree::CreateItem(const QString &text, quint32 nodeId)
+{
+    /**
+     * Creates a detached tree item with default state
+     * @param text Display text for the item
+     * @param nodeId Identifier to assign, 0 for the next free one
+     * @return Newly allocated item
+     */
+
+    A_TreeItem *_newItem = new A_TreeItem(text);          // Create new tree item
+    _newItem->setCheckState(0, Qt::Unchecked);            // Set initial checkbox state to unchecked
+    RegisterItem(_newItem, nodeId);                       // Assign stable node identifier
+    _newItem->Context = &ItemContext;                     // Attribute columns and roll-ups are served from the tree's arrays
+
+    // Set flags based on current edit mode state
+    Qt::ItemFlags _flags = _newItem->flags() | Qt::ItemIsUserCheckable;
+    if (IsEditModeEnabled) {
+        _flags |= Qt::ItemIsEditable;                     // Add editable flag only if edit mode is enabled
+    }
+    _newItem->setFlags(_flags);                           // Apply the flags
+
+    return _newItem;                                      // Return pointer to created item
+}
+
+void A_Tree::InsertSortedOrAppend(QTreeWidgetItem *container, A_TreeItem *item)
+{
+    /**
+     * Inserts an item into a sibling list
+     * Sorted lists get a binary-search placement instead of a resort
+     * @param container Parent item or invisible root item
+     * @param item Detached item to insert
+     */
+
+    SortSpec _spec;                                       // Sort configuration of the container
+    if (!FindSortSpec(container, &_spec)) {
+        container->addChild(item);                        // Unsorted list - keep insertion order
+        return;
+    }
+
+    SortEntry _entry = MakeSortEntry(item, _spec);   // Sort data of new item
+    container->insertChild(FindSortedInsertIndex(container, _entry, _spec, -1), item);
+}
+
+bool A_Tree::FindSortSpec(QTreeWidgetItem *container, SortSpec *spec) const
+{
+    /**
+     * Looks up the sort configuration of a sibling list
+     * Per-parent configurations take precedence over the tree-wide one
+     * @return True if the container is kept sorted
+     */
+
+    QHash<QTreeWidgetItem*, SortSpec>::const_iterator _found = SortedParents.constFind(container);
+    if (_found != SortedParents.constEnd()) {
+        *spec = _found.value();                           // Parent sorted individually
+        return true;
+    }
+
+    if (IsTreeSorted) {
+        *spec = TreeSortSpec;                             // Whole tree is kept sorted
+        return true;
+    }
+
+    return false;                                         // Insertion order
+}
+
+A_Tree::SortEntry A_Tree::MakeSortEntry(A_TreeItem *item, const SortSpec &spec)
+{
+    /**
+     * Builds sort data for an item
+     * The collation key is computed once and cached in the item until its text changes;
+     * attribute values are copied from the column arrays without boxing
+     * @return Sort entry for comparisons
+     */
+
+    const bool _wantsNaturalKey = (spec.Mode == SortNatural);  // Natural order needs numeric collation
+    if (!item->SortKey || item->IsNaturalSortKey != _wantsNaturalKey) {
+        const QCollator &_collator = _wantsNaturalKey ? NaturalCollator : TextCollator;
+        item->SortKey.reset(new QCollatorSortKey(_collator.sortKey(item->text(0))));  // Compute key once per text
+        item->IsNaturalSortKey = _wantsNaturalKey;
+    }
+
+    SortEntry _entry;                                     // Sort data being built
+    _entry.Item = item;
+    _entry.Key = item->SortKey.get();
+
+    switch (item->checkState(0)) {                        // Checked items first in ascending order
+    case Qt::Checked:
+        _entry.CheckRank = 0;
+        break;
+    case Qt::PartiallyChecked:
+        _entry.CheckRank = 1;
+        break;
+    default:
+        _entry.CheckRank = 2;
+        break;
+    }
+
+    if (spec.Mode == SortByAttribute && spec.AttributeColumn >= 0 && spec.AttributeColumn < Attributes.GetColumnCount()) {
+        _entry.HasAttribute = Attributes.HasValue(spec.AttributeColumn, item->NodeId);
+        switch (spec.AttributeType) {
+        case A_TreeAttributes::IntegerColumn:
+        case A_TreeAttributes::DateTimeColumn:
+            _entry.IntegerValue = Attributes.GetInteger(spec.AttributeColumn, item->NodeId);
+            break;
+        case A_TreeAttributes::DoubleColumn:
+            _entry.DoubleValue = Attributes.GetDouble(spec.AttributeColumn, item->NodeId);
+            break;
+        case A_TreeAttributes::TextColumn:
+            _entry.TextValue = &Attributes.GetText(spec.AttributeColumn, item->NodeId);
+            break;
+        }
+    }
+
+    return _entry;
+}
+
+bool A_Tree::SortContainer(QTreeWidgetItem *container, const SortSpec &spec)
+{
+    /**
+     * Sorts one sibling list
+     * Order is computed on precomputed keys (in parallel for wide lists), then applied
+     * through the view as ranks so expansion and selection are preserved
+     * @param container Parent item or invisible root item
+     * @param spec Sort configuration
+     * @return True if children moved
+     */
+
+    const int _childCount = container->childCount();      // Number of siblings
+    if (_childCount < 2) {
+        return false;                                     // Nothing to order
+    }
+
+    QVector<SortEntry> _entries;                          // Sort data per sibling
+    _entries.reserve(_childCount);
+    for (int _childIndex = 0; _childIndex < _childCount; ++_childIndex) {
+        _entries.append(MakeSortEntry(static_cast<A_TreeItem*>(container->child(_childIndex)), spec));
+    }
+
+    const SortSpec _spec = spec;                          // Captured by value for worker threads
+    auto _lessThan = [_spec](const SortEntry &left, const SortEntry &right) {
+        return IsSortedBefore(left, right, _spec);        // Compares cached data only
+    };
+
+    if (_childCount >= ParallelSortThreshold) {
+        ParallelStableSort(_entries, _lessThan);          // Wide list - sort chunks on all cores
+    } else {
+        std::stable_sort(_entries.begin(), _entries.end(), _lessThan);
+    }
+
+    bool _isInOrder = true;                               // Children already sit at their ranks
+    for (int _rank = 0; _rank < _entries.size(); ++_rank) {
+        _entries.at(_rank).Item->SortRank = _rank;        // Final position of each item
+        if (IsCompact) {
+            _entries.at(_rank).Item->SortKey.reset();     // Keys are not kept in compact mode
+        }
+        if (container->child(_rank) != _entries.at(_rank).Item) {
+            _isInOrder = false;
+        }
+    }
+    if (_isInOrder) {
+        return false;                                     // No layout change, nothing to journal
+    }
+
+    ApplySortRanks(container);                            // View applies ranks with integer comparisons only
+    JournalChildOrder(container);                         // Persist new order
+    return true;
+}
+
+bool A_Tree::IsSortedBefore(const SortEntry &left, const SortEntry &right, const SortSpec &spec)
+{
+    /**
+     * Strict ordering of two sort entries under a sort configuration
+     * Reads only precomputed entry data, so it is safe on worker threads
+     * @return True if left is ordered strictly before right
+     */
+
+    if (spec.Mode == SortByAttribute && left.HasAttribute != right.HasAttribute) {
+        return left.HasAttribute;                         // Items with a value first in either order
+    }
+
+    const SortEntry &_first = (spec.Order == Qt::AscendingOrder) ? left : right;   // Swap operands for descending order
+    const SortEntry &_second = (spec.Order == Qt::AscendingOrder) ? right : left;
+
+    if (spec.Mode == SortByCheckState && _first.CheckRank != _second.CheckRank) {
+        return _first.CheckRank < _second.CheckRank;      // Check state decides first
+    }
+
+    if (spec.Mode == SortByAttribute) {
+        if (_first.HasAttribute) {
+            int _comparison = 0;                          // Attribute order - 0 when equal
+            switch (spec.AttributeType) {
+            case A_TreeAttributes::IntegerColumn:
+            case A_TreeAttributes::DateTimeColumn:
+                _comparison = (_first.IntegerValue > _second.IntegerValue) - (_first.IntegerValue < _second.IntegerValue);
+                break;
+            case A_TreeAttributes::DoubleColumn:
+                _comparison = (_first.DoubleValue > _second.DoubleValue) - (_first.DoubleValue < _second.DoubleValue);
+                break;
+            case A_TreeAttributes::TextColumn:
+                _comparison = QString::localeAwareCompare(*_first.TextValue, *_second.TextValue);
+                break;
+            }
+            if (_comparison != 0) {
+                return _comparison < 0;                   // Attribute decides first
+            }
+        }
+    }
+
+    return _first.Key->compare(*_second.Key) < 0;         // Then collation key
+}
+
+int A_Tree::FindSortedInsertIndex(QTreeWidgetItem *container, const SortEntry &entry, const SortSpec &spec, int skipIndex)
+{
+    /**
+     * Binary search for the position of an item among sorted siblings
+     * Equal items keep insertion order - new item is placed after them
+     * @return Insert position among the siblings, excluding skipIndex
+     */
+
+    int _low = 0;                                         // First candidate position
+    int _high = container->childCount() - (skipIndex >= 0 ? 1 : 0);  // One past last candidate position
+
+    while (_low < _high) {
+        int _middle = _low + (_high - _low) / 2;          // Probe position among remaining siblings
+        int _childIndex = (skipIndex >= 0 && _middle >= skipIndex) ? _middle + 1 : _middle;
+        SortEntry _probe = MakeSortEntry(static_cast<A_TreeItem*>(container->child(_childIndex)), spec);
+
+        bool _isBefore = IsSortedBefore(entry, _probe, spec);  // Entry ordered strictly before probe
+        if (_isBefore) {
+            _high = _middle;                              // Insert left of probe
+        } else {
+            _low = _middle + 1;                           // Insert right of probe
+        }
+    }
+
+    return _low;
+}
+
+void A_Tree::RepositionSortedItem(QTreeWidgetItem *item)
+{
+    /**
+     * Moves an edited item to its sorted position
+     * Siblings get ranks around the new position and the view applies them,
+     * which keeps the item's expansion state and selection
+     * @param item Item whose text changed
+     */
+
+    if (!item) {
+        return;                                           // Nothing to reposition
+    }
+
+    QTreeWidgetItem *_container = item->parent() ? item->parent() : TreeWidget->invisibleRootItem();
+    SortSpec _spec;                                       // Sort configuration of siblings
+    if (!FindSortSpec(_container, &_spec) || _container->childCount() < 2) {
+        return;                                           // Siblings are not kept sorted
+    }
+
+    A_TreeItem *_item = static_cast<A_TreeItem*>(item);   // Items in the tree are always A_TreeItems
+    int _currentIndex = _container->indexOfChild(_item);  // Position before the edit
+    int _targetIndex = FindSortedInsertIndex(_container, MakeSortEntry(_item, _spec), _spec, _currentIndex);
+    if (_targetIndex == _currentIndex) {
+        return;                                           // Already in place
+    }
+
+    // Other siblings keep relative order on even ranks, edited item slots in on the odd rank before its target
+    int _rank = 0;
+    for (int _childIndex = 0; _childIndex < _container->childCount(); ++_childIndex) {
+        if (_childIndex == _currentIndex) {
+            continue;
+        }
+        static_cast<A_TreeItem*>(_container->child(_childIndex))->SortRank = 2 * _rank++;
+    }
+    _item->SortRank = 2 * _targetIndex - 1;
+
+    ApplySortRanks(_container);                           // Apply ranks through the view
+    JournalChildOrder(_container);                        // Persist new order
+    InvalidateFilterIndex();                              // Flattened positions changed
+}
+
+void A_Tree::ApplySortRanks(QTreeWidgetItem *container)
+{
+    /**
+     * Sorts through the view so expansion and selection survive; the model's layout signals
+     * name no parent, so handlers read the container from SortingContainer
+     * @param container Parent item or invisible root item
+     */
+
+    QTreeWidgetItem *_previous = SortingContainer;        // Sorts do not nest, kept for safety
+    SortingContainer = container;
+    container->sortChildren(0, Qt::AscendingOrder);       // A_TreeItem compares SortRank
+    SortingContainer = _previous;
+}
+
+bool A_Tree::IsCheckStateSorted() const
+{
+    /**
+     * Checks the tree-wide configuration and every per-parent one
+     * @return True if some list orders by check state
+     */
+
+    if (IsTreeSorted && TreeSortSpec.Mode == SortByCheckState) {
+        return true;
+    }
+    for (const SortSpec &_spec : SortedParents) {
+        if (_spec.Mode == SortByCheckState) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void A_Tree::RepositionCheckSortedItems(QTreeWidgetItem *item)
+{
+    /**
+     * Descendant lists are resorted as a whole - every member may have changed - while the
+     * item and its ancestors changed alone among their siblings and move by binary search
+     * @param item Item whose state was set, invisible root item after a tree-wide change
+     */
+
+    if (!item || !IsCheckStateSorted()) {
+        return;                                           // Order does not depend on check states
+    }
+
+    SortSpec _spec;                                       // Sort configuration of the visited list
+    bool _isMoved = false;                                // Some list below the item changed order
+    QVector<QTreeWidgetItem*> _pending;                   // Lists below the item still to visit
+    _pending.append(item);
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_container = _pending.takeLast();
+        if (FindSortSpec(_container, &_spec) && _spec.Mode == SortByCheckState && SortContainer(_container, _spec)) {
+            _isMoved = true;
+        }
+        for (int _childIndex = 0; _childIndex < _container->childCount(); ++_childIndex) {
+            if (_container->child(_childIndex)->childCount() > 0) {
+                _pending.append(_container->child(_childIndex));
+            }
+        }
+    }
+
+    for (QTreeWidgetItem *_item = item; _item && _item != TreeWidget->invisibleRootItem(); _item = _item->parent()) {
+        QTreeWidgetItem *_container = _item->parent() ? _item->parent() : TreeWidget->invisibleRootItem();
+        if (FindSortSpec(_container, &_spec) && _spec.Mode == SortByCheckState) {
+            RepositionSortedItem(_item);                  // Recalculated ancestors may move as well
+        }
+    }
+
+    if (_isMoved) {
+        InvalidateFilterIndex();                          // Flattened positions changed
+    }
+}
+
+int A_Tree::AddAttributeColumn(const QString &name, A_TreeAttributes::ColumnType type)
+{
+    /**
+     * Registers a typed column and adds it to the view header
+     * @param name Header text
+     * @param type Value type
+     * @return Attribute column index
+     */
+
+    int _column = Attributes.AddColumn(name, type);       // Storage for the new column
+    TreeWidget->setColumnCount(Attributes.GetColumnCount() + 1);  // Tree column plus attribute columns
+    TreeWidget->headerItem()->setText(_column + 1, name); // Header of the new view column
+
+    return _column;
+}
+
+bool A_Tree::SetItemAttribute(QTreeWidgetItem *item, int column, const QVariant &value)
+{
+    /**
+     * Stores an attribute value unboxed and repaints
+     * Items in a list sorted by this column move to their new position
+     * @return True if stored
+     */
+
+    if (!item || column < 0 || column >= Attributes.GetColumnCount()) {
+        return false;                                     // Invalid item or column
+    }
+
+    const quint32 _nodeId = GetItemId(item);              // Row in the column arrays
+    const bool _isAggregated = (column == Aggregates.GetValueColumn());  // Roll-ups follow this column
+    double _oldValue = 0.0;                               // Value before the change
+    const bool _hadValue = _isAggregated && GetAggregateValue(_nodeId, &_oldValue);
+
+    if (!Attributes.SetValue(column, _nodeId, value)) {
+        return false;                                     // Value does not fit the column type
+    }
+
+    if (_isAggregated && CanApplyAggregateDelta()) {
+        A_TreeAggregates::Values _delta;                  // One value removed or added
+        _delta.ValueCount = 1;
+        if (_hadValue) {
+            _delta.Sum = _delta.Min = _delta.Max = _oldValue;
+            ApplyAggregateDelta(item, _delta, true);
+        }
+        double _newValue = 0.0;
+        if (GetAggregateValue(_nodeId, &_newValue)) {
+            _delta.Sum = _delta.Min = _delta.Max = _newValue;
+            ApplyAggregateDelta(item, _delta, false);
+        }
+    }
+
+    RepositionSortedItem(item);                           // Sorted siblings may order by this column
+    TreeWidget->viewport()->update();                     // Coalesced repaint of visible cells
+
+    return true;
+}
+
+QVariant A_Tree::GetItemAttribute(QTreeWidgetItem *item, int column) const
+{
+    /**
+     * Reads an attribute value of an item
+     * @return Boxed value or null variant
+     */
+
+    if (!item) {
+        return QVariant();                                // Invalid item
+    }
+
+    return Attributes.GetDisplayValue(column, GetItemId(item));  // Checks column range
+}
+
+A_TreeAttributes& A_Tree::GetAttributes()
+{
+    /**
+     * Gets the attribute store
+     * @return Attribute columns
+     */
+
+    return Attributes;
+}
+
+void A_Tree::RefreshAttributeColumns()
+{
+    /**
+     * Repaints the view after direct attribute writes
+     * Direct writes bypass delta maintenance, so roll-ups of the aggregated column are recomputed
+     */
+
+    if (Aggregates.IsEnabled() && Aggregates.GetValueColumn() >= 0) {
+        RecomputeAggregates();
+    }
+    TreeWidget->viewport()->update();
+}
+
+bool A_Tree::EnableAggregates(int valueColumn)
+{
+    /**
+     * Enables roll-up maintenance and computes all roll-ups
+     * @param valueColumn Numeric attribute column or -1
+     * @return True if enabled
+     */
+
+    if (IsCompact) {
+        return false;                                     // Roll-ups are not kept in compact mode
+    }
+    if (valueColumn >= Attributes.GetColumnCount() ||
+        (valueColumn >= 0 && Attributes.GetColumnType(valueColumn) == A_TreeAttributes::TextColumn)) {
+        return false;                                     // Unknown or non-numeric column
+    }
+
+    Aggregates.Enable(qMax(-1, valueColumn));
+    RecomputeAggregates();                                // Starting point for delta maintenance
+    return true;
+}
+
+void A_Tree::DisableAggregates()
+{
+    /**
+     * Disables roll-up maintenance
+     */
+
+    Aggregates.Disable();
+    IsAggregatesStale = false;
+    TreeWidget->viewport()->update();                     // Drop roll-ups shown by the items
+}
+
+bool A_Tree::EnableSubtreeHashes()
+{
+    /**
+     * Enables hash maintenance - hashes are computed on first request
+     * @return True if enabled
+     */
+
+    if (IsCompact) {
+        return false;                                     // Hashes are not kept in compact mode
+    }
+
+    Hashes.Enable();
+    return true;
+}
+
+void A_Tree::DisableSubtreeHashes()
+{
+    /**
+     * Disables hash maintenance
+     */
+
+    Hashes.Disable();
+}
+
+bool A_Tree::IsSubtreeHashesEnabled() const
+{
+    /**
+     * Gets the hash maintenance flag
+     * @return True if enabled
+     */
+
+    return Hashes.IsEnabled();
+}
+
+quint64 A_Tree::GetItemHash(QTreeWidgetItem *item, bool isCheckStateIncluded)
+{
+    /**
+     * Reads one subtree hash, rehashing changed nodes below the item first
+     * @return Subtree hash
+     */
+
+    if (!item || !Hashes.IsEnabled()) {
+        return 0;
+    }
+
+    const A_TreeHashes::Values _values = GetSubtreeHashes(item);
+    return isCheckStateIncluded ? _values.StateHash : _values.ContentHash;
+}
+
+quint64 A_Tree::GetTreeHash(bool isCheckStateIncluded)
+{
+    /**
+     * Folds the root items' hashes like children of an unnamed parent
+     * @return Tree hash
+     */
+
+    if (!Hashes.IsEnabled()) {
+        return 0;
+    }
+
+    A_TreeHashes::Values _values = A_TreeHashes::Begin(QString(), Qt::Unchecked);  // Invisible root
+    for (int _rootIndex = 0; _rootIndex < TreeWidget->topLevelItemCount(); ++_rootIndex) {
+        A_TreeHashes::AddChild(_values, GetSubtreeHashes(TreeWidget->topLevelItem(_rootIndex)));
+    }
+    A_TreeHashes::Finish(_values, TreeWidget->topLevelItemCount());
+
+    return isCheckStateIncluded ? _values.StateHash : _values.ContentHash;
+}
+
+QVector<quint32> A_Tree::FindChangedItems(const A_TreeSnapshot &snapshot, bool isCheckStateIncluded)
+{
+    /**
+     * Descends the items and the snapshot side by side: each item is compared with the snapshot node
+     * of the same identifier among the children of its parent's counterpart, using the hashes stored
+     * in the snapshot's blocks, and only differing items are descended into
+     * @return Identifiers of differing items in pre-order
+     */
+
+    QVector<quint32> _changedIds;                         // Result
+    if (!Hashes.IsEnabled()) {
+        return _changedIds;
+    }
+
+    QHash<int, A_TreeHashes::Values> _openHashes;         // Folded hashes of open top items reached so far
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Items still to compare with their snapshot position - -1 if none
+    auto _appendChildren = [this, &snapshot, &_pending](QTreeWidgetItem *container, int begin, int end) {
+        QHash<quint32, int> _positions;                   // Snapshot children in [begin, end) by node identifier
+        for (int _child = begin; _child < end; _child = snapshot.GetSubtreeEnd(_child)) {
+            _positions.insert(snapshot.GetNodeId(_child), _child);
+        }
+        for (int _childIndex = container->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            QTreeWidgetItem *_child = container->child(_childIndex);  // Reversed so first child comes first
+            _pending.append(qMakePair(_child, _positions.value(GetItemId(_child), -1)));
+        }
+    };
+
+    _appendChildren(TreeWidget->invisibleRootItem(), 0, snapshot.GetNodeCount());
+    while (!_pending.isEmpty()) {
+        const QPair<QTreeWidgetItem*, int> _entry = _pending.takeLast();
+        const int _index = _entry.second;                 // Counterpart in the snapshot
+        if (_index >= 0) {
+            const A_TreeHashes::Values _values = GetSubtreeHashes(_entry.first);
+            const A_TreeHashes::Values _snapshotValues = GetSnapshotHashes(snapshot, _index, &_openHashes);
+            if (isCheckStateIncluded ? _snapshotValues.StateHash == _values.StateHash
+                                     : _snapshotValues.ContentHash == _values.ContentHash) {
+                continue;                                 // Identical subtree - nothing below can differ
+            }
+        }
+        _changedIds.append(GetItemId(_entry.first));
+        if (_index >= 0) {
+            _appendChildren(_entry.first, _index + 1, snapshot.GetSubtreeEnd(_index));
+        } else {
+            _appendChildren(_entry.first, 0, 0);          // New here - every descendant differs
+        }
+    }
+
+    return _changedIds;
+}
+
+A_TreeHashes::Values A_Tree::GetSubtreeHashes(QTreeWidgetItem *item)
+{
+    /**
+     * Returns stored hashes of valid nodes; invalid nodes fold their children's hashes in order
+     * @param item Subtree root
+     * @return Subtree hashes
+     */
+
+    const quint32 _nodeId = GetItemId(item);             // Hash slot
+    if (Hashes.IsValid(_nodeId)) {
+        return Hashes.Get(_nodeId);                       // Unchanged since last hashed
+    }
+
+    A_TreeHashes::Values _values = A_TreeHashes::Begin(item->text(0), item->checkState(0));  // Item alone
+    for (int _childIndex = 0; _childIndex < item->childCount(); ++_childIndex) {
+        A_TreeHashes::AddChild(_values, GetSubtreeHashes(item->child(_childIndex)));
+    }
+    A_TreeHashes::Finish(_values, item->childCount());
+    Hashes.Set(_nodeId, _values);
+    return _values;
+}
+
+void A_Tree::InvalidateSubtreeHash(QTreeWidgetItem *item)
+{
+    /**
+     * Walks up until an already invalid node - its ancestors were invalidated with it
+     * @param item Changed item or owner of changed rows
+     */
+
+    for (QTreeWidgetItem *_item = item; _item && _item != TreeWidget->invisibleRootItem(); _item = _item->parent()) {
+        if (!Hashes.Invalidate(GetItemId(_item))) {
+            break;
+        }
+    }
+}
+
+bool A_Tree::GetItemAggregate(QTreeWidgetItem *item, A_TreeAggregates::Values *values)
+{
+    /**
+     * Reads an item's roll-up, recomputing stale roll-ups and dirty ranges first
+     * @param item Tree item
+     * @param values Output values
+     * @return True if values were written
+     */
+
+    if (!item || !values || !Aggregates.IsEnabled()) {
+        return false;                                     // Invalid input or disabled
+    }
+
+    if (IsAggregatesStale) {
+        RecomputeAggregates();                            // Bulk changes not folded in yet
+    }
+    quint32 _nodeId = GetItemId(item);                    // Row in the roll-up arrays
+    if (!Aggregates.IsValid(_nodeId)) {
+        GetSubtreeAggregate(item);                        // Detached or never attached subtree
+    }
+    if (Aggregates.IsRangeDirty(_nodeId)) {
+        ResolveAggregateRange(item);                      // Min/Max were only widened
+    }
+
+    *values = Aggregates.Get(_nodeId);
+    return true;
+}
+
+void A_Tree::RecomputeAggregates()
+{
+    /**
+     * Flattens the tree on the GUI thread, then folds roll-ups on worker threads
+     */
+
+    if (!Aggregates.IsEnabled()) {
+        return;
+    }
+
+    A_TreeAggregates::Layout _layout;                     // Flattened tree
+    _layout.NodeIds.reserve(NodeTable.size());
+    _layout.ParentIndexes.reserve(NodeTable.size());
+    _layout.OwnValues.reserve(NodeTable.size());
+
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Items still to visit with their parent position
+    QTreeWidgetItem *_root = TreeWidget->invisibleRootItem();
+    for (int _rootIndex = _root->childCount() - 1; _rootIndex >= 0; --_rootIndex) {
+        _pending.append(qMakePair(_root->child(_rootIndex), -1));  // Reversed so first root pops first
+    }
+    while (!_pending.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> _next = _pending.takeLast();
+        A_TreeItem *_item = static_cast<A_TreeItem*>(_next.first);  // Items in the tree are always A_TreeItems
+        const int _position = _layout.NodeIds.size();     // Pre-order position of this item
+        _layout.NodeIds.append(_item->NodeId);
+        _layout.ParentIndexes.append(_next.second);
+        _layout.OwnValues.append(GetOwnAggregate(_item));
+        for (int _childIndex = _item->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            _pending.append(qMakePair(_item->child(_childIndex), _position));
+        }
+    }
+
+    const int _nodeCount = _layout.NodeIds.size();        // Nodes in the tree
+    _layout.SubtreeEnds.resize(_nodeCount);
+    for (int _position = 0; _position < _nodeCount; ++_position) {
+        _layout.SubtreeEnds[_position] = _position + 1;
+    }
+    for (int _position = _nodeCount - 1; _position >= 0; --_position) {
+        int _parent = _layout.ParentIndexes.at(_position);
+        if (_parent >= 0) {
+            _layout.SubtreeEnds[_parent] = qMax(_layout.SubtreeEnds.at(_parent), _layout.SubtreeEnds.at(_position));
+        }
+    }
+
+    Aggregates.Compute(_layout);                          // Parallel fold
+    IsAggregatesStale = false;
+    TreeWidget->viewport()->update();                     // Items show new roll-ups
+}
+
+bool A_Tree::CanApplyAggregateDelta()
+{
+    /**
+     * Decides between delta maintenance and a later recompute
+     * @return True if the caller should apply its delta now
+     */
+
+    if (!Aggregates.IsEnabled() || IsAggregatesStale) {
+        return false;                                     // Disabled or recomputed later anyway
+    }
+    if (BulkUpdateDepth > 0) {
+        IsAggregatesStale = true;                         // EndBulkUpdate recomputes in parallel
+        return false;
+    }
+
+    return true;
+}
+
+A_TreeAggregates::Values A_Tree::GetOwnAggregate(A_TreeItem *item) const
+{
+    /**
+     * Builds the contribution of a single item
+     * @return Values of the item without its children
+     */
+
+    A_TreeAggregates::Values _values;                     // Item alone
+    const int _nodeId = int(item->NodeId);
+    _values.CheckedLeafCount = (_nodeId < CheckedLeafBits.size() && CheckedLeafBits.testBit(_nodeId)) ? 1 : 0;
+
+    double _value = 0.0;                                  // Own value of the aggregated column
+    if (GetAggregateValue(item->NodeId, &_value)) {
+        _values.ValueCount = 1;
+        _values.Sum = _values.Min = _values.Max = _value;
+    }
+
+    return _values;
+}
+
+A_TreeAggregates::Values A_Tree::GetSubtreeAggregate(QTreeWidgetItem *item)
+{
+    /**
+     * Returns stored values, computing missing ones children-first
+     * @return Roll-up of the subtree
+     */
+
+    A_TreeItem *_item = static_cast<A_TreeItem*>(item);   // Items in the tree are always A_TreeItems
+    if (Aggregates.IsValid(_item->NodeId)) {
+        return Aggregates.Get(_item->NodeId);             // Moved subtree or already counted
+    }
+
+    A_TreeAggregates::Values _values = GetOwnAggregate(_item);  // Start with the item alone
+    for (int _childIndex = 0; _childIndex < item->childCount(); ++_childIndex) {
+        A_TreeAggregates::Combine(_values, GetSubtreeAggregate(item->child(_childIndex)));
+    }
+    Aggregates.Set(_item->NodeId, _values);
+
+    return _values;
+}
+
+void A_Tree::ApplyAggregateDelta(QTreeWidgetItem *item, const A_TreeAggregates::Values &delta, bool isRemoval)
+{
+    /**
+     * Walks from an item to its root item applying the same delta - O(depth)
+     */
+
+    for (QTreeWidgetItem *_current = item; _current && _current != TreeWidget->invisibleRootItem(); _current = _current->parent()) {
+        quint32 _nodeId = GetItemId(_current);            // Row in the roll-up arrays
+        if (!Aggregates.IsValid(_nodeId)) {
+            return;                                       // Subtree not attached yet - computed when it is
+        }
+        if (isRemoval) {
+            Aggregates.Subtract(_nodeId, delta);          // Marks the range dirty if an extreme was removed
+        } else {
+            Aggregates.Add(_nodeId, delta);
+        }
+    }
+}
+
+void A_Tree::ResolveAggregateRange(QTreeWidgetItem *item)
+{
+    /**
+     * Rebuilds Min/Max from the item's own value and its children's ranges
+     * Counts and sums are exact and kept
+     */
+
+    A_TreeItem *_item = static_cast<A_TreeItem*>(item);   // Items in the tree are always A_TreeItems
+    A_TreeAggregates::Values _values = Aggregates.Get(_item->NodeId);  // Values with exact counts
+    A_TreeAggregates::Values _range = GetOwnAggregate(_item);  // Range being rebuilt
+    for (int _childIndex = 0; _childIndex < item->childCount(); ++_childIndex) {
+        A_TreeItem *_child = static_cast<A_TreeItem*>(item->child(_childIndex));
+        if (!Aggregates.IsValid(_child->NodeId) || Aggregates.Get(_child->NodeId).ValueCount == 0) {
+            continue;                                     // No values below
+        }
+        if (Aggregates.IsRangeDirty(_child->NodeId)) {
+            ResolveAggregateRange(_child);
+        }
+        A_TreeAggregates::Combine(_range, Aggregates.Get(_child->NodeId));
+    }
+
+    _values.Min = _range.Min;
+    _values.Max = _range.Max;
+    Aggregates.Set(_item->NodeId, _values);               // Clears the dirty flag
+}
+
+bool A_Tree::GetAggregateValue(quint32 nodeId, double *value) const
+{
+    /**
+     * Reads the aggregated column as double
+     * @return True if the node has a value
+     */
+
+    const int _column = Aggregates.GetValueColumn();      // Aggregated attribute column
+    if (_column < 0 || !Attributes.HasValue(_column, nodeId)) {
+        return false;
+    }
+
+    if (Attributes.GetColumnType(_column) == A_TreeAttributes::DoubleColumn) {
+        *value = Attributes.GetDouble(_column, nodeId);
+    } else {
+        *value = double(Attributes.GetInteger(_column, nodeId));  // Integers and timestamps
+    }
+    return true;
+}
+
+quint32 A_Tree::GetItemId(QTreeWidgetItem *item) const
+{
+    /**
+     * Gets the stable identifier of an item
+     * @param item Tree item to identify
+     * @return Node identifier or 0 if item is invalid
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return 0;                                         // Return reserved identifier for invalid item
+    }
+
+    return static_cast<A_TreeItem*>(item)->NodeId;        // Items in the tree are always A_TreeItems
+}
+
+QTreeWidgetItem* A_Tree::GetItemById(quint32 id) const
+{
+    /**
+     * Gets the item with specified identifier
+     * @param id Node identifier
+     * @return Item or nullptr if identifier is unknown or deleted
+     */
+
+    if (id == 0 || id >= quint32(NodeTable.size())) {     // Validate identifier range
+        return nullptr;                                   // Return null for unknown identifier
+    }
+
+    return NodeTable.at(id);                              // Null if item was deleted
+}
+
+QBitArray A_Tree::GetCheckedLeafBitmap() const
+{
+    /**
+     * Gets the maintained checked-leaf bitmap
+     * @return Implicitly shared copy of the bitmap
+     */
+
+    return CheckedLeafBits;                               // O(1) shared copy
+}
+
+QVector<QPair<quint32, quint32>> A_Tree::GetCheckedLeafRanges() const
+{
+    /**
+     * Run-length encodes the checked-leaf bitmap into identifier ranges
+     * Scans packed bits a word at a time, skipping empty words and full bytes inside runs
+     * @return Inclusive identifier ranges
+     */
+
+    QVector<QPair<quint32, quint32>> _ranges;             // Ranges being collected
+    const uchar *_bytes = reinterpret_cast<const uchar*>(CheckedLeafBits.bits());  // Packed bits, LSB first
+    const int _byteCount = (CheckedLeafBits.size() + 7) / 8;  // Number of bytes holding bits
+
+    bool _isInRun = false;                                // Scanning inside a run of set bits
+    quint32 _runStart = 0;                                // First identifier of current run
+    int _byteIndex = 0;                                   // Current byte position
+
+    while (_byteIndex < _byteCount) {
+        if (!_isInRun && _byteIndex + 8 <= _byteCount) {
+            quint64 _word = 0;                            // Next 64 bits
+            memcpy(&_word, _bytes + _byteIndex, sizeof(_word));
+            if (_word == 0) {
+                _byteIndex += 8;                          // No checked leaf in these 64 identifiers
+                continue;
+            }
+        }
+
+        const uchar _byte = _bytes[_byteIndex];           // Next 8 bits
+        if ((_isInRun && _byte == 0xFF) || (!_isInRun && _byte == 0x00)) {
+            _byteIndex++;                                 // Byte continues current state
+            continue;
+        }
+
+        for (int _bitIndex = 0; _bitIndex < 8; ++_bitIndex) {
+            const bool _isSet = (_byte >> _bitIndex) & 1; // Bit of this identifier
+            const quint32 _id = quint32(_byteIndex) * 8 + _bitIndex;
+            if (_isSet && !_isInRun) {
+                _isInRun = true;                          // Run starts here
+                _runStart = _id;
+            } else if (!_isSet && _isInRun) {
+                _isInRun = false;                         // Run ended at previous identifier
+                _ranges.append(qMakePair(_runStart, _id - 1));
+            }
+        }
+        _byteIndex++;
+    }
+
+    if (_isInRun) {
+        _ranges.append(qMakePair(_runStart, quint32(CheckedLeafBits.size() - 1)));  // Run reaches last identifier
+    }
+
+    return _ranges;
+}
+
+QStringList A_Tree::GetCheckedLeafPaths(const QString &separator) const
+{
+    /**
+     * Builds full paths of all checked leaves - from the check overlay of the encoding while frozen
+     * @param separator Separator between path segments
+     * @return Paths in ascending identifier order
+     */
+
+    QStringList _paths;                                   // Paths being collected
+    QStringList _segments;                                // Reused segment buffer, leaf to root
+    if (FrozenTree) {
+        for (int _node = 0; _node < FrozenTree->GetNodeCount(); ++_node) {
+            if (FrozenTree->GetChildCount(_node) > 0 || FrozenTree->GetCheckState(_node) != Qt::Checked) {
+                continue;
+            }
+            _segments.clear();
+            for (int _current = _node; _current != A_TreeSuccinct::NoNode; _current = FrozenTree->GetParent(_current)) {
+                _segments.prepend(FrozenTree->GetText(_current));  // Walk up to root
+            }
+            _paths.append(_segments.join(separator));
+        }
+        return _paths;
+    }
+
+    _paths.reserve(GetCheckedLeafCount());
+    const QVector<QPair<quint32, quint32>> _ranges = GetCheckedLeafRanges();
+    for (const QPair<quint32, quint32> &_range : _ranges) {
+        for (quint32 _id = _range.first; _id <= _range.second; ++_id) {
+            if (!NodeTable.at(_id)->treeWidget()) {
+                continue;                                 // Detached subtree still being freed by a delete job
+            }
+            _segments.clear();
+            for (QTreeWidgetItem *_item = NodeTable.at(_id); _item; _item = _item->parent()) {
+                _segments.prepend(_item->text(0));        // Walk up to root
+            }
+            _paths.append(_segments.join(separator));
+        }
+    }
+
+    return _paths;
+}
+
+int A_Tree::GetCheckedLeafCount() const
+{
+    /**
+     * Counts checked leaves - scans the check overlay of the encoding while frozen
+     * @return Number of set bits in the checked-leaf bitmap
+     */
+
+    if (FrozenTree) {
+        int _count = 0;                                   // Checked leaves seen
+        for (int _node = 0; _node < FrozenTree->GetNodeCount(); ++_node) {
+            if (FrozenTree->GetChildCount(_node) == 0 && FrozenTree->GetCheckState(_node) == Qt::Checked) {
+                _count++;
+            }
+        }
+        return _count;
+    }
+
+    return CheckedLeafBits.count(true);                   // Population count over packed bits
+}
+
+A_Tree::MemoryUsage A_Tree::GetMemoryUsage() const
+{
+    /**
+     * Walks every item once for item, text and sort key bytes and the rows below expanded items,
+     * then adds the capacities of A_Tree's own arrays and indexes
+     * @return Byte counts
+     */
+
+    MemoryUsage _usage;                                   // Usage being collected
+    qint64 _sortKeyCount = 0;                             // Items holding a cached collation key
+    for (int _nodeId = 1; _nodeId < NodeTable.size(); ++_nodeId) {
+        const A_TreeItem *_item = NodeTable.at(_nodeId);  // Null for deleted identifiers
+        if (!_item) {
+            continue;
+        }
+        _usage.NodeCount++;
+        _usage.ItemBytes += qint64(sizeof(A_TreeItem)) + ItemDataBytesEstimate + qint64(sizeof(QTreeWidgetItem*));  // Object, Qt data, parent's child list entry
+        const QString _text = _item->text(0);             // Shares the item's buffer
+        if (!_text.isEmpty()) {
+            _usage.TextBytes += StringHeaderBytes + qint64(_text.capacity() + 1) * qint64(sizeof(QChar));
+        }
+        if (_item->SortKey) {
+            _sortKeyCount++;
+        }
+    }
+
+    qint64 _rowCount = 0;                                 // Rows laid out by the view
+    qint64 _expandedCount = 0;                            // Expanded items tracked by the view
+    QVector<QTreeWidgetItem*> _pending;                   // Rows still to visit
+    for (int _rootIndex = 0; _rootIndex < TreeWidget->topLevelItemCount(); ++_rootIndex) {
+        _pending.append(TreeWidget->topLevelItem(_rootIndex));
+    }
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_item = _pending.takeLast();
+        _rowCount++;
+        if (_item->childCount() > 0 && _item->isExpanded()) {
+            _expandedCount++;
+            for (int _childIndex = 0; _childIndex < _item->childCount(); ++_childIndex) {
+                _pending.append(_item->child(_childIndex));  // Children of expanded items are laid out
+            }
+        }
+    }
+    _usage.ViewBytes = _rowCount * ViewRowBytesEstimate + _expandedCount * ExpandedIndexBytesEstimate;
+
+    _usage.NodeStoreBytes = qint64(NodeTable.capacity()) * qint64(sizeof(A_TreeItem*)) +
+                            (CheckedLeafBits.size() + 7) / 8 + (ExpandedBits.size() + 7) / 8;
+
+    _usage.IndexBytes += qint64(PathIndex.size()) * (qint64(sizeof(QPair<quint32, uint>) + sizeof(quint32)) + HashEntryOverheadBytes);
+    _usage.IndexBytes += (PathIndexedBits.size() + 7) / 8;
+    _usage.IndexBytes += qint64(FilterItems.capacity()) * qint64(sizeof(QTreeWidgetItem*)) +
+                         qint64(FilterParents.capacity()) * qint64(sizeof(int)) +
+                         qint64(FilterTexts.size()) * qint64(sizeof(QString)) +  // Text buffers are shared with the items
+                         (FilterMatchBits.size() + 7) / 8 + (FilterVisibleBits.size() + 7) / 8;
+    _usage.IndexBytes += _sortKeyCount * SortKeyBytesEstimate;
+    _usage.IndexBytes += qint64(SortedParents.size()) * (qint64(sizeof(QTreeWidgetItem*) + sizeof(SortSpec)) + HashEntryOverheadBytes);
+    _usage.IndexBytes += Attributes.GetMemoryBytes();
+    _usage.IndexBytes += Aggregates.GetMemoryBytes();
+    _usage.IndexBytes += Hashes.GetMemoryBytes();
+
+    const std::shared_ptr<const A_TreeSnapshot> _snapshot = std::atomic_load(&PublishedSnapshot);  // Current version only
+    for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : _snapshot->GetBlocks()) {
+        _usage.IndexBytes += qint64(_block->NodeIds.capacity()) * qint64(sizeof(quint32)) +
+                             qint64(_block->ParentIndexes.capacity() + _block->SubtreeEnds.capacity()) * qint64(sizeof(qint32)) +
+                             qint64(_block->CheckStates.capacity()) +
+                             qint64(_block->ContentHashes.capacity() + _block->StateHashes.capacity()) * qint64(sizeof(quint64)) +
+                             qint64(_block->Texts.size()) * qint64(sizeof(QString));  // Text buffers are shared with the items
+    }
+    _usage.IndexBytes += qint64(SnapshotBlockKeys.capacity()) * qint64(sizeof(quint32)) +
+                         qint64(DirtySnapshotBlocks.size()) * (qint64(sizeof(quint32)) + HashEntryOverheadBytes);
+
+    if (FrozenTree) {
+        const A_TreeSuccinct::MemoryUsage _frozen = FrozenTree->GetMemoryUsage();  // Encoding replaces items while frozen
+        _usage.NodeCount += FrozenTree->GetNodeCount();
+        _usage.TextBytes += _frozen.TextBytes;
+        _usage.NodeStoreBytes += _frozen.StructureBytes + _frozen.CheckBytes;
+    }
+
+    _usage.TotalBytes = _usage.ItemBytes + _usage.TextBytes + _usage.ViewBytes + _usage.NodeStoreBytes + _usage.IndexBytes;
+    if (_usage.NodeCount > 0) {
+        _usage.OwnBytesPerNode = double(_usage.NodeStoreBytes + _usage.IndexBytes) / _usage.NodeCount;
+    }
+
+    return _usage;
+}
+
+void A_Tree::SetCompactMode(bool enabled)
+{
+    /**
+     * Enters or leaves compact mode
+     * Entering releases all optional state at once; leaving rebuilds it lazily on first use
+     * @param enabled True to enter compact mode
+     */
+
+    if (enabled == IsCompact) {
+        return;
+    }
+    IsCompact = enabled;
+
+    if (!IsCompact) {
+        MarkSnapshotAllDirty();                           // Readers get a full snapshot again
+        return;
+    }
+
+    PathIndex.clear();                                    // Lookups scan sibling lists
+    PathIndexedBits.clear();
+    ReleaseFilterIndex();
+    for (A_TreeItem *_item : std::as_const(NodeTable)) {
+        if (_item) {
+            _item->SortKey.reset();                       // Recomputed during each sort
+        }
+    }
+    DisableAggregates();
+    DisableSubtreeHashes();
+    if (SharedStore.IsWriter()) {
+        DetachSharedTree();                               // Store would no longer follow changes
+    }
+
+    std::atomic_store(&PublishedSnapshot, std::make_shared<const A_TreeSnapshot>());  // Readers holding a version keep it alive
+    DirtySnapshotBlocks.clear();
+    SnapshotBlockKeys = QVector<quint32>();               // Rebuilt with the first publish after compact mode
+    IsSnapshotAllDirty = true;                            // Nothing to reuse when compact mode ends
+    IsSnapshotStale = true;
+}
+
+bool A_Tree::IsCompactMode() const
+{
+    /**
+     * Gets the compact mode flag
+     * @return True in compact mode
+     */
+
+    return IsCompact;
+}
+
+QByteArray A_Tree::ExportCheckedState() const
+{
+    /**
+     * Packs the checked-leaf bits in pre-order and compresses them
+     * Runs of equal states, the common case for selections, compress to a few bytes
+     * @return Header, structure hash and compressed bitmap
+     */
+
+    QVector<QTreeWidgetItem*> _items;                     // Items in pre-order
+    CollectPreOrder(&_items);
+
+    QByteArray _bits((_items.size() + 7) / 8, '\0');      // Bit per pre-order position
+    for (int _position = 0; _position < _items.size(); ++_position) {
+        if (CheckedLeafBits.testBit(int(GetItemId(_items.at(_position))))) {
+            _bits[_position >> 3] = char(uchar(_bits.at(_position >> 3)) | (1 << (_position & 7)));
+        }
+    }
+
+    QByteArray _data;                                     // Serialized selection
+    QDataStream _stream(&_data, QIODevice::WriteOnly);
+    _stream.setVersion(QDataStream::Qt_5_12);             // Fixed encoding across Qt versions
+    _stream << CheckedStateMagic << CheckedStateVersion << quint32(_items.size()) << StructureHash(_items)
+            << qCompress(_bits);
+
+    return _data;
+}
+
+bool A_Tree::ImportCheckedState(const QByteArray &data)
+{
+    /**
+     * Validates a saved selection against the current tree and applies it
+     * Walking pre-order backwards visits children before their parent, so leaves take their saved state
+     * and each parent is recalculated from final children in the same pass
+     * @param data Serialized selection
+     * @return True if applied
+     */
+
+    QDataStream _stream(data);                            // Reader over selection
+    _stream.setVersion(QDataStream::Qt_5_12);
+    quint32 _magic = 0;                                   // Format marker
+    quint32 _version = 0;                                 // Format version
+    quint32 _nodeCount = 0;                               // Items in the exported tree
+    quint64 _hash = 0;                                    // Structure hash of the exported tree
+    QByteArray _compressedBits;                           // Compressed pre-order bitmap
+    _stream >> _magic >> _version >> _nodeCount >> _hash >> _compressedBits;
+    if (_stream.status() != QDataStream::Ok || _magic != CheckedStateMagic || _version != CheckedStateVersion) {
+        return false;                                     // Not a selection or unknown format
+    }
+
+    QVector<QTreeWidgetItem*> _items;                     // Items in pre-order
+    CollectPreOrder(&_items);
+    if (quint32(_items.size()) != _nodeCount || StructureHash(_items) != _hash) {
+        return false;                                     // Saved for a different tree
+    }
+    const QByteArray _bits = qUncompress(_compressedBits);
+    if (_bits.size() != (_items.size() + 7) / 8) {
+        return false;                                     // Corrupt bitmap
+    }
+    const uchar *_bytes = reinterpret_cast<const uchar*>(_bits.constData());  // Packed bits, LSB first
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole selection
+
+    int _changedLeafCount = 0;                            // Leaves whose state changed
+    for (int _position = _items.size() - 1; _position >= 0; --_position) {
+        QTreeWidgetItem *_item = _items.at(_position);    // Children of this item are already final
+        const bool _isLeaf = _item->childCount() == 0;
+        Qt::CheckState _state = Qt::Unchecked;            // State this item must have
+        if (_isLeaf) {
+            _state = ((_bytes[_position >> 3] >> (_position & 7)) & 1) ? Qt::Checked : Qt::Unchecked;
+        } else {
+            _state = CalculateParentCheckState(_item);
+        }
+        if (_item->checkState(0) == _state) {
+            continue;                                     // Unchanged items cost no signal
+        }
+
+        _item->setCheckState(0, _state);
+        if (_isLeaf) {
+            CheckedLeafBits.setBit(int(GetItemId(_item)), _state == Qt::Checked);
+            JournalItemRecord(A_TreeJournal::SetCheckState, _item);  // Parents follow on replay
+            _changedLeafCount++;
+        }
+    }
+
+    if (_changedLeafCount > 0) {
+        RepositionCheckSortedItems(TreeWidget->invisibleRootItem());  // States of many lists may have changed
+    }
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = false;                             // Clear flag
+
+    if (_changedLeafCount > 0 && Aggregates.IsEnabled()) {
+        if (BulkUpdateDepth > 0) {
+            IsAggregatesStale = true;                     // EndBulkUpdate recomputes
+        } else {
+            RecomputeAggregates();                        // One pass instead of a delta per leaf
+        }
+    }
+
+    emit CheckedStateImported(_changedLeafCount);
+    return true;
+}
+
+void A_Tree::CollectPreOrder(QVector<QTreeWidgetItem*> *items) const
+{
+    /**
+     * Walks the tree with an explicit stack
+     * @param items Output items
+     */
+
+    items->clear();
+    items->reserve(NodeTable.size());
+
+    QVector<QTreeWidgetItem*> _pending;                   // Items still to visit
+    QTreeWidgetItem *_root = TreeWidget->invisibleRootItem();
+    for (int _rootIndex = _root->childCount() - 1; _rootIndex >= 0; --_rootIndex) {
+        _pending.append(_root->child(_rootIndex));        // Reversed so first root pops first
+    }
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_item = _pending.takeLast();
+        items->append(_item);
+        for (int _childIndex = _item->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            _pending.append(_item->child(_childIndex));
+        }
+    }
+}
+
+void A_Tree::RegisterItem(A_TreeItem *item, quint32 nodeId)
+{
+    /**
+     * Assigns an identifier to an item and grows the packed state bits as needed
+     * @param item Newly created item
+     * @param nodeId Identifier recorded by the journal, 0 for the next unused one
+     */
+
+    if (nodeId == 0) {
+        nodeId = quint32(NodeTable.size());               // Next unused identifier
+    }
+    if (int(nodeId) >= NodeTable.size()) {
+        NodeTable.resize(int(nodeId) + 1);                // Identifiers skipped by replay stay empty
+    }
+    item->NodeId = nodeId;
+    NodeTable[int(nodeId)] = item;
+    Hashes.Invalidate(nodeId);                            // Identifier may be reused - hash of the removed item is stale
+
+    if (CheckedLeafBits.size() < NodeTable.size()) {
+        CheckedLeafBits.resize(qMax(NodeTable.size(), 2 * CheckedLeafBits.size()));  // Grow geometrically
+        ExpandedBits.resize(CheckedLeafBits.size());      // Same indexing as checked-leaf bits
+    }
+}
+
+int A_Tree::UnregisterSubtree(QTreeWidgetItem *item)
+{
+    /**
+     * Releases identifiers, checked-leaf bits and sort configuration of a subtree
+     * Prevents stale entries from matching a later item at the same address
+     * @param item Root of subtree being removed
+     * @return Number of items in the subtree
+     */
+
+    JournalItemRecord(A_TreeJournal::RemoveNode, item);   // Replay removes the whole subtree
+    return ReleaseSubtree(item);
+}
+
+int A_Tree::ReleaseSubtree(QTreeWidgetItem *item)
+{
+    /**
+     * Clears the table entry, bits, path index entry, attribute values and sort configuration of every item
+     * @param item Root of subtree being removed
+     * @return Number of items in the subtree
+     */
+
+    int _itemCount = 0;                                   // Items visited
+    QVector<QTreeWidgetItem*> _pending;                   // Items still to visit
+    _pending.append(item);
+    while (!_pending.isEmpty()) {
+        A_TreeItem *_current = static_cast<A_TreeItem*>(_pending.takeLast());  // Next item in subtree
+        NodeTable[_current->NodeId] = nullptr;            // Identifier no longer resolves
+        CheckedLeafBits.clearBit(_current->NodeId);       // Removed leaf is not checked anymore
+        ExpandedBits.clearBit(_current->NodeId);          // Identifier no longer expanded
+        if (!PathIndex.isEmpty()) {
+            quint32 _parentId = _current->parent() ? GetItemId(_current->parent()) : 0;  // Still attached here
+            PathIndex.remove(qMakePair(_parentId, PathTextHash(_current->text(0))), _current->NodeId);  // Drop path index entry
+        }
+        if (int(_current->NodeId) < PathIndexedBits.size()) {
+            PathIndexedBits.clearBit(_current->NodeId);   // Children go with the item
+        }
+        if (Attributes.GetColumnCount() > 0) {
+            Attributes.ClearNode(_current->NodeId);       // Identifier no longer has attribute values
+        }
+        if (!SortedParents.isEmpty()) {
+            SortedParents.remove(_current);               // Drop sort configuration of removed parent
+        }
+        if (_current == CurrentItem) {
+            CurrentItem = nullptr;                        // Context menu target is going away
+        }
+        for (int _childIndex = 0; _childIndex < _current->childCount(); ++_childIndex) {
+            _pending.append(_current->child(_childIndex));
+        }
+        _itemCount++;
+    }
+
+    return _itemCount;
+}
+
+void A_Tree::SyncCheckedLeafBit(QTreeWidgetItem *item)
+{
+    /**
+     * Keeps the checked-leaf bitmap in step with an item's state
+     * @param item Item whose state or child count changed
+     */
+
+    bool _isCheckedLeaf = item->childCount() == 0 && item->checkState(0) == Qt::Checked;  // Leaf in Checked state
+    const int _nodeId = int(static_cast<A_TreeItem*>(item)->NodeId);  // Bit to update
+    if (Aggregates.IsEnabled() && CheckedLeafBits.testBit(_nodeId) != _isCheckedLeaf && CanApplyAggregateDelta()) {
+        A_TreeAggregates::Values _delta;                  // One checked leaf more or less
+        _delta.CheckedLeafCount = 1;
+        ApplyAggregateDelta(item, _delta, !_isCheckedLeaf);
+    }
+    CheckedLeafBits.setBit(_nodeId, _isCheckedLeaf);
+}
+
+int A_Tree::ApplyCheckRules(const QVector<A_TreeCheckRules::Rule> &rules, const QString &separator, QString *errorMessage)
+{
+    /**
+     * Decides all leaves over the flattened filter index, then walks pre-order backwards so
+     * leaves take their decided state and only parents with a changed child are recalculated
+     * @return Changed leaf count or -1
+     */
+
+    A_TreeCheckRules _rules;                              // Compiled rules
+    if (!_rules.Compile(rules, separator, errorMessage)) {
+        return -1;
+    }
+
+    if (IsFilterIndexDirty) {
+        RebuildFilterIndex();                             // Flattened texts and parents, shared with filtering
+    }
+    const QVector<qint8> _decisions = _rules.EvaluateLeaves(FilterTexts, FilterParents);  // Per leaf: 1, 0 or -1
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for all changes
+
+    QBitArray _dirtyParents(FilterItems.size());          // Parents with at least one changed child
+    int _changedLeafCount = 0;                            // Leaves whose state changed
+    for (int _position = FilterItems.size() - 1; _position >= 0; --_position) {
+        QTreeWidgetItem *_item = FilterItems.at(_position);  // Children of this item are already final
+        const qint8 _decision = _decisions.at(_position);
+        Qt::CheckState _state = Qt::Unchecked;            // State this item must have
+        if (_decision >= 0) {
+            _state = _decision ? Qt::Checked : Qt::Unchecked;
+        } else if (_dirtyParents.testBit(_position)) {
+            _state = CalculateParentCheckState(_item);
+        } else {
+            continue;                                     // Unmatched leaf or untouched parent
+        }
+        if (_item->checkState(0) == _state) {
+            continue;
+        }
+
+        _item->setCheckState(0, _state);
+        if (_decision >= 0) {
+            CheckedLeafBits.setBit(int(GetItemId(_item)), _state == Qt::Checked);
+            JournalItemRecord(A_TreeJournal::SetCheckState, _item);  // Parents follow on replay
+            _changedLeafCount++;
+        }
+        if (FilterParents.at(_position) >= 0) {
+            _dirtyParents.setBit(FilterParents.at(_position));
+        }
+    }
+
+    if (_changedLeafCount > 0) {
+        RepositionCheckSortedItems(TreeWidget->invisibleRootItem());  // States of many lists may have changed
+    }
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = false;                             // Clear flag
+    if (IsCompact) {
+        ReleaseFilterIndex();                             // Not kept in compact mode
+    }
+
+    if (_changedLeafCount > 0 && Aggregates.IsEnabled()) {
+        if (BulkUpdateDepth > 0) {
+            IsAggregatesStale = true;                     // EndBulkUpdate recomputes
+        } else {
+            RecomputeAggregates();                        // One pass instead of a delta per leaf
+        }
+    }
+
+    emit CheckRulesApplied(_changedLeafCount);
+    return _changedLeafCount;
+}
+
+bool A_Tree::ExportTo(QIODevice *device, const A_TreeExporter::Options &options, qint64 *writtenCount) const
+{
+    /**
+     * Walks the items with a stack of (parent, next child) pairs, so neither a flattened
+     * copy nor per-item paths are built; excluded subtrees are not entered.
+     * While frozen the encoding is walked the same way
+     * @return True if every write succeeded
+     */
+
+    A_TreeExporter _exporter(device, options);            // Buffered writer
+    _exporter.Begin();
+
+    if (FrozenTree) {
+        QVector<QPair<int, int>> _frozenAncestors;        // Open parents with their next child number
+        _frozenAncestors.append(qMakePair(int(A_TreeSuccinct::NoNode), FrozenTree->GetFirstChild(A_TreeSuccinct::NoNode)));
+        while (!_frozenAncestors.isEmpty()) {
+            QPair<int, int> &_top = _frozenAncestors.last();
+            const int _firstChild = FrozenTree->GetFirstChild(_top.first);
+            if (_firstChild == A_TreeSuccinct::NoNode || _top.second >= _firstChild + FrozenTree->GetChildCount(_top.first)) {
+                _frozenAncestors.removeLast();            // All children written
+                continue;
+            }
+
+            const int _node = _top.second++;              // Next node in pre-order - siblings are consecutive
+            const Qt::CheckState _state = FrozenTree->GetCheckState(_node);
+            const bool _isLeaf = FrozenTree->GetChildCount(_node) == 0;
+            _exporter.AddItem(_frozenAncestors.size() - 1, FrozenTree->GetText(_node), _state, _isLeaf);
+            if (!_isLeaf && !_exporter.IsSubtreeExcluded(_state)) {
+                _frozenAncestors.append(qMakePair(_node, FrozenTree->GetFirstChild(_node)));  // Descend into children next
+            }
+        }
+    }
+
+    QVector<QPair<QTreeWidgetItem*, int>> _ancestors;     // Open parents with their next child position
+    _ancestors.append(qMakePair(TreeWidget->invisibleRootItem(), 0));
+    while (!_ancestors.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> &_top = _ancestors.last();
+        if (_top.second >= _top.first->childCount()) {
+            _ancestors.removeLast();                      // All children written
+            continue;
+        }
+
+        QTreeWidgetItem *_item = _top.first->child(_top.second++);  // Next item in pre-order
+        const Qt::CheckState _state = _item->checkState(0);
+        const bool _isLeaf = _item->childCount() == 0;
+        _exporter.AddItem(_ancestors.size() - 1, _item->text(0), _state, _isLeaf);
+        if (!_isLeaf && !_exporter.IsSubtreeExcluded(_state)) {
+            _ancestors.append(qMakePair(_item, 0));       // Descend into children next
+        }
+    }
+
+    const bool _isOk = _exporter.Finish();
+    if (writtenCount) {
+        *writtenCount = _exporter.GetWrittenCount();
+    }
+    return _isOk;
+}
+
+bool A_Tree::ExportToFileAsync(const QString &filePath, const A_TreeExporter::Options &options)
+{
+    /**
+     * Hands the current snapshot to a worker thread - the tree stays editable while the file is written
+     * @return False if an export is already running
+     */
+
+    if (IsExportRunning()) {
+        return false;
+    }
+
+    if (IsCompact || FrozenTree) {
+        QSaveFile _file(filePath);                        // No snapshot to hand over - write the live items or encoding here
+        qint64 _writtenCount = 0;
+        const bool _isSuccess = _file.open(QIODevice::WriteOnly) && ExportTo(&_file, options, &_writtenCount) && _file.commit();
+        emit ExportFinished(_isSuccess, _writtenCount);
+        return true;
+    }
+
+    const std::shared_ptr<const A_TreeSnapshot> _snapshot = GetSnapshot();  // Immutable state at call time
+    ExportWatcher->setFuture(QtConcurrent::run([_snapshot, filePath, options]() -> qint64 {
+        QSaveFile _file(filePath);                        // Output replaced only when complete
+        qint64 _writtenCount = 0;
+        if (!_file.open(QIODevice::WriteOnly) ||
+            !A_TreeExporter::ExportSnapshot(*_snapshot, &_file, options, &_writtenCount) || !_file.commit()) {
+            return -1;
+        }
+        return _writtenCount;
+    }));
+
+    return true;
+}
+
+bool A_Tree::IsExportRunning() const
+{
+    /**
+     * Gets whether the export watcher is busy
+     * @return True while running
+     */
+
+    return ExportWatcher->isRunning();
+}
+
+void A_Tree::OnExportFinished()
+{
+    /**
+     * Handles completion of a background export
+     */
+
+    const qint64 _writtenCount = ExportWatcher->result(); // -1 on failure
+    emit ExportFinished(_writtenCount >= 0, qMax<qint64>(0, _writtenCount));
+}
+
+bool A_Tree::MoveItem(QTreeWidgetItem *item, QTreeWidgetItem *newParent)
+{
+    /**
+     * Moves an item with its subtree to a new parent
+     * Check states of both old and new parent chains are recalculated
+     * @param item Item to move
+     * @param newParent New parent, nullptr for root level
+     * @return True if the item was moved
+     */
+
+    if (!item) {                                          // Validate item pointer
+        return false;                                     // Exit if item is null
+    }
+
+    for (QTreeWidgetItem *_ancestor = newParent; _ancestor; _ancestor = _ancestor->parent()) {
+        if (_ancestor == item) {
+            return false;                                 // Cannot move an item into its own subtree
+        }
+    }
+
+    QTreeWidgetItem *_oldContainer = item->parent() ? item->parent() : TreeWidget->invisibleRootItem();
+    QTreeWidgetItem *_newContainer = newParent ? newParent : TreeWidget->invisibleRootItem();
+    if (_oldContainer == _newContainer) {
+        return false;                                     // Already under requested parent - nothing changes
+    }
+
+    bool _wasExpanded = item->isExpanded();               // View forgets expansion when item is taken out
+    bool _wasInternalUpdate = IsInternalUpdate;           // Moves may run inside a batch
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+
+    _oldContainer->removeChild(item);                     // Detach from old parent
+    InsertSortedOrAppend(_newContainer, static_cast<A_TreeItem*>(item));  // Attach to new parent
+    JournalItemRecord(A_TreeJournal::MoveNode, item);     // Persist new parent and position
+    item->setExpanded(_wasExpanded);                      // Restore expansion
+
+    RefreshCheckStateAfterChange(_oldContainer);          // Old parent lost a child
+    RefreshCheckStateAfterChange(_newContainer);          // New parent gained a child
+
+    IsInternalUpdate = _wasInternalUpdate;                // Restore flag
+    InvalidateFilterIndex();                              // Flattened positions changed
+
+    return true;
+}
+
+QTreeWidgetItem* A_Tree::AddByPath(const QString &path, const QString &separator)
+{
+    /**
+     * Resolves a path through the path index, creating missing items
+     * Created items are expanded into view and the check state of the first existing parent is recalculated
+     * @param path Path from root item
+     * @param separator Separator between path segments
+     * @return Item at path or nullptr
+     */
+
+    QStringList _segments = SplitPath(path, separator);   // Path from root
+    if (_segments.isEmpty()) {
+        return nullptr;                                   // Path without segments
+    }
+
+    int _createdCount = 0;                                // Items created along the path
+    QTreeWidgetItem *_createdUnder = nullptr;             // Existing parent of first created item
+    bool _wasInternalUpdate = IsInternalUpdate;           // Paths may be added inside a batch
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+
+    QTreeWidgetItem *_item = ResolvePath(_segments, true, &_createdCount, &_createdUnder);
+    if (_createdCount > 0) {
+        for (QTreeWidgetItem *_parent = _item->parent(); _parent; _parent = _parent->parent()) {
+            ExpandNewItem(_parent);                       // Show created items like AddChildItem
+            if (_parent == _createdUnder) {
+                break;                                    // Ancestors above already showed their children
+            }
+        }
+        if (_createdUnder) {
+            RefreshCheckStateAfterChange(_createdUnder);  // Existing parent gained a child
+        }
+        InvalidateFilterIndex();                          // New items must be tested against active filter
+    }
+
+    IsInternalUpdate = _wasInternalUpdate;                // Restore flag
+    return _item;
+}
+
+int A_Tree::AddPaths(const QStringList &paths, const QString &separator)
+{
+    /**
+     * Adds paths in one bulk update
+     * The items resolved for the previous path are kept by identifier, so a path sharing its first
+     * segments with the previous one starts its lookups below the shared prefix
+     * @param paths Paths from root item
+     * @param separator Separator between path segments
+     * @return Number of items created
+     */
+
+    int _createdCount = 0;                                // Items created over all paths
+    QSet<quint32> _changedParents;                        // Existing parents that gained children
+    QVector<quint32> _chain;                              // Identifier per segment of the previous path
+    QStringList _previous;                                // Segments of the previous path
+    const quint32 _firstNewId = quint32(NodeTable.size()); // Items from here on are created by this batch
+
+    BeginBulkUpdate();                                    // Expansion applied once at the end
+    const bool _wasInternalUpdate = IsInternalUpdate;     // Paths may be added inside a batch or change handler
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole batch
+
+    for (const QString &_path : paths) {
+        QStringList _segments = SplitPath(_path, separator);  // Path from root
+        if (_segments.isEmpty()) {
+            continue;
+        }
+
+        int _shared = 0;                                  // Segments shared with the previous path
+        while (_shared < _segments.size() && _shared < _previous.size() && _segments.at(_shared) == _previous.at(_shared)) {
+            _shared++;
+        }
+        _chain.resize(_shared);
+
+        QTreeWidgetItem *_container = _shared > 0 ? GetItemById(_chain.last()) : TreeWidget->invisibleRootItem();
+        for (int _depth = _shared; _depth < _segments.size(); ++_depth) {
+            int _segmentCreated = 0;                      // 1 if this segment was created
+            QTreeWidgetItem *_child = ResolveChild(_container, _segments.at(_depth), true, &_segmentCreated, nullptr);
+            if (_segmentCreated > 0 && _container != TreeWidget->invisibleRootItem()) {
+                ExpandNewItem(_container);                // Records the bit during the bulk update
+                if (GetItemId(_container) < _firstNewId) {
+                    _changedParents.insert(GetItemId(_container));  // New parents only hold unchecked children
+                }
+            }
+            _createdCount += _segmentCreated;
+            _chain.append(GetItemId(_child));
+            _container = _child;
+        }
+        _previous = _segments;
+    }
+
+    for (quint32 _parentId : _changedParents) {
+        RefreshCheckStateAfterChange(GetItemById(_parentId));  // Once per parent instead of once per item
+    }
+
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = _wasInternalUpdate;                // Restore flag
+    EndBulkUpdate();
+    if (_createdCount > 0) {
+        InvalidateFilterIndex();                          // New items must be tested against active filter
+    }
+
+    return _createdCount;
+}
+
+QTreeWidgetItem* A_Tree::FindByPath(const QString &path, const QString &separator) const
+{
+    /**
+     * Resolves a path through the path index without creating items
+     * @param path Path from root item
+     * @param separator Separator between path segments
+     * @return Item at path or nullptr
+     */
+
+    QStringList _segments = SplitPath(path, separator);   // Path from root
+    if (_segments.isEmpty()) {
+        return nullptr;
+    }
+
+    QTreeWidgetItem *_container = TreeWidget->invisibleRootItem();  // Current sibling list owner
+    for (const QString &_segment : _segments) {
+        _container = FindChildByText(_container, _segment);
+        if (!_container) {
+            return nullptr;                               // Path does not exist
+        }
+    }
+
+    return _container;
+}
+
+bool A_Tree::SetCheckedByPath(const QString &path, bool checked, const QString &separator)
+{
+    /**
+     * Sets the checked state of the item at a path
+     * @param path Path from root item
+     * @param checked New checked state
+     * @param separator Separator between path segments
+     * @return True if the item exists
+     */
+
+    QTreeWidgetItem *_item = FindByPath(path, separator); // Target item
+    if (!_item) {
+        return false;                                     // Nothing at path
+    }
+
+    SetItemCheckedState(_item, checked);                  // Propagates, journals and notifies
+    return true;
+}
+
+void A_Tree::SyncFromSource(const QVector<SourceNode> &nodes)
+{
+    /**
+     * Reconciles the tree with a snapshot of an external hierarchy
+     * Each sibling list is matched by key (or text); unmatched items are deleted,
+     * unmatched source nodes are created, renamed items are updated in place and
+     * siblings are reordered to source order. A keyed item found under another parent
+     * in the source is moved there with its subtree and state; unmatched subtrees that
+     * hold such items are deleted only after the walk. Everything runs as one batch.
+     * @param nodes Source nodes, parents listed before children
+     */
+
+    const int _nodeCount = nodes.size();                  // Number of source nodes
+
+    // Group source nodes into sibling lists (CSR layout), skipping empty texts and orphans
+    QVector<bool> _isSkipped(_nodeCount, false);          // Node ignored together with its subtree
+    QVector<int> _childOffsets(_nodeCount + 1, 0);        // Start of each node's children in _childList
+    QVector<int> _sourceRoots;                            // Root level source nodes in order
+    for (int _nodeIndex = 0; _nodeIndex < _nodeCount; ++_nodeIndex) {
+        const SourceNode &_node = nodes.at(_nodeIndex);
+        const int _parentIndex = _node.ParentIndex;
+        if (_node.Text.trimmed().isEmpty() || _parentIndex >= _nodeIndex ||
+            (_parentIndex >= 0 && _isSkipped.at(_parentIndex))) {
+            _isSkipped[_nodeIndex] = true;                // Invalid node or inside skipped subtree
+        } else if (_parentIndex < 0) {
+            _sourceRoots.append(_nodeIndex);
+        } else {
+            _childOffsets[_parentIndex + 1]++;            // Count child of parent
+        }
+    }
+    for (int _nodeIndex = 0; _nodeIndex < _nodeCount; ++_nodeIndex) {
+        _childOffsets[_nodeIndex + 1] += _childOffsets.at(_nodeIndex);  // Prefix sums
+    }
+    QVector<int> _childList(_childOffsets.at(_nodeCount));  // Children of all nodes, grouped by parent
+    QVector<int> _fillCursor = _childOffsets;             // Next free slot per parent
+    for (int _nodeIndex = 0; _nodeIndex < _nodeCount; ++_nodeIndex) {
+        if (!_isSkipped.at(_nodeIndex) && nodes.at(_nodeIndex).ParentIndex >= 0) {
+            _childList[_fillCursor[nodes.at(_nodeIndex).ParentIndex]++] = _nodeIndex;
+        }
+    }
+
+    auto _sourceMatchKey = [&nodes](int nodeIndex) -> QString {      // Matching key of a source node
+        const SourceNode &_node = nodes.at(nodeIndex);
+        return _node.Key.isEmpty() ? QStringLiteral("t:") + _node.Text.trimmed()
+                                   : QStringLiteral("k:") + _node.Key;
+    };
+
+    // Hash source subtrees so matched items with an identical subtree are not descended into
+    const bool _isHashed = Hashes.IsEnabled();            // Identical subtrees can be skipped
+    QVector<A_TreeHashes::Values> _sourceHashes;          // Subtree hashes per source node - content hash only
+    QVector<bool> _isKeyedSubtree;                        // Source subtree matches by key somewhere - never skipped
+    if (_isHashed) {
+        _sourceHashes.resize(_nodeCount);
+        _isKeyedSubtree.resize(_nodeCount);
+        for (int _nodeIndex = _nodeCount - 1; _nodeIndex >= 0; --_nodeIndex) {  // Children come after parents
+            if (_isSkipped.at(_nodeIndex)) {
+                continue;
+            }
+            A_TreeHashes::Values _values = A_TreeHashes::Begin(nodes.at(_nodeIndex).Text.trimmed(), Qt::Unchecked);
+            bool _isKeyed = !nodes.at(_nodeIndex).Key.isEmpty();
+            for (int _slot = _childOffsets.at(_nodeIndex); _slot < _childOffsets.at(_nodeIndex + 1); ++_slot) {
+                A_TreeHashes::AddChild(_values, _sourceHashes.at(_childList.at(_slot)));
+                _isKeyed = _isKeyed || _isKeyedSubtree.at(_childList.at(_slot));
+            }
+            A_TreeHashes::Finish(_values, _childOffsets.at(_nodeIndex + 1) - _childOffsets.at(_nodeIndex));
+            _sourceHashes[_nodeIndex] = _values;
+            _isKeyedSubtree[_nodeIndex] = _isKeyed;
+        }
+    }
+
+    // Existing keyed items whose key occurs anywhere in the source - moved instead of recreated
+    QSet<QString> _sourceKeys;                            // Matching keys of keyed source nodes
+    for (int _nodeIndex = 0; _nodeIndex < _nodeCount; ++_nodeIndex) {
+        if (!_isSkipped.at(_nodeIndex) && !nodes.at(_nodeIndex).Key.isEmpty()) {
+            _sourceKeys.insert(_sourceMatchKey(_nodeIndex));
+        }
+    }
+    QHash<QString, quint32> _movableIds;                  // Unclaimed item per source key - first in identifier order
+    QSet<quint32> _keptIds;                               // Every such item - subtrees holding one are deleted last
+    if (!_sourceKeys.isEmpty()) {
+        for (A_TreeItem *_item : std::as_const(NodeTable)) {
+            if (!_item || !_item->treeWidget() || !_item->data(0, A_TreeItem::SyncKeyRole).isValid()) {
+                continue;                                 // Items of detached subtrees are being freed
+            }
+            const QString _key = SyncMatchKey(_item);
+            if (_sourceKeys.contains(_key) && !_movableIds.contains(_key)) {
+                _movableIds.insert(_key, _item->NodeId);
+                _keptIds.insert(_item->NodeId);
+            }
+        }
+    }
+    QSet<quint32> _claimedIds;                            // Kept items that found their source node
+    QVector<quint32> _deferredIds;                        // Unmatched subtrees holding kept items - deleted after the walk
+
+    auto _takeMovable = [this, &_movableIds, &_claimedIds](const QString &key) -> A_TreeItem* {  // Kept item with the key
+        const quint32 _nodeId = _movableIds.take(key);    // 0 if none or already claimed
+        if (_nodeId == 0) {
+            return nullptr;
+        }
+        _claimedIds.insert(_nodeId);
+        return static_cast<A_TreeItem*>(GetItemById(_nodeId));
+    };
+
+    auto _holdsKeptItem = [this, &_keptIds](QTreeWidgetItem *item) {  // Subtree holds an item to be moved
+        if (_keptIds.isEmpty()) {
+            return false;
+        }
+        QVector<QTreeWidgetItem*> _stack{item};           // Items still to test
+        while (!_stack.isEmpty()) {
+            QTreeWidgetItem *_current = _stack.takeLast();
+            if (_keptIds.contains(GetItemId(_current))) {
+                return true;
+            }
+            for (int _childIndex = 0; _childIndex < _current->childCount(); ++_childIndex) {
+                _stack.append(_current->child(_childIndex));
+            }
+        }
+        return false;
+    };
+
+    // Kept item found below a newly built parent - moved in once the parent is attached
+    struct SubtreeMove
+    {
+        A_TreeItem *Item = nullptr;      // Kept item
+        A_TreeItem *Parent = nullptr;    // Newly built parent
+        int ParentSource = -1;           // Source node of the parent
+    };
+    QVector<SubtreeMove> _subtreeMoves;                   // Moves into subtrees built for the current list
+
+    int _addedCount = 0;                                  // Items created
+    int _removedCount = 0;                                // Items deleted, including descendants
+    int _changedCount = 0;                                // Items renamed or moved
+
+    auto _createItem = [this, &nodes, &_addedCount](int nodeIndex) {  // New item for a source node
+        A_TreeItem *_newItem = CreateItem(nodes.at(nodeIndex).Text.trimmed());
+        if (!nodes.at(nodeIndex).Key.isEmpty()) {
+            _newItem->setData(0, A_TreeItem::SyncKeyRole, nodes.at(nodeIndex).Key);  // Remember identity
+        }
+        _addedCount++;
+        return _newItem;
+    };
+
+    auto _buildSubtree = [&](int nodeIndex) {             // Detached copy of a source subtree
+        A_TreeItem *_subtreeRoot = _createItem(nodeIndex);
+        QVector<QPair<A_TreeItem*, int>> _pending;        // Created items whose children are still missing
+        _pending.append(qMakePair(_subtreeRoot, nodeIndex));
+        while (!_pending.isEmpty()) {
+            QPair<A_TreeItem*, int> _entry = _pending.takeLast();
+            for (int _slot = _childOffsets.at(_entry.second); _slot < _childOffsets.at(_entry.second + 1); ++_slot) {
+                A_TreeItem *_movedItem = _takeMovable(_sourceMatchKey(_childList.at(_slot)));
+                if (_movedItem) {
+                    SubtreeMove _move;                    // Existing item moves in after attachment
+                    _move.Item = _movedItem;
+                    _move.Parent = _entry.first;
+                    _move.ParentSource = _entry.second;
+                    _subtreeMoves.append(_move);
+                    continue;
+                }
+                A_TreeItem *_child = _createItem(_childList.at(_slot));
+                InsertSortedOrAppend(_entry.first, _child);  // Detached insert - no view cost
+                _pending.append(qMakePair(_child, _childList.at(_slot)));
+            }
+        }
+        return _subtreeRoot;
+    };
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole batch
+
+    QVector<QTreeWidgetItem*> _changedContainers;         // Sibling lists that gained or lost items
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Matched containers with their source node (-1 = roots)
+    _pending.append(qMakePair(TreeWidget->invisibleRootItem(), -1));
+
+    while (!_pending.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> _entry = _pending.takeLast();
+        QTreeWidgetItem *_container = _entry.first;       // Sibling list owner being reconciled
+        const int _existingCount = _container->childCount();
+
+        // Index existing children by matching key; duplicates are chained in sibling order
+        QHash<QString, int> _firstByKey;                  // First unmatched child per key
+        QVector<int> _nextSameKey(_existingCount, -1);    // Next child with the same key
+        for (int _childIndex = _existingCount - 1; _childIndex >= 0; --_childIndex) {
+            QString _key = SyncMatchKey(_container->child(_childIndex));
+            _nextSameKey[_childIndex] = _firstByKey.value(_key, -1);
+            _firstByKey.insert(_key, _childIndex);
+        }
+
+        QVector<int> _sourceChildren;                     // Source sibling list for this container
+        if (_entry.second < 0) {
+            _sourceChildren = _sourceRoots;
+        } else {
+            _sourceChildren = _childList.mid(_childOffsets.at(_entry.second),
+                                             _childOffsets.at(_entry.second + 1) - _childOffsets.at(_entry.second));
+        }
+
+        QVector<bool> _isMatched(_existingCount, false);  // Existing child kept
+        QVector<A_TreeItem*> _desiredOrder;               // Children in source order
+        QList<QTreeWidgetItem*> _newItems;                // Created subtrees to attach
+        QVector<A_TreeItem*> _movedItems;                 // Kept items from other parents to move here
+        bool _hasRenames = false;                         // Any matched child changed text
+        _desiredOrder.reserve(_sourceChildren.size());
+        _subtreeMoves.clear();
+
+        for (int _sourceIndex : _sourceChildren) {
+            QString _key = _sourceMatchKey(_sourceIndex);
+            int _childIndex = _firstByKey.value(_key, -1); // Oldest unmatched child with this key
+            A_TreeItem *_child = nullptr;                 // Existing item with the node's identity
+            if (_childIndex >= 0) {
+                _firstByKey.insert(_key, _nextSameKey.at(_childIndex));  // Consume match
+                _isMatched[_childIndex] = true;
+                _child = static_cast<A_TreeItem*>(_container->child(_childIndex));
+                if (_movableIds.value(_key) == _child->NodeId) {
+                    _movableIds.remove(_key);             // Stays under this parent
+                    _claimedIds.insert(_child->NodeId);
+                }
+            } else {
+                _child = _takeMovable(_key);              // Same key under another parent
+                if (!_child) {
+                    A_TreeItem *_newItem = _buildSubtree(_sourceIndex);  // No counterpart - create subtree
+                    _newItems.append(_newItem);
+                    _desiredOrder.append(_newItem);
+                    continue;
+                }
+                _movedItems.append(_child);
+            }
+
+            QString _text = nodes.at(_sourceIndex).Text.trimmed();
+            if (_child->text(0) != _text) {
+                _child->setText(0, _text);                // Same identity, new text
+                JournalItemRecord(A_TreeJournal::SetText, _child);
+                _hasRenames = true;
+                _changedCount++;
+            }
+            _desiredOrder.append(_child);
+            if (_isHashed && !_isKeyedSubtree.at(_sourceIndex) &&
+                GetSubtreeHashes(_child).ContentHash == _sourceHashes.at(_sourceIndex).ContentHash) {
+                continue;                                 // Same texts in the same shape - nothing to reconcile below
+            }
+            _pending.append(qMakePair(static_cast<QTreeWidgetItem*>(_child), _sourceIndex));  // Reconcile its children next
+        }
+
+        // Delete unmatched children from the back so indices stay valid
+        bool _isChanged = !_newItems.isEmpty() || !_movedItems.isEmpty();  // Sibling list gained or lost items
+        QVector<A_TreeItem*> _deferredChildren;           // Unmatched children kept until their kept items moved
+        for (int _childIndex = _existingCount - 1; _childIndex >= 0; --_childIndex) {
+            if (_isMatched.at(_childIndex)) {
+                continue;
+            }
+            A_TreeItem *_unmatched = static_cast<A_TreeItem*>(_container->child(_childIndex));
+            if (_holdsKeptItem(_unmatched)) {
+                _deferredChildren.prepend(_unmatched);    // Sibling order
+                _deferredIds.append(_unmatched->NodeId);
+                continue;
+            }
+            _removedCount += DestroySubtree(_unmatched);
+            _isChanged = true;
+        }
+
+        QTreeWidgetItem *_newParent = (_container == TreeWidget->invisibleRootItem()) ? nullptr : _container;
+        for (A_TreeItem *_movedItem : std::as_const(_movedItems)) {
+            if (MoveItem(_movedItem, _newParent)) {       // Keeps subtree, check and expand state
+                _changedCount++;
+            }
+        }
+
+        SortSpec _spec;                                   // Sort configuration of this list
+        if (FindSortSpec(_container, &_spec)) {
+            for (QTreeWidgetItem *_newItem : _newItems) {
+                InsertSortedOrAppend(_container, static_cast<A_TreeItem*>(_newItem));  // Binary placement
+                JournalAddedSubtree(_newItem);
+            }
+            if (_hasRenames) {
+                SortContainer(_container, _spec);         // Renamed items may be out of place
+            }
+        } else {
+            if (!_newItems.isEmpty()) {
+                _container->addChildren(_newItems);       // Attach all new subtrees at once
+                for (QTreeWidgetItem *_newItem : _newItems) {
+                    JournalAddedSubtree(_newItem);
+                }
+            }
+
+            _desiredOrder += _deferredChildren;           // Deleted after the walk - kept behind the source order
+            bool _isInSourceOrder = true;                 // Current order already matches source
+            for (int _childIndex = 0; _childIndex < _desiredOrder.size(); ++_childIndex) {
+                _desiredOrder.at(_childIndex)->SortRank = _childIndex;
+                if (_container->child(_childIndex) != _desiredOrder.at(_childIndex)) {
+                    _isInSourceOrder = false;
+                }
+            }
+            if (!_isInSourceOrder) {
+                ApplySortRanks(_container);               // Reorder through the view, keeps expansion
+                JournalChildOrder(_container);
+            }
+        }
+
+        for (const SubtreeMove &_move : std::as_const(_subtreeMoves)) {
+            if (MoveItem(_move.Item, _move.Parent)) {     // Parent is attached now
+                _changedCount++;
+            }
+            if (_pending.isEmpty() || _pending.last().first != _move.Parent) {
+                _pending.append(qMakePair(static_cast<QTreeWidgetItem*>(_move.Parent), _move.ParentSource));  // Places and reconciles the moved item
+            }
+        }
+
+        if (_isChanged) {
+            _changedContainers.append(_container);
+        }
+    }
+
+    for (quint32 _nodeId : std::as_const(_deferredIds)) {
+        QTreeWidgetItem *_item = GetItemById(_nodeId);    // Deferred unmatched subtree
+        if (!_item || _claimedIds.contains(_nodeId)) {
+            continue;                                     // Moved to its source node
+        }
+        _changedContainers.append(_item->parent() ? _item->parent() : TreeWidget->invisibleRootItem());
+        _removedCount += DestroySubtree(_item);           // Kept items inside have moved out
+    }
+
+    for (int _containerIndex = _changedContainers.size() - 1; _containerIndex >= 0; --_containerIndex) {
+        RefreshCheckStateAfterChange(_changedContainers.at(_containerIndex));  // Deepest lists first
+    }
+
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = false;                             // Clear flag
+    InvalidateFilterIndex();                              // Flattened index is outdated
+
+    emit SyncApplied(_addedCount, _removedCount, _changedCount);
+}
+
+void A_Tree::ApplySyncEvents(const QVector<SyncEvent> &events, const QString &separator)
+{
+    /**
+     * Applies external change events as one batch
+     * Affected parents are tracked by identifier so later removals cannot leave dangling entries,
+     * and their check states are recalculated once at the end
+     * @param events Events in order of occurrence
+     * @param separator Separator between path segments
+     */
+
+    int _addedCount = 0;                                  // Items created
+    int _removedCount = 0;                                // Items deleted, including descendants
+    int _changedCount = 0;                                // Items renamed or moved
+    QSet<quint32> _changedParents;                        // Identifiers of parents that gained or lost children
+    bool _isCheckChanged = false;                         // Some event set a check state
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole batch
+
+    for (const SyncEvent &_event : events) {
+        QStringList _segments = SplitPath(_event.Path, separator);  // Path from root
+        if (_segments.isEmpty()) {
+            continue;                                     // Event without a target
+        }
+
+        switch (_event.Type) {
+        case SyncEvent::Add: {
+            int _createdCount = 0;                        // Items created along the path
+            QTreeWidgetItem *_createdUnder = nullptr;     // Parent of first created item
+            ResolvePath(_segments, true, &_createdCount, &_createdUnder);
+            if (_createdUnder) {
+                _changedParents.insert(GetItemId(_createdUnder));
+            }
+            _addedCount += _createdCount;
+            break;
+        }
+        case SyncEvent::Remove: {
+            QTreeWidgetItem *_item = ResolvePath(_segments, false, nullptr, nullptr);
+            if (_item) {
+                if (_item->parent()) {
+                    _changedParents.insert(GetItemId(_item->parent()));
+                }
+                _removedCount += DestroySubtree(_item);
+            }
+            break;
+        }
+        case SyncEvent::Rename: {
+            QTreeWidgetItem *_item = ResolvePath(_segments, false, nullptr, nullptr);
+            QString _newText = _event.Target.trimmed();   // Requested text
+            if (_item && !_newText.isEmpty() && _item->text(0) != _newText) {
+                _item->setText(0, _newText);
+                JournalItemRecord(A_TreeJournal::SetText, _item);
+                RepositionSortedItem(_item);              // Keep sorted siblings in order
+                _changedCount++;
+            }
+            break;
+        }
+        case SyncEvent::Move: {
+            QTreeWidgetItem *_item = ResolvePath(_segments, false, nullptr, nullptr);
+            if (!_item) {
+                break;                                    // Nothing to move
+            }
+            QStringList _targetSegments = SplitPath(_event.Target, separator);
+            QTreeWidgetItem *_newParent = nullptr;        // Root level unless target path given
+            if (!_targetSegments.isEmpty()) {
+                int _createdCount = 0;
+                QTreeWidgetItem *_createdUnder = nullptr;
+                _newParent = ResolvePath(_targetSegments, true, &_createdCount, &_createdUnder);
+                _addedCount += _createdCount;
+            }
+            if (MoveItem(_item, _newParent)) {
+                _changedCount++;
+            }
+            break;
+        }
+        case SyncEvent::Check:
+        case SyncEvent::Uncheck: {
+            QTreeWidgetItem *_item = ResolvePath(_segments, false, nullptr, nullptr);
+            const Qt::CheckState _state = _event.Type == SyncEvent::Check ? Qt::Checked : Qt::Unchecked;
+            if (!_item || _item->checkState(0) == _state) {
+                break;                                    // Nothing to change - subtree already follows the state
+            }
+            _item->setCheckState(0, _state);
+            SyncCheckedLeafBit(_item);
+            UpdateChildrenCheckState(_item);              // Ancestors are recalculated once at the end
+            JournalItemRecord(A_TreeJournal::SetCheckState, _item);
+            if (_item->parent()) {
+                _changedParents.insert(GetItemId(_item->parent()));
+            }
+            _isCheckChanged = true;
+            _changedCount++;
+            break;
+        }
+        }
+    }
+
+    for (quint32 _parentId : _changedParents) {
+        QTreeWidgetItem *_parent = GetItemById(_parentId);  // Null if removed by a later event
+        if (_parent) {
+            RefreshCheckStateAfterChange(_parent);
+        }
+    }
+    if (_isCheckChanged || !_changedParents.isEmpty()) {
+        RepositionCheckSortedItems(TreeWidget->invisibleRootItem());  // States of many lists may have changed
+    }
+
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = false;                             // Clear flag
+    InvalidateFilterIndex();                              // Flattened index is outdated
+
+    emit SyncApplied(_addedCount, _removedCount, _changedCount);
+}
+
+QString A_Tree::SyncMatchKey(QTreeWidgetItem *item)
+{
+    /**
+     * Builds the key used to match an item against source nodes
+     * @param item Tree item
+     * @return Prefixed sync key or prefixed text
+     */
+
+    QVariant _syncKey = item->data(0, A_TreeItem::SyncKeyRole);  // Identity from earlier sync, if any
+    if (_syncKey.isValid()) {
+        return QStringLiteral("k:") + _syncKey.toString();
+    }
+
+    return QStringLiteral("t:") + item->text(0);
+}
+
+QTreeWidgetItem* A_Tree::ResolvePath(const QStringList &segments, bool createMissing,
+                                     int *createdCount, QTreeWidgetItem **createdUnder)
+{
+    /**
+     * Resolves path segments one sibling list at a time through the path index
+     * @param segments Path segments from root to item
+     * @param createMissing Create missing items along the path
+     * @param createdCount Output number of created items - may be nullptr
+     * @param createdUnder Output parent of first created item - may be nullptr, untouched if nothing created or created at root
+     * @return Item at path or nullptr
+     */
+
+    QTreeWidgetItem *_container = TreeWidget->invisibleRootItem();  // Current sibling list owner
+    for (const QString &_segment : segments) {
+        _container = ResolveChild(_container, _segment, createMissing, createdCount, createdUnder);
+        if (!_container) {
+            return nullptr;                               // Path does not exist
+        }
+    }
+
+    return _container == TreeWidget->invisibleRootItem() ? nullptr : _container;
+}
+
+QTreeWidgetItem* A_Tree::ResolveChild(QTreeWidgetItem *container, const QString &text, bool createMissing,
+                                      int *createdCount, QTreeWidgetItem **createdUnder)
+{
+    /**
+     * Finds a child through the path index and creates it if requested
+     * @param container Parent item or invisible root item
+     * @param text Child text
+     * @param createMissing Create the child if missing
+     * @param createdCount Output number of created items - may be nullptr
+     * @param createdUnder Output parent of first created item - may be nullptr
+     * @return Child item or nullptr
+     */
+
+    QTreeWidgetItem *_child = FindChildByText(container, text);  // Existing child with this text
+    if (_child || !createMissing || text.isEmpty()) {
+        return _child;
+    }
+
+    A_TreeItem *_newItem = CreateItem(text);              // Create missing segment
+    InsertSortedOrAppend(container, _newItem);            // Indexed through rowsInserted
+    JournalAddedSubtree(_newItem);                        // Persist created segment
+    if (createdCount) {
+        if (*createdCount == 0 && createdUnder && container != TreeWidget->invisibleRootItem()) {
+            *createdUnder = container;                    // Only the first parent has a changed child list that matters
+        }
+        (*createdCount)++;
+    }
+
+    return _newItem;
+}
+
+QTreeWidgetItem* A_Tree::FindChildByText(QTreeWidgetItem *container, const QString &text) const
+{
+    /**
+     * Looks up a child by (parent identifier, text)
+     * Entries are checked against the item before use; entries of moved, renamed or deleted items are removed
+     * @param container Parent item or invisible root item
+     * @param text Child text
+     * @return First matching child in sibling order or nullptr
+     */
+
+    if (IsCompact) {
+        for (int _childIndex = 0; _childIndex < container->childCount(); ++_childIndex) {
+            if (container->child(_childIndex)->text(0) == text) {
+                return container->child(_childIndex);     // No index in compact mode - O(fan-out) scan
+            }
+        }
+        return nullptr;
+    }
+
+    const quint32 _containerId = container == TreeWidget->invisibleRootItem() ? 0 : GetItemId(container);
+    if (!IsPathContainerIndexed(_containerId)) {
+        IndexPathContainer(container);                    // O(fan-out) once per sibling list
+    }
+
+    const uint _textHash = PathTextHash(text);            // Texts are keyed by hash - entries store no string
+    const QPair<quint32, uint> _key(_containerId, _textHash);  // Index key
+    QTreeWidgetItem *_found = nullptr;                    // First valid child
+    int _foundIndex = -1;                                 // Sibling position of _found - computed only for duplicates
+    QVector<quint32> _staleIds;                           // Entries that no longer describe their item
+    for (auto _entry = PathIndex.constFind(_key); _entry != PathIndex.constEnd() && _entry.key() == _key; ++_entry) {
+        QTreeWidgetItem *_item = GetItemById(_entry.value());
+        QTreeWidgetItem *_itemContainer = _item && _item->parent() ? _item->parent() : TreeWidget->invisibleRootItem();
+        if (!_item || _itemContainer != container) {
+            _staleIds.append(_entry.value());             // Deleted or moved
+            continue;
+        }
+        const QString _itemText = _item->text(0);         // Current text of the indexed item
+        if (_itemText != text) {
+            if (PathTextHash(_itemText) != _textHash) {
+                _staleIds.append(_entry.value());         // Renamed since it was filed
+            }
+            continue;                                     // Hash collision with another text
+        }
+        if (!_found) {
+            _found = _item;                               // Common case - one child per text
+            continue;
+        }
+        if (_foundIndex < 0) {
+            _foundIndex = container->indexOfChild(_found);
+        }
+        int _index = container->indexOfChild(_item);      // Duplicate text - keep the earlier sibling
+        if (_index < _foundIndex) {
+            _found = _item;
+            _foundIndex = _index;
+        }
+    }
+
+    for (quint32 _staleId : _staleIds) {
+        PathIndex.remove(_key, _staleId);
+    }
+
+    return _found;
+}
+
+void A_Tree::IndexPathContainer(QTreeWidgetItem *container) const
+{
+    /**
+     * Files every child of a sibling list owner in the path index and marks the list as indexed
+     * @param container Parent item or invisible root item
+     */
+
+    for (int _childIndex = 0; _childIndex < container->childCount(); ++_childIndex) {
+        AddPathIndexEntry(container->child(_childIndex));
+    }
+
+    const int _containerId = container == TreeWidget->invisibleRootItem() ? 0 : int(GetItemId(container));
+    if (_containerId >= PathIndexedBits.size()) {
+        PathIndexedBits.resize(qMax(_containerId + 1, 2 * PathIndexedBits.size()));  // Grow geometrically
+    }
+    PathIndexedBits.setBit(_containerId);
+}
+
+void A_Tree::AddPathIndexEntry(QTreeWidgetItem *item) const
+{
+    /**
+     * Files an item under its parent identifier and current text
+     * @param item Attached item
+     */
+
+    const QString _text = item->text(0);                  // Current text
+    if (_text.isEmpty()) {
+        return;                                           // Empty text is never looked up
+    }
+
+    const quint32 _nodeId = GetItemId(item);              // Value filed under the key
+    const QPair<quint32, uint> _key(item->parent() ? GetItemId(item->parent()) : 0, PathTextHash(_text));
+    if (!PathIndex.contains(_key, _nodeId)) {
+        PathIndex.insert(_key, _nodeId);
+    }
+}
+
+bool A_Tree::IsPathContainerIndexed(quint32 containerId) const
+{
+    /**
+     * Checks the indexed flag of a sibling list owner
+     * @param containerId Parent identifier, 0 for root level
+     * @return True if its children are in the path index
+     */
+
+    return int(containerId) < PathIndexedBits.size() && PathIndexedBits.testBit(int(containerId));
+}
+
+QTreeWidgetItem* A_Tree::ContainerFromIndex(const QModelIndex &index) const
+{
+    /**
+     * Walks from the root level down the rows of a model index - O(depth)
+     * @param index Parent index, invalid for root level
+     * @return Parent item, invisible root item or nullptr
+     */
+
+    QVector<int> _rows;                                   // Rows from index up to root level
+    for (QModelIndex _current = index; _current.isValid(); _current = _current.parent()) {
+        _rows.append(_current.row());
+    }
+
+    QTreeWidgetItem *_item = TreeWidget->invisibleRootItem();  // Current owner
+    for (int _level = _rows.size() - 1; _level >= 0 && _item; --_level) {
+        _item = _item->child(_rows.at(_level));
+    }
+
+    return _item;
+}
+
+void A_Tree::DetachItem(QTreeWidgetItem *item)
+{
+    /**
+     * Removes the item from its parent or the root level; a parent left without children becomes a leaf
+     * @param item Item to detach
+     */
+
+    QTreeWidgetItem *_parent = item->parent();            // Get parent item for state update
+    if (_parent) {
+        _parent->removeChild(item);                       // Remove from parent if it has one
+        // Update parent state after child removal
+        if (_parent->childCount() > 0) {
+            UpdateParentCheckState(_parent->child(0));    // Update using first remaining child
+        } else {
+            SyncCheckedLeafBit(_parent);                  // Parent became a leaf
+        }
+    } else {
+        int _index = TreeWidget->indexOfTopLevelItem(item);  // Find index of root item
+        TreeWidget->takeTopLevelItem(_index);             // Remove root item from tree
+    }
+}
+
+int A_Tree::DestroySubtree(QTreeWidgetItem *item)
+{
+    /**
+     * Removes an item with its subtree from the tree and frees it
+     * @param item Item to delete
+     * @return Number of items deleted
+     */
+
+    int _itemCount = UnregisterSubtree(item);             // Release identifiers and auxiliary state
+    QTreeWidgetItem *_container = item->parent() ? item->parent() : TreeWidget->invisibleRootItem();
+    _container->removeChild(item);                        // Detach from view
+    delete item;                                          // Free subtree
+
+    return _itemCount;
+}
+
+void A_Tree::RefreshCheckStateAfterChange(QTreeWidgetItem *container)
+{
+    /**
+     * Recalculates check state after a sibling list changed
+     * @param container Parent item or invisible root item
+     */
+
+    if (container == TreeWidget->invisibleRootItem()) {
+        return;                                           // Root level has no aggregated state
+    }
+
+    if (container->childCount() > 0) {
+        UpdateParentCheckState(container->child(0));      // Recalculates container and its ancestors
+    }
+    SyncCheckedLeafBit(container);                        // Container may have become a leaf or stopped being one
+}
+
+bool A_Tree::EnableJournal(const QString &directoryPath)
+{
+    /**
+     * Opens a journal and recovers the tree it describes
+     * Recovery restores the last snapshot, then replays every later record with
+     * the recorded identifiers, so replayed records find the same items again
+     * @param directoryPath Journal directory
+     * @return True if journaling is active
+     */
+
+    DisableJournal();                                     // Close any previous journal
+
+    A_TreeJournal *_journal = new A_TreeJournal(this);    // Journal being opened
+    QVector<A_TreeJournal::SnapshotNode> _snapshotNodes;  // Recovered snapshot
+    QVector<A_TreeJournal::Record> _records;              // Records after the snapshot
+    quint32 _nextNodeId = 1;                              // First unused identifier at snapshot time
+    if (!_journal->Open(directoryPath, &_snapshotNodes, &_nextNodeId, &_records)) {
+        delete _journal;
+        return false;                                     // Directory not usable
+    }
+
+    const bool _hasHistory = !_snapshotNodes.isEmpty() || !_records.isEmpty();  // Journal describes a tree
+    if (_hasHistory) {
+        IsInternalUpdate = true;                          // Set flag to prevent recursive signals
+        TreeWidget->setUpdatesEnabled(false);             // One repaint for the whole recovery
+
+        ClearAllItems();                                  // Journal is authoritative - not recorded while Journal is null
+        RestoreJournalSnapshot(_snapshotNodes, _nextNodeId);
+        for (const A_TreeJournal::Record &_record : _records) {
+            ApplyJournalRecord(_record);
+        }
+
+        TreeWidget->setUpdatesEnabled(true);
+        ApplyExpandedState();                             // Restore the session's expand state in one layout
+        IsInternalUpdate = false;                         // Clear flag
+        InvalidateFilterIndex();                          // Whole tree was rebuilt
+    }
+
+    Journal = _journal;                                   // Record mutations from now on
+    connect(Journal, &A_TreeJournal::CompactionRequested, this, &A_Tree::OnJournalCompactionRequested);
+
+    if (!_hasHistory && TreeWidget->topLevelItemCount() > 0) {
+        OnJournalCompactionRequested();                   // Existing tree becomes the starting snapshot
+    }
+
+    return true;
+}
+
+void A_Tree::DisableJournal()
+{
+    /**
+     * Commits buffered records and stops journaling
+     */
+
+    if (!Journal) {
+        return;                                           // Journaling already off
+    }
+
+    Journal->Close();                                     // Commit and wait for compaction
+    delete Journal;
+    Journal = nullptr;
+}
+
+bool A_Tree::ResumeJournal(const QString &directoryPath)
+{
+    /**
+     * Opens the journal, drops what it recovered and records the current tree as the starting snapshot
+     * @param directoryPath Journal directory
+     * @return True if journaling is active
+     */
+
+    DisableJournal();                                     // Close any previous journal
+
+    A_TreeJournal *_journal = new A_TreeJournal(this);    // Journal being opened
+    QVector<A_TreeJournal::SnapshotNode> _snapshotNodes;  // Recovered snapshot - superseded by the current tree
+    QVector<A_TreeJournal::Record> _records;              // Recovered records - superseded too
+    quint32 _nextNodeId = 1;
+    if (!_journal->Open(directoryPath, &_snapshotNodes, &_nextNodeId, &_records)) {
+        delete _journal;
+        return false;                                     // Directory not usable
+    }
+
+    Journal = _journal;                                   // Record mutations from now on
+    connect(Journal, &A_TreeJournal::CompactionRequested, this, &A_Tree::OnJournalCompactionRequested);
+    OnJournalCompactionRequested();                       // Current tree becomes the starting snapshot
+
+    return true;
+}
+
+void A_Tree::EnableJournalInSlices(const QString &directoryPath)
+{
+    /**
+     * Opens the journal right away - its snapshot is mapped and verified here - and schedules the first
+     * building slice, so the window paints before any item is created
+     * @param directoryPath Journal directory
+     */
+
+    DisableJournal();                                     // Close any previous journal
+    PendingRestore.reset(new JournalRestore());
+    JournalRestore &_restore = *PendingRestore;           // Recovery being started
+
+    A_TreeJournal *_journal = new A_TreeJournal(this);    // Journal being opened
+    if (_journal->Open(directoryPath, &_restore.Nodes, &_restore.NextNodeId, &_restore.Records)) {
+        _restore.Journal = _journal;
+        if (!_restore.Nodes.isEmpty() || !_restore.Records.isEmpty()) {
+            ClearAllItems();                              // Journal is authoritative - not recorded while Journal is null
+        }
+    } else {
+        delete _journal;                                  // Directory not usable - reported by the first slice
+    }
+    QTimer::singleShot(0, this, &A_Tree::RunJournalRestoreSlice);
+}
+
+bool A_Tree::IsJournalRestoring() const
+{
+    /**
+     * Gets whether a sliced recovery is running
+     * @return True while slices are pending
+     */
+
+    return PendingRestore != nullptr;
+}
+
+void A_Tree::RunJournalRestoreSlice()
+{
+    /**
+     * Builds snapshot nodes detached and inserts each root item once the next root starts, so the view
+     * grows root by root and the inserted part can be browsed meanwhile; then records are replayed.
+     * The last slice applies the expand state and starts recording
+     */
+
+    if (!PendingRestore) {
+        return;
+    }
+    JournalRestore &_restore = *PendingRestore;           // Running recovery
+
+    if (!_restore.Journal) {
+        PendingRestore.reset();
+        emit JournalRestored(false);                      // Directory not usable
+        return;
+    }
+
+    QElapsedTimer _timer;                                 // Budget of this slice
+    _timer.start();
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+
+    const bool _hasHistory = !_restore.Nodes.isEmpty() || !_restore.Records.isEmpty();  // Journal describes a tree
+    int _stepCount = 0;                                   // Nodes and records handled in this slice
+    bool _isSliceOver = false;                            // Budget used up
+    while (_restore.NodeIndex < _restore.Nodes.size() && !_isSliceOver) {
+        const A_TreeJournal::SnapshotNode &_node = _restore.Nodes.at(_restore.NodeIndex++);
+        if (_node.ParentId == 0 && _restore.PendingRoot) {
+            TreeWidget->addTopLevelItem(_restore.PendingRoot);  // Previous root's subtree is complete
+            _restore.PendingRoot = nullptr;
+        }
+        A_TreeItem *_root = RestoreJournalNode(_node);    // Null for child items
+        if (_root) {
+            _restore.PendingRoot = _root;
+        }
+        _isSliceOver = (++_stepCount & 1023) == 0 && _timer.elapsed() >= SubtreeJobSliceMilliseconds;
+    }
+    if (_restore.NodeIndex == _restore.Nodes.size() && !_isSliceOver) {
+        if (_restore.PendingRoot) {
+            TreeWidget->addTopLevelItem(_restore.PendingRoot);
+            _restore.PendingRoot = nullptr;
+        }
+        if (_restore.RecordIndex == 0 && _hasHistory) {
+            FinishJournalSnapshot(_restore.NextNodeId);   // Once, before the first record
+        }
+        while (_restore.RecordIndex < _restore.Records.size() && !_isSliceOver) {
+            ApplyJournalRecord(_restore.Records.at(_restore.RecordIndex++));
+            _isSliceOver = (++_stepCount & 63) == 0 && _timer.elapsed() >= SubtreeJobSliceMilliseconds;
+        }
+    }
+    IsInternalUpdate = false;                             // Clear flag
+
+    if (_restore.NodeIndex < _restore.Nodes.size() || _restore.RecordIndex < _restore.Records.size()) {
+        QTimer::singleShot(0, this, &A_Tree::RunJournalRestoreSlice);  // Let input and painting run first
+        return;
+    }
+
+    if (_hasHistory) {
+        IsInternalUpdate = true;
+        ApplyExpandedState();                             // Restore the session's expand state in one layout
+        IsInternalUpdate = false;
+        InvalidateFilterIndex();                          // Whole tree was rebuilt
+    }
+
+    Journal = _restore.Journal;                           // Record mutations from now on
+    connect(Journal, &A_TreeJournal::CompactionRequested, this, &A_Tree::OnJournalCompactionRequested);
+    PendingRestore.reset();
+
+    if (!_hasHistory && TreeWidget->topLevelItemCount() > 0) {
+        OnJournalCompactionRequested();                   // Existing tree becomes the starting snapshot
+    }
+    emit JournalRestored(true);
+}
+
+bool A_Tree::IsJournalEnabled() const
+{
+    /**
+     * Gets whether mutations are being journaled
+     * @return True if a journal is open
+     */
+
+    return Journal != nullptr;
+}
+
+void A_Tree::OnJournalCompactionRequested()
+{
+    /**
+     * Captures the current tree in pre-order and hands it to the journal
+     * Only the capture runs here, serialization and sync happen on a worker thread
+     */
+
+    if (!Journal) {
+        return;                                           // Journaling stopped meanwhile
+    }
+
+    QVector<A_TreeJournal::SnapshotNode> _nodes;          // Tree in pre-order
+    if (FrozenTree) {
+        CaptureFrozenSnapshot(&_nodes);
+        Journal->Compact(_nodes, quint32(FrozenTree->GetNodeCount() + 1));
+        if (IsTreeSorted) {
+            JournalSortSpec(nullptr, TreeSortSpec);       // Per-parent configurations do not exist while frozen
+        }
+        return;
+    }
+
+    _nodes.reserve(NodeTable.size());
+    QTreeWidgetItemIterator _iterator(TreeWidget);        // Pre-order iterator over all items, hidden ones included
+    while (*_iterator) {
+        QTreeWidgetItem *_item = *_iterator;              // Current item in iteration
+        A_TreeJournal::SnapshotNode _node;
+        _node.NodeId = GetItemId(_item);
+        _node.ParentId = GetItemId(_item->parent());      // 0 for root items
+        _node.CheckState = quint8(_item->checkState(0));
+        _node.Text = _item->text(0);
+        _node.SyncKey = _item->data(0, A_TreeItem::SyncKeyRole).toString();
+        _node.IsExpanded = ExpandedBits.testBit(int(_node.NodeId));
+        _nodes.append(_node);
+        ++_iterator;
+    }
+
+    Journal->Compact(_nodes, quint32(NodeTable.size()));
+
+    // Snapshots hold items only - sort configurations go to the new segment replayed on top of it
+    if (IsTreeSorted) {
+        JournalSortSpec(nullptr, TreeSortSpec);
+    }
+    for (auto _found = SortedParents.constBegin(); _found != SortedParents.constEnd(); ++_found) {
+        JournalSortSpec(_found.key(), _found.value());
+    }
+}
+
+void A_Tree::CaptureFrozenSnapshot(QVector<A_TreeJournal::SnapshotNode> *nodes) const
+{
+    /**
+     * Walks the encoding in pre-order with a (parent, next child) stack; node n gets identifier n + 1
+     * @param nodes Receives the snapshot nodes
+     */
+
+    nodes->reserve(FrozenTree->GetNodeCount());
+    QVector<QPair<int, int>> _ancestors;                  // Open parents with their next child number
+    _ancestors.append(qMakePair(int(A_TreeSuccinct::NoNode), FrozenTree->GetFirstChild(A_TreeSuccinct::NoNode)));
+    while (!_ancestors.isEmpty()) {
+        QPair<int, int> &_top = _ancestors.last();
+        const int _firstChild = FrozenTree->GetFirstChild(_top.first);
+        if (_firstChild == A_TreeSuccinct::NoNode || _top.second >= _firstChild + FrozenTree->GetChildCount(_top.first)) {
+            _ancestors.removeLast();                      // All children captured
+            continue;
+        }
+
+        const int _node = _top.second++;                  // Next node in pre-order
+        A_TreeJournal::SnapshotNode _snapshotNode;
+        _snapshotNode.NodeId = quint32(_node + 1);
+        _snapshotNode.ParentId = quint32(_top.first + 1); // 0 for root items - NoNode is -1
+        _snapshotNode.CheckState = quint8(FrozenTree->GetCheckState(_node));
+        _snapshotNode.Text = FrozenTree->GetText(_node);
+        _snapshotNode.SyncKey = FrozenSyncKeys.value(_node);
+        _snapshotNode.IsExpanded = FrozenExpandedBits.testBit(_node);
+        nodes->append(_snapshotNode);
+        if (FrozenTree->GetChildCount(_node) > 0) {
+            _ancestors.append(qMakePair(_node, FrozenTree->GetFirstChild(_node)));  // Children next
+        }
+    }
+}
+
+void A_Tree::JournalAddedSubtree(QTreeWidgetItem *item)
+{
+    /**
+     * Appends AddNode records for a new subtree in pre-order
+     * Siblings are emitted in ascending order, so each recorded index is valid at replay time
+     * @param item Root of inserted subtree
+     */
+
+    if (!Journal || !item) {
+        return;                                           // Journaling off
+    }
+
+    QTreeWidgetItem *_container = item->parent() ? item->parent() : TreeWidget->invisibleRootItem();
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Items to record with their child index
+    _pending.append(qMakePair(item, IndexInParent(_container, item)));
+    while (!_pending.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> _entry = _pending.takeLast();
+        A_TreeJournal::Record _record;                    // Record for this item
+        _record.Type = A_TreeJournal::AddNode;
+        _record.NodeId = GetItemId(_entry.first);
+        _record.ParentId = GetItemId(_entry.first->parent());
+        _record.Index = _entry.second;
+        _record.Text = _entry.first->text(0);
+        _record.SyncKey = _entry.first->data(0, A_TreeItem::SyncKeyRole).toString();
+        Journal->Append(_record);
+
+        for (int _childIndex = _entry.first->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            _pending.append(qMakePair(_entry.first->child(_childIndex), _childIndex));  // Reversed so first child pops first
+        }
+    }
+}
+
+void A_Tree::JournalItemRecord(A_TreeJournal::Operation type, QTreeWidgetItem *item)
+{
+    /**
+     * Appends a record built from an item's current state
+     * @param type Operation being recorded
+     * @param item Affected item
+     */
+
+    if (!Journal || !item) {
+        return;                                           // Journaling off
+    }
+
+    A_TreeJournal::Record _record;                        // Record being built
+    _record.Type = type;
+    _record.NodeId = GetItemId(item);
+
+    switch (type) {
+    case A_TreeJournal::SetText:
+        _record.Text = item->text(0);
+        break;
+    case A_TreeJournal::SetCheckState:
+        _record.CheckState = quint8(item->checkState(0));
+        break;
+    case A_TreeJournal::SetExpanded:
+        _record.IsExpanded = ExpandedBits.testBit(int(_record.NodeId));
+        break;
+    case A_TreeJournal::MoveNode:
+        _record.ParentId = GetItemId(item->parent());
+        _record.Index = IndexInParent(item->parent() ? item->parent() : TreeWidget->invisibleRootItem(), item);
+        break;
+    default:
+        break;                                            // RemoveNode needs the identifier only
+    }
+
+    Journal->Append(_record);
+}
+
+void A_Tree::JournalChildOrder(QTreeWidgetItem *container)
+{
+    /**
+     * Appends the identifiers of a sibling list in their current order
+     * @param container Parent item or invisible root item
+     */
+
+    if (!Journal) {
+        return;                                           // Journaling off
+    }
+
+    A_TreeJournal::Record _record;                        // Reorder record
+    _record.Type = A_TreeJournal::SetChildOrder;
+    _record.ParentId = container == TreeWidget->invisibleRootItem() ? 0 : GetItemId(container);
+    _record.ChildOrder.reserve(container->childCount());
+    for (int _childIndex = 0; _childIndex < container->childCount(); ++_childIndex) {
+        _record.ChildOrder.append(GetItemId(container->child(_childIndex)));
+    }
+
+    Journal->Append(_record);
+}
+
+void A_Tree::JournalSortSpec(QTreeWidgetItem *container, const SortSpec &spec)
+{
+    /**
+     * Appends the configuration only - the order it produces is recorded by JournalChildOrder
+     * @param container Parent item or invisible root item - nullptr for the whole tree
+     * @param spec Sort configuration
+     */
+
+    if (!Journal) {
+        return;                                           // Journaling off
+    }
+
+    A_TreeJournal::Record _record;                        // Configuration record
+    _record.Type = container ? A_TreeJournal::SetSortOrder : A_TreeJournal::SetTreeSortOrder;
+    _record.ParentId = (!container || container == TreeWidget->invisibleRootItem()) ? 0 : GetItemId(container);
+    _record.SortMode = quint8(spec.Mode);
+    _record.SortOrder = quint8(spec.Order);
+    _record.SortColumn = spec.AttributeColumn;
+
+    Journal->Append(_record);
+}
+
+void A_Tree::RestoreJournalSnapshot(const QVector<A_TreeJournal::SnapshotNode> &nodes, quint32 nextNodeId)
+{
+    /**
+     * Rebuilds items from snapshot nodes
+     * Every node carries its own check state, so no propagation is needed. Subtrees are built detached
+     * and root items inserted in one step, so the model signals once instead of once per item
+     * @param nodes Snapshot nodes in pre-order
+     * @param nextNodeId First unused identifier at snapshot time
+     */
+
+    QList<QTreeWidgetItem*> _roots;                       // Restored root items in order - inserted last
+    for (const A_TreeJournal::SnapshotNode &_node : nodes) {
+        A_TreeItem *_root = RestoreJournalNode(_node);    // Null for child items
+        if (_root) {
+            _roots.append(_root);
+        }
+    }
+    TreeWidget->addTopLevelItems(_roots);
+    FinishJournalSnapshot(nextNodeId);
+}
+
+A_TreeItem* A_Tree::RestoreJournalNode(const A_TreeJournal::SnapshotNode &node)
+{
+    /**
+     * Creates the item with its recorded identifier, check state and sync key; the expand state is
+     * applied in one batch after recovery
+     * @param node Snapshot node
+     * @return New root item or nullptr
+     */
+
+    QTreeWidgetItem *_container = node.ParentId ? GetItemById(node.ParentId) : nullptr;  // Null for root items
+    if ((node.ParentId && !_container) || node.NodeId == 0 || GetItemById(node.NodeId)) {
+        return nullptr;                                   // Orphaned or duplicate node
+    }
+
+    A_TreeItem *_newItem = CreateItem(node.Text, node.NodeId);
+    if (!node.SyncKey.isEmpty()) {
+        _newItem->setData(0, A_TreeItem::SyncKeyRole, node.SyncKey);  // Restore sync identity
+    }
+    _newItem->setCheckState(0, Qt::CheckState(node.CheckState));
+    ExpandedBits.setBit(int(node.NodeId), node.IsExpanded);  // Applied in one batch after recovery
+    if (_container) {
+        _container->addChild(_newItem);                   // Pre-order lists siblings in order - detached insert
+        return nullptr;
+    }
+    return _newItem;
+}
+
+void A_Tree::FinishJournalSnapshot(quint32 nextNodeId)
+{
+    /**
+     * Grows the tables to the snapshot's identifier range and syncs the bit of every restored leaf
+     * @param nextNodeId First unused identifier at snapshot time
+     */
+
+    if (NodeTable.size() < int(nextNodeId)) {
+        NodeTable.resize(int(nextNodeId));                // Identifiers of deleted items are not reused
+        CheckedLeafBits.resize(NodeTable.size());
+        ExpandedBits.resize(NodeTable.size());
+    }
+
+    for (int _nodeId = 1; _nodeId < NodeTable.size(); ++_nodeId) {
+        A_TreeItem *_item = NodeTable.at(_nodeId);        // Restored item - null for unused identifiers
+        if (_item && _item->childCount() == 0) {
+            SyncCheckedLeafBit(_item);                    // Leaf status is known once all nodes are attached
+        }
+    }
+}
+
+void A_Tree::ApplyJournalRecord(const A_TreeJournal::Record &record)
+{
+    /**
+     * Re-applies one recorded mutation
+     * Positions are taken from the record instead of sort configuration,
+     * check states are derived the same way as during the original change
+     * @param record Recorded mutation
+     */
+
+    QTreeWidgetItem *_item = GetItemById(record.NodeId);  // Affected item - null for unknown identifiers
+    QTreeWidgetItem *_container = record.ParentId ? GetItemById(record.ParentId) : TreeWidget->invisibleRootItem();
+
+    switch (record.Type) {
+    case A_TreeJournal::AddNode: {
+        if (_item || !_container || record.NodeId == 0) {
+            break;                                        // Identifier in use or parent gone
+        }
+        A_TreeItem *_newItem = CreateItem(record.Text, record.NodeId);
+        if (!record.SyncKey.isEmpty()) {
+            _newItem->setData(0, A_TreeItem::SyncKeyRole, record.SyncKey);  // Restore sync identity
+        }
+        int _index = (record.Index >= 0 && record.Index <= _container->childCount()) ? record.Index : _container->childCount();
+        _container->insertChild(_index, _newItem);
+        if (_container != TreeWidget->invisibleRootItem() && _container->checkState(0) != Qt::Unchecked) {
+            RefreshCheckStateAfterChange(_container);     // Unchecked parents stay unchecked - skip the scan
+        }
+        break;
+    }
+    case A_TreeJournal::RemoveNode: {
+        if (!_item) {
+            break;                                        // Already gone
+        }
+        QTreeWidgetItem *_oldContainer = _item->parent() ? _item->parent() : TreeWidget->invisibleRootItem();
+        DestroySubtree(_item);
+        RefreshCheckStateAfterChange(_oldContainer);      // Parent lost a child
+        break;
+    }
+    case A_TreeJournal::SetText:
+        if (_item) {
+            _item->setText(0, record.Text);
+        }
+        break;
+    case A_TreeJournal::SetCheckState:
+        if (_item) {
+            _item->setCheckState(0, Qt::CheckState(record.CheckState));
+            PropagateCheckState(_item);                   // Same propagation as the original change
+        }
+        break;
+    case A_TreeJournal::MoveNode: {
+        if (!_item || !_container) {
+            break;                                        // Item or new parent gone
+        }
+        for (QTreeWidgetItem *_ancestor = _container; _ancestor; _ancestor = _ancestor->parent()) {
+            if (_ancestor == _item) {
+                return;                                   // Cannot move an item into its own subtree
+            }
+        }
+        QTreeWidgetItem *_oldContainer = _item->parent() ? _item->parent() : TreeWidget->invisibleRootItem();
+        bool _wasExpanded = _item->isExpanded();          // View forgets expansion when item is taken out
+        _oldContainer->removeChild(_item);
+        int _index = (record.Index >= 0 && record.Index <= _container->childCount()) ? record.Index : _container->childCount();
+        _container->insertChild(_index, _item);
+        _item->setExpanded(_wasExpanded);
+        RefreshCheckStateAfterChange(_oldContainer);      // Old parent lost a child
+        RefreshCheckStateAfterChange(_container);         // New parent gained a child
+        break;
+    }
+    case A_TreeJournal::SetChildOrder: {
+        if (!_container || _container->childCount() < 2) {
+            break;                                        // Nothing to reorder
+        }
+        const int _listedCount = record.ChildOrder.size(); // Unlisted children keep their order after listed ones
+        for (int _childIndex = 0; _childIndex < _container->childCount(); ++_childIndex) {
+            static_cast<A_TreeItem*>(_container->child(_childIndex))->SortRank = _listedCount + _childIndex;
+        }
+        for (int _rank = 0; _rank < _listedCount; ++_rank) {
+            A_TreeItem *_child = static_cast<A_TreeItem*>(GetItemById(record.ChildOrder.at(_rank)));
+            QTreeWidgetItem *_childContainer = (_child && _child->parent()) ? _child->parent() : TreeWidget->invisibleRootItem();
+            if (_child && _childContainer == _container) {
+                _child->SortRank = _rank;                 // Recorded position
+            }
+        }
+        ApplySortRanks(_container);                       // Apply ranks through the view
+        break;
+    }
+    case A_TreeJournal::SetExpanded:
+        if (_item) {
+            ExpandedBits.setBit(int(record.NodeId), record.IsExpanded);  // Applied in one batch after replay
+        }
+        break;
+    case A_TreeJournal::ClearAll:
+        ClearAllItems();
+        break;
+    case A_TreeJournal::SetSortOrder:
+    case A_TreeJournal::SetTreeSortOrder: {
+        if (record.SortMode > SortByAttribute || record.SortOrder > Qt::DescendingOrder) {
+            break;                                        // Unknown configuration
+        }
+        SortSpec _spec;                                   // Recorded configuration - order follows in SetChildOrder records
+        _spec.Mode = SortMode(record.SortMode);
+        _spec.Order = Qt::SortOrder(record.SortOrder);
+        if (record.Type == A_TreeJournal::SetTreeSortOrder) {
+            TreeSortSpec = _spec;
+            IsTreeSorted = true;
+            SortedParents.clear();                        // Superseded as in SortAllItems
+            break;
+        }
+        if (_spec.Mode == SortByAttribute) {
+            if (record.SortColumn < 0 || record.SortColumn >= Attributes.GetColumnCount()) {
+                break;                                    // Column not registered in this session
+            }
+            _spec.AttributeColumn = record.SortColumn;
+            _spec.AttributeType = Attributes.GetColumnType(record.SortColumn);
+        }
+        if (_container) {
+            SortedParents.insert(_container, _spec);
+        }
+        break;
+    }
+    case A_TreeJournal::ClearSortOrder:
+        SortedParents.clear();
+        IsTreeSorted = false;
+        break;
+    }
+}
+
+void A_Tree::OnItemChanged(QTreeWidgetItem *item, int column)
+{
+    /**
+     * Handles item change events, primarily checkbox state changes
+     * @param item Tree item that changed
+     * @param column Column that changed (should be 0 for text/checkbox)
+     */
+
+    if (!item || column != 0 || IsInternalUpdate) {       // Validate parameters and check for internal update
+        return;                                           // Exit if invalid or during internal update
+    }
+    if (!static_cast<A_TreeItem*>(item)->IsCheckStateChanged) {
+        return;                                           // Text or other data changed - state and subtree are untouched
+    }
+
+    Qt::CheckState _newState = item->checkState(0);       // Get new checkbox state
+    if (item->childCount() > 0 && _newState != Qt::PartiallyChecked) {
+        SetItemCheckedStateAsync(item, _newState == Qt::Checked);  // Subtree in slices - job journals and emits
+        return;
+    }
+
+    IsInternalUpdate = true;                              // Set flag to prevent recursion
+
+    PropagateCheckState(item);                            // Update children and parent chain
+
+    IsInternalUpdate = false;                             // Clear flag
+    JournalItemRecord(A_TreeJournal::SetCheckState, item);  // Persist state - replay propagates it again
+    RepositionCheckSortedItems(item);                     // Lists sorted by check state follow the change
+
+    // Emit signal for checkbox state changes
+    bool _isChecked = (_newState == Qt::Checked);         // Convert to boolean
+    emit ItemCheckStateChanged(item->text(0), _isChecked);  // Emit state change signal
+}
+
+std::shared_ptr<const A_TreeSnapshot> A_Tree::GetSnapshot()
+{
+    /**
+     * Publishes pending changes immediately and returns the resulting snapshot
+     * @return Current snapshot
+     */
+
+    IsSnapshotRequested.store(true);                      // Track changes from now on
+    PublishSnapshot();                                    // No-op if nothing changed
+    return std::atomic_load(&PublishedSnapshot);
+}
+
+std::shared_ptr<const A_TreeSnapshot> A_Tree::AcquireSnapshot() const
+{
+    /**
+     * Returns the latest published snapshot without locking
+     * Readers keep their version alive through the shared pointer; it is freed
+     * when the last reader releases it, so publishing never waits for readers
+     * @return Latest published snapshot
+     */
+
+    if (!IsSnapshotRequested.exchange(true)) {
+        // First request - publish on the GUI thread as soon as it is idle
+        QMetaObject::invokeMethod(const_cast<A_Tree*>(this), "PublishSnapshot", Qt::QueuedConnection);
+    }
+
+    return std::atomic_load(&PublishedSnapshot);
+}
+
+bool A_Tree::ShareTree(const QString &key)
+{
+    /**
+     * Becomes the store's writer and publishes the current tree
+     * @return True on success
+     */
+
+    if (IsCompact || IsSharedReader || FrozenTree) {
+        return false;                                     // No snapshots to publish, or content is not ours
+    }
+
+    const std::shared_ptr<const A_TreeSnapshot> _snapshot = GetSnapshot();  // Also turns on snapshot tracking
+    if (!SharedStore.CreateWriter(key)) {
+        return false;
+    }
+
+    return SharedStore.Publish(*_snapshot);
+}
+
+bool A_Tree::AttachSharedTree(const QString &key)
+{
+    /**
+     * Attaches read-only, loads the current content and starts polling
+     * @return True on success
+     */
+
+    if (FrozenTree) {
+        return false;                                     // Loaded items would stay hidden
+    }
+    DetachSharedTree();
+    if (!SharedStore.AttachReader(key)) {
+        return false;
+    }
+
+    DisableJournal();                                     // Content is persisted by the writer
+    IsSharedReader = true;
+    SetEditMode(false);
+    SharedSequence = 1;                                   // Force the first load
+    SharedContent.reset();                                // First load replaces all items
+    PollSharedTree();
+    SharedPollTimer->start();
+
+    return true;
+}
+
+void A_Tree::DetachSharedTree()
+{
+    /**
+     * Detaches from the store; viewer items get their check boxes back
+     */
+
+    SharedPollTimer->stop();
+    SharedStore.Detach();
+    SharedContent.reset();
+    if (!IsSharedReader) {
+        return;
+    }
+
+    IsSharedReader = false;
+    for (A_TreeItem *_item : std::as_const(NodeTable)) {
+        if (_item) {
+            _item->setFlags(_item->flags() | Qt::ItemIsUserCheckable);
+        }
     }
 }
 
-bool A_Tree::GetEditMode() const
+bool A_Tree::IsSharedTreeReader() const
 {
     /**
-     * Gets the current edit mode state
-     * @return True if editing is enabled, false if read-only
+     * Gets the reader flag
+     * @return True while attached as reader
      */
 
-    return IsEditModeEnabled;                             // Return current edit mode state
+    return IsSharedReader;
 }
 
-bool A_Tree::GetItemCheckedState(QTreeWidgetItem *item) const
+QString A_Tree::GetSharedTreeError() const
 {
     /**
-     * Gets the checked state of specified item
-     * @param item Tree item to check
-     * @return True if item is checked, false if unchecked or item invalid
+     * Gets the store's last error
+     * @return Error text
      */
 
-    if (!item) {                                          // Validate item pointer
-        return false;                                     // Return false for invalid item
+    return SharedStore.GetErrorString();
+}
+
+bool A_Tree::FreezeTree()
+{
+    /**
+     * Encodes the items breadth-first, drops them and shows the encoding through a model/view.
+     * Sync keys and expand bits are kept by node number next to the encoding; attribute values and
+     * per-parent sort configurations have no place there, so a tree with them is not frozen
+     * @return True on success
+     */
+
+    if (FrozenTree || IsSharedReader || IsSubtreeJobRunning() || IsExportRunning()) {
+        return false;                                     // Items are in use or not ours
+    }
+    for (auto _found = SortedParents.constBegin(); _found != SortedParents.constEnd(); ++_found) {
+        if (_found.key() != TreeWidget->invisibleRootItem()) {
+            return false;                                 // Configuration belongs to an item that would be dropped
+        }
+    }
+    for (int _column = 0; _column < Attributes.GetColumnCount(); ++_column) {
+        if (Attributes.GetPresenceBits(_column).count(true) > 0) {
+            return false;                                 // Attribute values would be lost
+        }
     }
 
-    return item->checkState(0) == Qt::Checked;            // Return true if item is checked
+    std::unique_ptr<A_TreeSuccinct> _tree(new A_TreeSuccinct());  // Encoding being built
+    QVector<QTreeWidgetItem*> _queue;                     // Items in breadth-first order - grows while walked
+    _queue.reserve(NodeTable.size());
+    for (int _rootIndex = 0; _rootIndex < TreeWidget->topLevelItemCount(); ++_rootIndex) {
+        _queue.append(TreeWidget->topLevelItem(_rootIndex));
+    }
+    QHash<int, QString> _syncKeys;                        // Sync keys by node number
+    QBitArray _expandedBits(NodeTable.size());            // Expand bits by node number
+    _tree->BeginBuild(_queue.size());
+    for (int _index = 0; _index < _queue.size(); ++_index) {
+        QTreeWidgetItem *_item = _queue.at(_index);
+        _tree->AddNode(_item->text(0), _item->childCount(), _item->checkState(0));
+        const QVariant _syncKey = _item->data(0, A_TreeItem::SyncKeyRole);  // Identity of keyed syncs
+        if (_syncKey.isValid()) {
+            _syncKeys.insert(_index, _syncKey.toString());
+        }
+        _expandedBits.setBit(_index, ExpandedBits.testBit(int(GetItemId(_item))));
+        for (int _childIndex = 0; _childIndex < _item->childCount(); ++_childIndex) {
+            _queue.append(_item->child(_childIndex));
+        }
+    }
+    _queue.clear();
+    if (!_tree->EndBuild()) {
+        return false;
+    }
+
+    FrozenJournalPath = Journal ? Journal->GetDirectoryPath() : QString();  // Reopened with the thawed tree
+    DisableJournal();                                     // Frozen nodes have no identifiers to record
+    ClearAllItems();
+    FrozenTree = std::move(_tree);
+    FrozenSyncKeys = _syncKeys;
+    FrozenExpandedBits = _expandedBits;
+
+    FrozenModel = new A_TreeFrozenModel(FrozenTree.get(), FrozenPageSize, this);
+    FrozenView = new QTreeView(this);                     // Asks the model only for visible rows
+    FrozenView->setModel(FrozenModel);
+    FrozenView->setSelectionMode(QAbstractItemView::SingleSelection);  // Same behavior as the tree widget
+    FrozenView->setRootIsDecorated(true);
+    FrozenView->setAlternatingRowColors(true);
+    FrozenView->setUniformRowHeights(true);               // Row heights are not measured per row
+    QWidget *_viewport = FrozenView->viewport();          // Repainted whole on any check change
+    connect(FrozenModel, &QAbstractItemModel::dataChanged, _viewport, [_viewport]() {
+        _viewport->update();                              // Covers visible descendants the model does not list
+    });
+    MainLayout->addWidget(FrozenView);
+    TreeWidget->hide();
+
+    return true;
 }
 
-void A_Tree::SetItemCheckedState(QTreeWidgetItem *item, bool checked)
+bool A_Tree::ThawTree()
 {
     /**
-     * Sets the checked state of specified item
-     * @param item Tree item to modify
-     * @param checked New checked state
+     * Creates one item per node detached from the view with its kept sync key and expand bit,
+     * links each sibling run to its parent and inserts the root items in one step
+     * @return True on success
      */
 
-    if (!item) {                                          // Validate item pointer
-        return;                                           // Exit if item is invalid
+    if (!FrozenTree) {
+        return false;
     }
 
     IsInternalUpdate = true;                              // Set flag to prevent recursive signals
-    item->setCheckState(0, checked ? Qt::Checked : Qt::Unchecked);  // Set checkbox state
-    UpdateChildrenCheckState(item);                       // Update children to match
-    UpdateParentCheckState(item);                         // Update parent based on siblings
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole content
+
+    const int _nodeCount = FrozenTree->GetNodeCount();    // Items to create
+    QVector<A_TreeItem*> _items(_nodeCount);              // Created items by node number
+    for (int _node = 0; _node < _nodeCount; ++_node) {
+        A_TreeItem *_item = CreateItem(FrozenTree->GetText(_node));
+        const Qt::CheckState _state = FrozenTree->GetCheckState(_node);
+        _item->setCheckState(0, _state);
+        if (FrozenTree->GetChildCount(_node) == 0) {
+            CheckedLeafBits.setBit(int(_item->NodeId), _state == Qt::Checked);
+        }
+        const QString _syncKey = FrozenSyncKeys.value(_node);  // Empty unless the item was synced by key
+        if (!_syncKey.isEmpty()) {
+            _item->setData(0, A_TreeItem::SyncKeyRole, _syncKey);
+        }
+        ExpandedBits.setBit(int(_item->NodeId), FrozenExpandedBits.testBit(_node));
+        _items[_node] = _item;
+    }
+    for (int _node = 0; _node < _nodeCount; ++_node) {
+        const int _firstChild = FrozenTree->GetFirstChild(_node);
+        const int _childCount = FrozenTree->GetChildCount(_node);
+        for (int _child = _firstChild; _child < _firstChild + _childCount; ++_child) {
+            _items.at(_node)->addChild(_items.at(_child));  // Detached insert - no view cost
+        }
+    }
+
+    QList<QTreeWidgetItem*> _roots;                       // Root items in order
+    const int _rootCount = FrozenTree->GetChildCount(A_TreeSuccinct::NoNode);
+    for (int _node = 0; _node < _rootCount; ++_node) {
+        _roots.append(_items.at(_node));
+    }
+    TreeWidget->addTopLevelItems(_roots);
+    ApplyExpandedState();
+
+    TreeWidget->setUpdatesEnabled(true);
     IsInternalUpdate = false;                             // Clear flag
 
-    emit ItemCheckStateChanged(item->text(0), checked);   // Emit signal with state change
+    delete FrozenView;
+    FrozenView = nullptr;
+    delete FrozenModel;
+    FrozenModel = nullptr;
+    FrozenTree.reset();
+    FrozenSyncKeys.clear();
+    FrozenExpandedBits.clear();
+    TreeWidget->show();
+    InvalidateFilterIndex();                              // Re-apply an active filter to the new items
+
+    if (!FrozenJournalPath.isEmpty()) {
+        ResumeJournal(FrozenJournalPath);                 // Thawed tree with its new identifiers replaces the recorded one
+        FrozenJournalPath.clear();
+    }
+
+    return true;
 }
 
-void A_Tree::OnItemChanged(QTreeWidgetItem *item, int column)
+void A_Tree::SetFrozenPageSize(int pageSize)
 {
     /**
-     * Handles item change events, primarily checkbox state changes
-     * @param item Tree item that changed
-     * @param column Column that changed (should be 0 for text/checkbox)
+     * Stores the bucket size and regroups a current frozen view
+     * @param pageSize Children per bucket
      */
 
-    if (!item || column != 0 || IsInternalUpdate) {       // Validate parameters and check for internal update
-        return;                                           // Exit if invalid or during internal update
+    FrozenPageSize = qMax(0, pageSize);
+    if (FrozenModel) {
+        FrozenModel->SetPageSize(FrozenPageSize);
     }
+}
 
-    IsInternalUpdate = true;                              // Set flag to prevent recursion
+int A_Tree::GetFrozenPageSize() const
+{
+    /**
+     * Gets the bucket size
+     * @return Children per bucket
+     */
 
-    Qt::CheckState _newState = item->checkState(0);       // Get new checkbox state
+    return FrozenPageSize;
+}
+
+bool A_Tree::IsTreeFrozen() const
+{
+    /**
+     * Gets whether an encoding replaces the items
+     * @return True while frozen
+     */
+
+    return FrozenTree != nullptr;
+}
+
+const A_TreeSuccinct* A_Tree::GetFrozenTree() const
+{
+    /**
+     * Gets the encoding
+     * @return Encoded tree or nullptr
+     */
 
-    // Update children to match parent state
-    if (_newState != Qt::PartiallyChecked) {
-        UpdateChildrenCheckState(item);                   // Update all children
+    return FrozenTree.get();
+}
+
+void A_Tree::PollSharedTree()
+{
+    /**
+     * Compares the sequence counter with the loaded one and copies the content only on change
+     */
+
+    const quint64 _sequence = SharedStore.GetSequence();  // Counter in shared memory
+    if (!IsSharedReader || _sequence == SharedSequence || (_sequence & 1)) {
+        return;                                           // Unchanged or writer busy - next poll retries
     }
 
-    // Update parent states up the tree
-    UpdateParentCheckState(item);                         // Update parent chain
+    quint64 _readSequence = 0;                            // Sequence of the copied content
+    const std::shared_ptr<const A_TreeSnapshot> _snapshot = SharedStore.Read(&_readSequence);
+    if (!_snapshot) {
+        return;
+    }
 
+    SharedSequence = _readSequence;
+    LoadSharedSnapshot(_snapshot);
+    emit SharedTreeUpdated(_snapshot->GetNodeCount());
+}
+
+void A_Tree::LoadSharedSnapshot(const std::shared_ptr<const A_TreeSnapshot> &snapshot)
+{
+    /**
+     * Builds the root items' subtrees detached from the view and inserts them in one step on the first
+     * load; later versions only touch the items of blocks the store did not share with the loaded one
+     */
+
+    const std::shared_ptr<const A_TreeSnapshot> _previous = SharedContent;  // Loaded version - nullptr before the first load
+    SharedContent = snapshot;
+    if (_previous) {
+        ApplySharedSnapshotDelta(*_previous, *snapshot);
+        return;
+    }
+
+    const QBitArray _expandedBits = ExpandedBits;         // Identifiers are the writer's, so bits stay meaningful
+    const bool _isFirstLoad = NodeTable.size() <= 1;      // Nothing loaded yet - expand root items
+
+    ClearAllItems();
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole content
+
+    QVector<A_TreeItem*> _items(snapshot->GetNodeCount());  // Created items by snapshot position
+    QList<QTreeWidgetItem*> _roots;                       // Root items in order
+    for (int _index = 0; _index < _items.size(); ++_index) {
+        A_TreeItem *_item = CreateItem(snapshot->GetText(_index), snapshot->GetNodeId(_index));
+        const Qt::CheckState _state = snapshot->GetCheckState(_index);
+        _item->setCheckState(0, _state);
+        _item->setFlags(_item->flags() & ~(Qt::ItemIsUserCheckable | Qt::ItemIsEditable));  // Viewer is read-only
+        if (snapshot->GetSubtreeEnd(_index) == _index + 1) {
+            CheckedLeafBits.setBit(int(_item->NodeId), _state == Qt::Checked);
+        }
+        const int _parentIndex = snapshot->GetParentIndex(_index);  // Parent may sit in an earlier block
+        if (_parentIndex >= 0) {
+            _items.at(_parentIndex)->addChild(_item);     // Detached insert - no view cost
+        } else {
+            _roots.append(_item);
+        }
+        _items[_index] = _item;
+    }
+    TreeWidget->addTopLevelItems(_roots);
+
+    if (_isFirstLoad) {
+        for (QTreeWidgetItem *_root : std::as_const(_roots)) {
+            ExpandedBits.setBit(int(GetItemId(_root)));   // Show the first level
+        }
+    } else {
+        const int _bitCount = qMin(_expandedBits.size(), ExpandedBits.size());
+        for (int _nodeId = 1; _nodeId < _bitCount; ++_nodeId) {
+            ExpandedBits.setBit(_nodeId, _expandedBits.testBit(_nodeId));
+        }
+    }
+    ApplyExpandedState();
+
+    TreeWidget->setUpdatesEnabled(true);
     IsInternalUpdate = false;                             // Clear flag
+    InvalidateFilterIndex();                              // Re-apply an active filter to the new items
+}
 
-    // Emit signal for checkbox state changes
-    bool _isChecked = (_newState == Qt::Checked);         // Convert to boolean
-    emit ItemCheckStateChanged(item->text(0), _isChecked);  // Emit state change signal
+void A_Tree::ApplySharedSnapshotDelta(const A_TreeSnapshot &previous, const A_TreeSnapshot &snapshot)
+{
+    /**
+     * Blocks the reader shared with the loaded version are the same objects, so everything else changed:
+     * items of new blocks are created or updated in place, items only dropped blocks held are deleted,
+     * and the child lists around new blocks are put in the snapshot's order. Items keep their expansion
+     * unless they were taken out of a reordered list, which restores it from ExpandedBits
+     * @param previous Loaded version
+     * @param snapshot New version
+     */
+
+    QSet<const A_TreeSnapshot::Block*> _previousBlocks;   // Blocks of the loaded version
+    for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : previous.GetBlocks()) {
+        _previousBlocks.insert(_block.get());
+    }
+    QSet<const A_TreeSnapshot::Block*> _currentBlocks;    // Blocks of the new version
+    for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : snapshot.GetBlocks()) {
+        _currentBlocks.insert(_block.get());
+    }
+
+    const bool _wasInternalUpdate = IsInternalUpdate;     // Polls may run inside a change handler
+    IsInternalUpdate = true;                              // Set flag to prevent recursive signals
+    TreeWidget->setUpdatesEnabled(false);                 // One repaint for the whole change
+
+    // Create or update the items of new blocks
+    QHash<quint32, quint32> _parentIds;                   // Parent identifier per item of a new block - 0 for root items
+    QHash<quint32, int> _containerPositions;              // Snapshot position of each list to reorder - -1 for the root level
+    const QVector<std::shared_ptr<const A_TreeSnapshot::Block>> &_blocks = snapshot.GetBlocks();
+    for (int _blockNumber = 0; _blockNumber < _blocks.size(); ++_blockNumber) {
+        const A_TreeSnapshot::Block &_block = *_blocks.at(_blockNumber);
+        if (_previousBlocks.contains(&_block)) {
+            continue;                                     // Items are up to date
+        }
+        const int _offset = snapshot.GetBlockOffset(_blockNumber);  // Position of the block's first item
+        for (int _local = 0; _local < _block.NodeIds.size(); ++_local) {
+            const int _position = _offset + _local;
+            const quint32 _nodeId = _block.NodeIds.at(_local);
+            const Qt::CheckState _state = Qt::CheckState(_block.CheckStates.at(_local));
+            A_TreeItem *_item = NodeTable.value(int(_nodeId));  // Null for items new to this reader
+            if (!_item) {
+                _item = CreateItem(_block.Texts.at(_local), _nodeId);
+                _item->setFlags(_item->flags() & ~(Qt::ItemIsUserCheckable | Qt::ItemIsEditable));  // Viewer is read-only
+            } else if (_item->text(0) != _block.Texts.at(_local)) {
+                _item->setText(0, _block.Texts.at(_local));
+            }
+            if (_item->checkState(0) != _state) {
+                _item->setCheckState(0, _state);
+            }
+            CheckedLeafBits.setBit(int(_nodeId), _state == Qt::Checked && snapshot.GetSubtreeEnd(_position) == _position + 1);
+
+            const int _parentPosition = snapshot.GetParentIndex(_position);  // May sit in an earlier block
+            const quint32 _parentId = _parentPosition < 0 ? 0 : snapshot.GetNodeId(_parentPosition);
+            _parentIds.insert(_nodeId, _parentId);
+            _containerPositions.insert(_parentId, _parentPosition);
+            _containerPositions.insert(_nodeId, _position);  // Children may have been added or moved
+        }
+    }
+
+    // Detach the children of lists whose order changed
+    QHash<QTreeWidgetItem*, QList<QTreeWidgetItem*>> _childLists;  // New child list per reordered container
+    for (QHash<quint32, int>::const_iterator _entry = _containerPositions.constBegin(); _entry != _containerPositions.constEnd(); ++_entry) {
+        QTreeWidgetItem *_container = _entry.key() == 0 ? TreeWidget->invisibleRootItem() : GetItemById(_entry.key());
+        if (!_container) {
+            continue;
+        }
+        const int _end = _entry.value() < 0 ? snapshot.GetNodeCount() : snapshot.GetSubtreeEnd(_entry.value());
+        QList<QTreeWidgetItem*> _children;                // Children in snapshot order
+        bool _isSame = true;                              // Current list already matches
+        for (int _child = _entry.value() + 1; _child < _end; _child = snapshot.GetSubtreeEnd(_child)) {
+            QTreeWidgetItem *_item = GetItemById(snapshot.GetNodeId(_child));
+            _isSame = _isSame && _children.size() < _container->childCount() && _container->child(_children.size()) == _item;
+            _children.append(_item);
+        }
+        if (_isSame && _children.size() == _container->childCount()) {
+            continue;
+        }
+        _container->takeChildren();
+        _childLists.insert(_container, _children);
+    }
+
+    // Detach moved items still under their old parent, then delete items no block holds anymore
+    for (QHash<quint32, quint32>::const_iterator _entry = _parentIds.constBegin(); _entry != _parentIds.constEnd(); ++_entry) {
+        QTreeWidgetItem *_item = GetItemById(_entry.key());
+        QTreeWidgetItem *_parent = _item->parent();       // Null for root items and detached items
+        if (_parent && GetItemId(_parent) != _entry.value()) {
+            _parent->removeChild(_item);
+        } else if (!_parent && _item->treeWidget() && _entry.value() != 0) {
+            TreeWidget->takeTopLevelItem(TreeWidget->indexOfTopLevelItem(_item));
+        }
+    }
+    for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : previous.GetBlocks()) {
+        if (_currentBlocks.contains(_block.get())) {
+            continue;
+        }
+        for (quint32 _nodeId : std::as_const(_block->NodeIds)) {
+            QTreeWidgetItem *_item = GetItemById(_nodeId);  // Null once deleted with an ancestor
+            if (!_item || _parentIds.contains(_nodeId)) {
+                continue;                                 // Gone already, or held by a new block
+            }
+            if (_item->parent()) {
+                _item->parent()->removeChild(_item);
+            } else if (_item->treeWidget()) {
+                TreeWidget->takeTopLevelItem(TreeWidget->indexOfTopLevelItem(_item));
+            }
+            UnregisterSubtree(_item);
+            delete _item;
+        }
+    }
+
+    // Attach the reordered lists and restore expansion of the re-attached items
+    for (QHash<QTreeWidgetItem*, QList<QTreeWidgetItem*>>::const_iterator _entry = _childLists.constBegin(); _entry != _childLists.constEnd(); ++_entry) {
+        QTreeWidgetItem *_container = _entry.key();
+        _container->addChildren(_entry.value());
+        if (_container != TreeWidget->invisibleRootItem() && !_container->isExpanded()) {
+            continue;                                     // Expanded with the container through OnItemExpanded
+        }
+        for (QTreeWidgetItem *_child : _entry.value()) {
+            if (_child->childCount() > 0 && !_child->isExpanded() && ExpandedBits.testBit(int(GetItemId(_child)))) {
+                _child->setExpanded(true);                // Cascades through OnItemExpanded
+            }
+        }
+    }
+
+    TreeWidget->setUpdatesEnabled(true);
+    IsInternalUpdate = _wasInternalUpdate;                // Restore flag
+    InvalidateFilterIndex();                              // Re-apply an active filter to the changed items
+}
+
+void A_Tree::PublishSnapshot()
+{
+    /**
+     * Builds and publishes a new snapshot version
+     * Walks the sibling lists block by block; blocks without changes are taken over from the previous version
+     */
+
+    IsSnapshotPublishPending = false;
+    if (!IsSnapshotStale || !IsSnapshotRequested.load() || IsCompact) {
+        return;                                           // Nothing changed, nobody reads snapshots or compact mode
+    }
+
+    std::shared_ptr<const A_TreeSnapshot> _previous = std::atomic_load(&PublishedSnapshot);  // Source of reusable blocks
+    QHash<quint32, std::shared_ptr<const A_TreeSnapshot::Block>> _reusableBlocks;  // Unchanged blocks by first node identifier
+    if (!IsSnapshotAllDirty) {
+        _reusableBlocks.reserve(_previous->GetBlocks().size());
+        for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : _previous->GetBlocks()) {
+            if (!DirtySnapshotBlocks.contains(_block->NodeIds.first())) {
+                _reusableBlocks.insert(_block->NodeIds.first(), _block);
+            }
+        }
+    }
+    SnapshotBlockKeys.resize(NodeTable.size());
+
+    QVector<std::shared_ptr<const A_TreeSnapshot::Block>> _blocks;  // Blocks of the new version in pre-order
+    _blocks.reserve(_previous->GetBlocks().size() + 1);
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Sibling lists being walked with their next child index
+    _pending.append(qMakePair(TreeWidget->invisibleRootItem(), 0));
+    while (!_pending.isEmpty()) {
+        QTreeWidgetItem *_container = _pending.last().first;  // Owner of the sibling list
+        const int _childIndex = _pending.last().second;   // First child not yet in a block
+        if (_childIndex >= _container->childCount()) {
+            _pending.removeLast();                        // Sibling list done
+            continue;
+        }
+
+        QTreeWidgetItem *_child = _container->child(_childIndex);
+        std::shared_ptr<const A_TreeSnapshot::Block> _block = _reusableBlocks.value(GetItemId(_child));
+        if (_block && !IsSnapshotBlockReusable(*_block, _container, _childIndex)) {
+            _block.reset();                               // Same first item, different sibling list
+        }
+        if (!_block) {
+            _block = BuildSnapshotBlock(_container, _childIndex, _reusableBlocks);  // New or changed items
+        }
+        _blocks.append(_block);
+
+        if (_block->IsOpen) {
+            _pending.last().second = _childIndex + 1;
+            _pending.append(qMakePair(_child, _block->LeadCount));  // Remaining children go to later blocks
+        } else {
+            _pending.last().second = _childIndex + _block->RunCount;
+        }
+    }
+
+    std::shared_ptr<const A_TreeSnapshot> _snapshot = std::make_shared<const A_TreeSnapshot>(++SnapshotVersion, _blocks);
+    std::atomic_store(&PublishedSnapshot, _snapshot);     // Readers switch to new version
+    if (SharedStore.IsWriter()) {
+        SharedStore.Publish(*_snapshot);                  // Viewer processes pick it up on their next poll
+    }
+
+    DirtySnapshotBlocks.clear();
+    IsSnapshotAllDirty = false;
+    IsSnapshotStale = false;
+}
+
+void A_Tree::MarkSnapshotDirty(const QModelIndex &index)
+{
+    /**
+     * Resolves the item only while snapshots are tracked - model signals arrive for every change
+     * @param index Changed item or parent of changed rows - invalid for root level changes
+     */
+
+    if (!IsSnapshotRequested.load(std::memory_order_relaxed) || IsCompact) {
+        return;                                           // Nobody reads snapshots - first publish rebuilds everything
+    }
+    MarkSnapshotDirty(ContainerFromIndex(index));
+}
+
+void A_Tree::MarkSnapshotDirty(QTreeWidgetItem *item)
+{
+    /**
+     * Records a change inside the block holding an item and schedules a coalesced publish
+     * Items not yet in a block are picked up through their parent's block or as new blocks
+     * @param item Changed item or owner of changed rows - invisible root item or nullptr for root level changes
+     */
+
+    if (!IsSnapshotRequested.load(std::memory_order_relaxed) || IsCompact) {
+        return;                                           // Nobody reads snapshots - first publish rebuilds everything
+    }
+
+    if (!IsSnapshotAllDirty && item && item != TreeWidget->invisibleRootItem()) {
+        const quint32 _nodeId = GetItemId(item);
+        if (int(_nodeId) < SnapshotBlockKeys.size() && SnapshotBlockKeys.at(int(_nodeId)) != 0) {
+            DirtySnapshotBlocks.insert(SnapshotBlockKeys.at(int(_nodeId)));  // Block holding the item
+        }
+    }
+
+    IsSnapshotStale = true;
+    if (!IsSnapshotPublishPending) {
+        IsSnapshotPublishPending = true;
+        QTimer::singleShot(0, this, &A_Tree::PublishSnapshot);  // One publish per event loop pass
+    }
+}
+
+void A_Tree::MarkSnapshotChildrenDirty(QTreeWidgetItem *container)
+{
+    /**
+     * Records a reorder of a sibling list - every block holding one of the children may be cut differently
+     * @param container Owner of the reordered children
+     */
+
+    if (!IsSnapshotRequested.load(std::memory_order_relaxed) || IsCompact) {
+        return;
+    }
+    MarkSnapshotDirty(container);
+    for (int _childIndex = 0; container && _childIndex < container->childCount(); ++_childIndex) {
+        MarkSnapshotDirty(container->child(_childIndex));
+    }
+}
+
+void A_Tree::MarkSnapshotAllDirty()
+{
+    /**
+     * Records a change that may affect every block
+     */
+
+    IsSnapshotAllDirty = true;
+    DirtySnapshotBlocks.clear();                          // Superseded by full rebuild
+    MarkSnapshotDirty(nullptr);
+}
+
+bool A_Tree::IsSnapshotBlockReusable(const A_TreeSnapshot::Block &block, QTreeWidgetItem *container, int childIndex) const
+{
+    /**
+     * A run is still cut the same way if its last item is where it was; an open block only needs the
+     * children it leads with - changes inside either mark the block dirty
+     * @return True if the block describes the items at this position
+     */
+
+    const quint32 _parentId = container == TreeWidget->invisibleRootItem() ? 0 : GetItemId(container);
+    if (block.ParentId != _parentId) {
+        return false;                                     // Item moved to another sibling list
+    }
+    if (block.IsOpen) {
+        return container->child(childIndex)->childCount() >= block.LeadCount;
+    }
+    const int _lastIndex = childIndex + block.RunCount - 1;  // Position of the run's last item
+    return _lastIndex < container->childCount() && GetItemId(container->child(_lastIndex)) == block.LastId;
+}
+
+std::shared_ptr<const A_TreeSnapshot::Block> A_Tree::BuildSnapshotBlock(QTreeWidgetItem *container, int firstIndex,
+                                                                         const QHash<quint32, std::shared_ptr<const A_TreeSnapshot::Block>> &reusableBlocks)
+{
+    /**
+     * Packs whole sibling subtrees into a run while they fit the block size; a first subtree that is too
+     * large becomes an open block holding the item and as many leading children as fit
+     * @param container Owner of the sibling list
+     * @param firstIndex Child index of the block's first item
+     * @param reusableBlocks Unchanged blocks - a run stops before the first item of one
+     * @return Immutable block
+     */
+
+    std::shared_ptr<A_TreeSnapshot::Block> _block = std::make_shared<A_TreeSnapshot::Block>();  // Block being filled
+    _block->ParentId = container == TreeWidget->invisibleRootItem() ? 0 : GetItemId(container);
+
+    QTreeWidgetItem *_first = container->child(firstIndex);  // Block's first item
+    if (CountSubtreeNodes(_first, SnapshotBlockNodes) > SnapshotBlockNodes) {
+        _block->IsOpen = true;
+        _block->RunCount = 1;
+        _block->LastId = GetItemId(_first);
+        _block->NodeIds.append(_block->LastId);
+        _block->ParentIndexes.append(-1);
+        _block->SubtreeEnds.append(1);                    // Set once the leading children are in
+        _block->CheckStates.append(quint8(_first->checkState(0)));
+        _block->Texts.append(_first->text(0));
+        int _budget = SnapshotBlockNodes - 1;             // Nodes left for leading children
+        for (int _childIndex = 0; _childIndex < _first->childCount(); ++_childIndex) {
+            const int _nodeCount = CountSubtreeNodes(_first->child(_childIndex), _budget);
+            if (_nodeCount > _budget) {
+                break;                                    // Remaining children go to later blocks
+            }
+            AppendSnapshotSubtree(_block.get(), _first->child(_childIndex), 0);
+            _budget -= _nodeCount;
+            _block->LeadCount++;
+        }
+        _block->SubtreeEnds[0] = _block->NodeIds.size();  // Block-local part of the subtree
+    } else {
+        int _budget = SnapshotBlockNodes;                 // Nodes left for further siblings
+        for (int _childIndex = firstIndex; _childIndex < container->childCount(); ++_childIndex) {
+            QTreeWidgetItem *_item = container->child(_childIndex);
+            if (_childIndex > firstIndex && reusableBlocks.contains(GetItemId(_item))) {
+                break;                                    // Unchanged block starts here
+            }
+            const int _nodeCount = CountSubtreeNodes(_item, _budget);
+            if (_nodeCount > _budget) {
+                break;
+            }
+            AppendSnapshotSubtree(_block.get(), _item, -1);
+            _budget -= _nodeCount;
+            _block->RunCount++;
+            _block->LastId = GetItemId(_item);
+        }
+    }
+
+    const quint32 _blockKey = _block->NodeIds.first();    // Blocks are found by their first node
+    for (quint32 _nodeId : std::as_const(_block->NodeIds)) {
+        SnapshotBlockKeys[int(_nodeId)] = _blockKey;
+    }
+    A_TreeHashes::HashBlock(_block.get());                // Once per block - comparisons read the stored hashes
+
+    return _block;
+}
+
+void A_Tree::AppendSnapshotSubtree(A_TreeSnapshot::Block *block, QTreeWidgetItem *item, int parentIndex) const
+{
+    /**
+     * Flattens a subtree in pre-order into the block's parallel arrays
+     * @param block Block being filled
+     * @param item Subtree root
+     * @param parentIndex Block-local position of the item's parent - -1 for top level items
+     */
+
+    const int _begin = block->NodeIds.size();            // Position of the subtree root
+    QVector<QPair<QTreeWidgetItem*, int>> _pending;       // Items to visit with their parent position
+    _pending.append(qMakePair(item, parentIndex));
+    while (!_pending.isEmpty()) {
+        QPair<QTreeWidgetItem*, int> _entry = _pending.takeLast();
+        const int _position = block->NodeIds.size();     // Pre-order position of this item
+        block->NodeIds.append(GetItemId(_entry.first));
+        block->ParentIndexes.append(_entry.second);
+        block->SubtreeEnds.append(_position + 1);        // Extended by descendants below
+        block->CheckStates.append(quint8(_entry.first->checkState(0)));
+        block->Texts.append(_entry.first->text(0));
+        for (int _childIndex = _entry.first->childCount() - 1; _childIndex >= 0; --_childIndex) {
+            _pending.append(qMakePair(_entry.first->child(_childIndex), _position));  // Reversed so first child comes first
+        }
+    }
+
+    for (int _position = block->NodeIds.size() - 1; _position > _begin; --_position) {
+        int _parent = block->ParentIndexes.at(_position);  // Descendants end no earlier than their subtree
+        block->SubtreeEnds[_parent] = qMax(block->SubtreeEnds.at(_parent), block->SubtreeEnds.at(_position));
+    }
+}
+
+void A_Tree::PropagateCheckState(QTreeWidgetItem *item)
+{
+    /**
+     * Propagates a check state that was just set on an item
+     * Children follow a checked or unchecked state, ancestors are recalculated
+     * @param item Item whose check state was set
+     */
+
+    SyncCheckedLeafBit(item);                             // Record state if item is a leaf
+    UpdateChildrenCheckState(item);                       // Update children to match - skipped for partial state
+    UpdateParentCheckState(item);                         // Update parent chain
 }
 
 void A_Tree::UpdateChildrenCheckState(QTreeWidgetItem *parentItem)
@@ -443,7 +5462,11 @@ void A_Tree::UpdateChildrenCheckState(QTreeWidgetItem *parentItem)
     for (int _childIndex = 0; _childIndex < parentItem->childCount(); ++_childIndex) {
         QTreeWidgetItem *_child = parentItem->child(_childIndex);  // Get child at index
         _child->setCheckState(0, _parentState);           // Set child state to match parent
-        UpdateChildrenCheckState(_child);                 // Recursively update grandchildren
+        if (_child->childCount() == 0) {
+            SyncCheckedLeafBit(_child);                   // Record leaf state
+        } else {
+            UpdateChildrenCheckState(_child);             // Recursively update grandchildren
+        }
     }
 }
 
@@ -514,6 +5537,14 @@ void A_Tree::ShowContextMenu(const QPoint &pos)
      * @param pos Position where right-click occurred
      */
 
+    if (IsSharedReader || IsJournalRestoring()) {
+        return;                                           // Content belongs to the writer process or the journal
+    }
+
+    if (!ContextMenu) {
+        SetupContextMenu();                               // Created on first use - not needed for startup
+    }
+
     CurrentItem = TreeWidget->itemAt(pos);                // Get item at click position
 
     // Enable/disable actions based on context
@@ -579,6 +5610,17 @@ void A_Tree::OnEditAction()
     EditItem(CurrentItem);                                // Edit the currently selected item
 }
 
+void A_Tree::OnSortAction(QAction *action)
+{
+    /**
+     * Context menu action handler for sorting children
+     * Sorts children of the right-clicked item, or root items if clicked on empty space
+     * @param action Triggered sort action
+     */
+
+    SortChildren(CurrentItem, static_cast<SortMode>(action->data().toInt()));  // Sort ascending by chosen mode
+}
+
 void A_Tree::OnDeleteAction()
 {
     /**
@@ -599,7 +5641,7 @@ void A_Tree::OnDeleteAction()
         );
 
     if (_userResponse == QMessageBox::Yes) {
-        DeleteItem(CurrentItem);                          // Delete the item if confirmed
+        DeleteItemAsync(CurrentItem);                     // Delete the item if confirmed - large subtrees in slices
         CurrentItem = nullptr;                            // Clear current item pointer
     }
 }
@@ -10,12 +10,112 @@
 #include <QMessageBox>
 #include <QVBoxLayout>
 #include <QMouseEvent>
+#include <QBitArray>
+#include <QFutureWatcher>
+#include <QCollator>
+#include <QHash>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QTreeView>
+#include "a_tree_item.h"
+#include "a_tree_journal.h"
+#include "a_tree_node_store.h"
+#include "a_tree_snapshot.h"
+#include "a_tree_attributes.h"
+#include "a_tree_aggregates.h"
+#include "a_tree_hashes.h"
+#include "a_tree_generator.h"
+#include "a_tree_exporter.h"
+#include "a_tree_check_rules.h"
+#include "a_tree_shared_store.h"
+#include "a_tree_succinct.h"
+#include "a_tree_frozen_model.h"
+#include <atomic>
+#include <memory>
 
 class A_Tree : public QWidget
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Sort criteria for sibling ordering
+     */
+    enum SortMode {
+        SortByText,                  // Locale-aware, case-insensitive text collation
+        SortByCheckState,            // Checked, then partially checked, then unchecked - ties ordered by text
+        SortNatural,                 // Text collation with digit runs compared numerically ("Item 2" < "Item 10")
+        SortByAttribute              // Attribute column value, items without a value last - ties ordered by text
+    };
+
+    /**
+     * @brief Node of an external hierarchy passed to SyncFromSource
+     * Nodes are listed with every parent before its children; siblings keep list order
+     */
+    struct SourceNode
+    {
+        QString Text;                // Display text - nodes with empty text are skipped with their subtree
+        QString Key;                 // Optional identity - when set, matched by key instead of text so renames are detected
+        int ParentIndex = -1;        // Index of parent node in the same list - -1 for root level
+    };
+
+    /**
+     * @brief Single change event from an external hierarchy passed to ApplySyncEvents
+     */
+    struct SyncEvent
+    {
+        enum Kind {
+            Add,                     // Create node at Path (missing ancestors are created)
+            Remove,                  // Delete node at Path with its subtree
+            Rename,                  // Change text of node at Path to Target
+            Move,                    // Move node at Path under parent path Target (empty Target = root level)
+            Check,                   // Check node at Path with its subtree
+            Uncheck                  // Uncheck node at Path with its subtree
+        };
+
+        Kind Type = Add;             // Event kind
+        QString Path;                // Path of the affected node
+        QString Target;              // New text for Rename, new parent path for Move
+    };
+
+    /**
+     * @brief Memory used by the tree, split by owner
+     */
+    struct MemoryUsage
+    {
+        int NodeCount = 0;           // Live items
+        qint64 ItemBytes = 0;        // Item objects with Qt's per-item data arrays and child lists (estimated)
+        qint64 TextBytes = 0;        // UTF-16 text buffers of all items
+        qint64 ViewBytes = 0;        // View row cache and expanded index set of rows below expanded items (estimated)
+        qint64 NodeStoreBytes = 0;   // Node table and packed per-node flags, frozen structure and check overlay
+        qint64 IndexBytes = 0;       // Path index, filter index, sort keys, attribute columns, roll-ups and snapshot
+        qint64 TotalBytes = 0;       // Sum of all parts
+        double OwnBytesPerNode = 0.0;  // NodeStoreBytes and IndexBytes per node - item objects excluded, compared with CompactNodeBudget
+    };
+
+    /**
+     * @brief Result of LoadSyntheticData
+     */
+    struct SyntheticLoadReport
+    {
+        int NodeCount = 0;           // Items created
+        qint64 GenerateMilliseconds = 0;  // Time spent drawing the tree
+        qint64 BuildMilliseconds = 0;     // Time spent creating items, expanding and laying out
+    };
+
+    /**
+     * @brief Per-node budget of A_TreeCompactNodeStore, where it is enforced; compact mode reports OwnBytesPerNode against it
+     * OwnBytesPerNode covers the node table, packed per-node bits and indexes only. The item objects, including
+     * A_TreeItem's NodeId, Context, SortRank and SortKey fields and Qt's per-item data, are counted in ItemBytes
+     */
+    static constexpr int CompactNodeBudget = A_TreeCompactNodeBudget;
+
+    /**
+     * @brief Children per range bucket when wide parents are paged in the frozen view
+     */
+    static constexpr int DefaultPageSize = 10000;
+
     /**
      * @brief Constructor for A_Tree widget
      * @param parent Parent widget pointer - can be nullptr for standalone widget
@@ -49,6 +149,37 @@ public:
      */
     void DeleteItem(QTreeWidgetItem *item);
 
+    /**
+     * @brief Deletes an item with its subtree in time-sliced steps that keep the event loop running
+     * The subtree is journaled as one removal and detached from the view at once; its items are
+     * then released and freed children-first in slices
+     * @param item Tree item to delete - must be valid existing item
+     * @return True if the job was queued
+     */
+    bool DeleteItemAsync(QTreeWidgetItem *item);
+
+    /**
+     * @brief Checks or unchecks an item's subtree in time-sliced steps that keep the event loop running
+     * Items are updated children-first and the ancestor chain is recalculated after every slice
+     * @param item Tree item to modify - must be valid existing item
+     * @param checked New checked state
+     * @return True if the job was queued
+     */
+    bool SetItemCheckedStateAsync(QTreeWidgetItem *item, bool checked);
+
+    /**
+     * @brief Stops all queued and running subtree jobs after the current slice
+     * Work already done is kept - the tree stays consistent. Subtrees of delete jobs are already
+     * detached, so their remaining items are freed right away
+     */
+    void CancelSubtreeJobs();
+
+    /**
+     * @brief Gets whether subtree jobs are queued or running
+     * @return True if a job has not finished yet
+     */
+    bool IsSubtreeJobRunning() const;
+
     /**
      * @brief Edits the text of specified item (only if edit mode enabled)
      * @param item Tree item to edit - must be valid existing item
@@ -61,13 +192,46 @@ public:
      */
     void LoadDemoData();
 
+    /**
+     * @brief Replaces the tree with a generated one for load testing
+     * The same parameters always produce the same tree; items are built detached and inserted as one batch
+     * @param parameters Generator settings - size, shape and labels
+     * @return Node count and timings
+     */
+    SyntheticLoadReport LoadSyntheticData(const A_TreeGenerator::Parameters &parameters);
+
     /**
      * @brief Removes all items from the tree
      * Clears the entire tree structure and resets internal state
      */
     void ClearAllItems();
 
+    /**
+     * @brief Starts a bulk update - inserted items are not expanded one by one until EndBulkUpdate
+     * Calls nest; only the outermost EndBulkUpdate applies expansion
+     */
+    void BeginBulkUpdate();
+
+    /**
+     * @brief Ends a bulk update and applies the recorded expand state in one batch
+     */
+    void EndBulkUpdate();
+
     // Getters and Setters
+    /**
+     * @brief Gets the expand state of all items
+     * @return Bitmap where bit N is set if node N is expanded - shared copy, O(1)
+     */
+    QBitArray GetExpandedState() const;
+
+    /**
+     * @brief Restores a previously saved expand state in one batch
+     * Only items that end up visible are laid out; expanded items below collapsed ones are expanded
+     * when their parent is expanded
+     * @param expandedBits Bitmap returned by GetExpandedState - bits of unknown nodes are ignored
+     */
+    void SetExpandedState(const QBitArray &expandedBits);
+
     /**
      * @brief Sets the edit mode state for the tree widget
      * @param enabled Edit mode flag - true allows editing, false makes items read-only
@@ -94,119 +258,1324 @@ public:
      */
     void SetItemCheckedState(QTreeWidgetItem *item, bool checked);
 
-signals:
     /**
-     * @brief Signal emitted when an item is successfully edited
-     * @param itemText New text of the edited item
+     * @brief Shows only items whose text contains the query, together with their ancestors
+     * Narrowing queries re-test only current matches; large trees are evaluated off the GUI thread
+     * @param text Filter query - case-insensitive substring, empty string shows all items
      */
-    void ItemEdited(const QString &itemText);
+    void SetFilterText(const QString &text);
 
     /**
-     * @brief Signal emitted when an item is successfully deleted
-     * @param itemText Text of the deleted item (captured before deletion)
+     * @brief Gets the currently requested filter query
+     * @return Active filter text - empty if no filter is applied
      */
-    void ItemDeleted(const QString &itemText);
+    QString GetFilterText() const;
 
     /**
-     * @brief Signal emitted when an item's checked state changes
-     * @param itemText Text of the item whose state changed
-     * @param checked New checked state of the item
+     * @brief Sorts the direct children of an item and keeps them sorted on later inserts and edits
+     * @param parent Item whose children are sorted - nullptr sorts the root items
+     * @param mode Sort criterion to apply
+     * @param order Ascending or descending order
      */
-    void ItemCheckStateChanged(const QString &itemText, bool checked);
+    void SortChildren(QTreeWidgetItem *parent, SortMode mode, Qt::SortOrder order = Qt::AscendingOrder);
 
-private slots:
     /**
-     * @brief Handles item state changes (primarily checkbox changes)
-     * @param item Tree item that changed - guaranteed to be valid
-     * @param column Column that changed - should be 0 for text/checkbox column
+     * @brief Sorts every sibling list in the tree and keeps the whole tree sorted
+     * @param mode Sort criterion to apply
+     * @param order Ascending or descending order
      */
-    void OnItemChanged(QTreeWidgetItem *item, int column);
+    void SortAllItems(SortMode mode, Qt::SortOrder order = Qt::AscendingOrder);
 
     /**
-     * @brief Shows context menu at specified position
-     * @param pos Position where right-click occurred - in widget coordinates
+     * @brief Stops keeping items sorted - current order is kept, new items are appended again
      */
-    void ShowContextMenu(const QPoint &pos);
+    void ClearSortOrder();
 
     /**
-     * @brief Context menu action to add root item
+     * @brief Adds a typed attribute column and shows it in the view after the tree column
+     * Values are kept in one array per column indexed by node identifier, not in the items
+     * @param name Header text of the column
+     * @param type Value type of the column
+     * @return Attribute column index - the view column is index + 1
      */
-    void OnAddRootAction();
+    int AddAttributeColumn(const QString &name, A_TreeAttributes::ColumnType type);
 
     /**
-     * @brief Context menu action to add child item
+     * @brief Sets an attribute value of an item
+     * @param item Tree item to modify - must be valid existing item
+     * @param column Attribute column index returned by AddAttributeColumn
+     * @param value New value, converted once to the column type - null variant clears the value
+     * @return True if stored - false if item or column is invalid or the value cannot be converted
      */
-    void OnAddChildAction();
+    bool SetItemAttribute(QTreeWidgetItem *item, int column, const QVariant &value);
 
     /**
-     * @brief Context menu action to edit selected item
+     * @brief Gets an attribute value of an item
+     * @param item Tree item to read - must be valid existing item
+     * @param column Attribute column index
+     * @return Value - null variant if not set or invalid
      */
-    void OnEditAction();
+    QVariant GetItemAttribute(QTreeWidgetItem *item, int column) const;
 
     /**
-     * @brief Context menu action to delete selected item
+     * @brief Gets the attribute columns for typed bulk reads and writes without QVariant
+     * Call RefreshAttributeColumns after writing directly
+     * @return Attribute store indexed by node identifier
      */
-    void OnDeleteAction();
+    A_TreeAttributes& GetAttributes();
 
-private:
     /**
-     * @brief Sets up the user interface components
-     * Creates and configures the tree widget and layout
+     * @brief Repaints attribute columns after direct writes through GetAttributes
+     * Roll-ups of the aggregated column are recomputed in parallel
      */
-    void SetupUserInterface();
+    void RefreshAttributeColumns();
 
     /**
-     * @brief Applies styling to the tree widget
-     * Sets colors, fonts, and visual appearance for consistency
+     * @brief Sorts the direct children of an item by an attribute column and keeps them sorted
+     * @param parent Item whose children are sorted - nullptr sorts the root items
+     * @param column Attribute column index
+     * @param order Ascending or descending order
      */
-    void SetTreeWidgetStyle();
+    void SortChildrenByAttribute(QTreeWidgetItem *parent, int column, Qt::SortOrder order = Qt::AscendingOrder);
 
     /**
-     * @brief Sets up the context menu and its actions
-     * Creates right-click menu with add, edit, delete options
+     * @brief Starts maintaining subtree roll-ups - descendant count, checked-leaf count and sum/min/max of a column
+     * Roll-ups are computed once in parallel, then updated by delta along the ancestor chain on every change;
+     * changes made during a bulk update are folded in by one parallel recompute at its end
+     * @param valueColumn Integer, double or date-time attribute column to aggregate - -1 for counts only
+     * @return True if enabled - false if the column cannot be aggregated
      */
-    void SetupContextMenu();
+    bool EnableAggregates(int valueColumn = -1);
 
     /**
-     * @brief Connects internal signals and slots
-     * Establishes communication between tree widget and internal handlers
+     * @brief Stops maintaining roll-ups and frees them
      */
-    void ConnectSignalsAndSlots();
+    void DisableAggregates();
 
     /**
-     * @brief Updates child items to match parent's checked state
-     * @param parentItem Parent item whose children should be updated - must be valid
+     * @brief Gets the roll-up of an item's subtree
+     * @param item Tree item to read - must be valid existing item
+     * @param values Output roll-up - the item itself counts toward CheckedLeafCount and the value aggregates
+     * @return True if aggregates are enabled and item is valid
      */
-    void UpdateChildrenCheckState(QTreeWidgetItem *parentItem);
+    bool GetItemAggregate(QTreeWidgetItem *item, A_TreeAggregates::Values *values);
 
     /**
-     * @brief Updates parent item's checked state based on children
-     * @param childItem Child item that triggered the update - must be valid
+     * @brief Recomputes every roll-up from scratch, splitting the tree across all cores
      */
-    void UpdateParentCheckState(QTreeWidgetItem *childItem);
+    void RecomputeAggregates();
 
     /**
-     * @brief Calculates appropriate check state for parent based on children
-     * @param parentItem Parent item to calculate state for - must be valid
-     * @return Calculated check state - Checked, Unchecked, or PartiallyChecked
+     * @brief Starts maintaining a content hash per subtree - texts, structure and, separately, check states
+     * Every change invalidates the hashes up the ancestor chain; hashes are recomputed on request,
+     * so only changed paths are rehashed. Equal hashes mean equal subtrees, so comparisons and syncs
+     * skip them without visiting their items
+     * @return False in compact mode
      */
-    Qt::CheckState CalculateParentCheckState(QTreeWidgetItem *parentItem) const;
+    bool EnableSubtreeHashes();
 
-    // UI Components
-    QTreeWidget *TreeWidget;         // Main tree display widget - shows hierarchical data with checkboxes
-    QVBoxLayout *MainLayout;         // Layout container - organizes tree widget within this widget
+    /**
+     * @brief Stops maintaining subtree hashes and frees them
+     */
+    void DisableSubtreeHashes();
 
-    // Context Menu Components
-    QMenu *ContextMenu;              // Right-click context menu - provides item manipulation options
-    QAction *AddRootAction;          // Context menu action - adds new root level item
-    QAction *AddChildAction;         // Context menu action - adds child to selected item
-    QAction *EditAction;             // Context menu action - edits selected item text
-    QAction *DeleteAction;           // Context menu action - deletes selected item
+    /**
+     * @brief Gets whether subtree hashes are maintained
+     * @return True if enabled
+     */
+    bool IsSubtreeHashesEnabled() const;
 
-    // State Variables
-    QTreeWidgetItem *CurrentItem;    // Currently selected/right-clicked item - can be nullptr if no selection
-    bool IsEditModeEnabled;          // Edit mode flag - true allows editing, false makes read-only
-    bool IsInternalUpdate;           // Internal update flag - prevents recursive signal handling during updates
+    /**
+     * @brief Gets the hash of an item's subtree
+     * @param item Tree item to read - must be valid existing item
+     * @param isCheckStateIncluded True to include check states, false for texts and structure only
+     * @return Subtree hash - 0 if hashes are disabled or item is null
+     */
+    quint64 GetItemHash(QTreeWidgetItem *item, bool isCheckStateIncluded = false);
+
+    /**
+     * @brief Gets the hash of the whole tree - equal for trees with the same items in the same order
+     * @param isCheckStateIncluded True to include check states
+     * @return Tree hash - 0 if hashes are disabled
+     */
+    quint64 GetTreeHash(bool isCheckStateIncluded = false);
+
+    /**
+     * @brief Finds the items whose subtree differs from the same item in a snapshot
+     * Subtrees with equal hashes are skipped whole, reading the hashes stored in the snapshot's blocks,
+     * so the cost follows the changed paths and not the tree size; ancestors of a change differ too and are listed
+     * @param snapshot Earlier version of this tree - items are matched by node identifier among the children of their parent
+     * @param isCheckStateIncluded True to also report check state changes
+     * @return Node identifiers of differing items, parents before children - empty if hashes are disabled
+     */
+    QVector<quint32> FindChangedItems(const A_TreeSnapshot &snapshot, bool isCheckStateIncluded = false);
+
+    /**
+     * @brief Gets the memory used by the tree, split by owner
+     * Qt's item and view internals are estimated from their layout; A_Tree's own arrays are measured
+     * @return Byte counts - O(n) walk over all items
+     */
+    MemoryUsage GetMemoryUsage() const;
+
+    /**
+     * @brief Switches compact mode - trades optional per-node state for a bounded footprint
+     * Compact mode releases and stops keeping the path index, the flattened filter index, cached sort keys,
+     * roll-up aggregates and published snapshots. Path lookups then scan sibling lists, filtering rebuilds
+     * its index on every run and snapshots stay empty
+     * @param enabled True to enter compact mode
+     */
+    void SetCompactMode(bool enabled);
+
+    /**
+     * @brief Gets whether compact mode is on
+     * @return True in compact mode
+     */
+    bool IsCompactMode() const;
+
+    /**
+     * @brief Gets the stable identifier of an item
+     * Identifiers are never reused while the item exists and are reset by ClearAllItems
+     * @param item Tree item to identify - must be valid existing item
+     * @return Node identifier - 0 if item is invalid
+     */
+    quint32 GetItemId(QTreeWidgetItem *item) const;
+
+    /**
+     * @brief Gets the item with specified identifier
+     * @param id Node identifier returned by GetItemId
+     * @return Pointer to item - nullptr if no item has this identifier
+     */
+    QTreeWidgetItem* GetItemById(quint32 id) const;
+
+    /**
+     * @brief Gets the checked leaves as a bitmap over node identifiers
+     * @return Bitmap where bit N is set if node N is a checked leaf - shared copy, O(1)
+     */
+    QBitArray GetCheckedLeafBitmap() const;
+
+    /**
+     * @brief Gets the checked leaves as run-length encoded identifier ranges
+     * @return Inclusive [first, last] identifier ranges in ascending order
+     */
+    QVector<QPair<quint32, quint32>> GetCheckedLeafRanges() const;
+
+    /**
+     * @brief Gets the full paths of all checked leaves
+     * @param separator Separator placed between path segments
+     * @return Paths from root item to leaf in ascending identifier order - in breadth-first order while frozen
+     */
+    QStringList GetCheckedLeafPaths(const QString &separator = "/") const;
+
+    /**
+     * @brief Gets the number of checked leaves
+     * @return Count of leaves in Checked state
+     */
+    int GetCheckedLeafCount() const;
+
+    /**
+     * @brief Exports the check selection as a compressed bitmap over pre-order positions
+     * Only checked leaves are stored - parent states follow from them. A hash of the tree shape and texts
+     * is stored with the bitmap so a selection is never applied to a different tree
+     * @return Serialized selection
+     */
+    QByteArray ExportCheckedState() const;
+
+    /**
+     * @brief Restores a selection saved by ExportCheckedState
+     * Leaves are set and parents recalculated in one children-first pass; only changed items are touched
+     * @param data Serialized selection
+     * @return True if applied - false if data is corrupt or was saved for a different tree
+     */
+    bool ImportCheckedState(const QByteArray &data);
+
+    /**
+     * @brief Streams all items to a device in one pre-order walk on the calling thread
+     * Memory stays proportional to tree depth; works in compact mode and while frozen
+     * @param device Open output device
+     * @param options Format, check state filter and buffer size
+     * @param writtenCount Receives the number of records - may be nullptr
+     * @return True if every write succeeded
+     */
+    bool ExportTo(QIODevice *device, const A_TreeExporter::Options &options, qint64 *writtenCount = nullptr) const;
+
+    /**
+     * @brief Writes all items to a file on a worker thread from the current snapshot
+     * The file is replaced only when complete; ExportFinished reports the outcome.
+     * In compact mode and while frozen no snapshots are kept and the export runs synchronously
+     * @param filePath Output file
+     * @param options Format, check state filter and buffer size
+     * @return False if another export is still running
+     */
+    bool ExportToFileAsync(const QString &filePath, const A_TreeExporter::Options &options);
+
+    /**
+     * @brief Gets whether a background export is running
+     * @return True while ExportFinished is outstanding
+     */
+    bool IsExportRunning() const;
+
+    /**
+     * @brief Moves an item with its subtree under a new parent
+     * @param item Item to move - must be valid existing item
+     * @param newParent New parent item - nullptr moves the item to root level
+     * @return True if moved - false if item invalid, already under newParent or newParent is inside item's subtree
+     */
+    bool MoveItem(QTreeWidgetItem *item, QTreeWidgetItem *newParent);
+
+    /**
+     * @brief Adds an item by path, creating missing ancestors - O(depth) through the path index
+     * @param path Path from root item, e.g. "Media/Photo Albums/Vacation 2023"
+     * @param separator Separator between path segments
+     * @return Item at path (existing or created) - nullptr if path has no segments
+     */
+    QTreeWidgetItem* AddByPath(const QString &path, const QString &separator = "/");
+
+    /**
+     * @brief Adds many paths in one batch, reusing the resolved parent prefix of the previous path
+     * Sorted or grouped input resolves shared ancestors once; check states are recalculated once per changed parent
+     * @param paths Paths from root item
+     * @param separator Separator between path segments
+     * @return Number of items created
+     */
+    int AddPaths(const QStringList &paths, const QString &separator = "/");
+
+    /**
+     * @brief Finds an item by path - O(depth) through the path index
+     * If siblings share a text, the first of them in sibling order is followed
+     * @param path Path from root item
+     * @param separator Separator between path segments
+     * @return Item at path - nullptr if no item has this path
+     */
+    QTreeWidgetItem* FindByPath(const QString &path, const QString &separator = "/") const;
+
+    /**
+     * @brief Sets the checked state of the item at a path, propagating it like SetItemCheckedState
+     * @param path Path from root item
+     * @param checked New checkbox state
+     * @param separator Separator between path segments
+     * @return True if an item exists at path
+     */
+    bool SetCheckedByPath(const QString &path, bool checked, const QString &separator = "/");
+
+    /**
+     * @brief Checks and unchecks leaves by pattern rules in one traversal
+     * Rules are compiled once and evaluated on worker threads for large trees; the last matching rule
+     * decides a leaf, unmatched leaves keep their state. Parents are recalculated in one bottom-up pass
+     * and CheckRulesApplied is emitted once
+     * @param rules Rules in precedence order
+     * @param separator Path separator for path rules
+     * @param errorMessage Receives the reason if a pattern is invalid - may be nullptr
+     * @return Number of leaves whose state changed - -1 if a pattern is invalid
+     */
+    int ApplyCheckRules(const QVector<A_TreeCheckRules::Rule> &rules, const QString &separator = "/",
+                        QString *errorMessage = nullptr);
+
+    /**
+     * @brief Updates the tree to match a new snapshot of an external hierarchy
+     * Nodes are matched per sibling list by key (or text), only differences are applied in one batch,
+     * and matched items keep their check and expand state. A keyed item whose node moved to another
+     * parent is moved with its subtree; items are deleted only if their key is missing from the source
+     * @param nodes Source nodes with every parent listed before its children
+     */
+    void SyncFromSource(const QVector<SourceNode> &nodes);
+
+    /**
+     * @brief Applies a stream of external change events in one batch
+     * @param events Events in the order they occurred - events on missing paths are skipped
+     * @param separator Separator between path segments
+     */
+    void ApplySyncEvents(const QVector<SyncEvent> &events, const QString &separator = "/");
+
+    /**
+     * @brief Persists every tree mutation to an append-only journal in a directory
+     * If the directory holds an earlier journal, the tree is replaced by the recovered state;
+     * otherwise the current tree becomes the journal's starting snapshot
+     * @param directoryPath Journal directory - created if missing
+     * @return True if the journal is open and recording
+     */
+    bool EnableJournal(const QString &directoryPath);
+
+    /**
+     * @brief Like EnableJournal, but opens and recovers the journal in time slices after the current event loop pass
+     * The journal is opened and its snapshot verified during the call; items are built in slices after it,
+     * so the window paints first and recovered root items appear as their subtrees complete. Inserted items
+     * can be browsed but not checked, edited or changed through the context menu until JournalRestored is
+     * emitted, and recording starts then
+     * @param directoryPath Journal directory - created if missing
+     */
+    void EnableJournalInSlices(const QString &directoryPath);
+
+    /**
+     * @brief Gets whether a sliced journal recovery is running
+     * @return True until JournalRestored is emitted
+     */
+    bool IsJournalRestoring() const;
+
+    /**
+     * @brief Commits pending journal records and stops journaling
+     */
+    void DisableJournal();
+
+    /**
+     * @brief Gets whether mutations are being journaled
+     * @return True if a journal is open
+     */
+    bool IsJournalEnabled() const;
+
+    /**
+     * @brief Publishes the tree into a shared-memory store that viewer processes attach to
+     * Every snapshot publish rewrites the store, so readers follow changes within one poll interval.
+     * Not available in compact mode, which keeps no snapshots
+     * @param key Store name - one writer per key
+     * @return False if the store cannot be created or the tree is frozen
+     */
+    bool ShareTree(const QString &key);
+
+    /**
+     * @brief Turns the tree into a read-only viewer of a shared-memory store
+     * Items are rebuilt whenever the writer publishes; expansion is kept across updates.
+     * The journal is closed and editing and context menu actions are disabled while attached
+     * @param key Store name used by the writer
+     * @return False if no writer created the store or the tree is frozen
+     */
+    bool AttachSharedTree(const QString &key);
+
+    /**
+     * @brief Stops writing or following a shared store - items stay as they are and become editable again
+     */
+    void DetachSharedTree();
+
+    /**
+     * @brief Gets whether the tree follows a shared store
+     * @return True while attached as reader
+     */
+    bool IsSharedTreeReader() const;
+
+    /**
+     * @brief Gets the last shared store error
+     * @return Error text - empty if none
+     */
+    QString GetSharedTreeError() const;
+
+    /**
+     * @brief Replaces all items with a read-only succinct encoding shown through a model/view
+     * Structure takes about 2 bits per node, texts are front-coded UTF-8 and check states a 2-bit overlay;
+     * rows are decoded on demand, so no per-node objects exist. Check boxes stay usable and propagate.
+     * While frozen the item API sees an empty tree, except for the checked leaf paths, the checked leaf count
+     * and exports, which read the encoding; the journal is closed and reopened by ThawTree or, if the tree
+     * is destroyed while frozen, by the destructor, which records the encoding as the journal's snapshot.
+     * Texts, check states, sync keys and expand state are kept; identifiers are renumbered
+     * @return False if already frozen, attached as reader, a background job or export is running, or
+     *         attribute values or per-parent sort configurations exist
+     */
+    bool FreezeTree();
+
+    /**
+     * @brief Rebuilds items from the frozen encoding, keeping texts, order and check states
+     * Items get new identifiers in breadth-first order; root items are expanded. A journal closed by
+     * FreezeTree is reopened with the thawed tree as its new snapshot, so check changes made while frozen persist
+     * @return False if the tree is not frozen
+     */
+    bool ThawTree();
+
+    /**
+     * @brief Gets whether the tree is frozen
+     * @return True while items are replaced by the succinct encoding
+     */
+    bool IsTreeFrozen() const;
+
+    /**
+     * @brief Gets the frozen encoding
+     * @return Encoded tree - nullptr unless frozen
+     */
+    const A_TreeSuccinct* GetFrozenTree() const;
+
+    /**
+     * @brief Groups the children of wide parents in the frozen view into range buckets
+     * A parent with more than pageSize children shows buckets like "1–10000" instead of its children;
+     * a bucket's rows are laid out only when it is expanded, and its check box sets the whole range
+     * and shows the range's tri-state aggregate. Applies to the current and later frozen views
+     * @param pageSize Children per bucket - 0 shows all children directly
+     */
+    void SetFrozenPageSize(int pageSize);
+
+    /**
+     * @brief Gets the bucket size of the frozen view
+     * @return Children per bucket - 0 if paging is off
+     */
+    int GetFrozenPageSize() const;
+
+    /**
+     * @brief Gets an up-to-date immutable snapshot of the tree (GUI thread only)
+     * The snapshot can be handed to worker threads and read there without locks while the tree keeps changing;
+     * subtrees of root items that did not change are shared with the previous version
+     * @return Snapshot of the current tree - never nullptr
+     */
+    std::shared_ptr<const A_TreeSnapshot> GetSnapshot();
+
+    /**
+     * @brief Gets the most recently published snapshot (thread-safe, lock-free)
+     * Snapshots are republished once per event loop pass after changes, so the result may lag behind
+     * the tree by one pass; the first call from a worker thread starts publishing
+     * @return Latest published snapshot - never nullptr
+     */
+    std::shared_ptr<const A_TreeSnapshot> AcquireSnapshot() const;
+
+signals:
+    /**
+     * @brief Signal emitted when an item is successfully edited
+     * @param itemText New text of the edited item
+     */
+    void ItemEdited(const QString &itemText);
+
+    /**
+     * @brief Signal emitted when an item is successfully deleted
+     * @param itemText Text of the deleted item (captured before deletion)
+     */
+    void ItemDeleted(const QString &itemText);
+
+    /**
+     * @brief Signal emitted when an item's checked state changes
+     * @param itemText Text of the item whose state changed
+     * @param checked New checked state of the item
+     */
+    void ItemCheckStateChanged(const QString &itemText, bool checked);
+
+    /**
+     * @brief Signal emitted when a filter evaluation has been applied to the tree
+     * @param matchCount Number of items whose own text matches the filter query
+     */
+    void FilterApplied(int matchCount);
+
+    /**
+     * @brief Signal emitted when a synchronization batch has been applied
+     * @param addedCount Number of items created
+     * @param removedCount Number of items deleted, including descendants
+     * @param changedCount Number of items renamed, moved, checked or unchecked
+     */
+    void SyncApplied(int addedCount, int removedCount, int changedCount);
+
+    /**
+     * @brief Signal emitted after every slice of a subtree job
+     * @param processedCount Items processed by the current job
+     * @param totalCount Items in the job's subtree - 0 while the subtree is still being collected
+     */
+    void SubtreeJobProgress(int processedCount, int totalCount);
+
+    /**
+     * @brief Signal emitted when a subtree job finished or was cancelled
+     * @param isCancelled True if the job was stopped by CancelSubtreeJobs
+     */
+    void SubtreeJobFinished(bool isCancelled);
+
+    /**
+     * @brief Signal emitted when a saved check selection was applied
+     * @param changedLeafCount Number of leaves whose state changed
+     */
+    void CheckedStateImported(int changedLeafCount);
+
+    /**
+     * @brief Signal emitted when ExportToFileAsync completed
+     * @param isSuccess False if the file could not be written
+     * @param writtenCount Number of records written
+     */
+    void ExportFinished(bool isSuccess, qint64 writtenCount);
+
+    /**
+     * @brief Signal emitted once after ApplyCheckRules changed the tree
+     * @param changedLeafCount Number of leaves whose state changed
+     */
+    void CheckRulesApplied(int changedLeafCount);
+
+    /**
+     * @brief Signal emitted when a viewer picked up a new version of a shared store
+     * @param nodeCount Number of items after the update
+     */
+    void SharedTreeUpdated(int nodeCount);
+
+    /**
+     * @brief Signal emitted when EnableJournalInSlices finished
+     * @param isEnabled False if the journal directory is not usable
+     */
+    void JournalRestored(bool isEnabled);
+
+private slots:
+    /**
+     * @brief Handles item state changes (primarily checkbox changes)
+     * @param item Tree item that changed - guaranteed to be valid
+     * @param column Column that changed - should be 0 for text/checkbox column
+     */
+    void OnItemChanged(QTreeWidgetItem *item, int column);
+
+    /**
+     * @brief Records an expanded item and expands its children that were expanded before
+     * @param item Tree item that was expanded
+     */
+    void OnItemExpanded(QTreeWidgetItem *item);
+
+    /**
+     * @brief Records a collapsed item
+     * @param item Tree item that was collapsed
+     */
+    void OnItemCollapsed(QTreeWidgetItem *item);
+
+    /**
+     * @brief Shows context menu at specified position
+     * @param pos Position where right-click occurred - in widget coordinates
+     */
+    void ShowContextMenu(const QPoint &pos);
+
+    /**
+     * @brief Context menu action to add root item
+     */
+    void OnAddRootAction();
+
+    /**
+     * @brief Context menu action to add child item
+     */
+    void OnAddChildAction();
+
+    /**
+     * @brief Context menu action to edit selected item
+     */
+    void OnEditAction();
+
+    /**
+     * @brief Context menu action to delete selected item
+     */
+    void OnDeleteAction();
+
+    /**
+     * @brief Applies the result of a background filter evaluation
+     */
+    void OnFilterFinished();
+
+    /**
+     * @brief Reports the result of a background export
+     */
+    void OnExportFinished();
+
+    /**
+     * @brief Context menu action to sort children of selected item (or root items)
+     * @param action Triggered sort action - carries the SortMode in its data
+     */
+    void OnSortAction(QAction *action);
+
+    /**
+     * @brief Hands a snapshot of the current tree to the journal for background compaction
+     */
+    void OnJournalCompactionRequested();
+
+    /**
+     * @brief Publishes a new snapshot version, rebuilding only blocks of changed root items
+     */
+    void PublishSnapshot();
+
+    /**
+     * @brief Reloads the items if the shared store's sequence changed (reader only)
+     */
+    void PollSharedTree();
+
+    /**
+     * @brief Runs one time slice of the first queued subtree job and schedules the next slice
+     */
+    void RunSubtreeJobSlice();
+
+    /**
+     * @brief Runs one time slice of a sliced journal recovery and schedules the next slice
+     */
+    void RunJournalRestoreSlice();
+
+private:
+    /**
+     * @brief Result of one filter evaluation over the flattened tree
+     */
+    struct FilterResult
+    {
+        QBitArray MatchBits;             // Per-node match flag - set if the node's own text contains the query
+        QBitArray VisibleBits;           // Per-node visibility flag - set if the node or a descendant matches
+        QString Query;                   // Query the result was computed for
+        int RequestId = 0;               // Filter request the result belongs to - stale results are discarded
+    };
+
+    /**
+     * @brief Kind of time-sliced subtree job
+     */
+    enum SubtreeJobType {
+        DeleteSubtreeJob,                // Remove the subtree
+        CheckSubtreeJob                  // Set the check state of the subtree
+    };
+
+    /**
+     * @brief Time-sliced operation on one subtree
+     * Items are referenced by identifier so changes made between slices never leave dangling pointers
+     */
+    struct SubtreeJob
+    {
+        SubtreeJobType Type = DeleteSubtreeJob;  // Operation to perform
+        quint32 RootId = 0;              // Subtree root
+        QString RootText;                // Root text reported when the job finishes
+        Qt::CheckState State = Qt::Unchecked;  // Target state of check jobs
+        QVector<quint32> Pending;        // Identifiers still to collect
+        QVector<quint32> NodeIds;        // Collected identifiers - processed from the back, children before parents
+        int ProcessedCount = 0;          // Items processed so far
+        bool IsCollected = false;        // Collection flag - true once every item of the subtree is in NodeIds
+        bool IsRootDone = false;         // Root flag - true once the root was processed, its signal is emitted after removal
+    };
+
+    /**
+     * @brief Journal recovery spread over time slices
+     * The journal is opened in the first slice; later slices build snapshot nodes, then replay records
+     */
+    struct JournalRestore
+    {
+        A_TreeJournal *Journal = nullptr;  // Opened journal - becomes Journal when the recovery ends, nullptr if it could not be opened
+        QVector<A_TreeJournal::SnapshotNode> Nodes;  // Recovered snapshot in pre-order
+        QVector<A_TreeJournal::Record> Records;  // Records after the snapshot
+        quint32 NextNodeId = 1;          // First unused identifier at snapshot time
+        int NodeIndex = 0;               // Next snapshot node to build
+        int RecordIndex = 0;             // Next record to replay
+        A_TreeItem *PendingRoot = nullptr;  // Root item whose subtree is still being built - inserted once complete
+    };
+
+    /**
+     * @brief Queues a subtree job and runs its first slice right away
+     * @param job Job to queue
+     */
+    void StartSubtreeJob(const SubtreeJob &job);
+
+    /**
+     * @brief Collects subtree items until the slice ends
+     * @param job Job being collected
+     * @param timer Timer started at the beginning of the slice
+     * @return True if collection finished within the slice
+     */
+    bool CollectSubtreeJob(SubtreeJob &job, const QElapsedTimer &timer);
+
+    /**
+     * @brief Processes collected items until the slice ends
+     * @param job Job being processed
+     * @param timer Timer started at the beginning of the slice
+     * @return True if every item was processed
+     */
+    bool ProcessSubtreeJob(SubtreeJob &job, const QElapsedTimer &timer);
+
+    /**
+     * @brief Evaluates a filter query over flattened node texts (thread-safe, touches no items)
+     * @param texts Node texts in pre-order
+     * @param parents Parent index of each node in pre-order - -1 for root items
+     * @param query Case-insensitive substring to match
+     * @param candidates Nodes that may still match - empty array tests every node
+     * @param requestId Filter request identifier stored in the result
+     * @return Match and visibility bits for every node
+     */
+    static FilterResult EvaluateFilter(const QStringList &texts, const QVector<int> &parents,
+                                       const QString &query, const QBitArray &candidates, int requestId);
+
+    /**
+     * @brief Rebuilds the flattened pre-order filter index from the tree widget
+     */
+    void RebuildFilterIndex();
+
+    /**
+     * @brief Marks the filter index stale after a structural or text change
+     * Schedules one coalesced re-filter if a filter is currently active
+     */
+    void InvalidateFilterIndex();
+
+    /**
+     * @brief Starts evaluation of the current filter query (synchronously or on a worker thread)
+     */
+    void RunFilter();
+
+    /**
+     * @brief Frees the flattened filter index - the next run rebuilds it
+     */
+    void ReleaseFilterIndex();
+
+    /**
+     * @brief Applies visibility from a filter result, touching only items whose visibility changed
+     * @param result Filter evaluation result - ignored if it belongs to an outdated request
+     */
+    void ApplyFilterResult(const FilterResult &result);
+
+    /**
+     * @brief Sort configuration kept for a sorted sibling list
+     */
+    struct SortSpec
+    {
+        SortMode Mode = SortByText;                  // Sort criterion
+        Qt::SortOrder Order = Qt::AscendingOrder;    // Sort direction
+        int AttributeColumn = -1;                    // Attribute column compared by SortByAttribute
+        A_TreeAttributes::ColumnType AttributeType = A_TreeAttributes::IntegerColumn;  // Type of AttributeColumn
+    };
+
+    /**
+     * @brief Precomputed sort data of one item - compared without touching the item
+     */
+    struct SortEntry
+    {
+        A_TreeItem *Item = nullptr;                  // Item being sorted
+        const QCollatorSortKey *Key = nullptr;       // Cached collation key owned by the item
+        int CheckRank = 0;                           // Check state rank - 0 checked, 1 partial, 2 unchecked
+        qint64 IntegerValue = 0;                     // Integer or date-time attribute value
+        double DoubleValue = 0.0;                    // Double attribute value
+        const QString *TextValue = nullptr;          // Pooled text attribute value - owned by the attribute store
+        bool HasAttribute = false;                   // Attribute presence - items without a value sort last
+    };
+
+    /**
+     * @brief Creates a detached item with default check state and flags for current edit mode
+     * @param text Display text for the item - expected to be already trimmed
+     * @param nodeId Identifier to assign - 0 assigns the next free identifier
+     * @return Newly allocated item - caller inserts it into the tree
+     */
+    A_TreeItem* CreateItem(const QString &text, quint32 nodeId = 0);
+
+    /**
+     * @brief Inserts item at its sorted position if the container is kept sorted, otherwise appends it
+     * @param container Parent item or invisible root item
+     * @param item Detached item to insert
+     */
+    void InsertSortedOrAppend(QTreeWidgetItem *container, A_TreeItem *item);
+
+    /**
+     * @brief Looks up the sort configuration applying to a sibling list
+     * @param container Parent item or invisible root item
+     * @param spec Output sort configuration - written only if the container is kept sorted
+     * @return True if the container's children are kept sorted
+     */
+    bool FindSortSpec(QTreeWidgetItem *container, SortSpec *spec) const;
+
+    /**
+     * @brief Builds sort data for an item, computing its collation key once if needed
+     * @param item Item to describe
+     * @param spec Sort configuration determining the key flavour and attribute column
+     * @return Sort entry referencing the item's cached key
+     */
+    SortEntry MakeSortEntry(A_TreeItem *item, const SortSpec &spec);
+
+    /**
+     * @brief Strict ordering of two sort entries (thread-safe, reads only entry data)
+     * @param left First entry
+     * @param right Second entry
+     * @param spec Sort configuration - mode and direction
+     * @return True if left is ordered strictly before right
+     */
+    static bool IsSortedBefore(const SortEntry &left, const SortEntry &right, const SortSpec &spec);
+
+    /**
+     * @brief Sorts one sibling list, in parallel for very wide lists
+     * @param container Parent item or invisible root item
+     * @param spec Sort configuration to apply
+     * @return True if children moved - false if the list was already in order
+     */
+    bool SortContainer(QTreeWidgetItem *container, const SortSpec &spec);
+
+    /**
+     * @brief Finds the binary-search insert position among sorted siblings
+     * @param container Parent item or invisible root item - children must be sorted by spec
+     * @param entry Sort data of the item to place
+     * @param spec Sort configuration of the sibling list
+     * @param skipIndex Child index to ignore (the item itself when repositioning) - -1 for none
+     * @return Insert position counted without the skipped child
+     */
+    int FindSortedInsertIndex(QTreeWidgetItem *container, const SortEntry &entry, const SortSpec &spec, int skipIndex);
+
+    /**
+     * @brief Moves an item whose text, attribute or check state changed to its sorted position among its siblings
+     * @param item Item that changed - ignored if its siblings are not kept sorted
+     */
+    void RepositionSortedItem(QTreeWidgetItem *item);
+
+    /**
+     * @brief Reorders a sibling list by the SortRank of its children
+     * Qt reports the reorder as a layout change without parents; the container is kept
+     * in SortingContainer meanwhile so snapshot blocks and hashes outside it stay valid
+     * @param container Parent item or invisible root item
+     */
+    void ApplySortRanks(QTreeWidgetItem *container);
+
+    /**
+     * @brief Gets whether any sibling list is kept sorted by check state
+     * @return True if check state changes can reorder items
+     */
+    bool IsCheckStateSorted() const;
+
+    /**
+     * @brief Moves items of lists sorted by check state after a state change
+     * Lists below the item are resorted - they followed its state - and the item and its
+     * ancestors are repositioned among their siblings
+     * @param item Item whose state was set, invisible root item after a tree-wide change
+     */
+    void RepositionCheckSortedItems(QTreeWidgetItem *item);
+
+    /**
+     * @brief Gets the key used to match an item against source nodes
+     * @param item Tree item - must be valid existing item
+     * @return "k:" plus sync key if the item was synchronized with a key, otherwise "t:" plus text
+     */
+    static QString SyncMatchKey(QTreeWidgetItem *item);
+
+    /**
+     * @brief Resolves a path to an item by walking sibling lists from the root level
+     * @param segments Path segments from root to item
+     * @param createMissing Create missing items along the path
+     * @param createdCount Output number of items created - may be nullptr
+     * @param createdUnder Output parent of the first created item - may be nullptr
+     * @return Item at path - nullptr if not found and not created
+     */
+    QTreeWidgetItem* ResolvePath(const QStringList &segments, bool createMissing,
+                                 int *createdCount, QTreeWidgetItem **createdUnder);
+
+    /**
+     * @brief Finds or creates the child with a text under one sibling list owner
+     * @param container Parent item or invisible root item
+     * @param text Child text
+     * @param createMissing Create the child if no child has this text
+     * @param createdCount Output number of created items, incremented on creation - may be nullptr
+     * @param createdUnder Output parent of the first created item - may be nullptr, untouched for root level
+     * @return Child item - nullptr if not found and not created
+     */
+    QTreeWidgetItem* ResolveChild(QTreeWidgetItem *container, const QString &text, bool createMissing,
+                                  int *createdCount, QTreeWidgetItem **createdUnder);
+
+    /**
+     * @brief Looks up a child by text through the (parent identifier, text hash) index
+     * The sibling list is indexed on first lookup; entries left behind by moves and renames are dropped when seen.
+     * Compact mode keeps no index and scans the sibling list
+     * @param container Parent item or invisible root item
+     * @param text Child text
+     * @return First child in sibling order with this text - nullptr if none
+     */
+    QTreeWidgetItem* FindChildByText(QTreeWidgetItem *container, const QString &text) const;
+
+    /**
+     * @brief Adds all children of a sibling list owner to the path index
+     * @param container Parent item or invisible root item
+     */
+    void IndexPathContainer(QTreeWidgetItem *container) const;
+
+    /**
+     * @brief Adds one item to the path index under its current parent and text
+     * @param item Attached item
+     */
+    void AddPathIndexEntry(QTreeWidgetItem *item) const;
+
+    /**
+     * @brief Gets whether the children of a sibling list owner are in the path index
+     * @param containerId Parent identifier - 0 for root level
+     * @return True if every child is indexed
+     */
+    bool IsPathContainerIndexed(quint32 containerId) const;
+
+    /**
+     * @brief Gets the sibling list owner of a model index
+     * @param index Parent index from a model signal - invalid for root level
+     * @return Parent item or invisible root item - nullptr if the index cannot be resolved
+     */
+    QTreeWidgetItem* ContainerFromIndex(const QModelIndex &index) const;
+
+    /**
+     * @brief Collects all items in pre-order - parents before children, siblings in view order
+     * @param items Output items
+     */
+    void CollectPreOrder(QVector<QTreeWidgetItem*> *items) const;
+
+    /**
+     * @brief Removes and deletes an item with its subtree without notifications
+     * @param item Item to delete
+     * @return Number of items deleted
+     */
+    int DestroySubtree(QTreeWidgetItem *item);
+
+    /**
+     * @brief Recalculates check state of a changed sibling list owner and its ancestors
+     * @param container Parent item or invisible root item whose children changed
+     */
+    void RefreshCheckStateAfterChange(QTreeWidgetItem *container);
+
+    /**
+     * @brief Assigns the next node identifier to a new item and records it in the node table
+     * @param item Detached item being created
+     * @param nodeId Identifier to assign (journal replay) - 0 assigns the next free identifier
+     */
+    void RegisterItem(A_TreeItem *item, quint32 nodeId = 0);
+
+    /**
+     * @brief Releases identifiers, checked-leaf bits and sort configuration of a subtree before deletion
+     * @param item Root of the subtree being removed
+     * @return Number of items in the subtree
+     */
+    int UnregisterSubtree(QTreeWidgetItem *item);
+
+    /**
+     * @brief Releases a subtree like UnregisterSubtree without journaling it
+     * @param item Root of the subtree being removed - its removal is journaled by the caller
+     * @return Number of items in the subtree
+     */
+    int ReleaseSubtree(QTreeWidgetItem *item);
+
+    /**
+     * @brief Takes an item out of its parent or the root level and updates the parent's check state
+     * @param item Item to detach - its subtree stays registered
+     */
+    void DetachItem(QTreeWidgetItem *item);
+
+    /**
+     * @brief Updates the checked-leaf bit of an item from its current state and child count
+     * @param item Item whose state or leaf status changed
+     */
+    void SyncCheckedLeafBit(QTreeWidgetItem *item);
+
+    /**
+     * @brief Appends AddNode records for an item that was just inserted and its whole subtree
+     * @param item Root of the inserted subtree - must already be attached to its parent
+     */
+    void JournalAddedSubtree(QTreeWidgetItem *item);
+
+    /**
+     * @brief Appends a record describing the current state of one item
+     * @param type RemoveNode, SetText, SetCheckState or MoveNode
+     * @param item Affected item - ignored if nullptr
+     */
+    void JournalItemRecord(A_TreeJournal::Operation type, QTreeWidgetItem *item);
+
+    /**
+     * @brief Appends a SetChildOrder record with the current order of a sibling list
+     * @param container Parent item or invisible root item that was reordered
+     */
+    void JournalChildOrder(QTreeWidgetItem *container);
+
+    /**
+     * @brief Appends a record of a sort configuration that is kept from now on
+     * @param container Parent item or invisible root item - nullptr for the tree-wide configuration
+     * @param spec Sort configuration
+     */
+    void JournalSortSpec(QTreeWidgetItem *container, const SortSpec &spec);
+
+    /**
+     * @brief Opens a journal for the current tree without recovering it - the tree becomes the journal's new snapshot
+     * @param directoryPath Journal directory
+     * @return True if the journal is open and recording
+     */
+    bool ResumeJournal(const QString &directoryPath);
+
+    /**
+     * @brief Captures the frozen encoding as journal snapshot nodes
+     * @param nodes Receives the nodes in pre-order
+     */
+    void CaptureFrozenSnapshot(QVector<A_TreeJournal::SnapshotNode> *nodes) const;
+
+    /**
+     * @brief Rebuilds the tree from journal snapshot nodes
+     * @param nodes Snapshot nodes in pre-order
+     * @param nextNodeId First unused node identifier at snapshot time
+     */
+    void RestoreJournalSnapshot(const QVector<A_TreeJournal::SnapshotNode> &nodes, quint32 nextNodeId);
+
+    /**
+     * @brief Creates the item of one journal snapshot node, detached below its restored parent
+     * @param node Snapshot node - its parent precedes it in pre-order
+     * @return New root item - nullptr for child items and skipped nodes
+     */
+    A_TreeItem* RestoreJournalNode(const A_TreeJournal::SnapshotNode &node);
+
+    /**
+     * @brief Reserves the snapshot's identifiers and updates the checked-leaf bits once all snapshot nodes are restored
+     * @param nextNodeId First unused node identifier at snapshot time
+     */
+    void FinishJournalSnapshot(quint32 nextNodeId);
+
+    /**
+     * @brief Re-applies one journal record during recovery
+     * @param record Record to apply - records referring to missing items are skipped
+     */
+    void ApplyJournalRecord(const A_TreeJournal::Record &record);
+
+    /**
+     * @brief Records that the snapshot block holding the item at a model index changed
+     * @param index Changed item or parent of inserted/removed rows - invalid for root level list changes
+     */
+    void MarkSnapshotDirty(const QModelIndex &index);
+
+    /**
+     * @brief Records that the snapshot block holding an item changed
+     * @param item Changed item or owner of inserted/removed rows - invisible root item or nullptr for root level list changes
+     */
+    void MarkSnapshotDirty(QTreeWidgetItem *item);
+
+    /**
+     * @brief Records that the children of an item were reordered
+     * @param container Owner of the reordered children - invisible root item for the root level
+     */
+    void MarkSnapshotChildrenDirty(QTreeWidgetItem *container);
+
+    /**
+     * @brief Records that every snapshot block may have changed
+     */
+    void MarkSnapshotAllDirty();
+
+    /**
+     * @brief Checks whether a block of the previous snapshot still describes the items at a position
+     * @param block Clean block whose first item is the child at childIndex
+     * @param container Owner of the sibling list being walked
+     * @param childIndex Child index of the block's first item
+     * @return True if the block can be taken over
+     */
+    bool IsSnapshotBlockReusable(const A_TreeSnapshot::Block &block, QTreeWidgetItem *container, int childIndex) const;
+
+    /**
+     * @brief Flattens a run of sibling subtrees, or the head of one large subtree, into an immutable snapshot block
+     * @param container Owner of the sibling list
+     * @param firstIndex Child index of the block's first item
+     * @param reusableBlocks Unchanged blocks by first node identifier - a run stops before one of them
+     * @return New block - bounded by the block size
+     */
+    std::shared_ptr<const A_TreeSnapshot::Block> BuildSnapshotBlock(QTreeWidgetItem *container, int firstIndex,
+                                                                    const QHash<quint32, std::shared_ptr<const A_TreeSnapshot::Block>> &reusableBlocks);
+
+    /**
+     * @brief Appends a subtree in pre-order to a block being built
+     * @param block Block being filled
+     * @param item Subtree root
+     * @param parentIndex Block-local position of the item's parent - -1 for top level items
+     */
+    void AppendSnapshotSubtree(A_TreeSnapshot::Block *block, QTreeWidgetItem *item, int parentIndex) const;
+
+    /**
+     * @brief Expands a newly populated item, or only records it as expanded during a bulk update
+     * @param item Item to expand
+     */
+    void ExpandNewItem(QTreeWidgetItem *item);
+
+    /**
+     * @brief Replaces all items with the content of a shared store snapshot, or applies the blocks that changed
+     * Items take the writer's identifiers, so the recorded expand state carries over
+     * @param snapshot Store content
+     */
+    void LoadSharedSnapshot(const std::shared_ptr<const A_TreeSnapshot> &snapshot);
+
+    /**
+     * @brief Brings the items of a loaded shared store version to a newer one
+     * @param previous Loaded version
+     * @param snapshot New version - shares its unchanged blocks with previous
+     */
+    void ApplySharedSnapshotDelta(const A_TreeSnapshot &previous, const A_TreeSnapshot &snapshot);
+
+    /**
+     * @brief Resets the view's expansion to ExpandedBits with a single deferred layout
+     */
+    void ApplyExpandedState();
+
+    /**
+     * @brief Propagates an item's check state to its subtree and ancestors
+     * @param item Item whose check state was set
+     */
+    void PropagateCheckState(QTreeWidgetItem *item);
+
+    /**
+     * @brief Gets whether a change can be applied to roll-ups by delta
+     * During bulk updates roll-ups are marked stale instead and recomputed by EndBulkUpdate
+     * @return True if roll-ups are enabled, current and no bulk update is running
+     */
+    bool CanApplyAggregateDelta();
+
+    /**
+     * @brief Gets the contribution of one item alone to roll-ups
+     * @param item Tree item
+     * @return Checked-leaf flag and own value of the aggregated column
+     */
+    A_TreeAggregates::Values GetOwnAggregate(A_TreeItem *item) const;
+
+    /**
+     * @brief Gets the roll-up of a subtree, computing nodes that were never computed (newly attached subtrees)
+     * @param item Subtree root
+     * @return Roll-up values
+     */
+    A_TreeAggregates::Values GetSubtreeAggregate(QTreeWidgetItem *item);
+
+    /**
+     * @brief Applies a delta to an item and its ancestors
+     * @param item First item to update - the invisible root item updates nothing
+     * @param delta Values to add or remove
+     * @param isRemoval True to subtract the delta
+     */
+    void ApplyAggregateDelta(QTreeWidgetItem *item, const A_TreeAggregates::Values &delta, bool isRemoval);
+
+    /**
+     * @brief Gets the hashes of a subtree, rehashing invalid nodes below it
+     * @param item Subtree root
+     * @return Subtree hashes
+     */
+    A_TreeHashes::Values GetSubtreeHashes(QTreeWidgetItem *item);
+
+    /**
+     * @brief Invalidates the hashes of an item and its ancestors after a change
+     * @param item Changed item or owner of changed rows - the invisible root item changes nothing
+     */
+    void InvalidateSubtreeHash(QTreeWidgetItem *item);
+
+    /**
+     * @brief Recomputes the Min/Max of an item whose range was widened by a removal
+     * @param item Item with a dirty range - dirty children are resolved first
+     */
+    void ResolveAggregateRange(QTreeWidgetItem *item);
+
+    /**
+     * @brief Reads the aggregated column value of a node as double
+     * @param nodeId Node identifier
+     * @param value Output value
+     * @return True if the node has a value
+     */
+    bool GetAggregateValue(quint32 nodeId, double *value) const;
+
+    /**
+     * @brief Sets up the user interface components
+     * Creates and configures the tree widget and layout
+     */
+    void SetupUserInterface();
+
+    /**
+     * @brief Applies styling to the tree views
+     * Sets colors, fonts, and visual appearance for consistency. The sheet is set once on this widget
+     * before any view exists, so both TreeWidget and a frozen view inherit it without parsing it again
+     */
+    void SetTreeWidgetStyle();
+
+    /**
+     * @brief Sets up the context menu and its actions
+     * Creates right-click menu with add, edit, delete options - called on the first right click
+     */
+    void SetupContextMenu();
+
+    /**
+     * @brief Connects internal signals and slots
+     * Establishes communication between tree widget and internal handlers
+     */
+    void ConnectSignalsAndSlots();
+
+    /**
+     * @brief Updates child items to match parent's checked state
+     * @param parentItem Parent item whose children should be updated - must be valid
+     */
+    void UpdateChildrenCheckState(QTreeWidgetItem *parentItem);
+
+    /**
+     * @brief Updates parent item's checked state based on children
+     * @param childItem Child item that triggered the update - must be valid
+     */
+    void UpdateParentCheckState(QTreeWidgetItem *childItem);
+
+    /**
+     * @brief Calculates appropriate check state for parent based on children
+     * @param parentItem Parent item to calculate state for - must be valid
+     * @return Calculated check state - Checked, Unchecked, or PartiallyChecked
+     */
+    Qt::CheckState CalculateParentCheckState(QTreeWidgetItem *parentItem) const;
+
+    // UI Components
+    QTreeWidget *TreeWidget;         // Main tree display widget - shows hierarchical data with checkboxes
+    QVBoxLayout *MainLayout;         // Layout container - organizes tree widget within this widget
+
+    // Context Menu Components
+    QMenu *ContextMenu;              // Right-click context menu - provides item manipulation options
+    QAction *AddRootAction;          // Context menu action - adds new root level item
+    QAction *AddChildAction;         // Context menu action - adds child to selected item
+    QAction *EditAction;             // Context menu action - edits selected item text
+    QAction *DeleteAction;           // Context menu action - deletes selected item
+    QMenu *SortMenu;                 // Context submenu - sorts children of selected item by chosen criterion
+
+    // State Variables
+    QTreeWidgetItem *CurrentItem;    // Currently selected/right-clicked item - can be nullptr if no selection
+    bool IsEditModeEnabled;          // Edit mode flag - true allows editing, false makes read-only
+    bool IsInternalUpdate;           // Internal update flag - prevents recursive signal handling during updates
+    QString EditStartText;           // Text of the item when its inline editor opened - compared when the editor closes
+
+    // Filter State
+    QString FilterText;                          // Requested filter query - empty when no filter is active
+    QString FilterMatchQuery;                    // Query that FilterMatchBits was computed for - basis for narrowing
+    QVector<QTreeWidgetItem*> FilterItems;       // Flattened items in pre-order - valid while index is clean
+    QVector<int> FilterParents;                  // Parent index per flattened item - -1 for root items
+    QStringList FilterTexts;                     // Item texts per flattened item - shared with worker threads
+    QBitArray FilterMatchBits;                   // Per-node "text matches" bits of the last applied result
+    QBitArray FilterVisibleBits;                 // Per-node "matches or has matching descendant" bits currently applied
+    QFutureWatcher<FilterResult> *FilterWatcher; // Watcher for background evaluations on large trees
+    int FilterRequestId;                         // Latest filter request - increments on every run and invalidation
+    bool IsFilterIndexDirty;                     // Index dirty flag - true when tree changed since last flattening
+    bool IsFilterRefreshPending;                 // Refresh flag - true while a coalesced re-filter is scheduled
+
+    // Sort State
+    QHash<QTreeWidgetItem*, SortSpec> SortedParents;  // Sibling lists kept sorted - keyed by parent or invisible root
+    SortSpec TreeSortSpec;                            // Tree-wide sort configuration - used when IsTreeSorted is set
+    bool IsTreeSorted;                                // Tree-wide sort flag - true after SortAllItems until cleared
+    QTreeWidgetItem *SortingContainer;                // Sibling list being reordered by ApplySortRanks - nullptr otherwise
+    QCollator TextCollator;                           // Collator for text order - case-insensitive locale collation
+    QCollator NaturalCollator;                        // Collator for natural order - numeric mode enabled
+
+    // Node Identity State
+    QVector<A_TreeItem*> NodeTable;                   // Items indexed by node identifier - slot 0 reserved, nullptr once deleted
+    QBitArray CheckedLeafBits;                        // Packed per-node flags - set if node is a leaf in Checked state
+    QBitArray ExpandedBits;                           // Packed per-node flags - set if node is expanded, also below collapsed parents
+
+    // Path Index State
+    mutable QMultiHash<QPair<quint32, uint>, quint32> PathIndex;  // Child identifiers by (parent identifier, text hash) - 0 is root level
+    mutable QBitArray PathIndexedBits;                // Packed per-node flags - set if the node's children are in PathIndex, bit 0 for root level
+
+    // Memory State
+    A_TreeItemContext ItemContext;                    // Tree state shared by all items - one pointer per item
+    bool IsCompact;                                   // Compact mode flag - true while optional per-node state is not kept
+
+    // Attribute State
+    A_TreeAttributes Attributes;                      // Typed attribute columns indexed by node identifier - read by items at render time
+
+    // Aggregate State
+    A_TreeAggregates Aggregates;                      // Subtree roll-ups indexed by node identifier - maintained by delta while enabled
+    bool IsAggregatesStale;                           // Recompute flag - true when changes skipped delta maintenance
+
+    // Hash State
+    A_TreeHashes Hashes;                              // Subtree hashes indexed by node identifier - invalidated up the ancestor chain on change
+
+    // Bulk Update State
+    int BulkUpdateDepth;                              // Nesting depth of BeginBulkUpdate calls - 0 outside bulk updates
+    bool IsApplyingExpandState;                       // Expand restore flag - true while view expansion is reset
+
+    // Subtree Job State
+    QVector<SubtreeJob> SubtreeJobs;                  // Queued time-sliced jobs - the first one is running
+    bool IsSubtreeSlicePending;                       // Slice flag - true while the next slice is scheduled
+
+    // Persistence State
+    A_TreeJournal *Journal;                           // Write-ahead journal - nullptr while journaling is off or replaying
+    std::unique_ptr<JournalRestore> PendingRestore;   // Sliced recovery - nullptr unless EnableJournalInSlices is running
+
+    // Snapshot State
+    std::shared_ptr<const A_TreeSnapshot> PublishedSnapshot;  // Latest snapshot - read and replaced with std::atomic_load/store
+    QSet<quint32> DirtySnapshotBlocks;                // First node identifiers of blocks to rebuild on next publish
+    QVector<quint32> SnapshotBlockKeys;               // First node identifier of the block holding each node - 0 if in none
+    quint64 SnapshotVersion;                          // Version of the latest published snapshot
+    bool IsSnapshotAllDirty;                          // Rebuild flag - true when no block of the last snapshot may be reused
+    bool IsSnapshotStale;                             // Stale flag - true when the tree changed since the last publish
+    bool IsSnapshotPublishPending;                    // Publish flag - true while a coalesced publish is scheduled
+    mutable std::atomic<bool> IsSnapshotRequested;    // Tracking flag - false until a snapshot was first requested
+
+    // Export State
+    QFutureWatcher<qint64> *ExportWatcher;            // Watcher for background exports - result is the record count, -1 on failure
+
+    // Shared Store State
+    A_TreeSharedStore SharedStore;                    // Shared-memory store - written after every snapshot publish or followed as reader
+    QTimer *SharedPollTimer;                          // Reader poll timer - checks the store's sequence counter
+    quint64 SharedSequence;                           // Sequence of the loaded store content - odd value means nothing loaded
+    std::shared_ptr<const A_TreeSnapshot> SharedContent;  // Loaded store content - nullptr before the first load
+    bool IsSharedReader;                              // Reader flag - true while items mirror a shared store
+
+    // Frozen State
+    std::unique_ptr<A_TreeSuccinct> FrozenTree;       // Succinct encoding - nullptr unless frozen
+    A_TreeFrozenModel *FrozenModel;                   // Model over FrozenTree - nullptr unless frozen
+    QTreeView *FrozenView;                            // View replacing TreeWidget while frozen - nullptr unless frozen
+    int FrozenPageSize;                               // Children per bucket of wide parents in FrozenView - 0 if paging is off
+    QString FrozenJournalPath;                        // Directory of the journal closed by FreezeTree - empty if none was open
+    QHash<int, QString> FrozenSyncKeys;               // Sync keys of frozen nodes by node number
+    QBitArray FrozenExpandedBits;                     // Expand bits of frozen nodes by node number
 };
 
 #endif // A_TREE_H
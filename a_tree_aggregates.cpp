@@ -0,0 +1,281 @@
+#include "a_tree_aggregates.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+namespace {
+const int MinimumTaskSize = 4096;  // Subtrees smaller than this are never split further
+}
+
+A_TreeAggregates::A_TreeAggregates()
+    : ValueColumn(-1)               // Value column - starts at -1, only counts are maintained
+    , IsOn(false)                   // Maintenance flag - starts false, no cost until enabled
+{
+}
+
+bool A_TreeAggregates::IsEnabled() const
+{
+    /**
+     * Gets the maintenance flag
+     * @return True if enabled
+     */
+
+    return IsOn;
+}
+
+int A_TreeAggregates::GetValueColumn() const
+{
+    /**
+     * Gets the summed column
+     * @return Attribute column or -1
+     */
+
+    return ValueColumn;
+}
+
+void A_TreeAggregates::Enable(int valueColumn)
+{
+    /**
+     * Enables maintenance with empty values
+     */
+
+    IsOn = true;
+    ValueColumn = valueColumn;
+    Invalidate();
+}
+
+void A_TreeAggregates::Disable()
+{
+    /**
+     * Disables maintenance and releases memory
+     */
+
+    IsOn = false;
+    ValueColumn = -1;
+    Nodes.clear();
+    ValidBits.clear();
+    RangeDirtyBits.clear();
+}
+
+void A_TreeAggregates::Invalidate()
+{
+    /**
+     * Drops all values - nothing is valid until computed again
+     */
+
+    Nodes.clear();
+    ValidBits.clear();
+    RangeDirtyBits.clear();
+}
+
+bool A_TreeAggregates::IsValid(quint32 nodeId) const
+{
+    /**
+     * Tests the valid bit of a node
+     * @return True if computed
+     */
+
+    return int(nodeId) < ValidBits.size() && ValidBits.testBit(int(nodeId));
+}
+
+bool A_TreeAggregates::IsRangeDirty(quint32 nodeId) const
+{
+    /**
+     * Tests the range dirty bit of a node
+     * @return True if Min/Max need recomputation
+     */
+
+    return int(nodeId) < RangeDirtyBits.size() && RangeDirtyBits.testBit(int(nodeId));
+}
+
+const A_TreeAggregates::Values& A_TreeAggregates::Get(quint32 nodeId) const
+{
+    /**
+     * Reads a node's values
+     * @return Values
+     */
+
+    return Nodes.at(int(nodeId));
+}
+
+void A_TreeAggregates::Set(quint32 nodeId, const Values &values)
+{
+    /**
+     * Stores values computed from scratch
+     */
+
+    Grow(nodeId);
+    Nodes[int(nodeId)] = values;
+    ValidBits.setBit(int(nodeId));
+    RangeDirtyBits.clearBit(int(nodeId));                 // Range computed from the subtree is exact
+}
+
+void A_TreeAggregates::Add(quint32 nodeId, const Values &delta)
+{
+    /**
+     * Applies a positive delta - counts and sum add up, the range widens
+     */
+
+    Values &_values = Nodes[int(nodeId)];                 // Values being updated
+    if (delta.ValueCount > 0) {
+        if (_values.ValueCount == 0) {
+            _values.Min = delta.Min;                      // First value in the subtree
+            _values.Max = delta.Max;
+        } else {
+            _values.Min = qMin(_values.Min, delta.Min);
+            _values.Max = qMax(_values.Max, delta.Max);
+        }
+    }
+    _values.DescendantCount += delta.DescendantCount;
+    _values.CheckedLeafCount += delta.CheckedLeafCount;
+    _values.ValueCount += delta.ValueCount;
+    _values.Sum += delta.Sum;
+}
+
+bool A_TreeAggregates::Subtract(quint32 nodeId, const Values &delta)
+{
+    /**
+     * Applies a negative delta - counts and sum are exact, the range can only be narrowed by a rescan
+     * @return True if the range became dirty
+     */
+
+    Values &_values = Nodes[int(nodeId)];                 // Values being updated
+    _values.DescendantCount -= delta.DescendantCount;
+    _values.CheckedLeafCount -= delta.CheckedLeafCount;
+    _values.ValueCount -= delta.ValueCount;
+    _values.Sum -= delta.Sum;
+
+    if (delta.ValueCount == 0) {
+        return false;                                     // No values removed
+    }
+    if (_values.ValueCount == 0) {
+        _values.Sum = 0.0;                                // Drop rounding residue
+        return false;                                     // Empty range is exact
+    }
+    if (delta.Min > _values.Min && delta.Max < _values.Max) {
+        return false;                                     // Removed values were strictly inside the range
+    }
+
+    return MarkRangeDirty(nodeId);
+}
+
+bool A_TreeAggregates::MarkRangeDirty(quint32 nodeId)
+{
+    /**
+     * Sets the range dirty bit
+     * @return True if newly set
+     */
+
+    Grow(nodeId);
+    if (RangeDirtyBits.testBit(int(nodeId))) {
+        return false;
+    }
+    RangeDirtyBits.setBit(int(nodeId));
+    return true;
+}
+
+void A_TreeAggregates::Combine(Values &parent, const Values &child)
+{
+    /**
+     * Folds a child subtree into its parent's values
+     */
+
+    if (child.ValueCount > 0) {
+        if (parent.ValueCount == 0) {
+            parent.Min = child.Min;
+            parent.Max = child.Max;
+        } else {
+            parent.Min = qMin(parent.Min, child.Min);
+            parent.Max = qMax(parent.Max, child.Max);
+        }
+    }
+    parent.DescendantCount += child.DescendantCount + 1;  // Child and its descendants
+    parent.CheckedLeafCount += child.CheckedLeafCount;
+    parent.ValueCount += child.ValueCount;
+    parent.Sum += child.Sum;
+}
+
+void A_TreeAggregates::Compute(const Layout &layout)
+{
+    /**
+     * Computes every roll-up from scratch
+     * Large subtrees are split until there are enough independent tasks for all cores; each task folds
+     * its range children-first into positions it owns, then the few split nodes above the tasks are
+     * folded on the calling thread
+     */
+
+    const int _nodeCount = layout.NodeIds.size();         // Nodes in the tree
+    QVector<Values> _values = layout.OwnValues;           // Roll-ups by pre-order position
+    Values *_data = _values.data();                       // Detach once on calling thread
+
+    const int _taskTarget = qMax(MinimumTaskSize, _nodeCount / qMax(1, 4 * QThread::idealThreadCount()));
+    QVector<int> _tasks;                                  // Subtree roots processed on workers
+    QVector<int> _splitNodes;                             // Nodes above the tasks - folded afterwards
+    QVector<int> _pending;                                // Subtree roots still to classify
+    for (int _position = 0; _position < _nodeCount; _position = layout.SubtreeEnds.at(_position)) {
+        _pending.append(_position);                       // Root items
+    }
+    while (!_pending.isEmpty()) {
+        int _root = _pending.takeLast();
+        int _end = layout.SubtreeEnds.at(_root);
+        if (_end - _root <= _taskTarget || _end - _root == 1) {
+            _tasks.append(_root);
+            continue;
+        }
+        _splitNodes.append(_root);                        // Too large - hand its children out instead
+        for (int _child = _root + 1; _child < _end; _child = layout.SubtreeEnds.at(_child)) {
+            _pending.append(_child);
+        }
+    }
+
+    QtConcurrent::blockingMap(_tasks, [_data, &layout](const int &root) {
+        for (int _position = layout.SubtreeEnds.at(root) - 1; _position > root; --_position) {
+            Combine(_data[layout.ParentIndexes.at(_position)], _data[_position]);  // Parent lies inside the task
+        }
+    });
+
+    std::sort(_splitNodes.begin(), _splitNodes.end());    // Children-first order is reverse pre-order
+    for (int _index = _splitNodes.size() - 1; _index >= 0; --_index) {
+        int _node = _splitNodes.at(_index);
+        for (int _child = _node + 1; _child < layout.SubtreeEnds.at(_node); _child = layout.SubtreeEnds.at(_child)) {
+            Combine(_data[_node], _data[_child]);         // Children are tasks or split nodes done earlier
+        }
+    }
+
+    Invalidate();
+    if (_nodeCount > 0) {
+        Grow(*std::max_element(layout.NodeIds.constBegin(), layout.NodeIds.constEnd()));
+    }
+    for (int _position = 0; _position < _nodeCount; ++_position) {
+        quint32 _nodeId = layout.NodeIds.at(_position);
+        Nodes[int(_nodeId)] = _values.at(_position);
+        ValidBits.setBit(int(_nodeId));
+    }
+}
+
+qint64 A_TreeAggregates::GetMemoryBytes() const
+{
+    /**
+     * Sums value capacity and flag bits
+     * @return Bytes
+     */
+
+    return qint64(Nodes.capacity()) * qint64(sizeof(Values)) + (ValidBits.size() + 7) / 8 + (RangeDirtyBits.size() + 7) / 8;
+}
+
+void A_TreeAggregates::Grow(quint32 nodeId)
+{
+    /**
+     * Grows values and flags geometrically
+     */
+
+    const int _required = int(nodeId) + 1;                // Size needed to address nodeId
+    if (Nodes.size() >= _required) {
+        return;
+    }
+
+    const int _size = qMax(_required, 2 * Nodes.size());  // Grow geometrically
+    Nodes.resize(_size);
+    ValidBits.resize(_size);
+    RangeDirtyBits.resize(_size);
+}
@@ -0,0 +1,150 @@
+#ifndef A_TREE_AGGREGATES_H
+#define A_TREE_AGGREGATES_H
+
+#include <QVector>
+#include <QBitArray>
+
+class A_TreeAggregates
+{
+public:
+    /**
+     * @brief Roll-up of one node's subtree
+     */
+    struct Values
+    {
+        qint32 DescendantCount = 0;  // Items below the node
+        qint32 CheckedLeafCount = 0; // Checked leaves in the subtree - the node itself included
+        qint32 ValueCount = 0;       // Items in the subtree with a value in the aggregated column
+        double Sum = 0.0;            // Sum of aggregated column values
+        double Min = 0.0;            // Smallest value - meaningful only if ValueCount > 0
+        double Max = 0.0;            // Largest value - meaningful only if ValueCount > 0
+    };
+
+    /**
+     * @brief Flattened tree handed to Compute
+     */
+    struct Layout
+    {
+        QVector<quint32> NodeIds;            // Node identifiers in pre-order
+        QVector<int> ParentIndexes;          // Parent position - -1 for root items
+        QVector<int> SubtreeEnds;            // Position one past each node's subtree
+        QVector<Values> OwnValues;           // Contribution of each node alone (leaf flag, own value)
+    };
+
+    /**
+     * @brief Constructor for disabled aggregates
+     */
+    A_TreeAggregates();
+
+    /**
+     * @brief Gets whether aggregates are maintained
+     * @return True if enabled
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Gets the attribute column whose values are summed
+     * @return Attribute column index - -1 if only counts are maintained
+     */
+    int GetValueColumn() const;
+
+    /**
+     * @brief Turns maintenance on and drops all values - call Compute to fill them
+     * @param valueColumn Numeric attribute column to sum - -1 for counts only
+     */
+    void Enable(int valueColumn);
+
+    /**
+     * @brief Turns maintenance off and frees all values
+     */
+    void Disable();
+
+    /**
+     * @brief Marks every node as not computed
+     */
+    void Invalidate();
+
+    /**
+     * @brief Gets whether a node's values are computed
+     * @param nodeId Node identifier
+     * @return True if Get returns the node's roll-up
+     */
+    bool IsValid(quint32 nodeId) const;
+
+    /**
+     * @brief Gets whether a node's Min and Max may be wider than its subtree after a removal
+     * @param nodeId Node identifier
+     * @return True if the range must be recomputed from the children
+     */
+    bool IsRangeDirty(quint32 nodeId) const;
+
+    /**
+     * @brief Gets the values of a node
+     * @param nodeId Node identifier - must be valid
+     * @return Roll-up values
+     */
+    const Values& Get(quint32 nodeId) const;
+
+    /**
+     * @brief Stores computed values of a node and marks it valid with an exact range
+     * @param nodeId Node identifier
+     * @param values Roll-up values
+     */
+    void Set(quint32 nodeId, const Values &values);
+
+    /**
+     * @brief Adds a subtree roll-up to a node by delta
+     * @param nodeId Node identifier - must be valid
+     * @param delta Values to add - Min and Max widen the node's range
+     */
+    void Add(quint32 nodeId, const Values &delta);
+
+    /**
+     * @brief Removes a subtree roll-up from a node by delta
+     * @param nodeId Node identifier - must be valid
+     * @param delta Values to remove
+     * @return True if the removed range touched the node's Min or Max - the range is then marked dirty
+     */
+    bool Subtract(quint32 nodeId, const Values &delta);
+
+    /**
+     * @brief Marks a node's range dirty
+     * @param nodeId Node identifier
+     * @return True if it was clean before
+     */
+    bool MarkRangeDirty(quint32 nodeId);
+
+    /**
+     * @brief Combines a child roll-up into a parent roll-up
+     * @param parent Parent values to extend
+     * @param child Child subtree values - the child itself counts as one descendant
+     */
+    static void Combine(Values &parent, const Values &child);
+
+    /**
+     * @brief Computes all roll-ups of a flattened tree, splitting it into subtrees processed on all cores
+     * @param layout Flattened tree with each node's own contribution
+     */
+    void Compute(const Layout &layout);
+
+    /**
+     * @brief Gets the bytes held by all roll-ups
+     * @return Allocated value and flag bytes
+     */
+    qint64 GetMemoryBytes() const;
+
+private:
+    /**
+     * @brief Grows the arrays to hold a node identifier
+     * @param nodeId Node identifier that must fit
+     */
+    void Grow(quint32 nodeId);
+
+    QVector<Values> Nodes;           // Roll-up values indexed by node identifier
+    QBitArray ValidBits;             // Set if the node's values are computed
+    QBitArray RangeDirtyBits;        // Set if Min/Max may be too wide
+    int ValueColumn;                 // Summed attribute column - -1 for counts only
+    bool IsOn;                       // Maintenance flag
+};
+
+#endif // A_TREE_AGGREGATES_H
@@ -0,0 +1,381 @@
+#include "a_tree_attributes.h"
+
+A_TreeAttributes::A_TreeAttributes()
+{
+}
+
+int A_TreeAttributes::AddColumn(const QString &name, ColumnType type)
+{
+    /**
+     * Appends an empty column
+     * @return Index of the new column
+     */
+
+    Column _column;                                       // Column being added
+    _column.Name = name;
+    _column.Type = type;
+    if (type == TextColumn) {
+        _column.TextPool.append(QString());               // Index 0 stands for "no text"
+        _column.TextLookup.insert(QString(), 0);
+    }
+    Columns.append(_column);
+
+    return Columns.size() - 1;
+}
+
+int A_TreeAttributes::GetColumnCount() const
+{
+    /**
+     * Gets the number of columns
+     * @return Column count
+     */
+
+    return Columns.size();
+}
+
+int A_TreeAttributes::FindColumn(const QString &name) const
+{
+    /**
+     * Searches the column names
+     * @return Column index or -1
+     */
+
+    for (int _column = 0; _column < Columns.size(); ++_column) {
+        if (Columns.at(_column).Name == name) {
+            return _column;
+        }
+    }
+
+    return -1;
+}
+
+QString A_TreeAttributes::GetColumnName(int column) const
+{
+    /**
+     * Gets a column name
+     * @return Name
+     */
+
+    return Columns.at(column).Name;
+}
+
+A_TreeAttributes::ColumnType A_TreeAttributes::GetColumnType(int column) const
+{
+    /**
+     * Gets a column type
+     * @return Type
+     */
+
+    return Columns.at(column).Type;
+}
+
+bool A_TreeAttributes::HasValue(int column, quint32 nodeId) const
+{
+    /**
+     * Tests the presence bit of a node
+     * @return True if set
+     */
+
+    const QBitArray &_presence = Columns.at(column).Presence;  // Presence flags of the column
+    return int(nodeId) < _presence.size() && _presence.testBit(int(nodeId));
+}
+
+qint64 A_TreeAttributes::GetInteger(int column, quint32 nodeId) const
+{
+    /**
+     * Reads the integer array directly
+     * @return Value or 0
+     */
+
+    const QVector<qint64> &_values = Columns.at(column).Integers;  // Values of the column
+    return int(nodeId) < _values.size() ? _values.at(int(nodeId)) : 0;
+}
+
+double A_TreeAttributes::GetDouble(int column, quint32 nodeId) const
+{
+    /**
+     * Reads the double array directly
+     * @return Value or 0
+     */
+
+    const QVector<double> &_values = Columns.at(column).Doubles;  // Values of the column
+    return int(nodeId) < _values.size() ? _values.at(int(nodeId)) : 0.0;
+}
+
+const QString& A_TreeAttributes::GetText(int column, quint32 nodeId) const
+{
+    /**
+     * Resolves the text index of a node in the column's pool
+     * @return Pooled text
+     */
+
+    const Column &_column = Columns.at(column);           // Column holding the pool
+    quint32 _textId = int(nodeId) < _column.TextIds.size() ? _column.TextIds.at(int(nodeId)) : 0;
+    return _column.TextPool.at(int(_textId));
+}
+
+void A_TreeAttributes::SetInteger(int column, quint32 nodeId, qint64 value)
+{
+    /**
+     * Stores an integer in place
+     */
+
+    Column &_column = Columns[column];                    // Column being written
+    Grow(_column, nodeId);
+    _column.Integers[int(nodeId)] = value;
+    _column.Presence.setBit(int(nodeId));
+}
+
+void A_TreeAttributes::SetDouble(int column, quint32 nodeId, double value)
+{
+    /**
+     * Stores a double in place
+     */
+
+    Column &_column = Columns[column];                    // Column being written
+    Grow(_column, nodeId);
+    _column.Doubles[int(nodeId)] = value;
+    _column.Presence.setBit(int(nodeId));
+}
+
+void A_TreeAttributes::SetDateTime(int column, quint32 nodeId, const QDateTime &value)
+{
+    /**
+     * Stores a timestamp as milliseconds since epoch
+     */
+
+    if (!value.isValid()) {
+        ClearValue(column, nodeId);                       // No timestamp
+        return;
+    }
+
+    SetInteger(column, nodeId, value.toMSecsSinceEpoch());
+}
+
+void A_TreeAttributes::SetText(int column, quint32 nodeId, const QString &value)
+{
+    /**
+     * Stores the pool index of a text, adding the text to the pool on first use
+     */
+
+    Column &_column = Columns[column];                    // Column being written
+    Grow(_column, nodeId);
+
+    QHash<QString, quint32>::const_iterator _found = _column.TextLookup.constFind(value);
+    quint32 _textId = 0;                                  // Pool index of value
+    if (_found != _column.TextLookup.constEnd()) {
+        _textId = _found.value();                         // Text seen before - share it
+    } else {
+        _textId = quint32(_column.TextPool.size());
+        _column.TextPool.append(value);
+        _column.TextLookup.insert(value, _textId);
+    }
+
+    _column.TextIds[int(nodeId)] = _textId;
+    _column.Presence.setBit(int(nodeId));
+}
+
+bool A_TreeAttributes::SetValue(int column, quint32 nodeId, const QVariant &value)
+{
+    /**
+     * Converts a variant to the column type and stores it unboxed
+     * @return True if stored or cleared
+     */
+
+    if (value.isNull()) {
+        ClearValue(column, nodeId);                       // Null clears
+        return true;
+    }
+
+    bool _isConverted = false;                            // Conversion result
+    switch (Columns.at(column).Type) {
+    case IntegerColumn: {
+        qint64 _value = value.toLongLong(&_isConverted);
+        if (_isConverted) {
+            SetInteger(column, nodeId, _value);
+        }
+        break;
+    }
+    case DoubleColumn: {
+        double _value = value.toDouble(&_isConverted);
+        if (_isConverted) {
+            SetDouble(column, nodeId, _value);
+        }
+        break;
+    }
+    case DateTimeColumn: {
+        QDateTime _value = value.toDateTime();
+        _isConverted = _value.isValid();
+        if (_isConverted) {
+            SetInteger(column, nodeId, _value.toMSecsSinceEpoch());
+        }
+        break;
+    }
+    case TextColumn:
+        SetText(column, nodeId, value.toString());
+        _isConverted = true;
+        break;
+    }
+
+    return _isConverted;
+}
+
+void A_TreeAttributes::ClearValue(int column, quint32 nodeId)
+{
+    /**
+     * Clears the presence bit and resets the stored value
+     */
+
+    Column &_column = Columns[column];                    // Column being written
+    if (int(nodeId) >= _column.Presence.size()) {
+        return;                                           // Never stored
+    }
+
+    _column.Presence.clearBit(int(nodeId));
+    switch (_column.Type) {
+    case IntegerColumn:
+    case DateTimeColumn:
+        _column.Integers[int(nodeId)] = 0;
+        break;
+    case DoubleColumn:
+        _column.Doubles[int(nodeId)] = 0.0;
+        break;
+    case TextColumn:
+        _column.TextIds[int(nodeId)] = 0;                 // Pooled text stays for later reuse
+        break;
+    }
+}
+
+void A_TreeAttributes::ClearNode(quint32 nodeId)
+{
+    /**
+     * Clears a node in every column
+     */
+
+    for (int _column = 0; _column < Columns.size(); ++_column) {
+        ClearValue(_column, nodeId);
+    }
+}
+
+void A_TreeAttributes::ClearValues()
+{
+    /**
+     * Drops all values and text pools, keeping column definitions
+     */
+
+    for (Column &_column : Columns) {
+        _column.Integers.clear();
+        _column.Doubles.clear();
+        _column.TextIds.clear();
+        _column.Presence.clear();
+        if (_column.Type == TextColumn) {
+            _column.TextPool = QStringList(QString());    // Keep index 0
+            _column.TextLookup.clear();
+            _column.TextLookup.insert(QString(), 0);
+        }
+    }
+}
+
+QVariant A_TreeAttributes::GetDisplayValue(int column, quint32 nodeId) const
+{
+    /**
+     * Boxes a stored value for painting
+     * @return Value or null variant
+     */
+
+    if (column < 0 || column >= Columns.size() || !HasValue(column, nodeId)) {
+        return QVariant();                                // Empty cell
+    }
+
+    switch (Columns.at(column).Type) {
+    case IntegerColumn:
+        return QVariant(qlonglong(GetInteger(column, nodeId)));
+    case DoubleColumn:
+        return QVariant(GetDouble(column, nodeId));
+    case DateTimeColumn:
+        return QVariant(QDateTime::fromMSecsSinceEpoch(GetInteger(column, nodeId)));
+    case TextColumn:
+        return QVariant(GetText(column, nodeId));
+    }
+
+    return QVariant();
+}
+
+const QVector<qint64>& A_TreeAttributes::GetIntegerArray(int column) const
+{
+    /**
+     * Gets the integer array of a column
+     * @return Values by node identifier
+     */
+
+    return Columns.at(column).Integers;
+}
+
+const QVector<double>& A_TreeAttributes::GetDoubleArray(int column) const
+{
+    /**
+     * Gets the double array of a column
+     * @return Values by node identifier
+     */
+
+    return Columns.at(column).Doubles;
+}
+
+const QBitArray& A_TreeAttributes::GetPresenceBits(int column) const
+{
+    /**
+     * Gets the presence flags of a column
+     * @return Bits by node identifier
+     */
+
+    return Columns.at(column).Presence;
+}
+
+qint64 A_TreeAttributes::GetMemoryBytes() const
+{
+    /**
+     * Sums array capacities, presence bits and pooled texts
+     * @return Bytes
+     */
+
+    qint64 _bytes = 0;                                    // Bytes counted so far
+    for (const Column &_column : Columns) {
+        _bytes += qint64(_column.Integers.capacity()) * qint64(sizeof(qint64));
+        _bytes += qint64(_column.Doubles.capacity()) * qint64(sizeof(double));
+        _bytes += qint64(_column.TextIds.capacity()) * qint64(sizeof(quint32));
+        _bytes += (_column.Presence.size() + 7) / 8;
+        for (const QString &_text : _column.TextPool) {
+            _bytes += qint64(sizeof(QString)) + qint64(_text.capacity()) * qint64(sizeof(QChar));  // Pool entry and lookup share the text
+        }
+    }
+
+    return _bytes;
+}
+
+void A_TreeAttributes::Grow(Column &column, quint32 nodeId)
+{
+    /**
+     * Grows the typed array and the presence bits geometrically
+     * Only the array matching the column type is allocated
+     */
+
+    const int _required = int(nodeId) + 1;                // Size needed to address nodeId
+    if (column.Presence.size() >= _required) {
+        return;                                           // Already large enough
+    }
+
+    const int _size = qMax(_required, 2 * column.Presence.size());  // Grow geometrically
+    column.Presence.resize(_size);
+    switch (column.Type) {
+    case IntegerColumn:
+    case DateTimeColumn:
+        column.Integers.resize(_size);
+        break;
+    case DoubleColumn:
+        column.Doubles.resize(_size);
+        break;
+    case TextColumn:
+        column.TextIds.resize(_size);
+        break;
+    }
+}
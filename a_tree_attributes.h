@@ -0,0 +1,217 @@
+#ifndef A_TREE_ATTRIBUTES_H
+#define A_TREE_ATTRIBUTES_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QBitArray>
+#include <QVariant>
+#include <QDateTime>
+
+class A_TreeAttributes
+{
+public:
+    /**
+     * @brief Value type of an attribute column - decides which array holds its values
+     */
+    enum ColumnType {
+        IntegerColumn,               // 64-bit integers (sizes, counts)
+        DoubleColumn,                // Floating point values
+        DateTimeColumn,              // Timestamps stored as milliseconds since epoch (UTC)
+        TextColumn                   // Short strings with many repeats (owners) - stored once, referenced by index
+    };
+
+    /**
+     * @brief Constructor for a store without columns
+     */
+    A_TreeAttributes();
+
+    /**
+     * @brief Adds an attribute column
+     * @param name Column name - shown as header text
+     * @param type Value type of the column
+     * @return Column index - 0 for the first column
+     */
+    int AddColumn(const QString &name, ColumnType type);
+
+    /**
+     * @brief Gets the number of attribute columns
+     * @return Column count
+     */
+    int GetColumnCount() const;
+
+    /**
+     * @brief Finds a column by name
+     * @param name Column name
+     * @return Column index - -1 if no column has this name
+     */
+    int FindColumn(const QString &name) const;
+
+    /**
+     * @brief Gets the name of a column
+     * @param column Column index
+     * @return Column name
+     */
+    QString GetColumnName(int column) const;
+
+    /**
+     * @brief Gets the value type of a column
+     * @param column Column index
+     * @return Column type
+     */
+    ColumnType GetColumnType(int column) const;
+
+    /**
+     * @brief Gets whether a node has a value in a column
+     * @param column Column index
+     * @param nodeId Node identifier
+     * @return True if a value was set
+     */
+    bool HasValue(int column, quint32 nodeId) const;
+
+    /**
+     * @brief Gets an integer or date-time value without conversion
+     * @param column Integer or date-time column
+     * @param nodeId Node identifier
+     * @return Value - 0 if not set
+     */
+    qint64 GetInteger(int column, quint32 nodeId) const;
+
+    /**
+     * @brief Gets a floating point value without conversion
+     * @param column Double column
+     * @param nodeId Node identifier
+     * @return Value - 0 if not set
+     */
+    double GetDouble(int column, quint32 nodeId) const;
+
+    /**
+     * @brief Gets a text value without copying
+     * @param column Text column
+     * @param nodeId Node identifier
+     * @return Value - empty string if not set
+     */
+    const QString& GetText(int column, quint32 nodeId) const;
+
+    /**
+     * @brief Sets an integer or date-time value
+     * @param column Integer or date-time column
+     * @param nodeId Node identifier
+     * @param value New value - milliseconds since epoch for date-time columns
+     */
+    void SetInteger(int column, quint32 nodeId, qint64 value);
+
+    /**
+     * @brief Sets a floating point value
+     * @param column Double column
+     * @param nodeId Node identifier
+     * @param value New value
+     */
+    void SetDouble(int column, quint32 nodeId, double value);
+
+    /**
+     * @brief Sets a date-time value
+     * @param column Date-time column
+     * @param nodeId Node identifier
+     * @param value New value - invalid date-times clear the value
+     */
+    void SetDateTime(int column, quint32 nodeId, const QDateTime &value);
+
+    /**
+     * @brief Sets a text value - equal strings share one stored copy
+     * @param column Text column
+     * @param nodeId Node identifier
+     * @param value New value
+     */
+    void SetText(int column, quint32 nodeId, const QString &value);
+
+    /**
+     * @brief Sets a value of any column, converting it once to the column type
+     * @param column Column index
+     * @param nodeId Node identifier
+     * @param value New value - a null variant clears the value
+     * @return True if stored - false if the value cannot be converted
+     */
+    bool SetValue(int column, quint32 nodeId, const QVariant &value);
+
+    /**
+     * @brief Removes the value of a node in one column
+     * @param column Column index
+     * @param nodeId Node identifier
+     */
+    void ClearValue(int column, quint32 nodeId);
+
+    /**
+     * @brief Removes the values of a node in every column
+     * @param nodeId Node identifier
+     */
+    void ClearNode(quint32 nodeId);
+
+    /**
+     * @brief Removes all values and keeps the columns
+     */
+    void ClearValues();
+
+    /**
+     * @brief Boxes a value for the view - the only place values are converted to QVariant
+     * @param column Column index
+     * @param nodeId Node identifier
+     * @return Value as QVariant - null variant if not set
+     */
+    QVariant GetDisplayValue(int column, quint32 nodeId) const;
+
+    /**
+     * @brief Gets the contiguous values of an integer or date-time column for scans
+     * @param column Integer or date-time column
+     * @return Values indexed by node identifier - may be shorter than the identifier range
+     */
+    const QVector<qint64>& GetIntegerArray(int column) const;
+
+    /**
+     * @brief Gets the contiguous values of a double column for scans
+     * @param column Double column
+     * @return Values indexed by node identifier - may be shorter than the identifier range
+     */
+    const QVector<double>& GetDoubleArray(int column) const;
+
+    /**
+     * @brief Gets the presence flags of a column for scans
+     * @param column Column index
+     * @return Bit per node identifier - set if the node has a value
+     */
+    const QBitArray& GetPresenceBits(int column) const;
+
+    /**
+     * @brief Gets the bytes held by all columns
+     * @return Allocated array, presence and pooled text bytes
+     */
+    qint64 GetMemoryBytes() const;
+
+private:
+    /**
+     * @brief One attribute column - only the array matching its type is used
+     */
+    struct Column
+    {
+        QString Name;                        // Header text
+        ColumnType Type = IntegerColumn;     // Value type
+        QVector<qint64> Integers;            // Integer and date-time values by node identifier
+        QVector<double> Doubles;             // Double values by node identifier
+        QVector<quint32> TextIds;            // Index into TextPool by node identifier
+        QStringList TextPool;                // Distinct texts - entry 0 is the empty string
+        QHash<QString, quint32> TextLookup;  // Index of each distinct text in TextPool
+        QBitArray Presence;                  // Set if the node has a value
+    };
+
+    /**
+     * @brief Grows the arrays of a column to hold a node identifier
+     * @param column Column to grow
+     * @param nodeId Node identifier that must fit
+     */
+    static void Grow(Column &column, quint32 nodeId);
+
+    QVector<Column> Columns;                 // Attribute columns in registration order
+};
+
+#endif // A_TREE_ATTRIBUTES_H
@@ -0,0 +1,268 @@
+#include "a_tree_bit_vector.h"
+#include <QtAlgorithms>
+
+namespace {
+const int WordBits = 64;                                  // Bits per word
+const int BlockWords = 8;                                 // Words per rank block - 512 bits
+const qint64 BlockBits = qint64(WordBits) * BlockWords;   // Bits per rank block
+
+/**
+ * @brief Finds the k-th set bit of a word
+ * @param word Word with at least k set bits
+ * @param k 1-based occurrence
+ * @return Bit index within the word
+ */
+int SelectInWord(quint64 word, int k)
+{
+    for (int _skip = 1; _skip < k; ++_skip) {
+        word &= word - 1;                                 // Drop the lowest set bit
+    }
+    return int(qCountTrailingZeroBits(word));
+}
+}
+
+A_TreeBitVector::A_TreeBitVector()
+    : Size(0)                       // Bit count - starts at 0, nothing appended yet
+{
+}
+
+void A_TreeBitVector::Clear()
+{
+    /**
+     * Drops bits and index
+     */
+
+    Words.clear();
+    BlockRanks.clear();
+    Size = 0;
+}
+
+void A_TreeBitVector::Resize(qint64 bitCount)
+{
+    /**
+     * Resizes the word array and clears bits past the new end
+     */
+
+    Words.resize(int((bitCount + WordBits - 1) / WordBits));
+    if (bitCount % WordBits != 0) {
+        Words.last() &= (quint64(1) << (bitCount % WordBits)) - 1;  // Bits past the end stay 0 for Count
+    }
+    Size = bitCount;
+    BlockRanks.clear();
+}
+
+void A_TreeBitVector::Reserve(qint64 bitCount)
+{
+    /**
+     * Reserves words
+     */
+
+    Words.reserve(int((bitCount + WordBits - 1) / WordBits));
+}
+
+void A_TreeBitVector::Append(bool value)
+{
+    /**
+     * Starts a new word when the last one is full
+     */
+
+    if (Size % WordBits == 0) {
+        Words.append(0);
+    }
+    if (value) {
+        Words.last() |= quint64(1) << (Size % WordBits);
+    }
+    Size++;
+    BlockRanks.clear();
+}
+
+qint64 A_TreeBitVector::GetSize() const
+{
+    /**
+     * Gets the bit count
+     * @return Bits
+     */
+
+    return Size;
+}
+
+bool A_TreeBitVector::Test(qint64 position) const
+{
+    /**
+     * Reads one bit
+     * @return Bit value
+     */
+
+    return (Words.at(int(position / WordBits)) >> (position % WordBits)) & 1;
+}
+
+void A_TreeBitVector::Set(qint64 position, bool value)
+{
+    /**
+     * Writes one bit
+     */
+
+    const quint64 _mask = quint64(1) << (position % WordBits);  // Bit within its word
+    if (value) {
+        Words[int(position / WordBits)] |= _mask;
+    } else {
+        Words[int(position / WordBits)] &= ~_mask;
+    }
+}
+
+void A_TreeBitVector::Fill(qint64 begin, qint64 end, bool value)
+{
+    /**
+     * Masks the partial words at both ends and writes whole words in between
+     */
+
+    while (begin < end) {
+        const int _word = int(begin / WordBits);          // Word holding begin
+        const int _first = int(begin % WordBits);         // First bit in this word
+        const int _last = int(qMin<qint64>(WordBits, _first + (end - begin)));  // One past the last bit in this word
+        const quint64 _mask = (_last == WordBits ? ~quint64(0) : (quint64(1) << _last) - 1) & ~((quint64(1) << _first) - 1);
+        if (value) {
+            Words[_word] |= _mask;
+        } else {
+            Words[_word] &= ~_mask;
+        }
+        begin += _last - _first;
+    }
+}
+
+qint64 A_TreeBitVector::Count(qint64 begin, qint64 end) const
+{
+    /**
+     * Masks the partial words at both ends and counts whole words in between
+     * @return Set bits
+     */
+
+    qint64 _count = 0;                                    // Set bits so far
+    while (begin < end) {
+        const int _word = int(begin / WordBits);          // Word holding begin
+        const int _first = int(begin % WordBits);         // First bit in this word
+        const int _last = int(qMin<qint64>(WordBits, _first + (end - begin)));  // One past the last bit in this word
+        const quint64 _mask = (_last == WordBits ? ~quint64(0) : (quint64(1) << _last) - 1) & ~((quint64(1) << _first) - 1);
+        _count += qPopulationCount(Words.at(_word) & _mask);
+        begin += _last - _first;
+    }
+    return _count;
+}
+
+void A_TreeBitVector::BuildRankIndex()
+{
+    /**
+     * Records the running count of set bits at every block start
+     */
+
+    const int _blockCount = int((Size + BlockBits - 1) / BlockBits);  // Blocks covering the bits
+    BlockRanks.resize(_blockCount + 1);
+    qint64 _rank = 0;                                     // Set bits before the current block
+    for (int _block = 0; _block < _blockCount; ++_block) {
+        BlockRanks[_block] = _rank;
+        const int _end = qMin(Words.size(), (_block + 1) * BlockWords);  // One past the block's last word
+        for (int _word = _block * BlockWords; _word < _end; ++_word) {
+            _rank += qPopulationCount(Words.at(_word));
+        }
+    }
+    BlockRanks[_blockCount] = _rank;
+    BlockRanks.squeeze();
+}
+
+qint64 A_TreeBitVector::Rank1(qint64 position) const
+{
+    /**
+     * Adds the block counter and at most seven whole words plus one masked word
+     * @return Set bits before position
+     */
+
+    const int _block = int(position / BlockBits);         // Block holding position
+    qint64 _rank = BlockRanks.at(_block);                 // Set bits before the block
+    const int _word = int(position / WordBits);           // Word holding position
+    for (int _index = _block * BlockWords; _index < _word; ++_index) {
+        _rank += qPopulationCount(Words.at(_index));
+    }
+    if (position % WordBits != 0) {
+        _rank += qPopulationCount(Words.at(_word) & ((quint64(1) << (position % WordBits)) - 1));
+    }
+    return _rank;
+}
+
+qint64 A_TreeBitVector::Rank0(qint64 position) const
+{
+    /**
+     * Derives clear bits from set bits
+     * @return Clear bits before position
+     */
+
+    return position - Rank1(position);
+}
+
+qint64 A_TreeBitVector::Select1(qint64 k) const
+{
+    /**
+     * Finds a set bit
+     * @return Bit position
+     */
+
+    return Select(k, true);
+}
+
+qint64 A_TreeBitVector::Select0(qint64 k) const
+{
+    /**
+     * Finds a clear bit
+     * @return Bit position
+     */
+
+    return Select(k, false);
+}
+
+qint64 A_TreeBitVector::GetMemoryBytes() const
+{
+    /**
+     * Sums word and counter capacity
+     * @return Bytes
+     */
+
+    return qint64(Words.capacity()) * qint64(sizeof(quint64)) + qint64(BlockRanks.capacity()) * qint64(sizeof(qint64));
+}
+
+qint64 A_TreeBitVector::Select(qint64 k, bool isOne) const
+{
+    /**
+     * Binary searches the last block with fewer than k matching bits before it,
+     * then walks its words
+     * @return Bit position
+     */
+
+    const int _blockCount = BlockRanks.size() - 1;        // Blocks covering the bits
+    auto _before = [this, isOne](int block) {             // Matching bits before a block
+        return isOne ? BlockRanks.at(block) : qMin(Size, qint64(block) * BlockBits) - BlockRanks.at(block);
+    };
+    if (k < 1 || _blockCount < 0 || _before(_blockCount) < k) {
+        return -1;
+    }
+
+    int _low = 0;                                         // Block with fewer than k matches before it
+    int _high = _blockCount;                              // Block with at least k matches before it
+    while (_high - _low > 1) {
+        const int _middle = (_low + _high) / 2;
+        if (_before(_middle) < k) {
+            _low = _middle;
+        } else {
+            _high = _middle;
+        }
+    }
+
+    qint64 _remaining = k - _before(_low);                // Matches still to skip inside the block
+    for (int _word = _low * BlockWords; _word < Words.size(); ++_word) {
+        const quint64 _bits = isOne ? Words.at(_word) : ~Words.at(_word);  // Matching bits set
+        const int _count = qPopulationCount(_bits);
+        if (_remaining <= _count) {
+            return qint64(_word) * WordBits + SelectInWord(_bits, int(_remaining));
+        }
+        _remaining -= _count;
+    }
+    return -1;
+}
@@ -0,0 +1,127 @@
+#ifndef A_TREE_BIT_VECTOR_H
+#define A_TREE_BIT_VECTOR_H
+
+#include <QVector>
+
+class A_TreeBitVector
+{
+public:
+    /**
+     * @brief Constructor for an empty bit vector
+     */
+    A_TreeBitVector();
+
+    /**
+     * @brief Removes all bits and the rank index
+     */
+    void Clear();
+
+    /**
+     * @brief Resizes the vector - new bits are 0, the rank index is dropped
+     * @param bitCount New size in bits
+     */
+    void Resize(qint64 bitCount);
+
+    /**
+     * @brief Reserves room for bits appended later
+     * @param bitCount Expected size in bits
+     */
+    void Reserve(qint64 bitCount);
+
+    /**
+     * @brief Appends one bit - the rank index is dropped
+     * @param value Bit value
+     */
+    void Append(bool value);
+
+    /**
+     * @brief Gets the size
+     * @return Number of bits
+     */
+    qint64 GetSize() const;
+
+    /**
+     * @brief Reads one bit
+     * @param position Bit position - must be below GetSize()
+     * @return Bit value
+     */
+    bool Test(qint64 position) const;
+
+    /**
+     * @brief Writes one bit - the rank index is not updated, so only use on vectors without one
+     * @param position Bit position
+     * @param value Bit value
+     */
+    void Set(qint64 position, bool value);
+
+    /**
+     * @brief Writes a range of bits a word at a time
+     * @param begin First position
+     * @param end One past the last position
+     * @param value Bit value
+     */
+    void Fill(qint64 begin, qint64 end, bool value);
+
+    /**
+     * @brief Counts set bits in a range a word at a time
+     * @param begin First position
+     * @param end One past the last position
+     * @return Number of set bits
+     */
+    qint64 Count(qint64 begin, qint64 end) const;
+
+    /**
+     * @brief Builds the rank index - one 64-bit counter per 512 bits, 12.5% on top of the bits
+     * Call once the vector is complete; Rank and Select need it
+     */
+    void BuildRankIndex();
+
+    /**
+     * @brief Counts set bits before a position in constant time
+     * @param position Bit position - may equal GetSize()
+     * @return Number of set bits in [0, position)
+     */
+    qint64 Rank1(qint64 position) const;
+
+    /**
+     * @brief Counts clear bits before a position in constant time
+     * @param position Bit position - may equal GetSize()
+     * @return Number of clear bits in [0, position)
+     */
+    qint64 Rank0(qint64 position) const;
+
+    /**
+     * @brief Finds the k-th set bit - binary search over the rank index, then a scan of one block
+     * @param k 1-based occurrence
+     * @return Bit position - -1 if there are fewer set bits
+     */
+    qint64 Select1(qint64 k) const;
+
+    /**
+     * @brief Finds the k-th clear bit
+     * @param k 1-based occurrence
+     * @return Bit position - -1 if there are fewer clear bits
+     */
+    qint64 Select0(qint64 k) const;
+
+    /**
+     * @brief Gets the bytes held by bits and rank index
+     * @return Allocated bytes
+     */
+    qint64 GetMemoryBytes() const;
+
+private:
+    /**
+     * @brief Finds the k-th set or clear bit
+     * @param k 1-based occurrence
+     * @param isOne True to look for set bits
+     * @return Bit position - -1 if not found
+     */
+    qint64 Select(qint64 k, bool isOne) const;
+
+    QVector<quint64> Words;          // Bits, 64 per word, lowest position in the lowest bit
+    QVector<qint64> BlockRanks;      // Set bits before each 512-bit block, plus the total at the end
+    qint64 Size;                     // Number of bits
+};
+
+#endif // A_TREE_BIT_VECTOR_H
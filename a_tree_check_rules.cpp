@@ -0,0 +1,231 @@
+#include "a_tree_check_rules.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+namespace {
+const int MinimumTaskSize = 4096;                         // Items per worker task at least - smaller trees run in one task
+}
+
+A_TreeCheckRules::A_TreeCheckRules()
+    : IsPathNeeded(false)           // Path flag - starts false, no rules yet
+{
+}
+
+bool A_TreeCheckRules::Compile(const QVector<Rule> &rules, const QString &separator, QString *errorMessage)
+{
+    /**
+     * Compiles and optimizes every pattern up front so worker threads only match
+     * @return False on the first invalid pattern
+     */
+
+    Rules.clear();
+    Separator = separator;
+    IsPathNeeded = false;
+
+    for (const Rule &_rule : rules) {
+        CompiledRule _compiled;                           // Rule ready for matching
+        _compiled.MatchTarget = _rule.MatchTarget;
+        _compiled.IsInclude = _rule.IsInclude;
+        if (_rule.PatternSyntax == GlobSyntax) {
+            _compiled.Expression = CompileGlob(_rule.Pattern, separator);
+        } else {
+            _compiled.Expression = QRegularExpression(_rule.Pattern);
+            _compiled.Expression.optimize();              // Compile once before use on many threads
+        }
+        if (!_compiled.Expression.isValid()) {
+            if (errorMessage) {
+                *errorMessage = QString("%1: %2").arg(_rule.Pattern, _compiled.Expression.errorString());
+            }
+            Rules.clear();
+            IsPathNeeded = false;
+            return false;
+        }
+        IsPathNeeded = IsPathNeeded || _rule.MatchTarget == PathTarget;
+        Rules.append(_compiled);
+    }
+
+    return true;
+}
+
+bool A_TreeCheckRules::IsEmpty() const
+{
+    /**
+     * Gets whether rules exist
+     * @return True if none
+     */
+
+    return Rules.isEmpty();
+}
+
+int A_TreeCheckRules::Evaluate(const QString &label, const QString &path) const
+{
+    /**
+     * Tests rules from last to first - the first hit is the rule with highest precedence
+     * @return 1, 0 or -1
+     */
+
+    for (int _ruleIndex = Rules.size() - 1; _ruleIndex >= 0; --_ruleIndex) {
+        const CompiledRule &_rule = Rules.at(_ruleIndex);
+        const QString &_subject = _rule.MatchTarget == PathTarget ? path : label;  // Matched text
+        if (_rule.Expression.match(_subject).hasMatch()) {
+            return _rule.IsInclude ? 1 : 0;
+        }
+    }
+
+    return -1;
+}
+
+QVector<qint8> A_TreeCheckRules::EvaluateLeaves(const QStringList &texts, const QVector<int> &parents) const
+{
+    /**
+     * Splits positions into equal ranges; each task rebuilds the path of its first item's
+     * ancestors once and then extends a single path buffer per item
+     * @return Decision per position
+     */
+
+    const int _nodeCount = texts.size();                  // Items to decide
+    QVector<qint8> _decisions(_nodeCount, qint8(-1));     // Result - written by position, so tasks never overlap
+    if (Rules.isEmpty() || _nodeCount == 0) {
+        return _decisions;
+    }
+    qint8 *_data = _decisions.data();                     // Detach once on calling thread
+
+    const int _taskSize = qMax(MinimumTaskSize, _nodeCount / qMax(1, 4 * QThread::idealThreadCount()));
+    QVector<int> _taskBegins;                             // First position of each task
+    for (int _position = 0; _position < _nodeCount; _position += _taskSize) {
+        _taskBegins.append(_position);
+    }
+
+    QtConcurrent::blockingMap(_taskBegins, [this, _data, _nodeCount, _taskSize, &texts, &parents](const int &begin) {
+        const int _end = qMin(_nodeCount, begin + _taskSize);  // One past the last position of this task
+        QString _path;                                    // Path of the current item - prefix reused by descendants
+        QVector<QPair<int, int>> _ancestors;              // Positions on the current path with their path length
+
+        if (IsPathNeeded) {
+            QVector<int> _chain;                          // Ancestors of the first item, nearest first
+            for (int _parent = parents.at(begin); _parent >= 0; _parent = parents.at(_parent)) {
+                _chain.append(_parent);
+            }
+            for (int _index = _chain.size() - 1; _index >= 0; --_index) {
+                if (!_ancestors.isEmpty()) {
+                    _path += Separator;
+                }
+                _path += texts.at(_chain.at(_index));
+                _ancestors.append(qMakePair(_chain.at(_index), _path.size()));
+            }
+        }
+
+        for (int _position = begin; _position < _end; ++_position) {
+            if (IsPathNeeded) {
+                const int _parent = parents.at(_position);
+                while (!_ancestors.isEmpty() && _ancestors.last().first != _parent) {
+                    _ancestors.removeLast();              // Left the subtree of this ancestor
+                }
+                _path.truncate(_ancestors.isEmpty() ? 0 : _ancestors.last().second);
+                if (!_ancestors.isEmpty()) {
+                    _path += Separator;
+                }
+                _path += texts.at(_position);
+                _ancestors.append(qMakePair(_position, _path.size()));
+            }
+
+            const bool _isLeaf = _position + 1 >= _nodeCount || parents.at(_position + 1) != _position;
+            if (_isLeaf) {
+                _data[_position] = qint8(Evaluate(texts.at(_position), _path));
+            }
+        }
+    });
+
+    return _decisions;
+}
+
+bool A_TreeCheckRules::Parse(const QStringList &lines, QVector<Rule> *rules, QString *errorMessage)
+{
+    /**
+     * Reads the sign, then any number of target and syntax prefixes
+     * @return False on the first malformed line
+     */
+
+    rules->clear();
+    for (const QString &_line : lines) {
+        const QString _trimmed = _line.trimmed();         // Line without surrounding blanks
+        if (_trimmed.isEmpty() || _trimmed.startsWith('#')) {
+            continue;
+        }
+        if (_trimmed.size() < 2 || (_trimmed.at(0) != QLatin1Char('+') && _trimmed.at(0) != QLatin1Char('-'))) {
+            if (errorMessage) {
+                *errorMessage = QString("Rule must start with + or -: %1").arg(_trimmed);
+            }
+            return false;
+        }
+
+        Rule _rule;                                       // Rule of this line
+        _rule.IsInclude = _trimmed.at(0) == QLatin1Char('+');
+        QString _pattern = _trimmed.mid(1);               // Prefixes and pattern
+        for (;;) {
+            if (_pattern.startsWith(QStringLiteral("label:"))) {
+                _rule.MatchTarget = LabelTarget;
+                _pattern.remove(0, 6);
+            } else if (_pattern.startsWith(QStringLiteral("re:"))) {
+                _rule.PatternSyntax = RegexSyntax;
+                _pattern.remove(0, 3);
+            } else {
+                break;
+            }
+        }
+        if (_pattern.isEmpty()) {
+            if (errorMessage) {
+                *errorMessage = QString("Rule has no pattern: %1").arg(_trimmed);
+            }
+            return false;
+        }
+        _rule.Pattern = _pattern;
+        rules->append(_rule);
+    }
+
+    return true;
+}
+
+QRegularExpression A_TreeCheckRules::CompileGlob(const QString &glob, const QString &separator)
+{
+    /**
+     * Translates a path glob to an anchored regular expression
+     * A whole-segment ** also matches no segment at all: "a/**/b" matches "a/b", "a/**" matches "a"
+     * @return Compiled expression
+     */
+
+    const QString _separator = QRegularExpression::escape(separator);  // Separator as a literal
+    const QString _notSeparator = QStringLiteral("(?:(?!") + _separator + QStringLiteral(").)");
+    const QString _anySegments = separator + QStringLiteral("**");  // Trailing form of a whole-segment **
+    QString _expression = QStringLiteral("^");            // Expression being built
+    for (int _position = 0; _position < glob.size(); ++_position) {
+        const QChar _char = glob.at(_position);
+        if (_position > 0 && glob.size() - _position == _anySegments.size() && glob.mid(_position) == _anySegments) {
+            _expression += QStringLiteral("(?:") + _separator + QStringLiteral(".*)?");  // Item itself or anything below
+            break;
+        }
+        if (_char == QLatin1Char('*')) {
+            if (_position + 1 < glob.size() && glob.at(_position + 1) == QLatin1Char('*')) {
+                const bool _isSegmentStart = _position == 0 || glob.left(_position).endsWith(separator);
+                if (_isSegmentStart && glob.mid(_position + 2, separator.size()) == separator) {
+                    _expression += QStringLiteral("(?:.*") + _separator + QStringLiteral(")?");  // Zero or more whole segments
+                    _position += 1 + separator.size();
+                } else {
+                    _expression += QStringLiteral(".*");  // Spans segments
+                    _position++;
+                }
+            } else {
+                _expression += _notSeparator + QStringLiteral("*");  // Within one segment
+            }
+        } else if (_char == QLatin1Char('?')) {
+            _expression += _notSeparator;
+        } else {
+            _expression += QRegularExpression::escape(QString(_char));
+        }
+    }
+    _expression += QStringLiteral("$");
+
+    QRegularExpression _pattern(_expression);
+    _pattern.optimize();                                  // Compile once before use on many threads
+    return _pattern;
+}
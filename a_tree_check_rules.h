@@ -0,0 +1,111 @@
+#ifndef A_TREE_CHECK_RULES_H
+#define A_TREE_CHECK_RULES_H
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class A_TreeCheckRules
+{
+public:
+    /**
+     * @brief Pattern language of a rule
+     */
+    enum Syntax {
+        GlobSyntax,                  // * and ? within a segment, ** across segments, anchored
+        RegexSyntax                  // Perl-compatible expression, unanchored
+    };
+
+    /**
+     * @brief Text a rule is matched against
+     */
+    enum Target {
+        PathTarget,                  // Full path from the root item, segments joined by the separator
+        LabelTarget                  // Item text only
+    };
+
+    /**
+     * @brief Single check rule - later rules take precedence over earlier ones
+     */
+    struct Rule
+    {
+        QString Pattern;             // Glob or regular expression
+        Syntax PatternSyntax = GlobSyntax;  // Pattern language
+        Target MatchTarget = PathTarget;    // Matched text
+        bool IsInclude = true;       // True checks matching leaves, false unchecks them
+    };
+
+    /**
+     * @brief Constructor for an empty rule set
+     */
+    A_TreeCheckRules();
+
+    /**
+     * @brief Compiles rules once for evaluation on many items and threads
+     * @param rules Rules in precedence order - the last matching rule decides
+     * @param separator Path separator - also bounds * and ? in globs
+     * @param errorMessage Receives the reason if a pattern is invalid - may be nullptr
+     * @return False if a pattern is invalid; the set is then empty
+     */
+    bool Compile(const QVector<Rule> &rules, const QString &separator, QString *errorMessage = nullptr);
+
+    /**
+     * @brief Gets whether no rule is compiled
+     * @return True if empty
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Decides one item
+     * @param label Item text
+     * @param path Full item path - ignored if no rule targets paths
+     * @return 1 to check, 0 to uncheck, -1 if no rule matches
+     */
+    int Evaluate(const QString &label, const QString &path) const;
+
+    /**
+     * @brief Decides every leaf of a pre-order flattened tree in one pass
+     * Paths are built incrementally and only if a rule targets them; root subtrees are spread over worker threads
+     * @param texts Item text per position
+     * @param parents Parent position per position - -1 for root items
+     * @return Decision per position - -1 for parents and unmatched leaves
+     */
+    QVector<qint8> EvaluateLeaves(const QStringList &texts, const QVector<int> &parents) const;
+
+    /**
+     * @brief Parses rules written one per line
+     * Line syntax: "+" or "-" followed by optional "label:" and "re:" prefixes and the pattern;
+     * empty lines and lines starting with # are ignored
+     * @param lines Rule lines
+     * @param rules Receives the parsed rules
+     * @param errorMessage Receives the offending line - may be nullptr
+     * @return False if a line cannot be parsed
+     */
+    static bool Parse(const QStringList &lines, QVector<Rule> *rules, QString *errorMessage = nullptr);
+
+    /**
+     * @brief Translates a path glob to an anchored regular expression
+     * @param glob Glob - * and ? stay within a segment, ** spans segments
+     * @param separator Path separator
+     * @return Compiled and optimized expression
+     */
+    static QRegularExpression CompileGlob(const QString &glob, const QString &separator);
+
+private:
+    /**
+     * @brief Rule ready for matching
+     */
+    struct CompiledRule
+    {
+        QRegularExpression Expression;   // Compiled pattern - optimized before use
+        Target MatchTarget = PathTarget; // Matched text
+        bool IsInclude = true;           // Decision on match
+    };
+
+    QVector<CompiledRule> Rules;     // Compiled rules in precedence order
+    QString Separator;               // Path separator
+    bool IsPathNeeded;               // Path flag - true if any rule targets paths
+};
+
+#endif // A_TREE_CHECK_RULES_H
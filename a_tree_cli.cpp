@@ -0,0 +1,257 @@
+#include "a_tree_cli.h"
+#include "a_tree_node_store_bench.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThreadPool>
+
+A_TreeCli::A_TreeCli()
+    : Separator("/")                // Separator - "/" like A_Tree::GetItemPath
+    , Output(stdout)                // Output stream - usage text
+    , Log(stderr)                   // Log stream - timings stay out of piped output
+{
+}
+
+int A_TreeCli::Run(const QStringList &arguments)
+{
+    /**
+     * Walks the arguments left to right so operations apply in the order given
+     * @return 0 on success, 1 on a failed operation, 2 on a usage error
+     */
+
+    if (arguments.size() < 2) {
+        PrintUsage();
+        return 2;
+    }
+
+    QElapsedTimer _totalTimer;                            // Whole run
+    _totalTimer.start();
+
+    for (int _index = 1; _index < arguments.size(); ++_index) {
+        QString _argument = arguments.at(_index);
+        if (_argument == "--help" || _argument == "-h") {
+            PrintUsage();
+            return 0;
+        }
+        if (!_argument.startsWith("--")) {
+            Log << "Unexpected argument: " << _argument << Qt::endl;
+            return 2;
+        }
+
+        QString _operation = _argument.mid(2);            // Operation name without dashes
+        QString _value;                                   // Operation argument
+        if (TakesArgument(_operation)) {
+            if (_index + 1 >= arguments.size()) {
+                Log << "Missing value for " << _argument << Qt::endl;
+                return 2;
+            }
+            _value = arguments.at(++_index);
+        }
+
+        if (!RunOperation(_operation, _value)) {
+            return 1;
+        }
+    }
+
+    Log << "Done: " << Store.GetNodeCount() << " nodes in " << _totalTimer.elapsed() << " ms" << Qt::endl;
+    return 0;
+}
+
+bool A_TreeCli::RunOperation(const QString &operation, const QString &argument)
+{
+    /**
+     * Dispatches one operation to the store and logs its result and duration
+     * @return True on success
+     */
+
+    QElapsedTimer _timer;                                 // Operation duration
+    _timer.start();
+    QString _result;                                      // Summary for the log
+
+    if (operation == "input") {
+        if (!Store.LoadPathFile(argument, Separator)) {
+            Log << "Cannot read " << argument << Qt::endl;
+            return false;
+        }
+        _result = QString("%1 nodes").arg(Store.GetNodeCount());
+    } else if (operation == "journal") {
+        if (!Store.LoadJournal(argument)) {
+            Log << "Cannot read journal " << argument << Qt::endl;
+            return false;
+        }
+        _result = QString("%1 nodes").arg(Store.GetNodeCount());
+    } else if (operation == "generate") {
+        const QStringList _fields = argument.split(':');  // Node count and optional seed
+        A_TreeGenerator::Parameters _parameters;          // Defaults apart from size and seed
+        bool _isCountValid = false;
+        bool _isSeedValid = true;
+        _parameters.NodeCount = _fields.at(0).toInt(&_isCountValid);
+        if (_fields.size() > 1) {
+            _parameters.Seed = _fields.at(1).toUInt(&_isSeedValid);
+        }
+        if (!_isCountValid || !_isSeedValid || _fields.size() > 2 || _parameters.NodeCount < 0) {
+            Log << "Invalid generator spec " << argument << Qt::endl;
+            return false;
+        }
+        const QVector<A_TreeGenerator::Node> _nodes = A_TreeGenerator(_parameters).Generate();
+        QVector<quint32> _nodeIds(_nodes.size());         // Store identifier per generated node
+        Store.Clear();
+        for (int _nodeIndex = 0; _nodeIndex < _nodes.size(); ++_nodeIndex) {
+            const int _parentIndex = _nodes.at(_nodeIndex).ParentIndex;
+            _nodeIds[_nodeIndex] = Store.AddNode(_parentIndex < 0 ? A_TreeStore::RootId : _nodeIds.at(_parentIndex),
+                                                 _nodes.at(_nodeIndex).Text);
+        }
+        _result = QString("%1 nodes").arg(Store.GetNodeCount());
+    } else if (operation == "bench-store") {
+        const QStringList _fields = argument.split(':');  // Node count and optional seed
+        A_TreeGenerator::Parameters _parameters;          // Defaults apart from size and seed
+        bool _isCountValid = false;
+        bool _isSeedValid = true;
+        _parameters.NodeCount = _fields.at(0).toInt(&_isCountValid);
+        if (_fields.size() > 1) {
+            _parameters.Seed = _fields.at(1).toUInt(&_isSeedValid);
+        }
+        if (!_isCountValid || !_isSeedValid || _fields.size() > 2 || _parameters.NodeCount <= 0) {
+            Log << "Invalid benchmark spec " << argument << Qt::endl;
+            return false;
+        }
+        const QVector<A_TreeNodeStoreBench::Result> _results = A_TreeNodeStoreBench::Run(A_TreeGenerator(_parameters).Generate());
+        Output << A_TreeNodeStoreBench::FormatTable(_results) << Qt::flush;
+        _result = QString("%1 configurations").arg(_results.size());
+    } else if (operation == "check-budget") {
+        const QStringList _fields = argument.split(':');  // Node count and optional seed
+        A_TreeGenerator::Parameters _parameters;          // Defaults apart from size and seed
+        bool _isCountValid = false;
+        bool _isSeedValid = true;
+        _parameters.NodeCount = _fields.at(0).toInt(&_isCountValid);
+        if (_fields.size() > 1) {
+            _parameters.Seed = _fields.at(1).toUInt(&_isSeedValid);
+        }
+        if (!_isCountValid || !_isSeedValid || _fields.size() > 2 || _parameters.NodeCount <= 0) {
+            Log << "Invalid budget spec " << argument << Qt::endl;
+            return false;
+        }
+        const double _bytesPerNode = A_TreeNodeStoreBench::MeasureCompactBytesPerNode(A_TreeGenerator(_parameters).Generate());
+        if (_bytesPerNode >= A_TreeCompactNodeBudget) {
+            Log << "Compact store uses " << QString::number(_bytesPerNode, 'f', 2) << " bytes per node plus text - budget is under "
+                << A_TreeCompactNodeBudget << Qt::endl;
+            return false;
+        }
+        _result = QString("%1 bytes per node plus text, under %2").arg(_bytesPerNode, 0, 'f', 2).arg(A_TreeCompactNodeBudget);
+    } else if (operation == "separator") {
+        if (argument.isEmpty()) {
+            Log << "Separator must not be empty" << Qt::endl;
+            return false;
+        }
+        Separator = argument;
+        return true;                                      // Nothing to time
+    } else if (operation == "check" || operation == "uncheck") {
+        QRegularExpression _pattern = A_TreeStore::CompileGlob(argument, Separator);
+        QVector<quint32> _matches = Store.FindMatching(_pattern, Separator);
+        Store.SetCheckStates(_matches, operation == "check" ? Qt::Checked : Qt::Unchecked);
+        _result = QString("%1 matches").arg(_matches.size());
+    } else if (operation == "prune") {
+        _result = QString("%1 removed").arg(Store.Prune());
+    } else if (operation == "dedupe") {
+        _result = QString("%1 merged").arg(Store.Dedupe());
+    } else if (operation == "output") {
+        if (!Store.SavePathFile(argument, Separator)) {
+            Log << "Cannot write " << argument << Qt::endl;
+            return false;
+        }
+        _result = QString("%1 nodes").arg(Store.GetNodeCount());
+    } else if (operation == "script") {
+        return RunScript(argument);                       // Operations log themselves
+    } else if (operation == "threads") {
+        bool _isNumber = false;
+        int _threadCount = argument.toInt(&_isNumber);
+        if (!_isNumber || _threadCount < 1) {
+            Log << "Invalid thread count " << argument << Qt::endl;
+            return false;
+        }
+        QThreadPool::globalInstance()->setMaxThreadCount(_threadCount);
+        return true;
+    } else {
+        Log << "Unknown operation: " << operation << Qt::endl;
+        return false;
+    }
+
+    Log << operation << (argument.isEmpty() ? QString() : " " + argument) << ": " << _result
+        << " (" << _timer.elapsed() << " ms)" << Qt::endl;
+    return true;
+}
+
+bool A_TreeCli::RunScript(const QString &filePath)
+{
+    /**
+     * Reads a script and runs its lines as operations, stopping at the first failure
+     * @return True if every line succeeded
+     */
+
+    QFile _file(filePath);                                // Script file
+    if (!_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        Log << "Cannot read script " << filePath << Qt::endl;
+        return false;
+    }
+
+    int _lineNumber = 0;                                  // For error messages
+    while (!_file.atEnd()) {
+        _lineNumber++;
+        QString _line = QString::fromUtf8(_file.readLine()).trimmed();
+        if (_line.isEmpty() || _line.startsWith('#')) {
+            continue;
+        }
+
+        int _space = _line.indexOf(' ');                  // Operation ends at first space
+        QString _operation = _space < 0 ? _line : _line.left(_space);
+        QString _argument = _space < 0 ? QString() : _line.mid(_space + 1).trimmed();
+        if (_operation == "script") {
+            Log << filePath << ":" << _lineNumber << ": nested scripts are not supported" << Qt::endl;
+            return false;
+        }
+        if (TakesArgument(_operation) == _argument.isEmpty()) {
+            Log << filePath << ":" << _lineNumber << ": bad argument for " << _operation << Qt::endl;
+            return false;
+        }
+        if (!RunOperation(_operation, _argument)) {
+            Log << filePath << ":" << _lineNumber << ": failed" << Qt::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool A_TreeCli::TakesArgument(const QString &operation)
+{
+    /**
+     * Lists operations with an argument
+     * @return True if an argument follows
+     */
+
+    return operation != "prune" && operation != "dedupe";
+}
+
+void A_TreeCli::PrintUsage()
+{
+    /**
+     * Prints the option list
+     */
+
+    Output << "Usage: qt_tree_cli [operation...]\n"
+              "Operations run in the order given:\n"
+              "  --input FILE       Load paths, one per line, optional tab and 1/0 check flag\n"
+              "  --journal DIR      Load the tree saved by the application's journal\n"
+              "  --generate N[:S]   Replace the tree with N generated nodes from seed S (default 1)\n"
+              "  --bench-store N[:S] Time node store configurations on N generated nodes, print a table\n"
+              "  --check-budget N[:S] Fail unless the compact node store stays under its per-node budget on N nodes\n"
+              "  --separator SEP    Path separator for files and patterns (default /)\n"
+              "  --check GLOB       Check nodes whose path matches (* ? within a segment, ** across)\n"
+              "  --uncheck GLOB     Uncheck nodes whose path matches\n"
+              "  --prune            Remove unchecked nodes\n"
+              "  --dedupe           Merge siblings with the same text\n"
+              "  --script FILE      Run operations from a file, one per line without dashes\n"
+              "  --output FILE      Write leaf paths, checked leaves followed by tab and 1\n"
+              "  --threads N        Limit worker threads (default all cores)\n"
+              "  --help             Show this text\n"
+           << Qt::flush;
+}
@@ -0,0 +1,62 @@
+#ifndef A_TREE_CLI_H
+#define A_TREE_CLI_H
+
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include "a_tree_store.h"
+#include "a_tree_generator.h"
+
+class A_TreeCli
+{
+public:
+    /**
+     * @brief Constructor for a headless batch driver
+     */
+    A_TreeCli();
+
+    /**
+     * @brief Runs the operations given on the command line in order
+     * Options: --input FILE, --journal DIR, --generate COUNT[:SEED], --bench-store COUNT[:SEED],
+     * --check-budget COUNT[:SEED], --separator SEP, --check GLOB, --uncheck GLOB,
+     * --prune, --dedupe, --script FILE, --output FILE, --threads N, --help
+     * @param arguments Command line arguments including the program name
+     * @return Process exit code - 0 on success
+     */
+    int Run(const QStringList &arguments);
+
+private:
+    /**
+     * @brief Runs one operation and reports its timing
+     * @param operation Operation name without leading dashes
+     * @param argument Operation argument - empty for operations without one
+     * @return True on success
+     */
+    bool RunOperation(const QString &operation, const QString &argument);
+
+    /**
+     * @brief Runs every operation of a script file - one "operation argument" per line, # comments
+     * @param filePath Script file
+     * @return True if every operation succeeded
+     */
+    bool RunScript(const QString &filePath);
+
+    /**
+     * @brief Gets whether an operation takes an argument
+     * @param operation Operation name without leading dashes
+     * @return True if the next command line argument belongs to the operation
+     */
+    static bool TakesArgument(const QString &operation);
+
+    /**
+     * @brief Prints usage to stdout
+     */
+    void PrintUsage();
+
+    A_TreeStore Store;               // Tree being processed
+    QString Separator;               // Path separator for files and patterns
+    QTextStream Output;              // Usage output
+    QTextStream Log;                 // Timings and errors
+};
+
+#endif // A_TREE_CLI_H
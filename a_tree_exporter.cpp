@@ -0,0 +1,272 @@
+#include "a_tree_exporter.h"
+
+namespace {
+const int MinimumBufferBytes = 4096;                      // Smallest accepted write size
+const char HexDigits[] = "0123456789abcdef";              // For JSON control character escapes
+
+/**
+ * @brief Gets the record name of a check state
+ * @param state Check state
+ * @return "checked", "partial" or "unchecked"
+ */
+const char* CheckStateName(Qt::CheckState state)
+{
+    switch (state) {
+    case Qt::Checked:
+        return "checked";
+    case Qt::PartiallyChecked:
+        return "partial";
+    default:
+        return "unchecked";
+    }
+}
+}
+
+A_TreeExporter::A_TreeExporter(QIODevice *device, const Options &options)
+    : Device(device)                // Output device - owned by the caller
+    , Settings(options)             // Settings - copied, buffer size clamped below
+    , IsSeparatorQuoted(false)      // Separator quoting flag - set below once the separator is encoded
+    , WrittenCount(0)               // Record counter - starts at 0, nothing written yet
+    , IsFailed(false)               // Write error flag - starts false, no write attempted yet
+{
+    Settings.BufferBytes = qMax(MinimumBufferBytes, Settings.BufferBytes);
+    Buffer.reserve(Settings.BufferBytes + MinimumBufferBytes);  // Last record may overshoot the flush size
+    IsSeparatorQuoted = AppendEscaped(&EscapedSeparator, Settings.Separator);
+}
+
+void A_TreeExporter::Begin()
+{
+    /**
+     * Writes the header of the output format
+     */
+
+    if (Settings.OutputFormat == CsvFormat) {
+        Buffer += "path,state\n";
+    } else if (Settings.OutputFormat == JsonFormat) {
+        Buffer += "[\n";
+    }
+}
+
+void A_TreeExporter::AddItem(int depth, const QString &text, Qt::CheckState state, bool isLeaf)
+{
+    /**
+     * Cuts the path back to the parent's length, appends the item's segment once and copies
+     * the whole path into the buffer - no per-item path string is built
+     */
+
+    depth = qBound(0, depth, PathLengths.size());         // Deeper than possible means malformed input
+    Path.resize(depth > 0 ? PathLengths.at(depth - 1) : 0);  // Keep the parent's path
+    bool _isQuoted = depth > 0 && PathQuoted.at(depth - 1);  // CSV quoting inherited from ancestors
+    if (depth > 0) {
+        Path += EscapedSeparator;
+        _isQuoted = _isQuoted || IsSeparatorQuoted;
+    }
+    _isQuoted = AppendEscaped(&Path, text) || _isQuoted;
+    if (depth == PathLengths.size()) {
+        PathLengths.append(Path.size());                  // First item at this depth
+        PathQuoted.append(_isQuoted);
+    } else {
+        PathLengths[depth] = Path.size();                 // Deeper entries are overwritten before use
+        PathQuoted[depth] = _isQuoted;
+    }
+
+    const bool _isIncluded = Settings.Filter == AllItems ||
+                             (Settings.Filter == CheckedItems && state == Qt::Checked) ||
+                             (Settings.Filter == UncheckedItems && state == Qt::Unchecked);
+    if (!_isIncluded || (Settings.IsLeavesOnly && !isLeaf)) {
+        return;                                           // Item only contributes its path segment
+    }
+
+    switch (Settings.OutputFormat) {
+    case TextFormat:
+        Buffer += Path;
+        if (state == Qt::Checked) {
+            Buffer += "\t1";                              // Same flag as qt_tree_cli path files
+        }
+        Buffer += '\n';
+        break;
+    case CsvFormat:
+        if (_isQuoted) {
+            Buffer += '"';
+            Buffer += Path;                               // Quotes were doubled while encoding
+            Buffer += '"';
+        } else {
+            Buffer += Path;
+        }
+        Buffer += ',';
+        Buffer += CheckStateName(state);
+        Buffer += '\n';
+        break;
+    case JsonFormat:
+        if (WrittenCount > 0) {
+            Buffer += ",\n";
+        }
+        Buffer += "{\"path\":\"";
+        Buffer += Path;                                   // Escaped while encoding
+        Buffer += "\",\"state\":\"";
+        Buffer += CheckStateName(state);
+        Buffer += "\"}";
+        break;
+    }
+
+    WrittenCount++;
+    Flush(false);
+}
+
+bool A_TreeExporter::IsSubtreeExcluded(Qt::CheckState state) const
+{
+    /**
+     * Unchecked parents have only unchecked descendants and checked parents only checked ones,
+     * so the filter decides whole subtrees from the parent's state
+     * @return True if the subtree can be skipped
+     */
+
+    return (Settings.Filter == CheckedItems && state == Qt::Unchecked) ||
+           (Settings.Filter == UncheckedItems && state == Qt::Checked);
+}
+
+bool A_TreeExporter::Finish()
+{
+    /**
+     * Writes the trailer and the remaining buffer
+     * @return True if nothing failed
+     */
+
+    if (Settings.OutputFormat == JsonFormat) {
+        Buffer += WrittenCount > 0 ? "\n]\n" : "]\n";
+    }
+    Flush(true);
+
+    return !IsFailed;
+}
+
+qint64 A_TreeExporter::GetWrittenCount() const
+{
+    /**
+     * Gets the record counter
+     * @return Records written
+     */
+
+    return WrittenCount;
+}
+
+bool A_TreeExporter::ExportSnapshot(const A_TreeSnapshot &snapshot, QIODevice *device, const Options &options,
+                                    qint64 *writtenCount)
+{
+    /**
+     * Walks all blocks in pre-order; depth comes from a stack of open subtree ends, so memory stays
+     * proportional to tree depth - subtrees split across blocks end where the snapshot says
+     * @return True if every write succeeded
+     */
+
+    A_TreeExporter _exporter(device, options);            // Writer shared by all blocks
+    _exporter.Begin();
+
+    const QVector<std::shared_ptr<const A_TreeSnapshot::Block>> &_blocks = snapshot.GetBlocks();
+    const int _nodeCount = snapshot.GetNodeCount();       // Items of all blocks
+    QVector<int> _openEnds;                               // Subtree ends of the current item's ancestors
+    int _blockNumber = 0;                                 // Block holding the current item
+    int _offset = 0;                                      // Position of the block's first item
+    int _index = 0;                                       // Snapshot position
+    while (_index < _nodeCount) {
+        if (_index >= _offset + _blocks.at(_blockNumber)->NodeIds.size()) {
+            _blockNumber = snapshot.FindBlock(_index);    // Next block, or a later one after a skipped subtree
+            _offset = snapshot.GetBlockOffset(_blockNumber);
+        }
+        const A_TreeSnapshot::Block &_block = *_blocks.at(_blockNumber);
+        const int _local = _index - _offset;              // Block-local position
+        while (!_openEnds.isEmpty() && _index >= _openEnds.last()) {
+            _openEnds.removeLast();                       // Left the subtree of this ancestor
+        }
+        const int _subtreeEnd = (_local == 0 && _block.IsOpen) ? snapshot.GetSubtreeEnd(_index)
+                                                              : _offset + _block.SubtreeEnds.at(_local);
+        const Qt::CheckState _state = Qt::CheckState(_block.CheckStates.at(_local));
+        _exporter.AddItem(_openEnds.size(), _block.Texts.at(_local), _state, _subtreeEnd == _index + 1);
+        if (_exporter.IsSubtreeExcluded(_state)) {
+            _index = _subtreeEnd;                         // Nothing below can pass the filter
+            continue;
+        }
+        _openEnds.append(_subtreeEnd);
+        _index++;
+    }
+
+    const bool _isOk = _exporter.Finish();
+    if (writtenCount) {
+        *writtenCount = _exporter.GetWrittenCount();
+    }
+    return _isOk;
+}
+
+bool A_TreeExporter::AppendEscaped(QByteArray *target, const QString &text) const
+{
+    /**
+     * Encodes UTF-16 to UTF-8 directly into the target, escaping for JSON and doubling
+     * quotes for CSV on the way; unpaired surrogates become U+FFFD
+     * @return True if the text needs CSV quoting
+     */
+
+    bool _needsQuotes = false;                            // CSV field must be quoted
+    const QChar *_data = text.constData();
+    const int _length = text.size();
+    for (int _position = 0; _position < _length; ++_position) {
+        const ushort _unit = _data[_position].unicode();  // UTF-16 code unit
+        if (_unit < 0x80) {
+            const char _byte = char(_unit);
+            if (Settings.OutputFormat == JsonFormat) {
+                if (_byte == '"' || _byte == '\\') {
+                    target->append('\\');
+                } else if (_unit < 0x20) {
+                    target->append("\\u00");
+                    target->append(HexDigits[_unit >> 4]);
+                    target->append(HexDigits[_unit & 0xF]);
+                    continue;
+                }
+            } else if (Settings.OutputFormat == CsvFormat) {
+                if (_byte == '"') {
+                    target->append('"');                  // Quote is doubled inside quoted fields
+                    _needsQuotes = true;
+                } else if (_byte == ',' || _byte == '\n' || _byte == '\r') {
+                    _needsQuotes = true;
+                }
+            }
+            target->append(_byte);
+        } else if (_unit < 0x800) {
+            target->append(char(0xC0 | (_unit >> 6)));
+            target->append(char(0x80 | (_unit & 0x3F)));
+        } else {
+            uint _codePoint = _unit;                      // Full code point
+            if (QChar::isHighSurrogate(_unit) && _position + 1 < _length && _data[_position + 1].isLowSurrogate()) {
+                _codePoint = QChar::surrogateToUcs4(_unit, _data[++_position].unicode());
+            } else if (QChar::isSurrogate(_unit)) {
+                _codePoint = QChar::ReplacementCharacter; // Unpaired half cannot be encoded
+            }
+            if (_codePoint >= 0x10000) {
+                target->append(char(0xF0 | (_codePoint >> 18)));
+                target->append(char(0x80 | ((_codePoint >> 12) & 0x3F)));
+            } else {
+                target->append(char(0xE0 | (_codePoint >> 12)));
+            }
+            target->append(char(0x80 | ((_codePoint >> 6) & 0x3F)));
+            target->append(char(0x80 | (_codePoint & 0x3F)));
+        }
+    }
+
+    return _needsQuotes;
+}
+
+void A_TreeExporter::Flush(bool isForced)
+{
+    /**
+     * Hands the buffer to the device in one write and keeps its capacity for the next batch
+     * @param isForced True to write a partly filled buffer
+     */
+
+    if (Buffer.isEmpty() || (!isForced && Buffer.size() < Settings.BufferBytes)) {
+        return;
+    }
+
+    if (!IsFailed && Device->write(Buffer) != Buffer.size()) {
+        IsFailed = true;                                  // Disk full or device closed - skip further writes
+    }
+    Buffer.resize(0);                                     // Reserved capacity survives
+}
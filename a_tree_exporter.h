@@ -0,0 +1,122 @@
+#ifndef A_TREE_EXPORTER_H
+#define A_TREE_EXPORTER_H
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "a_tree_snapshot.h"
+
+class A_TreeExporter
+{
+public:
+    /**
+     * @brief Output format - every format writes one record per exported item with its full path
+     */
+    enum Format {
+        TextFormat,                  // One path per line, checked items followed by tab and 1 (readable by qt_tree_cli --input)
+        CsvFormat,                   // "path,state" header, RFC 4180 quoting
+        JsonFormat                   // Array of {"path": ..., "state": ...} objects
+    };
+
+    /**
+     * @brief Items written, by check state
+     */
+    enum CheckFilter {
+        AllItems,                    // Every item
+        CheckedItems,                // Checked items only - subtrees of unchecked items are skipped
+        UncheckedItems               // Unchecked items only - subtrees of checked items are skipped
+    };
+
+    /**
+     * @brief Export settings
+     */
+    struct Options
+    {
+        Format OutputFormat = TextFormat;  // Record layout
+        CheckFilter Filter = AllItems;     // Items written
+        bool IsLeavesOnly = false;   // Skip records of items with children
+        QString Separator = "/";     // Placed between path segments
+        int BufferBytes = 1 << 20;   // Output collected before each device write
+    };
+
+    /**
+     * @brief Constructor for a writer - nothing is written before Begin
+     * @param device Open output device - must outlive the writer
+     * @param options Export settings
+     */
+    A_TreeExporter(QIODevice *device, const Options &options);
+
+    /**
+     * @brief Writes the format header
+     */
+    void Begin();
+
+    /**
+     * @brief Feeds the next item in pre-order - items outside the filter only extend the path
+     * @param depth Item depth - 0 for root items, at most one more than the previous item's depth
+     * @param text Item text
+     * @param state Check state of the item
+     * @param isLeaf True if the item has no children
+     */
+    void AddItem(int depth, const QString &text, Qt::CheckState state, bool isLeaf);
+
+    /**
+     * @brief Gets whether no descendant of an item can pass the filter
+     * Callers skip such subtrees after feeding the item itself
+     * @param state Check state of the item
+     * @return True if the subtree can be skipped
+     */
+    bool IsSubtreeExcluded(Qt::CheckState state) const;
+
+    /**
+     * @brief Writes the format trailer and flushes the buffer
+     * @return True if every device write succeeded
+     */
+    bool Finish();
+
+    /**
+     * @brief Gets the number of records written
+     * @return Record count
+     */
+    qint64 GetWrittenCount() const;
+
+    /**
+     * @brief Exports a snapshot - safe on a worker thread, the snapshot is immutable
+     * @param snapshot Tree snapshot
+     * @param device Open output device
+     * @param options Export settings
+     * @param writtenCount Receives the number of records - may be nullptr
+     * @return True if every device write succeeded
+     */
+    static bool ExportSnapshot(const A_TreeSnapshot &snapshot, QIODevice *device, const Options &options,
+                               qint64 *writtenCount = nullptr);
+
+private:
+    /**
+     * @brief Appends text as UTF-8 with the escaping of the output format
+     * @param target Buffer receiving the bytes
+     * @param text Text to encode
+     * @return True if the text needs CSV quoting
+     */
+    bool AppendEscaped(QByteArray *target, const QString &text) const;
+
+    /**
+     * @brief Writes the buffer to the device once it reached BufferBytes
+     * @param isForced True to write regardless of size
+     */
+    void Flush(bool isForced);
+
+    QIODevice *Device;               // Output device
+    Options Settings;                // Export settings
+    QByteArray Buffer;               // Pending output - capacity reused between writes
+    QByteArray Path;                 // Escaped UTF-8 path of the current item - prefix reused by descendants
+    QVector<int> PathLengths;        // Path length per depth of the current item's ancestors
+    QVector<bool> PathQuoted;        // CSV quoting flag per depth - set if a segment up to this depth needs quotes
+    QByteArray EscapedSeparator;     // Separator in output encoding
+    bool IsSeparatorQuoted;          // CSV quoting flag of the separator
+    qint64 WrittenCount;             // Records written
+    bool IsFailed;                   // Write error flag - set once a device write fell short
+};
+
+#endif // A_TREE_EXPORTER_H
@@ -0,0 +1,312 @@
+#include "a_tree_frozen_model.h"
+
+A_TreeFrozenModel::A_TreeFrozenModel(A_TreeSuccinct *tree, int pageSize, QObject *parent)
+    : QAbstractItemModel(parent)
+    , Tree(tree)                    // Encoded tree - read on every request
+    , PageSize(qMax(0, pageSize))   // Bucket size - 0 shows all children directly
+{
+}
+
+void A_TreeFrozenModel::SetPageSize(int pageSize)
+{
+    /**
+     * Drops all handed-out bucket indexes with a model reset
+     */
+
+    beginResetModel();
+    PageSize = qMax(0, pageSize);
+    Buckets.clear();
+    BucketNumbers.clear();
+    endResetModel();
+}
+
+int A_TreeFrozenModel::GetPageSize() const
+{
+    /**
+     * Gets the bucket size
+     * @return Children per bucket
+     */
+
+    return PageSize;
+}
+
+QModelIndex A_TreeFrozenModel::index(int row, int column, const QModelIndex &parent) const
+{
+    /**
+     * Siblings have consecutive numbers, so the row is an offset from the first child of the parent
+     * or of the bucket
+     * @return Model index - invalid if out of range
+     */
+
+    if (column != 0 || row < 0 || row >= rowCount(parent)) {
+        return QModelIndex();
+    }
+
+    const int _bucket = BucketFromIndex(parent);          // Set if the parent row is a bucket
+    if (_bucket >= 0) {
+        int _first = 0;                                   // First child in the bucket
+        int _count = 0;
+        GetBucketRange(_bucket, &_first, &_count);
+        return createIndex(row, 0, quintptr(_first + row));
+    }
+
+    const int _node = NodeFromIndex(parent);              // Parent node
+    if (IsPaged(_node)) {
+        return IndexFromBucket(_node, row);
+    }
+    return createIndex(row, 0, quintptr(Tree->GetFirstChild(_node) + row));
+}
+
+QModelIndex A_TreeFrozenModel::parent(const QModelIndex &child) const
+{
+    /**
+     * Finds the parent through the encoding; children of a paged parent hang below their bucket
+     * @return Parent index - invalid for root items and root level buckets
+     */
+
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+
+    const int _bucket = BucketFromIndex(child);           // Set if the row is a bucket
+    if (_bucket >= 0) {
+        const int _owner = Buckets.at(_bucket).Parent;    // Node owning the bucket
+        return _owner == A_TreeSuccinct::NoNode ? QModelIndex() : IndexFromNode(_owner);
+    }
+
+    const int _node = NodeFromIndex(child);               // Child node
+    const int _parent = Tree->GetParent(_node);           // Parent number
+    if (IsPaged(_parent)) {
+        return IndexFromBucket(_parent, (_node - Tree->GetFirstChild(_parent)) / PageSize);
+    }
+    return _parent == A_TreeSuccinct::NoNode ? QModelIndex() : IndexFromNode(_parent);
+}
+
+int A_TreeFrozenModel::rowCount(const QModelIndex &parent) const
+{
+    /**
+     * Reads the length of the parent's child run - or the number of buckets it is split into
+     * @return Row count
+     */
+
+    if (parent.column() > 0) {
+        return 0;
+    }
+
+    const int _bucket = BucketFromIndex(parent);          // Set if the parent row is a bucket
+    if (_bucket >= 0) {
+        int _first = 0;
+        int _count = 0;                                   // Children in the bucket
+        GetBucketRange(_bucket, &_first, &_count);
+        return _count;
+    }
+
+    const int _node = NodeFromIndex(parent);              // Parent node
+    const int _childCount = Tree->GetChildCount(_node);
+    return IsPaged(_node) ? (_childCount + PageSize - 1) / PageSize : _childCount;
+}
+
+int A_TreeFrozenModel::columnCount(const QModelIndex &parent) const
+{
+    /**
+     * One column like A_Tree's tree widget
+     * @return Column count
+     */
+
+    Q_UNUSED(parent);
+    return 1;
+}
+
+bool A_TreeFrozenModel::hasChildren(const QModelIndex &parent) const
+{
+    /**
+     * Same as a non-zero row count
+     * @return True if the row has children
+     */
+
+    return rowCount(parent) > 0;
+}
+
+QVariant A_TreeFrozenModel::data(const QModelIndex &index, int role) const
+{
+    /**
+     * Decodes the text or reads the check overlay; buckets show their 1-based range and
+     * the aggregate of their children
+     * @return Value - invalid for other roles
+     */
+
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    const int _bucket = BucketFromIndex(index);           // Set if the row is a bucket
+    if (_bucket >= 0) {
+        int _first = 0;                                   // First child in the bucket
+        int _count = 0;                                   // Children in the bucket
+        GetBucketRange(_bucket, &_first, &_count);
+        if (role == Qt::DisplayRole) {
+            const int _offset = Buckets.at(_bucket).Number * PageSize;  // Children before the bucket
+            return QString::number(_offset + 1) + QChar(0x2013) + QString::number(_offset + _count);
+        }
+        if (role == Qt::CheckStateRole) {
+            return int(Tree->GetRangeCheckState(_first, _count));
+        }
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole) {
+        return Tree->GetText(NodeFromIndex(index));
+    }
+    if (role == Qt::CheckStateRole) {
+        return int(Tree->GetCheckState(NodeFromIndex(index)));
+    }
+    return QVariant();
+}
+
+bool A_TreeFrozenModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    /**
+     * Writes the check overlay - a bucket sets its whole range - and notifies the view of the row,
+     * its ancestors and its children. Deeper descendants are not listed; the owner repaints the
+     * viewport on any change, which covers them
+     * @return True if the check state was set
+     */
+
+    if (!index.isValid() || role != Qt::CheckStateRole) {
+        return false;
+    }
+
+    const Qt::CheckState _state = Qt::CheckState(value.toInt()) == Qt::Checked ? Qt::Checked : Qt::Unchecked;
+    const int _bucket = BucketFromIndex(index);           // Set if the row is a bucket
+    if (_bucket >= 0) {
+        int _first = 0;                                   // First child in the bucket
+        int _count = 0;                                   // Children in the bucket
+        GetBucketRange(_bucket, &_first, &_count);
+        Tree->SetRangeCheckState(_first, _count, _state);
+    } else {
+        Tree->SetCheckState(NodeFromIndex(index), _state);
+    }
+
+    const QVector<int> _roles{Qt::CheckStateRole};        // Only check states change
+    for (QModelIndex _index = index; _index.isValid(); _index = _index.parent()) {
+        emit dataChanged(_index, _index, _roles);
+    }
+    const int _rowCount = rowCount(index);                // Children or bucket members
+    if (_rowCount > 0) {
+        emit dataChanged(this->index(0, 0, index), this->index(_rowCount - 1, 0, index), _roles);
+    }
+    return true;
+}
+
+Qt::ItemFlags A_TreeFrozenModel::flags(const QModelIndex &index) const
+{
+    /**
+     * Items and buckets can be checked but not edited
+     * @return Item flags
+     */
+
+    if (!index.isValid()) {
+        return Qt::NoItemFlags;
+    }
+    Qt::ItemFlags _flags = Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+    if (BucketFromIndex(index) < 0 && Tree->GetChildCount(NodeFromIndex(index)) == 0) {
+        _flags |= Qt::ItemNeverHasChildren;               // Lets the view skip child queries for leaves
+    }
+    return _flags;
+}
+
+QVariant A_TreeFrozenModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    /**
+     * Same header text as A_Tree's tree widget
+     * @return Header text
+     */
+
+    if (section == 0 && orientation == Qt::Horizontal && role == Qt::DisplayRole) {
+        return QStringLiteral("Tree Structure");
+    }
+    return QVariant();
+}
+
+int A_TreeFrozenModel::NodeFromIndex(const QModelIndex &index) const
+{
+    /**
+     * Internal ids below the node count are node numbers
+     * @return Node number
+     */
+
+    if (!index.isValid() || index.internalId() >= quintptr(Tree->GetNodeCount())) {
+        return A_TreeSuccinct::NoNode;
+    }
+    return int(index.internalId());
+}
+
+int A_TreeFrozenModel::BucketFromIndex(const QModelIndex &index) const
+{
+    /**
+     * Internal ids from the node count on are bucket positions
+     * @return Bucket number or -1
+     */
+
+    if (!index.isValid() || index.internalId() < quintptr(Tree->GetNodeCount())) {
+        return -1;
+    }
+    return int(index.internalId() - quintptr(Tree->GetNodeCount()));
+}
+
+QModelIndex A_TreeFrozenModel::IndexFromNode(int node) const
+{
+    /**
+     * The row is the distance from the parent's first child, within the bucket if the parent is paged
+     * @return Model index
+     */
+
+    const int _parent = Tree->GetParent(node);            // Owner of the sibling run
+    const int _offset = node - Tree->GetFirstChild(_parent);  // Position among all siblings
+    return createIndex(IsPaged(_parent) ? _offset % PageSize : _offset, 0, quintptr(node));
+}
+
+QModelIndex A_TreeFrozenModel::IndexFromBucket(int parent, int number) const
+{
+    /**
+     * Buckets are registered when first handed out, so only visited parents cost memory
+     * @return Model index
+     */
+
+    const QPair<int, int> _key(parent, number);           // Bucket identity
+    auto _found = BucketNumbers.constFind(_key);
+    int _bucket = 0;                                      // Position in Buckets
+    if (_found != BucketNumbers.constEnd()) {
+        _bucket = _found.value();
+    } else {
+        Bucket _new;
+        _new.Parent = parent;
+        _new.Number = number;
+        _bucket = Buckets.size();
+        Buckets.append(_new);
+        BucketNumbers.insert(_key, _bucket);
+    }
+    return createIndex(number, 0, quintptr(Tree->GetNodeCount()) + quintptr(_bucket));
+}
+
+bool A_TreeFrozenModel::IsPaged(int node) const
+{
+    /**
+     * Compares the child count with the bucket size
+     * @return True if paged
+     */
+
+    return PageSize > 0 && Tree->GetChildCount(node) > PageSize;
+}
+
+void A_TreeFrozenModel::GetBucketRange(int bucket, int *first, int *count) const
+{
+    /**
+     * The last bucket holds the remainder
+     */
+
+    const Bucket &_bucket = Buckets.at(bucket);           // Bucket being resolved
+    const int _offset = _bucket.Number * PageSize;        // Children before the bucket
+    *first = Tree->GetFirstChild(_bucket.Parent) + _offset;
+    *count = qMin(PageSize, Tree->GetChildCount(_bucket.Parent) - _offset);
+}
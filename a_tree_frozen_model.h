@@ -0,0 +1,108 @@
+#ifndef A_TREE_FROZEN_MODEL_H
+#define A_TREE_FROZEN_MODEL_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include "a_tree_succinct.h"
+
+class A_TreeFrozenModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructor for a model reading a succinct tree
+     * Indexes carry the node number, so no per-node objects exist - rows are decoded when the view asks
+     * @param tree Encoded tree - owned by the caller, must outlive the model
+     * @param pageSize Children per bucket row of wide parents - 0 shows all children directly
+     * @param parent Parent object
+     */
+    explicit A_TreeFrozenModel(A_TreeSuccinct *tree, int pageSize = 0, QObject *parent = nullptr);
+
+    /**
+     * @brief Groups the children of parents with more than pageSize children into range buckets
+     * Bucket rows read "1–10000", "10001–20000", ...; their check box sets the whole range and shows
+     * the range's tri-state aggregate. Resets the model, so expansion is lost
+     * @param pageSize Children per bucket - 0 turns grouping off
+     */
+    void SetPageSize(int pageSize);
+
+    /**
+     * @brief Gets the bucket size
+     * @return Children per bucket - 0 if grouping is off
+     */
+    int GetPageSize() const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    /**
+     * @brief Range bucket of a wide parent
+     */
+    struct Bucket
+    {
+        int Parent = A_TreeSuccinct::NoNode;  // Node owning the children - NoNode for root items
+        int Number = 0;                  // Bucket position among the parent's buckets
+    };
+
+    /**
+     * @brief Gets the node number of an index
+     * @param index Model index - invalid for the root level
+     * @return Node number - A_TreeSuccinct::NoNode for the root level and for buckets
+     */
+    int NodeFromIndex(const QModelIndex &index) const;
+
+    /**
+     * @brief Gets the bucket of an index
+     * @param index Model index
+     * @return Bucket number in Buckets - -1 if the index is a node or the root level
+     */
+    int BucketFromIndex(const QModelIndex &index) const;
+
+    /**
+     * @brief Creates the index of a node
+     * @param node Node number
+     * @return Model index with the node's row among its siblings or within its bucket
+     */
+    QModelIndex IndexFromNode(int node) const;
+
+    /**
+     * @brief Creates the index of a bucket, registering it on first use
+     * @param parent Node owning the children
+     * @param number Bucket position among the parent's buckets
+     * @return Model index
+     */
+    QModelIndex IndexFromBucket(int parent, int number) const;
+
+    /**
+     * @brief Gets whether a node's children are grouped into buckets
+     * @param node Node number - NoNode for root items
+     * @return True if grouping is on and the node has more than PageSize children
+     */
+    bool IsPaged(int node) const;
+
+    /**
+     * @brief Gets the children covered by a bucket
+     * @param bucket Bucket number in Buckets
+     * @param first Receives the first child's node number
+     * @param count Receives the number of children
+     */
+    void GetBucketRange(int bucket, int *first, int *count) const;
+
+    A_TreeSuccinct *Tree;            // Encoded tree - not owned
+    int PageSize;                    // Children per bucket - 0 if grouping is off
+    mutable QVector<Bucket> Buckets;  // Buckets handed out in indexes - internal id is node count plus position
+    mutable QHash<QPair<int, int>, int> BucketNumbers;  // Position in Buckets by (parent, bucket position)
+};
+
+#endif // A_TREE_FROZEN_MODEL_H
@@ -0,0 +1,181 @@
+#include "a_tree_generator.h"
+#include <cmath>
+
+namespace {
+const int LabelPoolLimit = 4096;                          // Fresh labels kept for reuse - oldest are overwritten at random
+const char Consonants[] = "bcdfghjklmnprstvwz";           // Letters alternated with vowels for readable labels
+const char Vowels[] = "aeiou";
+}
+
+A_TreeGenerator::A_TreeGenerator(const Parameters &parameters)
+    : Settings(parameters)          // Settings - copied, clamped below
+    , Random(parameters.Seed)       // Engine - seeded once, same sequence for same seed
+{
+    Settings.NodeCount = qMax(0, Settings.NodeCount);
+    Settings.RootCount = qMax(1, Settings.RootCount);
+    Settings.MaxDepth = qMax(0, Settings.MaxDepth);
+    Settings.BranchProbability = qBound(0.0, Settings.BranchProbability, 1.0);
+    Settings.FanOutMean = qMax(1, Settings.FanOutMean);
+    Settings.FanOutMax = qMax(1, Settings.FanOutMax);
+    Settings.LabelMinLength = qMax(1, Settings.LabelMinLength);
+    Settings.LabelMaxLength = qMax(Settings.LabelMinLength, Settings.LabelMaxLength);
+    Settings.LabelReuseRate = qBound(0.0, Settings.LabelReuseRate, 1.0);
+}
+
+QVector<A_TreeGenerator::Node> A_TreeGenerator::Generate()
+{
+    /**
+     * Grows the tree breadth-first: every visited item below MaxDepth becomes a parent
+     * (roots always, others with BranchProbability) and gets a drawn number of children.
+     * If the frontier dies out before NodeCount is reached another root is started
+     * @return Nodes, parents before children
+     */
+
+    const int _nodeCount = Settings.NodeCount;            // Exact size of the result
+    QVector<Node> _nodes;                                 // Result being built
+    QVector<int> _depths;                                 // Depth per node
+    _nodes.reserve(_nodeCount);
+    _depths.reserve(_nodeCount);
+
+    auto _appendNode = [&](int parentIndex, int depth) {  // Adds one node with a drawn label
+        Node _node;
+        _node.Text = DrawLabel();
+        _node.ParentIndex = parentIndex;
+        _nodes.append(_node);
+        _depths.append(depth);
+    };
+
+    for (int _rootIndex = 0; _rootIndex < Settings.RootCount && _nodes.size() < _nodeCount; ++_rootIndex) {
+        _appendNode(-1, 0);
+    }
+
+    int _nextParent = 0;                                  // Breadth-first cursor
+    while (_nodes.size() < _nodeCount) {
+        if (_nextParent >= _nodes.size()) {
+            _appendNode(-1, 0);                           // Frontier died out - start another root
+            continue;
+        }
+
+        const int _parentIndex = _nextParent++;           // Item deciding about children
+        const int _depth = _depths.at(_parentIndex);
+        if (_depth >= Settings.MaxDepth) {
+            continue;                                     // Deepest level holds only leaves
+        }
+        if (_depth > 0 && Random.generateDouble() >= Settings.BranchProbability) {
+            continue;                                     // Stays a leaf
+        }
+
+        const int _childCount = qMin(DrawFanOut(), _nodeCount - _nodes.size());
+        for (int _childIndex = 0; _childIndex < _childCount; ++_childIndex) {
+            _appendNode(_parentIndex, _depth + 1);        // Siblings stay contiguous
+        }
+    }
+
+    return _nodes;
+}
+
+const A_TreeGenerator::Parameters& A_TreeGenerator::GetParameters() const
+{
+    /**
+     * Gets the clamped settings
+     * @return Settings reference
+     */
+
+    return Settings;
+}
+
+QString A_TreeGenerator::GetDistributionName(FanOutDistribution distribution)
+{
+    /**
+     * Maps a distribution to its display name
+     * @return Name
+     */
+
+    switch (distribution) {
+    case FixedFanOut:
+        return "Fixed";
+    case UniformFanOut:
+        return "Uniform";
+    case GeometricFanOut:
+        return "Geometric";
+    case PowerLawFanOut:
+        return "Power law";
+    }
+    return QString();
+}
+
+int A_TreeGenerator::DrawFanOut()
+{
+    /**
+     * Draws from the configured distribution by inverse transform of one uniform sample
+     * @return Children count clamped to 1..FanOutMax
+     */
+
+    const double _mean = Settings.FanOutMean;             // Target mean
+    const double _uniform = 1.0 - Random.generateDouble();  // Sample in (0, 1] - safe for log and division
+    double _count = _mean;                                // Drawn count before clamping
+
+    switch (Settings.FanOut) {
+    case FixedFanOut:
+        break;
+    case UniformFanOut:
+        _count = 1 + std::floor((1.0 - _uniform) * (2.0 * _mean - 1.0));  // 1 .. 2 * mean - 1
+        break;
+    case GeometricFanOut:
+        if (_mean > 1.0) {
+            _count = 1 + std::floor(std::log(_uniform) / std::log(1.0 - 1.0 / _mean));  // Support 1, 2, ... with mean _mean
+        }
+        break;
+    case PowerLawFanOut:
+        _count = std::ceil(_mean / 2.0 / std::sqrt(_uniform));  // Pareto with alpha 2 and minimum mean / 2
+        break;
+    }
+
+    if (_count > Settings.FanOutMax) {
+        return Settings.FanOutMax;                        // Also guards the cast against huge draws
+    }
+    return qMax(1, int(_count));
+}
+
+QString A_TreeGenerator::DrawLabel()
+{
+    /**
+     * Repeats a pooled label at the configured rate so duplicate texts, shared prefixes for
+     * filtering and collation ties appear as often as in real data
+     * @return Label text
+     */
+
+    if (!LabelPool.isEmpty() && Random.generateDouble() < Settings.LabelReuseRate) {
+        return LabelPool.at(Random.bounded(LabelPool.size()));  // Shares the pooled string buffer
+    }
+
+    QString _label = MakeFreshLabel();                    // New label
+    if (LabelPool.size() < LabelPoolLimit) {
+        LabelPool.append(_label);
+    } else {
+        LabelPool[Random.bounded(LabelPoolLimit)] = _label;  // Keep the pool bounded
+    }
+    return _label;
+}
+
+QString A_TreeGenerator::MakeFreshLabel()
+{
+    /**
+     * Alternates consonants and vowels so labels are readable and sort like words
+     * @return Label text
+     */
+
+    const int _length = Settings.LabelMinLength +
+                        Random.bounded(Settings.LabelMaxLength - Settings.LabelMinLength + 1);  // Drawn length
+    QString _label(_length, Qt::Uninitialized);           // Label being filled
+    for (int _position = 0; _position < _length; ++_position) {
+        if (_position % 2 == 0) {
+            _label[_position] = QLatin1Char(Consonants[Random.bounded(int(sizeof(Consonants) - 1))]);
+        } else {
+            _label[_position] = QLatin1Char(Vowels[Random.bounded(int(sizeof(Vowels) - 1))]);
+        }
+    }
+    _label[0] = _label.at(0).toUpper();
+
+    return _label;
+}
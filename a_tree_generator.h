@@ -0,0 +1,99 @@
+#ifndef A_TREE_GENERATOR_H
+#define A_TREE_GENERATOR_H
+
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class A_TreeGenerator
+{
+public:
+    /**
+     * @brief Shape of the fan-out distribution
+     */
+    enum FanOutDistribution {
+        FixedFanOut,                 // Every parent gets exactly FanOutMean children
+        UniformFanOut,               // Uniform between 1 and 2 * FanOutMean - 1
+        GeometricFanOut,             // Many small, few large sibling lists - mean FanOutMean
+        PowerLawFanOut               // Heavy tail (Pareto, alpha 2) - mean about FanOutMean, a few huge folders
+    };
+
+    /**
+     * @brief Generator settings - the same settings and seed always produce the same tree
+     */
+    struct Parameters
+    {
+        quint32 Seed = 1;            // Random seed
+        int NodeCount = 10000;       // Exact number of nodes to generate
+        int RootCount = 4;           // Root level items created first
+        int MaxDepth = 8;            // Deepest level that may hold items - roots are depth 0
+        double BranchProbability = 0.3;  // Chance that a non-root item gets children - shapes the depth distribution
+        FanOutDistribution FanOut = GeometricFanOut;  // Children per parent
+        int FanOutMean = 8;          // Mean children per parent
+        int FanOutMax = 1000;        // Largest sibling list
+        int LabelMinLength = 4;      // Shortest fresh label in characters
+        int LabelMaxLength = 16;     // Longest fresh label in characters
+        double LabelReuseRate = 0.2; // Chance that a label repeats an earlier one instead of being fresh
+    };
+
+    /**
+     * @brief Generated node - nodes are listed breadth-first, parents before children, siblings contiguous
+     */
+    struct Node
+    {
+        QString Text;                // Label
+        int ParentIndex = -1;        // Index of the parent node - -1 for root level
+    };
+
+    /**
+     * @brief Constructor for a generator
+     * @param parameters Generator settings - out of range values are clamped
+     */
+    explicit A_TreeGenerator(const Parameters &parameters);
+
+    /**
+     * @brief Generates the tree described by the settings
+     * Independent of platform and Qt version for a given seed
+     * @return Exactly NodeCount nodes
+     */
+    QVector<Node> Generate();
+
+    /**
+     * @brief Gets the settings after clamping
+     * @return Effective settings
+     */
+    const Parameters& GetParameters() const;
+
+    /**
+     * @brief Gets the name of a fan-out distribution for display
+     * @param distribution Distribution
+     * @return Name such as "Geometric"
+     */
+    static QString GetDistributionName(FanOutDistribution distribution);
+
+private:
+    /**
+     * @brief Draws the number of children of one parent
+     * @return Children count between 1 and FanOutMax
+     */
+    int DrawFanOut();
+
+    /**
+     * @brief Draws a label - repeated from the pool at LabelReuseRate, otherwise fresh
+     * @return Label text, never empty
+     */
+    QString DrawLabel();
+
+    /**
+     * @brief Builds a fresh pronounceable label of random length
+     * @return Label text with an upper case first letter
+     */
+    QString MakeFreshLabel();
+
+    Parameters Settings;             // Clamped settings
+    QRandomGenerator Random;         // Seeded engine - the only source of randomness
+    QStringList LabelPool;           // Earlier fresh labels available for reuse
+};
+
+#endif // A_TREE_GENERATOR_H
@@ -0,0 +1,212 @@
+#include "a_tree_hashes.h"
+
+namespace {
+const quint64 TextHashBasis = 0xcbf29ce484222325ULL;      // FNV-1a offset basis
+const quint64 TextHashPrime = 0x100000001b3ULL;           // FNV-1a prime
+const quint64 StateSalt = 0x9e3779b97f4a7c15ULL;          // Separates the state hash from the content hash
+
+/**
+ * @brief Scrambles all bits of a value (SplitMix64 finalizer)
+ * @param value Value to mix
+ * @return Mixed value
+ */
+quint64 Mix(quint64 value)
+{
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ULL;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    return value;
+}
+
+/**
+ * @brief Hashes a text - stable across runs and platforms, unlike qHash
+ * @param text Text
+ * @return FNV-1a hash of the UTF-16 code units
+ */
+quint64 HashText(const QString &text)
+{
+    quint64 _hash = TextHashBasis;                        // Running hash
+    const QChar *_data = text.constData();
+    for (int _position = 0; _position < text.size(); ++_position) {
+        _hash = (_hash ^ _data[_position].unicode()) * TextHashPrime;
+    }
+    return _hash;
+}
+}
+
+A_TreeHashes::A_TreeHashes()
+    : IsOn(false)                   // Maintenance flag - starts false, no cost until enabled
+{
+}
+
+bool A_TreeHashes::IsEnabled() const
+{
+    /**
+     * Gets the maintenance flag
+     * @return True if enabled
+     */
+
+    return IsOn;
+}
+
+void A_TreeHashes::Enable()
+{
+    /**
+     * Enables maintenance with nothing computed
+     */
+
+    IsOn = true;
+    InvalidateAll();
+}
+
+void A_TreeHashes::Disable()
+{
+    /**
+     * Disables maintenance and releases memory
+     */
+
+    IsOn = false;
+    InvalidateAll();
+}
+
+void A_TreeHashes::InvalidateAll()
+{
+    /**
+     * Drops all hashes
+     */
+
+    Nodes.clear();
+    ValidBits.clear();
+}
+
+bool A_TreeHashes::Invalidate(quint32 nodeId)
+{
+    /**
+     * Clears the valid bit of a node
+     * @return True if it was set
+     */
+
+    if (!IsValid(nodeId)) {
+        return false;
+    }
+    ValidBits.clearBit(int(nodeId));
+    return true;
+}
+
+bool A_TreeHashes::IsValid(quint32 nodeId) const
+{
+    /**
+     * Tests the valid bit of a node
+     * @return True if computed
+     */
+
+    return int(nodeId) < ValidBits.size() && ValidBits.testBit(int(nodeId));
+}
+
+const A_TreeHashes::Values& A_TreeHashes::Get(quint32 nodeId) const
+{
+    /**
+     * Gets stored hashes
+     * @return Hashes
+     */
+
+    return Nodes.at(int(nodeId));
+}
+
+void A_TreeHashes::Set(quint32 nodeId, const Values &values)
+{
+    /**
+     * Stores hashes and sets the valid bit
+     */
+
+    Grow(nodeId);
+    Nodes[int(nodeId)] = values;
+    ValidBits.setBit(int(nodeId));
+}
+
+qint64 A_TreeHashes::GetMemoryBytes() const
+{
+    /**
+     * Sums hash capacity and flag bits
+     * @return Bytes
+     */
+
+    return qint64(Nodes.capacity()) * qint64(sizeof(Values)) + (ValidBits.size() + 7) / 8;
+}
+
+A_TreeHashes::Values A_TreeHashes::Begin(const QString &text, Qt::CheckState state)
+{
+    /**
+     * Seeds both hashes with the text; the state hash also takes the check state
+     * @return Started hashes
+     */
+
+    Values _values;                                       // Node alone
+    _values.ContentHash = Mix(HashText(text));
+    _values.StateHash = Mix(_values.ContentHash ^ StateSalt ^ quint64(state));
+    return _values;
+}
+
+void A_TreeHashes::AddChild(Values &parent, const Values &child)
+{
+    /**
+     * Folds a child in sequentially - mixing after every step makes the result order dependent
+     */
+
+    parent.ContentHash = Mix(parent.ContentHash ^ child.ContentHash);
+    parent.StateHash = Mix(parent.StateHash ^ child.StateHash);
+}
+
+void A_TreeHashes::Finish(Values &values, int childCount)
+{
+    /**
+     * Folds in the child count so a leaf and a parent cannot share a fold sequence
+     */
+
+    values.ContentHash = Mix(values.ContentHash + quint64(childCount));
+    values.StateHash = Mix(values.StateHash + quint64(childCount));
+}
+
+void A_TreeHashes::HashBlock(A_TreeSnapshot::Block *block)
+{
+    /**
+     * Children sit after their parent in pre-order, so walking positions backwards finds
+     * every child hashed; children of a position are found by jumping over subtree ends
+     */
+
+    const int _nodeCount = block->NodeIds.size();         // Positions in the block
+    block->ContentHashes.resize(_nodeCount);
+    block->StateHashes.resize(_nodeCount);
+    for (int _position = _nodeCount - 1; _position >= 0; --_position) {
+        Values _values = Begin(block->Texts.at(_position), Qt::CheckState(block->CheckStates.at(_position)));
+        int _childCount = 0;                              // Children folded in
+        for (int _child = _position + 1; _child < block->SubtreeEnds.at(_position); _child = block->SubtreeEnds.at(_child)) {
+            Values _childValues;                          // Child hashes stored by this pass
+            _childValues.ContentHash = block->ContentHashes.at(_child);
+            _childValues.StateHash = block->StateHashes.at(_child);
+            AddChild(_values, _childValues);
+            _childCount++;
+        }
+        Finish(_values, _childCount);
+        block->ContentHashes[_position] = _values.ContentHash;
+        block->StateHashes[_position] = _values.StateHash;
+    }
+}
+
+void A_TreeHashes::Grow(quint32 nodeId)
+{
+    /**
+     * Grows hashes and flags geometrically
+     */
+
+    const int _required = int(nodeId) + 1;                // Size needed to address nodeId
+    if (Nodes.size() >= _required) {
+        return;
+    }
+
+    const int _size = qMax(_required, 2 * Nodes.size());  // Grow geometrically
+    Nodes.resize(_size);
+    ValidBits.resize(_size);
+}
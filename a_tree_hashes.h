@@ -0,0 +1,123 @@
+#ifndef A_TREE_HASHES_H
+#define A_TREE_HASHES_H
+
+#include <QBitArray>
+#include <QString>
+#include <QVector>
+#include "a_tree_snapshot.h"
+
+class A_TreeHashes
+{
+public:
+    /**
+     * @brief Hashes of one node's subtree
+     */
+    struct Values
+    {
+        quint64 ContentHash = 0;     // Texts and structure - equal for subtrees with the same labels in the same shape
+        quint64 StateHash = 0;       // Texts, structure and check states
+    };
+
+    /**
+     * @brief Constructor for disabled hashes
+     */
+    A_TreeHashes();
+
+    /**
+     * @brief Gets whether hashes are maintained
+     * @return True if enabled
+     */
+    bool IsEnabled() const;
+
+    /**
+     * @brief Turns maintenance on - every node starts invalid and is hashed on first request
+     */
+    void Enable();
+
+    /**
+     * @brief Turns maintenance off and frees all hashes
+     */
+    void Disable();
+
+    /**
+     * @brief Marks every node as not computed
+     */
+    void InvalidateAll();
+
+    /**
+     * @brief Marks a node as not computed
+     * @param nodeId Node identifier
+     * @return True if it was valid before - false means its ancestors are already invalid too
+     */
+    bool Invalidate(quint32 nodeId);
+
+    /**
+     * @brief Gets whether a node's hashes are computed
+     * @param nodeId Node identifier
+     * @return True if Get returns the node's hashes
+     */
+    bool IsValid(quint32 nodeId) const;
+
+    /**
+     * @brief Gets the hashes of a node
+     * @param nodeId Node identifier - must be valid
+     * @return Subtree hashes
+     */
+    const Values& Get(quint32 nodeId) const;
+
+    /**
+     * @brief Stores computed hashes of a node and marks it valid
+     * @param nodeId Node identifier
+     * @param values Subtree hashes
+     */
+    void Set(quint32 nodeId, const Values &values);
+
+    /**
+     * @brief Gets the bytes held by all hashes
+     * @return Allocated hash and flag bytes
+     */
+    qint64 GetMemoryBytes() const;
+
+    /**
+     * @brief Starts the hashes of a node from its own text and state
+     * @param text Node text
+     * @param state Node check state
+     * @return Hashes to which the children are added in order
+     */
+    static Values Begin(const QString &text, Qt::CheckState state);
+
+    /**
+     * @brief Adds the next child's subtree - order matters, so reordered siblings hash differently
+     * @param parent Hashes started with Begin
+     * @param child Child subtree hashes
+     */
+    static void AddChild(Values &parent, const Values &child);
+
+    /**
+     * @brief Completes a node's hashes once all children are added
+     * @param values Hashes started with Begin
+     * @param childCount Number of children added
+     */
+    static void Finish(Values &values, int childCount);
+
+    /**
+     * @brief Hashes every node of a snapshot block in one backward pass and stores the hashes in the block
+     * Blocks are immutable once built, so each block is hashed once however often it is compared
+     * @param block Block being built - its hashes equal A_Tree's hashes of the same items,
+     * except for an open top item, whose hash covers only the leading children
+     */
+    static void HashBlock(A_TreeSnapshot::Block *block);
+
+private:
+    /**
+     * @brief Grows the arrays to hold a node identifier
+     * @param nodeId Node identifier that must fit
+     */
+    void Grow(quint32 nodeId);
+
+    QVector<Values> Nodes;           // Hashes indexed by node identifier
+    QBitArray ValidBits;             // Set if the node's hashes are computed - an invalid node has invalid ancestors
+    bool IsOn;                       // Maintenance flag
+};
+
+#endif // A_TREE_HASHES_H
@@ -0,0 +1,467 @@
+#include "a_tree_ipc_server.h"
+#include "a_tree.h"
+#include <QDataStream>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrentRun>
+
+namespace {
+const int FrameHeaderBytes = 4;                           // Length field in front of every frame
+const int RequestHeaderBytes = 5;                         // Request identifier and opcode
+const quint32 MaxFrameBytes = 64 * 1024 * 1024;           // Larger frames close the connection
+const int ProbeMilliseconds = 100;                        // Wait for a live server on the requested name
+
+/**
+ * @brief Starts a reply with its status - fields are appended after it
+ * @param status Reply status
+ * @param reply Receives the status byte
+ */
+void BeginReply(A_TreeIpcServer::Status status, QByteArray *reply)
+{
+    QDataStream _stream(reply, QIODevice::WriteOnly);
+    _stream.setVersion(QDataStream::Qt_5_12);             // Fixed encoding across Qt versions
+    _stream << quint8(status);
+}
+
+/**
+ * @brief Encodes a failed reply
+ * @param status Reply status
+ * @param reason Error text for the client
+ * @return Status and reason
+ */
+QByteArray ErrorReply(A_TreeIpcServer::Status status, const QString &reason)
+{
+    QByteArray _reply;                                    // Status and reason
+    QDataStream _stream(&_reply, QIODevice::WriteOnly);
+    _stream.setVersion(QDataStream::Qt_5_12);
+    _stream << quint8(status) << reason;
+    return _reply;
+}
+
+/**
+ * @brief Reads a separator and a counted list of strings
+ * @param body Request fields
+ * @param separator Receives the separator - "/" if empty
+ * @param strings Receives the strings
+ * @return False if the body is malformed
+ */
+bool DecodeStrings(const QByteArray &body, QString *separator, QStringList *strings)
+{
+    QDataStream _stream(body);                            // Reader over request fields
+    _stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 _count = 0;                                   // Number of strings that follow
+    _stream >> *separator >> _count;
+    if (_count > quint32(body.size() / 4)) {
+        return false;                                     // Count cannot fit in body
+    }
+    strings->reserve(int(_count));
+    for (quint32 _index = 0; _index < _count && _stream.status() == QDataStream::Ok; ++_index) {
+        QString _string;
+        _stream >> _string;
+        strings->append(_string);
+    }
+    if (separator->isEmpty()) {
+        *separator = QStringLiteral("/");
+    }
+
+    return _stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief Resolves paths to node identifiers on a snapshot (worker thread)
+ * @param snapshot Tree version the request sees
+ * @param body Request fields
+ * @return Status and identifiers
+ */
+QByteArray FindPathsReply(const A_TreeSnapshot &snapshot, const QByteArray &body)
+{
+    QString _separator;                                   // Path separator
+    QStringList _paths;                                   // Requested paths
+    if (!DecodeStrings(body, &_separator, &_paths)) {
+        return ErrorReply(A_TreeIpcServer::BadRequest, QStringLiteral("Malformed path list"));
+    }
+
+    QByteArray _reply;                                    // Status and identifiers
+    BeginReply(A_TreeIpcServer::Ok, &_reply);
+    QDataStream _stream(&_reply, QIODevice::Append);
+    _stream.setVersion(QDataStream::Qt_5_12);
+    _stream << quint32(_paths.size());
+    for (const QString &_path : std::as_const(_paths)) {
+        const int _index = snapshot.FindPath(_path, _separator);  // Pre-order position or -1
+        _stream << (_index < 0 ? quint32(0) : snapshot.GetNodeId(_index));
+    }
+    return _reply;
+}
+
+/**
+ * @brief Lists the paths of checked leaves on a snapshot (worker thread)
+ * @param snapshot Tree version the request sees
+ * @param body Request fields
+ * @return Status and paths
+ */
+QByteArray CheckedPathsReply(const A_TreeSnapshot &snapshot, const QByteArray &body)
+{
+    QDataStream _request(body);                           // Reader over request fields
+    _request.setVersion(QDataStream::Qt_5_12);
+    QString _separator;                                   // Path separator
+    _request >> _separator;
+    if (_request.status() != QDataStream::Ok) {
+        return ErrorReply(A_TreeIpcServer::BadRequest, QStringLiteral("Malformed separator"));
+    }
+    if (_separator.isEmpty()) {
+        _separator = QStringLiteral("/");
+    }
+
+    QStringList _paths;                                   // Checked leaf paths in pre-order
+    for (int _index = 0; _index < snapshot.GetNodeCount(); ++_index) {
+        if (snapshot.GetSubtreeEnd(_index) == _index + 1 && snapshot.GetCheckState(_index) == Qt::Checked) {
+            _paths.append(snapshot.GetPath(_index, _separator));
+        }
+    }
+
+    QByteArray _reply;                                    // Status and paths
+    BeginReply(A_TreeIpcServer::Ok, &_reply);
+    QDataStream _stream(&_reply, QIODevice::Append);
+    _stream.setVersion(QDataStream::Qt_5_12);
+    _stream << quint32(_paths.size());
+    for (const QString &_path : std::as_const(_paths)) {
+        _stream << _path;
+    }
+    return _reply;
+}
+}
+
+A_TreeIpcServer::A_TreeIpcServer(A_Tree *tree, QObject *parent)
+    : QObject(parent)
+    , Tree(tree)                    // Served tree - read through snapshots, written on the GUI thread
+    , Server(new QLocalServer(this))  // Listening socket - owns accepted client sockets
+{
+    connect(Server, &QLocalServer::newConnection, this, &A_TreeIpcServer::OnNewConnection);
+}
+
+A_TreeIpcServer::~A_TreeIpcServer()
+{
+    // Reads only hold snapshot copies, wait so no worker outlives the server
+    const QList<QFutureWatcher<QByteArray>*> _watchers = findChildren<QFutureWatcher<QByteArray>*>();
+    for (QFutureWatcher<QByteArray> *_watcher : _watchers) {
+        _watcher->waitForFinished();
+    }
+}
+
+bool A_TreeIpcServer::Listen(const QString &name)
+{
+    /**
+     * Refuses a name a live server answers on, then removes a stale socket file and listens
+     * @return True on success
+     */
+
+    Close();
+
+    QLocalSocket _probe;                                  // Connects only if another server is alive
+    _probe.connectToServer(name);
+    if (_probe.waitForConnected(ProbeMilliseconds)) {
+        ErrorString = QString("Another server listens on %1").arg(name);
+        return false;
+    }
+
+    QLocalServer::removeServer(name);                     // Left behind by a crashed instance
+    if (!Server->listen(name)) {
+        ErrorString = Server->errorString();
+        return false;
+    }
+
+    ErrorString.clear();
+    return true;
+}
+
+void A_TreeIpcServer::Close()
+{
+    /**
+     * Closes the listening socket and aborts all clients; pending reads finish unseen
+     */
+
+    Server->close();
+    const QList<QLocalSocket*> _sockets = Connections.keys();
+    Connections.clear();
+    for (QLocalSocket *_socket : _sockets) {
+        _socket->disconnect(this);                        // No DropConnection for an already forgotten client
+        _socket->abort();
+        _socket->deleteLater();
+    }
+}
+
+bool A_TreeIpcServer::IsListening() const
+{
+    /**
+     * Gets the listening state
+     * @return True while listening
+     */
+
+    return Server->isListening();
+}
+
+QString A_TreeIpcServer::GetErrorString() const
+{
+    /**
+     * Gets the last error
+     * @return Error text
+     */
+
+    return ErrorString;
+}
+
+QByteArray A_TreeIpcServer::EncodeRequest(quint32 requestId, Opcode opcode, const QByteArray &body)
+{
+    /**
+     * Writes the header in front of the body
+     * @return Framed request
+     */
+
+    QByteArray _frame(FrameHeaderBytes + RequestHeaderBytes, Qt::Uninitialized);  // Header, then body
+    qToBigEndian(quint32(RequestHeaderBytes + body.size()), _frame.data());
+    qToBigEndian(requestId, _frame.data() + FrameHeaderBytes);
+    _frame[FrameHeaderBytes + 4] = char(opcode);
+    _frame.append(body);
+    return _frame;
+}
+
+void A_TreeIpcServer::OnNewConnection()
+{
+    /**
+     * Registers every pending client
+     */
+
+    while (QLocalSocket *_socket = Server->nextPendingConnection()) {
+        Connections.insert(_socket, Connection());
+        connect(_socket, &QLocalSocket::readyRead, this, [this, _socket]() { ReadRequests(_socket); });
+        connect(_socket, &QLocalSocket::disconnected, this, [this, _socket]() { DropConnection(_socket); });
+    }
+}
+
+void A_TreeIpcServer::ReadRequests(QLocalSocket *socket)
+{
+    /**
+     * Splits the received bytes into frames; a partial frame stays buffered for the next read.
+     * Pipelined requests are handled in arrival order, so a read sees all writes sent before it
+     */
+
+    auto _found = Connections.find(socket);               // Client state
+    if (_found == Connections.end()) {
+        return;
+    }
+    _found->Buffer += socket->readAll();
+    const QByteArray _buffer = _found->Buffer;            // Frames are handled from a copy - handlers touch Connections
+
+    int _offset = 0;                                      // Start of the next frame
+    while (_buffer.size() - _offset >= FrameHeaderBytes) {
+        const quint32 _length = qFromBigEndian<quint32>(_buffer.constData() + _offset);
+        if (_length < quint32(RequestHeaderBytes) || _length > MaxFrameBytes) {
+            DropConnection(socket);                       // Stream cannot be resynchronized
+            socket->abort();
+            return;
+        }
+        if (quint32(_buffer.size() - _offset - FrameHeaderBytes) < _length) {
+            break;                                        // Rest of the frame not received yet
+        }
+
+        const char *_header = _buffer.constData() + _offset + FrameHeaderBytes;
+        const quint32 _requestId = qFromBigEndian<quint32>(_header);
+        const quint8 _opcode = quint8(_header[4]);
+        HandleRequest(socket, _requestId, _opcode,
+                      _buffer.mid(_offset + FrameHeaderBytes + RequestHeaderBytes, int(_length) - RequestHeaderBytes));
+        _offset += FrameHeaderBytes + int(_length);
+    }
+
+    _found = Connections.find(socket);
+    if (_found != Connections.end()) {
+        _found->Buffer = _buffer.mid(_offset);
+    }
+    FlushReplies(socket);
+}
+
+void A_TreeIpcServer::HandleRequest(QLocalSocket *socket, quint32 requestId, quint8 opcode, const QByteArray &body)
+{
+    /**
+     * Queues the request's reply slot; reads take the snapshot now and evaluate it on a worker thread.
+     * Compact and frozen trees publish no snapshots, so reads are refused there rather than answered
+     * from a stale or empty one
+     */
+
+    PendingReply _reply;                                  // Reply slot in request order
+    _reply.RequestId = requestId;
+
+    switch (opcode) {
+    case Ping:
+        BeginReply(Ok, &_reply.Reply);
+        break;
+    case FindPaths:
+    case GetCheckedPaths: {
+        if (Tree->IsCompactMode() || Tree->IsTreeFrozen()) {
+            _reply.Reply = ErrorReply(Unavailable, QStringLiteral("Tree keeps no snapshot"));
+            break;
+        }
+        const std::shared_ptr<const A_TreeSnapshot> _snapshot = Tree->GetSnapshot();  // Includes earlier writes of this client
+        QFutureWatcher<QByteArray> *_watcher = new QFutureWatcher<QByteArray>(this);
+        connect(_watcher, &QFutureWatcher<QByteArray>::finished, this, [this, socket, _watcher]() {
+            _watcher->deleteLater();
+            auto _found = Connections.find(socket);       // Client may be gone
+            if (_found == Connections.end()) {
+                return;
+            }
+            for (PendingReply &_pending : _found->Replies) {
+                if (_pending.Watcher == _watcher) {
+                    _pending.Reply = _watcher->result();
+                    _pending.Watcher = nullptr;
+                    break;
+                }
+            }
+            FlushReplies(socket);
+        });
+        _watcher->setFuture(QtConcurrent::run([_snapshot, opcode, body]() -> QByteArray {
+            return opcode == FindPaths ? FindPathsReply(*_snapshot, body) : CheckedPathsReply(*_snapshot, body);
+        }));
+        _reply.Watcher = _watcher;
+        break;
+    }
+    case ApplyCheckRules:
+        _reply.Reply = ApplyRuleLines(body);
+        break;
+    case ApplyEvents:
+        _reply.Reply = ApplyEventBatch(body);
+        break;
+    default:
+        _reply.Reply = ErrorReply(BadRequest, QString("Unknown opcode %1").arg(opcode));
+        break;
+    }
+
+    auto _found = Connections.find(socket);               // Client state
+    if (_found != Connections.end()) {
+        _found->Replies.enqueue(_reply);
+    }
+}
+
+QByteArray A_TreeIpcServer::ApplyEventBatch(const QByteArray &body)
+{
+    /**
+     * Decodes all events first, so a malformed batch changes nothing, then applies them
+     * through A_Tree::ApplySyncEvents - one repaint and one check state pass for the batch
+     * @return Status and counts
+     */
+
+    if (Tree->IsTreeFrozen() || Tree->IsSharedTreeReader()) {
+        return ErrorReply(Unavailable, QStringLiteral("Tree is read-only"));
+    }
+
+    QDataStream _stream(body);                            // Reader over request fields
+    _stream.setVersion(QDataStream::Qt_5_12);
+    QString _separator;                                   // Path separator
+    quint32 _count = 0;                                   // Number of events that follow
+    _stream >> _separator >> _count;
+    if (_count > quint32(body.size() / 9)) {
+        return ErrorReply(BadRequest, QStringLiteral("Event count exceeds body"));  // Kind and two string lengths at least
+    }
+
+    QVector<A_Tree::SyncEvent> _events;                   // Decoded events in order
+    _events.reserve(int(_count));
+    for (quint32 _index = 0; _index < _count && _stream.status() == QDataStream::Ok; ++_index) {
+        quint8 _kind = 0;                                 // Encoded A_Tree::SyncEvent::Kind
+        A_Tree::SyncEvent _event;
+        _stream >> _kind >> _event.Path >> _event.Target;
+        if (_kind > A_Tree::SyncEvent::Uncheck) {
+            return ErrorReply(BadRequest, QString("Unknown event kind %1").arg(_kind));
+        }
+        _event.Type = A_Tree::SyncEvent::Kind(_kind);
+        _events.append(_event);
+    }
+    if (_stream.status() != QDataStream::Ok) {
+        return ErrorReply(BadRequest, QStringLiteral("Malformed event list"));
+    }
+
+    qint32 _added = 0;                                    // Counts reported by the tree
+    qint32 _removed = 0;
+    qint32 _changed = 0;
+    const QMetaObject::Connection _counter = connect(Tree, &A_Tree::SyncApplied, this,
+        [&_added, &_removed, &_changed](int addedCount, int removedCount, int changedCount) {
+            _added = addedCount;
+            _removed = removedCount;
+            _changed = changedCount;
+        });
+    Tree->ApplySyncEvents(_events, _separator.isEmpty() ? QStringLiteral("/") : _separator);
+    disconnect(_counter);
+    emit TreeChangedByClient(ApplyEvents);
+
+    QByteArray _reply;                                    // Status and counts
+    BeginReply(Ok, &_reply);
+    QDataStream _replyStream(&_reply, QIODevice::Append);
+    _replyStream.setVersion(QDataStream::Qt_5_12);
+    _replyStream << _added << _removed << _changed;
+    return _reply;
+}
+
+QByteArray A_TreeIpcServer::ApplyRuleLines(const QByteArray &body)
+{
+    /**
+     * Parses the lines with A_TreeCheckRules::Parse and applies them in one traversal
+     * @return Status and changed leaf count
+     */
+
+    if (Tree->IsTreeFrozen() || Tree->IsSharedTreeReader()) {
+        return ErrorReply(Unavailable, QStringLiteral("Tree is read-only"));
+    }
+
+    QString _separator;                                   // Path separator
+    QStringList _lines;                                   // Rule lines
+    if (!DecodeStrings(body, &_separator, &_lines)) {
+        return ErrorReply(BadRequest, QStringLiteral("Malformed rule list"));
+    }
+
+    QVector<A_TreeCheckRules::Rule> _rules;               // Parsed rules
+    QString _errorMessage;                                // Parse or compile error
+    if (!A_TreeCheckRules::Parse(_lines, &_rules, &_errorMessage)) {
+        return ErrorReply(BadRequest, _errorMessage);
+    }
+    const int _changedCount = Tree->ApplyCheckRules(_rules, _separator, &_errorMessage);
+    if (_changedCount < 0) {
+        return ErrorReply(BadRequest, _errorMessage);
+    }
+    emit TreeChangedByClient(ApplyCheckRules);
+
+    QByteArray _reply;                                    // Status and count
+    BeginReply(Ok, &_reply);
+    QDataStream _replyStream(&_reply, QIODevice::Append);
+    _replyStream.setVersion(QDataStream::Qt_5_12);
+    _replyStream << qint32(_changedCount);
+    return _reply;
+}
+
+void A_TreeIpcServer::FlushReplies(QLocalSocket *socket)
+{
+    /**
+     * Writes replies from the head of the queue until one is still being computed
+     */
+
+    auto _found = Connections.find(socket);               // Client state
+    if (_found == Connections.end()) {
+        return;
+    }
+
+    while (!_found->Replies.isEmpty() && !_found->Replies.head().Watcher) {
+        const PendingReply _reply = _found->Replies.dequeue();
+        QByteArray _frame(FrameHeaderBytes + 4, Qt::Uninitialized);  // Length and request identifier, then reply
+        qToBigEndian(quint32(4 + _reply.Reply.size()), _frame.data());
+        qToBigEndian(_reply.RequestId, _frame.data() + FrameHeaderBytes);
+        _frame.append(_reply.Reply);
+        socket->write(_frame);
+    }
+}
+
+void A_TreeIpcServer::DropConnection(QLocalSocket *socket)
+{
+    /**
+     * Removes the client's state; reads still running find no client when they finish
+     */
+
+    if (Connections.remove(socket) > 0) {
+        socket->deleteLater();
+    }
+}
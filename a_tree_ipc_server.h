@@ -0,0 +1,168 @@
+#ifndef A_TREE_IPC_SERVER_H
+#define A_TREE_IPC_SERVER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QQueue>
+
+class A_Tree;
+
+class A_TreeIpcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Request operation
+     * Frames are [quint32 length][quint32 request id][quint8 opcode][body], replies are
+     * [quint32 length][quint32 request id][quint8 status][body]; length counts the bytes after itself.
+     * Fields use QDataStream (Qt 5.12 encoding, big-endian), strings are QString
+     */
+    enum Opcode : quint8 {
+        Ping = 0,                    // Empty body - empty reply
+        FindPaths = 1,               // [separator][quint32 n][n paths] - reply [quint32 n][n node identifiers, 0 if missing]
+        GetCheckedPaths = 2,         // [separator] - reply [quint32 n][n paths of checked leaves]
+        ApplyCheckRules = 3,         // [separator][quint32 n][n rule lines] - reply [qint32 changed leaves]
+        ApplyEvents = 4              // [separator][quint32 n][n x (quint8 kind, path, target)] - reply [qint32 added][qint32 removed][qint32 changed]
+    };
+
+    /**
+     * @brief Reply status
+     */
+    enum Status : quint8 {
+        Ok = 0,                      // Body as described by the opcode
+        BadRequest = 1,              // Body is [QString reason] - malformed body, unknown opcode or invalid rule
+        Unavailable = 2              // Body is [QString reason] - tree cannot be changed now, or read while compact or frozen
+    };
+
+    /**
+     * @brief Constructor for a stopped server
+     * @param tree Tree to serve - must outlive the server
+     * @param parent Parent object
+     */
+    explicit A_TreeIpcServer(A_Tree *tree, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor - waits for reads still running on worker threads
+     */
+    ~A_TreeIpcServer();
+
+    /**
+     * @brief Starts accepting clients on a local socket
+     * A socket file left behind by a crashed instance is removed first
+     * @param name Socket name - a path or a name in the platform's socket directory
+     * @return False if the socket cannot be created
+     */
+    bool Listen(const QString &name);
+
+    /**
+     * @brief Stops accepting clients and drops all connections
+     */
+    void Close();
+
+    /**
+     * @brief Gets whether the server accepts clients
+     * @return True while listening
+     */
+    bool IsListening() const;
+
+    /**
+     * @brief Gets the last error
+     * @return Error text - empty if none
+     */
+    QString GetErrorString() const;
+
+    /**
+     * @brief Frames a request for sending - helper for clients written with Qt
+     * @param requestId Identifier echoed in the reply
+     * @param opcode Operation
+     * @param body Operation fields encoded with QDataStream
+     * @return Framed request
+     */
+    static QByteArray EncodeRequest(quint32 requestId, Opcode opcode, const QByteArray &body);
+
+signals:
+    /**
+     * @brief Signal emitted after a write request changed the tree
+     * @param opcode Operation that was applied
+     */
+    void TreeChangedByClient(int opcode);
+
+private slots:
+    /**
+     * @brief Accepts pending clients
+     */
+    void OnNewConnection();
+
+private:
+    /**
+     * @brief Reply slot in request order - replies leave a connection in the order requests arrived
+     */
+    struct PendingReply
+    {
+        quint32 RequestId = 0;       // Echoed request identifier
+        QFutureWatcher<QByteArray> *Watcher = nullptr;  // Worker-thread read - nullptr once the reply is ready
+        QByteArray Reply;            // Status and body - valid once Watcher is nullptr
+    };
+
+    /**
+     * @brief State of one client
+     */
+    struct Connection
+    {
+        QByteArray Buffer;           // Received bytes not yet forming a complete frame
+        QQueue<PendingReply> Replies;  // Replies not yet sent
+    };
+
+    /**
+     * @brief Reads all complete frames a client sent and handles them in order
+     * @param socket Client socket
+     */
+    void ReadRequests(QLocalSocket *socket);
+
+    /**
+     * @brief Handles one request - reads start on a worker thread, writes are applied at once
+     * @param socket Client socket
+     * @param requestId Request identifier
+     * @param opcode Operation
+     * @param body Operation fields
+     */
+    void HandleRequest(QLocalSocket *socket, quint32 requestId, quint8 opcode, const QByteArray &body);
+
+    /**
+     * @brief Applies a batch of change events as one grouped update
+     * @param body Request fields
+     * @return Status and reply body
+     */
+    QByteArray ApplyEventBatch(const QByteArray &body);
+
+    /**
+     * @brief Applies check rule lines
+     * @param body Request fields
+     * @return Status and reply body
+     */
+    QByteArray ApplyRuleLines(const QByteArray &body);
+
+    /**
+     * @brief Sends the ready replies at the head of a client's queue
+     * @param socket Client socket
+     */
+    void FlushReplies(QLocalSocket *socket);
+
+    /**
+     * @brief Forgets a client and disconnects its pending reads
+     * @param socket Client socket
+     */
+    void DropConnection(QLocalSocket *socket);
+
+    A_Tree *Tree;                    // Served tree - not owned
+    QLocalServer *Server;            // Listening socket
+    QHash<QLocalSocket*, Connection> Connections;  // Per-client state
+    QString ErrorString;             // Last error
+};
+
+#endif // A_TREE_IPC_SERVER_H
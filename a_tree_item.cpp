@@ -0,0 +1,82 @@
+#include "a_tree_item.h"
+#include "a_tree_attributes.h"
+#include "a_tree_aggregates.h"
+
+A_TreeItem::A_TreeItem(const QString &text)
+    : QTreeWidgetItem(ItemType)
+    , NodeId(0)                     // Node identifier - starts at 0, assigned when registered with A_Tree
+    , Context(nullptr)              // Tree context pointer - initialized to null, set when registered with A_Tree
+    , SortRank(0)                   // Sort rank - starts at 0, assigned when siblings are sorted
+    , IsNaturalSortKey(false)       // Key flavour flag - starts false, no key computed yet
+    , IsCheckStateChanged(false)    // Check change flag - starts false, no data set yet
+{
+    setText(0, text);                                     // Set display text
+}
+
+bool A_TreeItem::operator<(const QTreeWidgetItem &other) const
+{
+    /**
+     * Orders siblings by precomputed rank so the view can apply a sort
+     * without evaluating collation during comparisons
+     * @param other Sibling item to compare with
+     * @return True if this item comes first
+     */
+
+    return SortRank < static_cast<const A_TreeItem&>(other).SortRank;  // Compare assigned ranks
+}
+
+void A_TreeItem::setData(int column, int role, const QVariant &value)
+{
+    /**
+     * Forwards data changes and invalidates the cached collation key on text edits
+     * Covers both programmatic setText and inline editing through the view
+     */
+
+    IsCheckStateChanged = column == 0 && role == Qt::CheckStateRole &&
+                          QTreeWidgetItem::data(0, Qt::CheckStateRole).toInt() != value.toInt();
+    const A_TreeAttributes *_attributes = Context ? Context->Attributes : nullptr;  // Attribute columns of the tree
+    if (column == 0 && (role == Qt::DisplayRole || role == Qt::EditRole)) {
+        SortKey.reset();                                  // Key no longer matches text
+    } else if (column > 0 && _attributes && column <= _attributes->GetColumnCount() &&
+               (role == Qt::DisplayRole || role == Qt::EditRole)) {
+        return;                                           // Attribute columns are written through A_Tree
+    }
+
+    QTreeWidgetItem::setData(column, role, value);        // Store value in base item
+}
+
+QVariant A_TreeItem::data(int column, int role) const
+{
+    /**
+     * Serves attribute columns from the owning tree's typed arrays
+     * Nothing is stored per item for attribute columns, so columns cost no QVariant memory
+     */
+
+    const A_TreeAttributes *_attributes = Context ? Context->Attributes : nullptr;  // Attribute columns of the tree
+    const A_TreeAggregates *_aggregates = Context ? Context->Aggregates : nullptr;  // Roll-ups of the tree
+    const bool _hasRollUp = _aggregates && _aggregates->IsEnabled() && childCount() > 0 && _aggregates->IsValid(NodeId);
+    if (column == 0 && role == Qt::ToolTipRole && _hasRollUp) {
+        const A_TreeAggregates::Values &_values = _aggregates->Get(NodeId);  // Roll-up of this subtree
+        QString _toolTip = QString("%1 items, %2 checked").arg(_values.DescendantCount).arg(_values.CheckedLeafCount);
+        if (_aggregates->GetValueColumn() >= 0 && _values.ValueCount > 0) {
+            _toolTip += QString(", sum %1").arg(_values.Sum);
+        }
+        return _toolTip;
+    }
+
+    if (column > 0 && _attributes && column <= _attributes->GetColumnCount()) {
+        const int _attributeColumn = column - 1;          // Attribute columns follow the tree column
+        if (role == Qt::DisplayRole) {
+            if (_hasRollUp && _attributeColumn == _aggregates->GetValueColumn() && !_attributes->HasValue(_attributeColumn, NodeId) &&
+                _aggregates->Get(NodeId).ValueCount > 0) {
+                return _aggregates->Get(NodeId).Sum;      // Parent without own value shows its subtree total
+            }
+            return _attributes->GetDisplayValue(_attributeColumn, NodeId);  // Boxed at render time only
+        }
+        if (role == Qt::TextAlignmentRole && _attributes->GetColumnType(_attributeColumn) != A_TreeAttributes::TextColumn) {
+            return int(Qt::AlignRight | Qt::AlignVCenter);  // Numbers and dates line up on the right
+        }
+    }
+
+    return QTreeWidgetItem::data(column, role);           // Tree column and other roles
+}
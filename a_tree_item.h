@@ -0,0 +1,81 @@
+#ifndef A_TREE_ITEM_H
+#define A_TREE_ITEM_H
+
+#include <QTreeWidgetItem>
+#include <QCollator>
+#include <memory>
+
+class A_Tree;
+class A_TreeAttributes;
+class A_TreeAggregates;
+
+/**
+ * @brief Tree-wide state read by items at render time - shared by all items of one A_Tree
+ */
+struct A_TreeItemContext
+{
+    const A_TreeAttributes *Attributes = nullptr;  // Attribute columns of the owning tree
+    const A_TreeAggregates *Aggregates = nullptr;  // Subtree roll-ups of the owning tree
+};
+
+class A_TreeItem : public QTreeWidgetItem
+{
+public:
+    /**
+     * @brief Item type identifier for A_Tree nodes
+     */
+    static const int ItemType = QTreeWidgetItem::UserType + 1;
+
+    /**
+     * @brief Data role holding the identity key of an item synchronized from an external source
+     */
+    static const int SyncKeyRole = Qt::UserRole + 1;
+
+    /**
+     * @brief Constructor for A_TreeItem
+     * @param text Display text for the item - expected to be already trimmed
+     */
+    explicit A_TreeItem(const QString &text);
+
+    /**
+     * @brief Compares items by the rank assigned during the last A_Tree sort
+     * @param other Sibling item to compare with - must be an A_TreeItem
+     * @return True if this item is ordered before other
+     */
+    bool operator<(const QTreeWidgetItem &other) const override;
+
+    /**
+     * @brief Stores item data and drops the cached collation key when the text changes
+     * Records whether the call changed the check state - itemChanged is emitted from inside it
+     * @param column Column being modified
+     * @param role Data role being modified
+     * @param value New value for the role
+     */
+    void setData(int column, int role, const QVariant &value) override;
+
+    /**
+     * @brief Gets item data - attribute columns are read from A_Tree's column arrays and boxed only here
+     * Parents show their subtree roll-up as tooltip and, without an own value, the rolled-up sum
+     * @param column Column being read - 0 is the tree column, attribute columns follow
+     * @param role Data role being read
+     * @return Stored or attribute value
+     */
+    QVariant data(int column, int role) const override;
+
+private:
+    friend class A_Tree;
+
+    // Identity
+    quint32 NodeId;                           // Stable node identifier - index into A_Tree's node table, 0 if unregistered
+    const A_TreeItemContext *Context;         // State of the owning tree - nullptr while unregistered
+
+    // Sort State
+    int SortRank;                             // Position assigned by last sort - consumed by operator<
+    bool IsNaturalSortKey;                    // Key flavour flag - true if SortKey was built with numeric collation
+
+    // Change State
+    bool IsCheckStateChanged;                 // Set if the last setData call changed the check state - read by A_Tree's itemChanged handler
+    std::unique_ptr<QCollatorSortKey> SortKey;  // Cached collation key of text(0) - null until sorted, after text change or in compact mode
+};
+
+#endif // A_TREE_ITEM_H
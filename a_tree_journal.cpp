@@ -0,0 +1,646 @@
+#include "a_tree_journal.h"
+#include <QDir>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QtEndian>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <array>
+#include <climits>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+const quint32 SegmentMagic = 0x41544A4C;            // "ATJL" - journal segment header
+const quint32 SnapshotMagic = 0x4154534E;           // "ATSN" - snapshot header
+const quint16 FormatVersion = 1;                    // On-disk format version of segments
+const quint16 SnapshotVersion = 2;                  // On-disk format version of snapshots - 2 adds expand state
+const int CommitIntervalMs = 200;                   // Group commit delay - records within this window share one sync
+const int CommitBufferLimit = 1 << 20;              // Buffered bytes that force an early commit
+const qint64 CompactionThreshold = 64LL << 20;      // Segment size that requests a compaction
+const char SnapshotFileName[] = "snapshot.dat";     // Snapshot file inside the journal directory
+
+/**
+ * @brief Computes the CRC-32 (IEEE) checksum used to detect torn or corrupted records
+ * @param data Bytes to checksum
+ * @return Checksum value
+ */
+quint32 Crc32(const QByteArray &data)
+{
+    static const std::array<quint32, 256> _table = []() {
+        std::array<quint32, 256> _entries{};            // Lookup table - built once, thread-safe static init
+        for (quint32 _byte = 0; _byte < 256; ++_byte) {
+            quint32 _value = _byte;
+            for (int _bit = 0; _bit < 8; ++_bit) {
+                _value = (_value & 1) ? (0xEDB88320u ^ (_value >> 1)) : (_value >> 1);
+            }
+            _entries[_byte] = _value;
+        }
+        return _entries;
+    }();
+
+    quint32 _crc = 0xFFFFFFFFu;                         // Running checksum
+    for (char _char : data) {
+        _crc = _table[(_crc ^ quint8(_char)) & 0xFF] ^ (_crc >> 8);
+    }
+    return _crc ^ 0xFFFFFFFFu;
+}
+
+/**
+ * @brief Encodes a record as [length][crc][payload]
+ * @param record Record to encode
+ * @return Framed record bytes
+ */
+QByteArray EncodeRecord(const A_TreeJournal::Record &record)
+{
+    QByteArray _payload;                                // Record fields
+    QDataStream _stream(&_payload, QIODevice::WriteOnly);
+    _stream.setVersion(QDataStream::Qt_5_12);           // Fixed encoding across Qt versions
+
+    _stream << quint8(record.Type);
+    switch (record.Type) {
+    case A_TreeJournal::AddNode:
+        _stream << record.NodeId << record.ParentId << record.Index << record.Text << record.SyncKey;
+        break;
+    case A_TreeJournal::RemoveNode:
+        _stream << record.NodeId;
+        break;
+    case A_TreeJournal::SetText:
+        _stream << record.NodeId << record.Text;
+        break;
+    case A_TreeJournal::SetCheckState:
+        _stream << record.NodeId << record.CheckState;
+        break;
+    case A_TreeJournal::SetExpanded:
+        _stream << record.NodeId << quint8(record.IsExpanded);
+        break;
+    case A_TreeJournal::MoveNode:
+        _stream << record.NodeId << record.ParentId << record.Index;
+        break;
+    case A_TreeJournal::SetChildOrder:
+        _stream << record.ParentId << quint32(record.ChildOrder.size());
+        for (quint32 _childId : record.ChildOrder) {
+            _stream << _childId;
+        }
+        break;
+    case A_TreeJournal::SetSortOrder:
+        _stream << record.ParentId << record.SortMode << record.SortOrder << record.SortColumn;
+        break;
+    case A_TreeJournal::SetTreeSortOrder:
+        _stream << record.SortMode << record.SortOrder;
+        break;
+    case A_TreeJournal::ClearAll:
+    case A_TreeJournal::ClearSortOrder:
+        break;
+    }
+
+    QByteArray _frame;                                  // Length, checksum and payload
+    QDataStream _frameStream(&_frame, QIODevice::WriteOnly);
+    _frameStream.setVersion(QDataStream::Qt_5_12);
+    _frameStream << quint32(_payload.size()) << Crc32(_payload);
+    _frame.append(_payload);
+    return _frame;
+}
+
+/**
+ * @brief Decodes a record payload
+ * @param payload Payload bytes without frame header
+ * @param record Output decoded record
+ * @return True if the payload is a complete, known record
+ */
+bool DecodeRecord(const QByteArray &payload, A_TreeJournal::Record *record)
+{
+    QDataStream _stream(payload);                       // Reader over payload
+    _stream.setVersion(QDataStream::Qt_5_12);
+
+    quint8 _type = 0;                                   // Operation code
+    _stream >> _type;
+    record->Type = A_TreeJournal::Operation(_type);
+
+    switch (record->Type) {
+    case A_TreeJournal::AddNode:
+        _stream >> record->NodeId >> record->ParentId >> record->Index >> record->Text >> record->SyncKey;
+        break;
+    case A_TreeJournal::RemoveNode:
+        _stream >> record->NodeId;
+        break;
+    case A_TreeJournal::SetText:
+        _stream >> record->NodeId >> record->Text;
+        break;
+    case A_TreeJournal::SetCheckState:
+        _stream >> record->NodeId >> record->CheckState;
+        break;
+    case A_TreeJournal::SetExpanded: {
+        quint8 _isExpanded = 0;                         // Encoded flag
+        _stream >> record->NodeId >> _isExpanded;
+        record->IsExpanded = _isExpanded != 0;
+        break;
+    }
+    case A_TreeJournal::MoveNode:
+        _stream >> record->NodeId >> record->ParentId >> record->Index;
+        break;
+    case A_TreeJournal::SetChildOrder: {
+        quint32 _childCount = 0;                        // Number of identifiers that follow
+        _stream >> record->ParentId >> _childCount;
+        if (_childCount > quint32(payload.size() / 4)) {
+            return false;                               // Count cannot fit in payload
+        }
+        record->ChildOrder.resize(int(_childCount));
+        for (quint32 &_childId : record->ChildOrder) {
+            _stream >> _childId;
+        }
+        break;
+    }
+    case A_TreeJournal::SetSortOrder:
+        _stream >> record->ParentId >> record->SortMode >> record->SortOrder >> record->SortColumn;
+        break;
+    case A_TreeJournal::SetTreeSortOrder:
+        _stream >> record->SortMode >> record->SortOrder;
+        break;
+    case A_TreeJournal::ClearAll:
+    case A_TreeJournal::ClearSortOrder:
+        break;
+    default:
+        return false;                                   // Unknown operation
+    }
+
+    return _stream.status() == QDataStream::Ok;
+}
+
+/**
+ * @brief Parses the generation number out of a segment file name
+ * @param fileName File name like "journal-42.log"
+ * @param generation Output generation number
+ * @return True if the name is a segment name
+ */
+bool ParseSegmentName(const QString &fileName, quint64 *generation)
+{
+    if (!fileName.startsWith(QLatin1String("journal-")) || !fileName.endsWith(QLatin1String(".log"))) {
+        return false;
+    }
+
+    bool _isNumber = false;                             // Conversion result
+    *generation = fileName.mid(8, fileName.size() - 12).toULongLong(&_isNumber);
+    return _isNumber;
+}
+
+/**
+ * @brief Deletes journal segments older than a generation
+ * @param directoryPath Journal directory
+ * @param generation First generation to keep
+ */
+void RemoveSegmentsBefore(const QString &directoryPath, quint64 generation)
+{
+    QDir _directory(directoryPath);                     // Journal directory
+    const QStringList _names = _directory.entryList(QStringList() << "journal-*.log", QDir::Files);
+    for (const QString &_name : _names) {
+        quint64 _generation = 0;
+        if (ParseSegmentName(_name, &_generation) && _generation < generation) {
+            QFile::remove(_directory.filePath(_name));  // Covered by snapshot
+        }
+    }
+}
+}
+
+A_TreeJournal::A_TreeJournal(QObject *parent)
+    : QObject(parent)
+    , Generation(0)                 // Segment generation - starts at 0, set when a journal is opened
+    , CommitTimer(nullptr)          // Commit timer pointer - initialized to null, created below
+    , CompactionWatcher(nullptr)    // Compaction watcher pointer - initialized to null, created below
+    , CompactedGeneration(0)        // Compaction target - starts at 0, set when a compaction starts
+    , IsCompacting(false)           // Compaction flag - starts false, no snapshot being written
+{
+    CommitTimer = new QTimer(this);                       // Group commit timer
+    CommitTimer->setSingleShot(true);
+    CommitTimer->setInterval(CommitIntervalMs);
+    connect(CommitTimer, &QTimer::timeout, this, &A_TreeJournal::Flush);
+
+    CompactionWatcher = new QFutureWatcher<bool>(this);   // Background snapshot writer watcher
+    connect(CompactionWatcher, &QFutureWatcher<bool>::finished, this, &A_TreeJournal::OnCompactionFinished);
+}
+
+A_TreeJournal::~A_TreeJournal()
+{
+    Close();                                              // Commit pending records before going away
+}
+
+bool A_TreeJournal::Open(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+                         quint32 *nextNodeId, QVector<Record> *records)
+{
+    /**
+     * Opens a journal directory for recovery and appending
+     * Reads the last snapshot, collects records of every later segment and
+     * resumes appending at the intact end of the newest segment
+     * @return True if the journal is open
+     */
+
+    Close();                                              // Finish any previous journal
+
+    QDir _directory(directoryPath);                       // Journal directory
+    if (!_directory.mkpath(".")) {
+        return false;                                     // Directory cannot be created
+    }
+
+    quint64 _firstGeneration = 1;                         // Generation the snapshot was taken at
+    quint64 _lastGeneration = 1;                          // Segment to append to
+    qint64 _lastValidLength = -1;                         // Intact length of that segment, -1 if new
+    ReadDirectory(_directory.absolutePath(), snapshotNodes, nextNodeId, records,
+                  &_firstGeneration, &_lastGeneration, &_lastValidLength);
+
+    // Segments older than the snapshot are leftovers of an interrupted compaction
+    RemoveSegmentsBefore(_directory.absolutePath(), _firstGeneration);
+
+    DirectoryPath = _directory.absolutePath();
+    if (!OpenSegment(_lastGeneration, _lastValidLength)) {
+        DirectoryPath.clear();
+        return false;                                     // Segment cannot be written
+    }
+
+    return true;
+}
+
+bool A_TreeJournal::Load(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+                         quint32 *nextNodeId, QVector<Record> *records)
+{
+    /**
+     * Reads a journal directory without modifying it
+     * Safe to use on the journal of a running application
+     * @return True if the directory exists
+     */
+
+    QDir _directory(directoryPath);                       // Journal directory
+    if (!_directory.exists()) {
+        return false;
+    }
+
+    quint64 _firstGeneration = 1;                         // Unused - needed by reader only
+    quint64 _lastGeneration = 1;
+    qint64 _lastValidLength = -1;
+    ReadDirectory(_directory.absolutePath(), snapshotNodes, nextNodeId, records,
+                  &_firstGeneration, &_lastGeneration, &_lastValidLength);
+    return true;
+}
+
+void A_TreeJournal::ReadDirectory(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+                                  quint32 *nextNodeId, QVector<Record> *records, quint64 *firstGeneration,
+                                  quint64 *lastGeneration, qint64 *lastValidLength)
+{
+    /**
+     * Reads the snapshot and the records of every segment it does not cover
+     * Segments older than the snapshot are skipped
+     */
+
+    QDir _directory(directoryPath);                       // Journal directory
+    snapshotNodes->clear();
+    records->clear();
+    *nextNodeId = 1;                                      // First identifier of an empty tree
+
+    *firstGeneration = 1;                                 // First segment to replay
+    if (!ReadSnapshot(_directory.filePath(SnapshotFileName), firstGeneration, nextNodeId, snapshotNodes)) {
+        snapshotNodes->clear();                           // No usable snapshot - replay from empty tree
+        *nextNodeId = 1;
+        *firstGeneration = 1;
+    }
+
+    QList<quint64> _generations;                          // Segments to replay in order
+    const QStringList _names = _directory.entryList(QStringList() << "journal-*.log", QDir::Files);
+    for (const QString &_name : _names) {
+        quint64 _generation = 0;
+        if (ParseSegmentName(_name, &_generation) && _generation >= *firstGeneration) {
+            _generations.append(_generation);
+        }
+    }
+    std::sort(_generations.begin(), _generations.end());
+
+    *lastGeneration = *firstGeneration;
+    *lastValidLength = -1;
+    for (quint64 _generation : _generations) {
+        qint64 _validLength = ReadSegment(SegmentPath(directoryPath, _generation), records);
+        *lastGeneration = _generation;
+        *lastValidLength = _validLength > 0 ? _validLength : -1;  // Broken header - start segment over
+    }
+}
+
+void A_TreeJournal::Close()
+{
+    /**
+     * Commits pending records, waits for compaction and closes the segment
+     */
+
+    if (!IsOpen()) {
+        return;                                           // Nothing open
+    }
+
+    Flush();                                              // Commit pending records
+    CompactionWatcher->waitForFinished();                 // Snapshot writer must not outlive the journal
+    SegmentFile.close();
+    DirectoryPath.clear();
+}
+
+bool A_TreeJournal::IsOpen() const
+{
+    /**
+     * Gets whether the journal accepts records
+     * @return True if open
+     */
+
+    return !DirectoryPath.isEmpty() && SegmentFile.isOpen();
+}
+
+QString A_TreeJournal::GetDirectoryPath() const
+{
+    /**
+     * Gets the directory passed to Open
+     * @return Directory path
+     */
+
+    return DirectoryPath;
+}
+
+void A_TreeJournal::Append(const Record &record)
+{
+    /**
+     * Buffers a record for the next group commit
+     * A full buffer is committed immediately
+     * @param record Record to append
+     */
+
+    if (!IsOpen()) {
+        return;                                           // Journal closed - record dropped
+    }
+
+    PendingBuffer.append(EncodeRecord(record));           // Encode into commit buffer
+
+    if (PendingBuffer.size() >= CommitBufferLimit) {
+        Flush();                                          // Large batch - commit now
+    } else if (!CommitTimer->isActive()) {
+        CommitTimer->start();                             // First record of a new group
+    }
+}
+
+void A_TreeJournal::Flush()
+{
+    /**
+     * Writes the commit buffer with a single write and a single sync
+     * Requests compaction when the segment grew beyond the threshold
+     */
+
+    CommitTimer->stop();
+    if (!IsOpen() || PendingBuffer.isEmpty()) {
+        return;                                           // Nothing to commit
+    }
+
+    SegmentFile.write(PendingBuffer);                     // One write for the whole group
+    SegmentFile.flush();                                  // Hand data to the operating system
+    SyncFile(SegmentFile);                                // One sync for the whole group
+    PendingBuffer.clear();
+
+    if (SegmentFile.size() > CompactionThreshold && !IsCompacting) {
+        emit CompactionRequested();                       // Owner provides a snapshot
+    }
+}
+
+void A_TreeJournal::Compact(const QVector<SnapshotNode> &nodes, quint32 nextNodeId)
+{
+    /**
+     * Rotates to a new segment and writes the snapshot on a worker thread
+     * Records appended meanwhile go to the new segment, which the snapshot does not cover
+     * @param nodes Snapshot nodes in pre-order
+     * @param nextNodeId First unused node identifier
+     */
+
+    if (!IsOpen() || IsCompacting) {
+        return;                                           // Closed or compaction already running
+    }
+
+    Flush();                                              // Old segment is complete on disk
+
+    const quint64 _oldGeneration = Generation;            // Segment the snapshot replaces
+    const qint64 _oldLength = SegmentFile.size();         // Committed length of that segment
+    const quint64 _newGeneration = Generation + 1;        // Segment replayed on top of the snapshot
+    if (!OpenSegment(_newGeneration, -1)) {
+        QFile::remove(SegmentPath(DirectoryPath, _newGeneration));
+        OpenSegment(_oldGeneration, _oldLength);          // Keep appending to old segment
+        emit CompactionFinished(false);
+        return;
+    }
+
+    IsCompacting = true;
+    CompactedGeneration = _newGeneration;
+
+    const QString _directoryPath = DirectoryPath;         // Copied for worker thread
+    const QString _snapshotPath = QDir(DirectoryPath).filePath(SnapshotFileName);
+    CompactionWatcher->setFuture(QtConcurrent::run([_directoryPath, _snapshotPath, _newGeneration, nextNodeId, nodes]() {
+        if (!WriteSnapshot(_snapshotPath, _newGeneration, nextNodeId, nodes)) {
+            return false;                                 // Old segments still needed
+        }
+        RemoveSegmentsBefore(_directoryPath, _newGeneration);  // Snapshot is durable - drop covered segments
+        return true;
+    }));
+}
+
+void A_TreeJournal::OnCompactionFinished()
+{
+    /**
+     * Handles completion of the background snapshot write
+     */
+
+    IsCompacting = false;                                 // Ready for next compaction
+    emit CompactionFinished(CompactionWatcher->result());
+}
+
+QString A_TreeJournal::SegmentPath(const QString &directoryPath, quint64 generation)
+{
+    /**
+     * Builds the path of a journal segment
+     * @return Path like "<dir>/journal-42.log"
+     */
+
+    return QDir(directoryPath).filePath(QString("journal-%1.log").arg(generation));
+}
+
+bool A_TreeJournal::ReadSnapshot(const QString &path, quint64 *generation, quint32 *nextNodeId,
+                                 QVector<SnapshotNode> *nodes)
+{
+    /**
+     * Reads a snapshot and verifies its trailing checksum
+     * @return True if the snapshot is complete and valid
+     */
+
+    QFile _file(path);                                    // Snapshot file
+    if (!_file.open(QIODevice::ReadOnly) || _file.size() < 4 || _file.size() > INT_MAX) {
+        return false;                                     // No snapshot yet, or too small or too large to be one
+    }
+
+    // Map instead of reading - checksum and decoding work on the page cache without copying the file
+    QByteArray _content;                                  // Body followed by 4-byte checksum
+    const uchar *_mapped = _file.map(0, _file.size());    // Unmapped when _file is destroyed
+    if (_mapped) {
+        _content = QByteArray::fromRawData(reinterpret_cast<const char*>(_mapped), int(_file.size()));
+    } else {
+        _content = _file.readAll();                       // File system without mapping support
+    }
+
+    const QByteArray _body = QByteArray::fromRawData(_content.constData(), _content.size() - 4);  // Checksummed part
+    const quint32 _storedChecksum = qFromBigEndian<quint32>(_content.constData() + _body.size());  // Written by QDataStream
+    if (_storedChecksum != Crc32(_body)) {
+        return false;                                     // Incomplete or corrupted snapshot
+    }
+
+    QDataStream _stream(_body);                           // Reader over body
+    _stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 _magic = 0;
+    quint16 _version = 0;
+    quint32 _nodeCount = 0;
+    _stream >> _magic >> _version >> *generation >> *nextNodeId >> _nodeCount;
+    if (_magic != SnapshotMagic || _version < 1 || _version > SnapshotVersion) {
+        return false;                                     // Not a snapshot of this format
+    }
+
+    nodes->clear();
+    nodes->reserve(int(_nodeCount));
+    for (quint32 _nodeIndex = 0; _nodeIndex < _nodeCount && _stream.status() == QDataStream::Ok; ++_nodeIndex) {
+        SnapshotNode _node;                               // Next node in pre-order
+        _stream >> _node.NodeId >> _node.ParentId >> _node.CheckState >> _node.Text >> _node.SyncKey;
+        if (_version >= 2) {
+            quint8 _isExpanded = 0;                       // Expand state - absent in version 1
+            _stream >> _isExpanded;
+            _node.IsExpanded = _isExpanded != 0;
+        }
+        nodes->append(_node);
+    }
+
+    return _stream.status() == QDataStream::Ok;
+}
+
+bool A_TreeJournal::WriteSnapshot(const QString &path, quint64 generation, quint32 nextNodeId,
+                                  const QVector<SnapshotNode> &nodes)
+{
+    /**
+     * Writes a snapshot through a temporary file that replaces the old snapshot only once synced
+     * @return True if the new snapshot is in place
+     */
+
+    QByteArray _body;                                     // Header and nodes
+    QDataStream _stream(&_body, QIODevice::WriteOnly);
+    _stream.setVersion(QDataStream::Qt_5_12);
+    _stream << SnapshotMagic << SnapshotVersion << generation << nextNodeId << quint32(nodes.size());
+    for (const SnapshotNode &_node : nodes) {
+        _stream << _node.NodeId << _node.ParentId << _node.CheckState << _node.Text << _node.SyncKey << quint8(_node.IsExpanded);
+    }
+
+    QByteArray _checksum;                                 // Trailing checksum of body
+    QDataStream _checksumStream(&_checksum, QIODevice::WriteOnly);
+    _checksumStream.setVersion(QDataStream::Qt_5_12);
+    _checksumStream << Crc32(_body);
+
+    QSaveFile _file(path);                                // Atomic replacement of the snapshot
+    if (!_file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    _file.write(_body);
+    _file.write(_checksum);
+    _file.flush();
+    if (!SyncFile(_file)) {
+        _file.cancelWriting();
+        return false;                                     // Data not durable - keep old snapshot
+    }
+
+    return _file.commit();                                // Rename over old snapshot
+}
+
+qint64 A_TreeJournal::ReadSegment(const QString &path, QVector<Record> *records)
+{
+    /**
+     * Reads records of a segment until the first torn or corrupted frame
+     * @return Byte length of the intact part, 0 if the header is invalid
+     */
+
+    QFile _file(path);                                    // Segment file
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+
+    const QByteArray _content = _file.readAll();          // Whole segment - bounded by compaction threshold
+    QDataStream _stream(_content);                        // Reader over header and frame headers
+    _stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 _magic = 0;
+    quint16 _version = 0;
+    quint64 _generation = 0;
+    _stream >> _magic >> _version >> _generation;
+    if (_stream.status() != QDataStream::Ok || _magic != SegmentMagic || _version != FormatVersion) {
+        return 0;                                         // Not a segment of this format
+    }
+
+    qint64 _validLength = _stream.device()->pos();        // End of last intact frame
+    while (_content.size() - _validLength >= 8) {
+        quint32 _payloadLength = 0;
+        quint32 _checksum = 0;
+        _stream >> _payloadLength >> _checksum;
+        if (qint64(_payloadLength) > _content.size() - _validLength - 8) {
+            break;                                        // Frame cut off by a crash
+        }
+
+        QByteArray _payload = _content.mid(int(_validLength + 8), int(_payloadLength));
+        Record _record;                                   // Decoded record
+        if (Crc32(_payload) != _checksum || !DecodeRecord(_payload, &_record)) {
+            break;                                        // Torn or corrupted frame
+        }
+
+        records->append(_record);
+        _validLength += 8 + _payloadLength;
+        _stream.skipRawData(int(_payloadLength));         // Move reader to next frame
+    }
+
+    return _validLength;
+}
+
+bool A_TreeJournal::OpenSegment(quint64 generation, qint64 validLength)
+{
+    /**
+     * Opens a segment for appending
+     * @param generation Segment generation
+     * @param validLength Intact length of existing segment, -1 to start a new segment
+     * @return True if open
+     */
+
+    SegmentFile.close();
+    SegmentFile.setFileName(SegmentPath(DirectoryPath, generation));
+    if (!SegmentFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    if (validLength < 0) {
+        SegmentFile.resize(0);                            // Fresh segment
+        QDataStream _stream(&SegmentFile);                // Header writer
+        _stream.setVersion(QDataStream::Qt_5_12);
+        _stream << SegmentMagic << FormatVersion << quint64(generation);
+        SegmentFile.flush();
+        SyncFile(SegmentFile);
+    } else if (SegmentFile.size() != validLength) {
+        SegmentFile.resize(validLength);                  // Cut off torn tail before appending
+    }
+
+    Generation = generation;
+    return true;
+}
+
+bool A_TreeJournal::SyncFile(QFileDevice &file)
+{
+    /**
+     * Forces written data to stable storage
+     * @return True on success
+     */
+
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
@@ -0,0 +1,235 @@
+#ifndef A_TREE_JOURNAL_H
+#define A_TREE_JOURNAL_H
+
+#include <QObject>
+#include <QFile>
+#include <QTimer>
+#include <QVector>
+#include <QFutureWatcher>
+
+class A_TreeJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Kind of mutation stored in a journal record
+     */
+    enum Operation : quint8 {
+        AddNode = 1,                 // Node created under a parent at a child index
+        RemoveNode = 2,              // Node deleted with its subtree
+        SetText = 3,                 // Node text changed
+        SetCheckState = 4,           // Check state set by the user or API - replay propagates it
+        MoveNode = 5,                // Node moved under a new parent at a child index
+        SetChildOrder = 6,           // Children of a parent reordered
+        ClearAll = 7,                // Every node removed
+        SetExpanded = 8,             // Node expanded or collapsed
+        SetSortOrder = 9,            // Children of a parent kept sorted from now on
+        SetTreeSortOrder = 10,       // Every sibling list kept sorted from now on - per-parent orders dropped
+        ClearSortOrder = 11          // No sibling list kept sorted any more
+    };
+
+    /**
+     * @brief One decoded journal record
+     */
+    struct Record
+    {
+        Operation Type = AddNode;    // Mutation kind
+        quint32 NodeId = 0;          // Affected node - unused for SetChildOrder and ClearAll
+        quint32 ParentId = 0;        // Parent node for AddNode, MoveNode and SetChildOrder - 0 for root level
+        qint32 Index = -1;           // Child index for AddNode and MoveNode
+        quint8 CheckState = 0;       // Qt::CheckState for SetCheckState
+        bool IsExpanded = false;     // Expand state for SetExpanded
+        quint8 SortMode = 0;         // A_Tree::SortMode for SetSortOrder and SetTreeSortOrder
+        quint8 SortOrder = 0;        // Qt::SortOrder for SetSortOrder and SetTreeSortOrder
+        qint32 SortColumn = -1;      // Attribute column for SetSortOrder by attribute
+        QString Text;                // Text for AddNode and SetText
+        QString SyncKey;             // Sync identity for AddNode - empty if none
+        QVector<quint32> ChildOrder; // Child identifiers in new order for SetChildOrder
+    };
+
+    /**
+     * @brief One node of a snapshot, listed in pre-order
+     */
+    struct SnapshotNode
+    {
+        quint32 NodeId = 0;          // Node identifier
+        quint32 ParentId = 0;        // Parent identifier - 0 for root level
+        quint8 CheckState = 0;       // Qt::CheckState of the node
+        QString Text;                // Display text
+        QString SyncKey;             // Sync identity - empty if none
+        bool IsExpanded = false;     // Expand state of the node
+    };
+
+    /**
+     * @brief Constructor for A_TreeJournal
+     * @param parent Parent object pointer - can be nullptr
+     */
+    explicit A_TreeJournal(QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor for A_TreeJournal - flushes pending records and waits for compaction
+     */
+    ~A_TreeJournal();
+
+    /**
+     * @brief Opens a journal directory and reads its last snapshot and all later records
+     * A torn record at the end of the last segment is cut off before appending resumes
+     * @param directoryPath Directory holding snapshot and journal segments - created if missing
+     * @param snapshotNodes Output snapshot nodes in pre-order - empty if no snapshot exists
+     * @param nextNodeId Output first unused node identifier recorded with the snapshot - 1 if none
+     * @param records Output records to replay on top of the snapshot, in order
+     * @return True if the journal is open for appending
+     */
+    bool Open(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+              quint32 *nextNodeId, QVector<Record> *records);
+
+    /**
+     * @brief Reads a journal directory without opening it for appending or modifying any file
+     * @param directoryPath Directory holding snapshot and journal segments
+     * @param snapshotNodes Output snapshot nodes in pre-order - empty if no snapshot exists
+     * @param nextNodeId Output first unused node identifier recorded with the snapshot - 1 if none
+     * @param records Output records to replay on top of the snapshot, in order
+     * @return True if the directory exists
+     */
+    static bool Load(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+                     quint32 *nextNodeId, QVector<Record> *records);
+
+    /**
+     * @brief Flushes pending records and closes the journal
+     */
+    void Close();
+
+    /**
+     * @brief Gets whether the journal is open for appending
+     * @return True if open
+     */
+    bool IsOpen() const;
+
+    /**
+     * @brief Gets the directory of the open journal
+     * @return Directory path - empty while closed
+     */
+    QString GetDirectoryPath() const;
+
+    /**
+     * @brief Appends a record to the commit buffer - written by the next group commit
+     * @param record Record to append
+     */
+    void Append(const Record &record);
+
+    /**
+     * @brief Writes and syncs all buffered records to disk now
+     */
+    void Flush();
+
+    /**
+     * @brief Starts a new journal segment and writes the snapshot on a worker thread
+     * Older segments are deleted once the snapshot is durable
+     * @param nodes Snapshot nodes in pre-order - state after every record appended so far
+     * @param nextNodeId First unused node identifier
+     */
+    void Compact(const QVector<SnapshotNode> &nodes, quint32 nextNodeId);
+
+signals:
+    /**
+     * @brief Signal emitted after a commit when the journal grew beyond the compaction threshold
+     */
+    void CompactionRequested();
+
+    /**
+     * @brief Signal emitted when a background compaction finished
+     * @param success True if the snapshot was written and old segments removed
+     */
+    void CompactionFinished(bool success);
+
+private slots:
+    /**
+     * @brief Handles completion of the background snapshot write
+     */
+    void OnCompactionFinished();
+
+private:
+    /**
+     * @brief Builds the file path of a journal segment
+     * @param directoryPath Journal directory
+     * @param generation Segment generation number
+     * @return Absolute segment path
+     */
+    static QString SegmentPath(const QString &directoryPath, quint64 generation);
+
+    /**
+     * @brief Reads the snapshot and all later segments of a journal directory
+     * @param directoryPath Journal directory
+     * @param snapshotNodes Output snapshot nodes
+     * @param nextNodeId Output first unused node identifier
+     * @param records Output records after the snapshot
+     * @param firstGeneration Output generation covered by the snapshot
+     * @param lastGeneration Output generation of the newest segment
+     * @param lastValidLength Output intact length of the newest segment - -1 if it must be started over
+     */
+    static void ReadDirectory(const QString &directoryPath, QVector<SnapshotNode> *snapshotNodes,
+                              quint32 *nextNodeId, QVector<Record> *records, quint64 *firstGeneration,
+                              quint64 *lastGeneration, qint64 *lastValidLength);
+
+    /**
+     * @brief Reads and validates a snapshot file
+     * @param path Snapshot file path
+     * @param generation Output first segment generation to replay on top of the snapshot
+     * @param nextNodeId Output first unused node identifier
+     * @param nodes Output snapshot nodes
+     * @return True if a valid snapshot was read
+     */
+    static bool ReadSnapshot(const QString &path, quint64 *generation, quint32 *nextNodeId,
+                             QVector<SnapshotNode> *nodes);
+
+    /**
+     * @brief Writes a snapshot atomically (temporary file, sync, rename)
+     * @param path Snapshot file path
+     * @param generation First segment generation to replay on top of the snapshot
+     * @param nextNodeId First unused node identifier
+     * @param nodes Snapshot nodes in pre-order
+     * @return True if the snapshot is durable
+     */
+    static bool WriteSnapshot(const QString &path, quint64 generation, quint32 nextNodeId,
+                              const QVector<SnapshotNode> &nodes);
+
+    /**
+     * @brief Reads all intact records of a segment
+     * @param path Segment file path
+     * @param records Output records appended in order
+     * @return Byte length of the intact part of the segment - 0 if the header is invalid
+     */
+    static qint64 ReadSegment(const QString &path, QVector<Record> *records);
+
+    /**
+     * @brief Opens a segment for appending, writing its header if the segment is new
+     * @param generation Segment generation number
+     * @param validLength Intact length of an existing segment - file is truncated to it, -1 for a new segment
+     * @return True if the segment is open
+     */
+    bool OpenSegment(quint64 generation, qint64 validLength);
+
+    /**
+     * @brief Forces written data of a file to stable storage
+     * @param file Open file to sync
+     * @return True if the sync succeeded
+     */
+    static bool SyncFile(QFileDevice &file);
+
+    // File State
+    QString DirectoryPath;                   // Journal directory - empty while closed
+    QFile SegmentFile;                       // Current journal segment - records are appended here
+    quint64 Generation;                      // Generation of the current segment - increments on compaction
+
+    // Group Commit State
+    QByteArray PendingBuffer;                // Encoded records not yet written - committed together
+    QTimer *CommitTimer;                     // Group commit timer - started by the first record after a commit
+
+    // Compaction State
+    QFutureWatcher<bool> *CompactionWatcher; // Watcher for background snapshot writes
+    quint64 CompactedGeneration;             // Segments below this generation are deleted after compaction
+    bool IsCompacting;                       // Compaction flag - true while a snapshot is being written
+};
+
+#endif // A_TREE_JOURNAL_H
@@ -0,0 +1,1270 @@
+#ifndef A_TREE_NODE_STORE_H
+#define A_TREE_NODE_STORE_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <utility>
+
+/**
+ * @brief Feature policies for A_TreeNodeStore
+ * Each policy brings its own per-node storage; a disabled feature has empty storage,
+ * so it adds no bytes to a node and its branches are removed at compile time
+ */
+namespace A_TreeNodePolicy {
+
+/**
+ * @brief No check boxes
+ */
+struct NoCheck
+{
+    static constexpr bool IsCheckable = false;
+    static constexpr bool IsTriState = false;
+
+    struct Storage
+    {
+        void Reserve(int) {}
+        void Clear() {}
+        void Append() {}
+        Qt::CheckState Get(int) const { return Qt::Unchecked; }
+        void Set(int, Qt::CheckState) {}
+        qint64 GetBytes() const { return 0; }
+    };
+};
+
+/**
+ * @brief Checked or unchecked - one bit per node, parents are checked when all children are
+ */
+struct BinaryCheck
+{
+    static constexpr bool IsCheckable = true;
+    static constexpr bool IsTriState = false;
+
+    struct Storage
+    {
+        QBitArray Bits;              // Checked flag by position - grown geometrically
+        int Count = 0;               // Positions in use
+
+        void Reserve(int nodeCount) { if (Bits.size() < nodeCount) Bits.resize(nodeCount); }
+        void Clear() { Bits.clear(); Count = 0; }
+        void Append() { if (Count == Bits.size()) Bits.resize(qMax(64, 2 * Bits.size())); Bits.clearBit(Count++); }
+        Qt::CheckState Get(int position) const { return Bits.testBit(position) ? Qt::Checked : Qt::Unchecked; }
+        void Set(int position, Qt::CheckState state) { Bits.setBit(position, state == Qt::Checked); }
+        qint64 GetBytes() const { return (Bits.size() + 7) / 8; }
+    };
+};
+
+/**
+ * @brief Checked, partially checked or unchecked - one byte per node, like A_Tree
+ */
+struct TriStateCheck
+{
+    static constexpr bool IsCheckable = true;
+    static constexpr bool IsTriState = true;
+
+    struct Storage
+    {
+        QVector<quint8> States;      // Qt::CheckState by position
+
+        void Reserve(int nodeCount) { States.reserve(nodeCount); }
+        void Clear() { States.clear(); }
+        void Append() { States.append(quint8(Qt::Unchecked)); }
+        Qt::CheckState Get(int position) const { return Qt::CheckState(States.at(position)); }
+        void Set(int position, Qt::CheckState state) { States[position] = quint8(state); }
+        qint64 GetBytes() const { return States.capacity() * qint64(sizeof(quint8)); }
+    };
+};
+
+/**
+ * @brief Texts fixed at insertion - packed into one string pool without per-node allocations
+ */
+struct ReadOnlyText
+{
+    static constexpr bool IsEditable = false;
+
+    struct Storage
+    {
+        QString Pool;                // All texts back to back
+        QVector<quint32> Ends;       // End offset in Pool by position
+
+        void Reserve(int nodeCount) { Ends.reserve(nodeCount); }
+        void Clear() { Pool.clear(); Ends.clear(); }
+        void Append(const QString &text) { Pool += text; Ends.append(quint32(Pool.size())); }
+        void Release(int) {}
+        QString Get(int position) const
+        {
+            const quint32 _begin = position > 0 ? Ends.at(position - 1) : 0;  // Start offset of this text
+            return Pool.mid(int(_begin), int(Ends.at(position) - _begin));
+        }
+        qint64 GetBytes() const { return Pool.capacity() * qint64(sizeof(QChar)) + Ends.capacity() * qint64(sizeof(quint32)); }
+        qint64 GetTextBytes() const { return Pool.capacity() * qint64(sizeof(QChar)); }
+    };
+};
+
+/**
+ * @brief Texts that can change - one string per node
+ */
+struct EditableText
+{
+    static constexpr bool IsEditable = true;
+
+    struct Storage
+    {
+        QVector<QString> Texts;      // Text by position
+        qint64 TextBytes = 0;        // Heap bytes of all texts - header and characters
+
+        void Reserve(int nodeCount) { Texts.reserve(nodeCount); }
+        void Clear() { Texts.clear(); TextBytes = 0; }
+        void Append(const QString &text) { Texts.append(text); TextBytes += HeapBytes(text); }
+        QString Get(int position) const { return Texts.at(position); }
+        void Release(int position) { Set(position, QString()); }
+        void Set(int position, const QString &text)
+        {
+            TextBytes += HeapBytes(text) - HeapBytes(Texts.at(position));
+            Texts[position] = text;
+        }
+        qint64 GetBytes() const { return Texts.capacity() * qint64(sizeof(QString)) + TextBytes; }
+        qint64 GetTextBytes() const { return TextBytes; }
+        static qint64 HeapBytes(const QString &text) { return text.isEmpty() ? 0 : 16 + text.size() * qint64(sizeof(QChar)); }
+    };
+};
+
+/**
+ * @brief Numeric attribute columns - one contiguous double array per column
+ * @tparam ColumnCount Number of columns - 0 removes attributes entirely
+ */
+template <int ColumnCount>
+struct DoubleAttributes
+{
+    static constexpr int Columns = ColumnCount;
+
+    struct Storage
+    {
+        std::array<QVector<double>, ColumnCount> Values;  // Value by position per column
+
+        void Reserve(int nodeCount) { for (QVector<double> &_column : Values) _column.reserve(nodeCount); }
+        void Clear() { for (QVector<double> &_column : Values) _column.clear(); }
+        void Append() { for (QVector<double> &_column : Values) _column.append(0.0); }
+        qint64 GetBytes() const
+        {
+            qint64 _bytes = 0;                            // Sum over columns
+            for (const QVector<double> &_column : Values) {
+                _bytes += _column.capacity() * qint64(sizeof(double));
+            }
+            return _bytes;
+        }
+    };
+};
+
+using NoAttributes = DoubleAttributes<0>;
+
+/**
+ * @brief Identifier is position + 1 - no storage, but identifiers of a rebuilt store change
+ */
+struct NoIdIndex
+{
+    static constexpr bool HasIdIndex = false;
+
+    struct Storage
+    {
+        int Count = 0;               // Positions in use
+
+        void Reserve(int) {}
+        void Clear() { Count = 0; }
+        bool Append(quint32) { Count++; return true; }
+        void Remove(int) {}
+        quint32 GetId(int position) const { return quint32(position) + 1; }
+        quint32 GetNextId() const { return quint32(Count) + 1; }
+        int Find(quint32 id) const { return id > 0 && id <= quint32(Count) ? int(id) - 1 : -1; }
+        qint64 GetBytes() const { return 0; }
+    };
+};
+
+/**
+ * @brief Stable caller-chosen identifiers with a hash index, like A_Tree's node identifiers after replay
+ */
+struct IdIndex
+{
+    static constexpr bool HasIdIndex = true;
+
+    struct Storage
+    {
+        QVector<quint32> Ids;        // Identifier by position
+        QHash<quint32, int> Positions;  // Position by identifier
+        quint32 NextId = 1;          // Next identifier handed out for 0
+
+        void Reserve(int nodeCount) { Ids.reserve(nodeCount); Positions.reserve(nodeCount); }
+        void Clear() { Ids.clear(); Positions.clear(); NextId = 1; }
+        bool Append(quint32 id)
+        {
+            if (id == 0) {
+                id = NextId;
+            }
+            if (Positions.contains(id)) {
+                return false;
+            }
+            Positions.insert(id, Ids.size());
+            Ids.append(id);
+            NextId = qMax(NextId, id + 1);
+            return true;
+        }
+        void Remove(int position) { Positions.remove(Ids.at(position)); }
+        quint32 GetId(int position) const { return Ids.at(position); }
+        quint32 GetNextId() const { return NextId; }
+        int Find(quint32 id) const { return Positions.value(id, -1); }
+        qint64 GetBytes() const { return Ids.capacity() * qint64(sizeof(quint32)) + Positions.capacity() * qint64(sizeof(void*) + 16); }
+    };
+};
+
+} // namespace A_TreeNodePolicy
+
+/**
+ * @brief Tree of nodes in flat arrays, specialized at compile time on the features it supports
+ * Nodes are addressed by position; links are parent, first child, last child and next sibling.
+ * Removed positions are not reused until Clear, so positions stay valid handles for live nodes.
+ * Calling a member of a disabled feature (SetText on read-only texts, SetCheckState without
+ * check boxes, attributes without columns) does not compile.
+ * @tparam CheckPolicy NoCheck, BinaryCheck or TriStateCheck
+ * @tparam TextPolicy ReadOnlyText or EditableText
+ * @tparam AttributePolicy NoAttributes or DoubleAttributes<N>
+ * @tparam IdPolicy NoIdIndex or IdIndex
+ */
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+class A_TreeNodeStore
+{
+public:
+    /**
+     * @brief Position meaning "no node" - parent of root items, end of sibling lists
+     */
+    static constexpr int NoNode = -1;
+
+    /**
+     * @brief Constructor for an empty store
+     */
+    A_TreeNodeStore() = default;
+
+    /**
+     * @brief Reserves room for nodes to avoid regrowing while building
+     * @param nodeCount Expected node count
+     */
+    void Reserve(int nodeCount);
+
+    /**
+     * @brief Removes all nodes
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the number of live nodes
+     * @return Node count
+     */
+    int GetNodeCount() const;
+
+    /**
+     * @brief Gets whether a position holds a live node
+     * @param position Node position
+     * @return False for removed and out of range positions
+     */
+    bool IsAlive(int position) const;
+
+    /**
+     * @brief Appends a node as last child of a parent
+     * @param parent Parent position - NoNode for root level
+     * @param text Node text
+     * @param id Identifier to assign with IdIndex - 0 for the next free one; ignored without index
+     * @return Position of the new node - NoNode if the parent is invalid or the identifier is in use
+     */
+    int AddNode(int parent, const QString &text, quint32 id = 0);
+
+    /**
+     * @brief Inserts a node at a child index of a parent
+     * @param parent Parent position - NoNode for root level
+     * @param text Node text
+     * @param index Child index - -1 or past the end appends
+     * @param id Identifier to assign with IdIndex - 0 for the next free one; ignored without index
+     * @return Position of the new node - NoNode if the parent is invalid or the identifier is in use
+     */
+    int InsertNode(int parent, const QString &text, int index, quint32 id = 0);
+
+    /**
+     * @brief Removes a node with its subtree - the parent's check state is recalculated
+     * @param position Node position
+     * @return Number of nodes removed
+     */
+    int RemoveSubtree(int position);
+
+    /**
+     * @brief Moves a node with its subtree under a new parent
+     * @param position Node position
+     * @param parent New parent position - NoNode for root level
+     * @param index Child index - -1 appends
+     * @return True if moved - false if invalid or the parent is inside the subtree
+     */
+    bool MoveNode(int position, int parent, int index = -1);
+
+    /**
+     * @brief Reorders the children of a node
+     * @param parent Parent position - NoNode for root items
+     * @param order Child positions in new order - unlisted children follow in their current order
+     */
+    void SetChildOrder(int parent, const QVector<int> &order);
+
+    /**
+     * @brief Gets the parent of a node
+     * @param position Node position
+     * @return Parent position - NoNode for root items
+     */
+    int GetParent(int position) const;
+
+    /**
+     * @brief Gets the first child of a node
+     * @param position Node position - NoNode for the first root item
+     * @return Child position - NoNode for leaves
+     */
+    int GetFirstChild(int position) const;
+
+    /**
+     * @brief Gets the next sibling of a node
+     * @param position Node position
+     * @return Sibling position - NoNode for the last child
+     */
+    int GetNextSibling(int position) const;
+
+    /**
+     * @brief Gets the text of a node
+     * @param position Node position
+     * @return Node text
+     */
+    QString GetText(int position) const;
+
+    /**
+     * @brief Changes the text of a node - EditableText only
+     * @param position Node position
+     * @param text New text
+     */
+    void SetText(int position, const QString &text);
+
+    /**
+     * @brief Gets the check state of a node
+     * @param position Node position
+     * @return Check state - always Unchecked with NoCheck
+     */
+    Qt::CheckState GetCheckState(int position) const;
+
+    /**
+     * @brief Sets a check state with A_Tree's propagation - BinaryCheck and TriStateCheck only
+     * The subtree receives checked and unchecked states, ancestors are recalculated up to the first unchanged one
+     * @param position Node position
+     * @param state New check state
+     */
+    void SetCheckState(int position, Qt::CheckState state);
+
+    /**
+     * @brief Sets many check states with one recalculation of all parents - BinaryCheck and TriStateCheck only
+     * @param states Positions and states, applied in order to the node and its subtree
+     */
+    void SetCheckStates(const QVector<QPair<int, Qt::CheckState>> &states);
+
+    /**
+     * @brief Removes every unchecked node with its subtree - BinaryCheck and TriStateCheck only
+     * @return Number of nodes removed
+     */
+    int RemoveUnchecked();
+
+    /**
+     * @brief Merges siblings with identical text, recursively merging their children
+     * A merged leaf is checked if any of its duplicates was checked
+     * @return Number of nodes merged away
+     */
+    int MergeDuplicateSiblings();
+
+    /**
+     * @brief Gets an attribute value - DoubleAttributes only
+     * @param column Column index
+     * @param position Node position
+     * @return Value - 0 if never set
+     */
+    double GetAttribute(int column, int position) const;
+
+    /**
+     * @brief Sets an attribute value - DoubleAttributes only
+     * @param column Column index
+     * @param position Node position
+     * @param value New value
+     */
+    void SetAttribute(int column, int position, double value);
+
+    /**
+     * @brief Gets the identifier of a node
+     * @param position Node position
+     * @return Identifier - position + 1 with NoIdIndex
+     */
+    quint32 GetId(int position) const;
+
+    /**
+     * @brief Finds a node by identifier
+     * @param id Identifier
+     * @return Position - NoNode if unknown
+     */
+    int FindById(quint32 id) const;
+
+    /**
+     * @brief Gets one past the largest identifier handed out
+     * @return Identifier bound
+     */
+    quint32 GetIdBound() const;
+
+    /**
+     * @brief Keeps identifiers below a bound unused, like the identifiers of nodes removed before a reload - IdIndex only
+     * @param id Next identifier handed out for 0 - lower values are ignored
+     */
+    void SetNextId(quint32 id);
+
+    /**
+     * @brief Calls a visitor for every node in pre-order
+     * @param visitor Callable taking (position, depth)
+     */
+    template <class Visitor>
+    void VisitPreOrder(Visitor &&visitor) const;
+
+    /**
+     * @brief Gets the heap bytes held by the store, from reserved capacities
+     * @return Bytes
+     */
+    qint64 GetMemoryBytes() const;
+
+    /**
+     * @brief Gets the part of GetMemoryBytes that grows with text length - characters and string headers
+     * @return Bytes
+     */
+    qint64 GetTextBytes() const;
+
+private:
+    /**
+     * @brief Parent link of removed positions
+     */
+    static constexpr qint32 RemovedNode = -2;
+
+    /**
+     * @brief Gets the head of a sibling list
+     * @param parent Parent position - NoNode for root items
+     * @return First child link
+     */
+    qint32 &FirstLink(int parent);
+
+    /**
+     * @brief Gets the tail of a sibling list
+     * @param parent Parent position - NoNode for root items
+     * @return Last child link
+     */
+    qint32 &LastLink(int parent);
+
+    /**
+     * @brief Links a detached node into a sibling list
+     * @param position Node position
+     * @param parent Parent position - NoNode for root level
+     * @param index Child index - -1 or past the end appends
+     */
+    void Link(int position, int parent, int index);
+
+    /**
+     * @brief Unlinks a node from its sibling list - the parent link is kept
+     * @param position Node position
+     */
+    void Unlink(int position);
+
+    /**
+     * @brief Replaces a sibling list
+     * @param parent Parent position - NoNode for root items
+     * @param children Child positions in order
+     */
+    void RelinkChildren(int parent, const QVector<qint32> &children);
+
+    /**
+     * @brief Marks an unlinked subtree removed and releases its texts and identifiers
+     * @param position Subtree root position
+     * @return Number of nodes removed
+     */
+    int ReleaseSubtree(int position);
+
+    /**
+     * @brief Copies a check state to every descendant
+     * @param position Subtree root position
+     * @param state State to copy
+     */
+    void SetSubtreeCheckState(int position, Qt::CheckState state);
+
+    /**
+     * @brief Recalculates a parent and its ancestors from their children
+     * @param position First parent to recalculate - stops at the root, a leaf or once a state is unchanged
+     */
+    void UpdateAncestors(int position);
+
+    /**
+     * @brief Recalculates every parent from its children in one bottom-up pass
+     */
+    void RecalculateCheckStates();
+
+    /**
+     * @brief Calculates a parent's state from its children
+     * @param position Parent position - must have children
+     * @return Aggregated state
+     */
+    Qt::CheckState CalculateCheckState(int position) const;
+
+    QVector<qint32> Parents;                          // Parent position by position
+    QVector<qint32> FirstChildren;                    // First child by position
+    QVector<qint32> LastChildren;                     // Last child by position - appends without walking siblings
+    QVector<qint32> NextSiblings;                     // Next sibling by position
+    qint32 FirstRoot = NoNode;                        // First root item
+    qint32 LastRoot = NoNode;                         // Last root item
+    int NodeCount = 0;                                // Live nodes - removed positions excluded
+    typename CheckPolicy::Storage Checks;             // Check states - empty with NoCheck
+    typename TextPolicy::Storage Texts;               // Texts - pooled or per node
+    typename AttributePolicy::Storage Attributes;     // Attribute columns - empty without columns
+    typename IdPolicy::Storage Ids;                   // Identifiers - empty without index
+};
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::Reserve(int nodeCount)
+{
+    /**
+     * Reserves every array the policies keep
+     */
+
+    Parents.reserve(nodeCount);
+    FirstChildren.reserve(nodeCount);
+    LastChildren.reserve(nodeCount);
+    NextSiblings.reserve(nodeCount);
+    Checks.Reserve(nodeCount);
+    Texts.Reserve(nodeCount);
+    Attributes.Reserve(nodeCount);
+    Ids.Reserve(nodeCount);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::Clear()
+{
+    /**
+     * Drops all nodes and links
+     */
+
+    Parents.clear();
+    FirstChildren.clear();
+    LastChildren.clear();
+    NextSiblings.clear();
+    FirstRoot = NoNode;
+    LastRoot = NoNode;
+    NodeCount = 0;
+    Checks.Clear();
+    Texts.Clear();
+    Attributes.Clear();
+    Ids.Clear();
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetNodeCount() const
+{
+    /**
+     * Gets the live node count
+     * @return Count
+     */
+
+    return NodeCount;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+bool A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::IsAlive(int position) const
+{
+    /**
+     * Checks the range and the removed marker
+     * @return True for live nodes
+     */
+
+    return position >= 0 && position < Parents.size() && Parents.at(position) != RemovedNode;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::AddNode(int parent, const QString &text, quint32 id)
+{
+    /**
+     * Appends behind the parent's last child
+     * @return New position
+     */
+
+    return InsertNode(parent, text, -1, id);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::InsertNode(int parent, const QString &text, int index, quint32 id)
+{
+    /**
+     * Appends to every array and links the node into the parent's sibling list
+     * @return New position
+     */
+
+    if ((parent != NoNode && !IsAlive(parent)) || !Ids.Append(id)) {
+        return NoNode;
+    }
+
+    const int _position = Parents.size();                // New node position
+    Parents.append(parent);
+    FirstChildren.append(NoNode);
+    LastChildren.append(NoNode);
+    NextSiblings.append(NoNode);
+    Checks.Append();
+    Texts.Append(text);
+    Attributes.Append();
+    NodeCount++;
+    Link(_position, parent, index);
+
+    if constexpr (CheckPolicy::IsCheckable) {
+        if (parent != NoNode && Checks.Get(parent) != Qt::Unchecked) {
+            UpdateAncestors(parent);                      // Unchecked child changes a checked parent only
+        }
+    }
+
+    return _position;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::RemoveSubtree(int position)
+{
+    /**
+     * Unlinks the subtree, releases it and lets the parent aggregate its remaining children
+     * @return Nodes removed
+     */
+
+    if (!IsAlive(position)) {
+        return 0;
+    }
+
+    const qint32 _parent = Parents.at(position);          // Parent losing a child
+    Unlink(position);
+    const int _removedCount = ReleaseSubtree(position);
+    if constexpr (CheckPolicy::IsCheckable) {
+        if (_parent != NoNode) {
+            UpdateAncestors(_parent);
+        }
+    }
+    return _removedCount;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+bool A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::MoveNode(int position, int parent, int index)
+{
+    /**
+     * Relinks a subtree under a new parent; both parents aggregate their new children
+     * @return True if moved
+     */
+
+    if (!IsAlive(position) || (parent != NoNode && !IsAlive(parent))) {
+        return false;
+    }
+    for (qint32 _ancestor = parent; _ancestor != NoNode; _ancestor = Parents.at(_ancestor)) {
+        if (_ancestor == position) {
+            return false;                                 // Cannot move into own subtree
+        }
+    }
+
+    const qint32 _oldParent = Parents.at(position);       // Parent losing the node
+    Unlink(position);
+    Link(position, parent, index);
+    if constexpr (CheckPolicy::IsCheckable) {
+        if (_oldParent != NoNode) {
+            UpdateAncestors(_oldParent);
+        }
+        if (parent != NoNode) {
+            UpdateAncestors(parent);
+        }
+    }
+    return true;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetChildOrder(int parent, const QVector<int> &order)
+{
+    /**
+     * Takes listed children first, then the unlisted ones in their current order
+     */
+
+    if (parent != NoNode && !IsAlive(parent)) {
+        return;
+    }
+
+    QVector<qint32> _ordered;                             // New order
+    QSet<qint32> _listed;                                 // Children already placed
+    for (int _child : order) {
+        if (IsAlive(_child) && Parents.at(_child) == parent && !_listed.contains(_child)) {
+            _listed.insert(_child);
+            _ordered.append(_child);
+        }
+    }
+    for (qint32 _child = FirstLink(parent); _child != NoNode; _child = NextSiblings.at(_child)) {
+        if (!_listed.contains(_child)) {
+            _ordered.append(_child);
+        }
+    }
+    RelinkChildren(parent, _ordered);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetParent(int position) const
+{
+    /**
+     * Gets the parent link
+     * @return Parent position
+     */
+
+    return Parents.at(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetFirstChild(int position) const
+{
+    /**
+     * Gets the first child link
+     * @return Child position
+     */
+
+    return position == NoNode ? FirstRoot : FirstChildren.at(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetNextSibling(int position) const
+{
+    /**
+     * Gets the sibling link
+     * @return Sibling position
+     */
+
+    return NextSiblings.at(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+QString A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetText(int position) const
+{
+    /**
+     * Gets the text from the text storage
+     * @return Text
+     */
+
+    return Texts.Get(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetText(int position, const QString &text)
+{
+    /**
+     * Replaces one text
+     */
+
+    static_assert(TextPolicy::IsEditable, "SetText needs the EditableText policy");
+    Texts.Set(position, text);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+Qt::CheckState A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetCheckState(int position) const
+{
+    /**
+     * Gets the check state from the check storage
+     * @return Check state
+     */
+
+    return Checks.Get(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetCheckState(int position, Qt::CheckState state)
+{
+    /**
+     * Copies the state into the subtree, then walks up while parents change
+     */
+
+    static_assert(CheckPolicy::IsCheckable, "SetCheckState needs a check policy");
+
+    if (state != Qt::PartiallyChecked) {
+        SetSubtreeCheckState(position, state);            // Children follow
+    }
+    Checks.Set(position, state);
+
+    if (Parents.at(position) != NoNode) {
+        UpdateAncestors(Parents.at(position));
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetCheckStates(const QVector<QPair<int, Qt::CheckState>> &states)
+{
+    /**
+     * Sets each state and its subtree, then recalculates parents once
+     */
+
+    static_assert(CheckPolicy::IsCheckable, "SetCheckStates needs a check policy");
+
+    for (const QPair<int, Qt::CheckState> &_state : states) {
+        if (!IsAlive(_state.first)) {
+            continue;
+        }
+        if (_state.second != Qt::PartiallyChecked) {
+            SetSubtreeCheckState(_state.first, _state.second);
+        }
+        Checks.Set(_state.first, _state.second);
+    }
+    RecalculateCheckStates();                             // One bottom-up pass instead of one walk per node
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::RemoveUnchecked()
+{
+    /**
+     * Filters each sibling list once, top-down; an unchecked parent means an unchecked subtree
+     * @return Nodes removed
+     */
+
+    static_assert(CheckPolicy::IsCheckable, "RemoveUnchecked needs a check policy");
+
+    int _removedCount = 0;                                // Nodes removed
+    QVector<qint32> _pending;                             // Containers to filter
+    _pending.append(NoNode);
+    while (!_pending.isEmpty()) {
+        const qint32 _container = _pending.takeLast();
+        QVector<qint32> _kept;                            // Children that stay
+        qint32 _child = FirstLink(_container);
+        while (_child != NoNode) {
+            const qint32 _next = NextSiblings.at(_child);  // Read before the child is released
+            if (Checks.Get(_child) == Qt::Unchecked) {
+                _removedCount += ReleaseSubtree(_child);
+            } else {
+                _kept.append(_child);
+                _pending.append(_child);
+            }
+            _child = _next;
+        }
+        RelinkChildren(_container, _kept);
+    }
+
+    RecalculateCheckStates();                             // Partial parents may now be fully checked
+    return _removedCount;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::MergeDuplicateSiblings()
+{
+    /**
+     * Merges duplicates top-down; children of a duplicate are appended to the first sibling
+     * with the same text, which is then deduplicated itself
+     * @return Nodes merged away
+     */
+
+    int _mergedCount = 0;                                 // Duplicates removed
+    QVector<qint32> _pending;                             // Containers to deduplicate
+    _pending.append(NoNode);
+    while (!_pending.isEmpty()) {
+        const qint32 _container = _pending.takeLast();
+        QHash<QString, qint32> _firstByText;              // Kept child per text
+        QVector<qint32> _kept;                            // Children that stay
+        qint32 _child = FirstLink(_container);
+        while (_child != NoNode) {
+            const qint32 _next = NextSiblings.at(_child);  // Read before the child is released
+            const QString _text = Texts.Get(_child);
+            const qint32 _first = _firstByText.value(_text, NoNode);  // Sibling absorbing a duplicate
+            if (_first == NoNode) {
+                _firstByText.insert(_text, _child);
+                _kept.append(_child);
+                _child = _next;
+                continue;
+            }
+
+            if constexpr (CheckPolicy::IsCheckable) {
+                if (Checks.Get(_child) == Qt::Checked && FirstChildren.at(_first) == NoNode &&
+                    FirstChildren.at(_child) == NoNode) {
+                    Checks.Set(_first, Qt::Checked);      // A checked duplicate leaf keeps the path checked
+                }
+            }
+            const qint32 _moved = FirstChildren.at(_child);  // Children handed to the kept sibling
+            if (_moved != NoNode) {
+                for (qint32 _grandChild = _moved; _grandChild != NoNode; _grandChild = NextSiblings.at(_grandChild)) {
+                    Parents[_grandChild] = _first;
+                }
+                if (LastChildren.at(_first) == NoNode) {
+                    FirstChildren[_first] = _moved;
+                } else {
+                    NextSiblings[LastChildren.at(_first)] = _moved;
+                }
+                LastChildren[_first] = LastChildren.at(_child);
+                FirstChildren[_child] = NoNode;
+                LastChildren[_child] = NoNode;
+            }
+            _mergedCount += ReleaseSubtree(_child);       // Only the duplicate itself is left in it
+            _child = _next;
+        }
+        RelinkChildren(_container, _kept);
+        for (qint32 _keptChild : std::as_const(_kept)) {
+            _pending.append(_keptChild);                  // Merged children are deduplicated next
+        }
+    }
+
+    if constexpr (CheckPolicy::IsCheckable) {
+        RecalculateCheckStates();                         // Merged parents aggregate new children
+    }
+    return _mergedCount;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+double A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetAttribute(int column, int position) const
+{
+    /**
+     * Reads one column value
+     * @return Value
+     */
+
+    static_assert(AttributePolicy::Columns > 0, "GetAttribute needs attribute columns");
+    return Attributes.Values.at(column).at(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetAttribute(int column, int position, double value)
+{
+    /**
+     * Writes one column value
+     */
+
+    static_assert(AttributePolicy::Columns > 0, "SetAttribute needs attribute columns");
+    Attributes.Values[column][position] = value;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+quint32 A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetId(int position) const
+{
+    /**
+     * Gets the identifier from the identifier storage
+     * @return Identifier
+     */
+
+    return Ids.GetId(position);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::FindById(quint32 id) const
+{
+    /**
+     * Looks an identifier up - a bounds check without index, a hash lookup with it
+     * @return Position
+     */
+
+    const int _position = Ids.Find(id);                   // Removed positions stay in the index without hash
+    return IsAlive(_position) ? _position : NoNode;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+quint32 A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetIdBound() const
+{
+    /**
+     * Gets the next identifier the identifier storage hands out
+     * @return Identifier bound
+     */
+
+    return Ids.GetNextId();
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetNextId(quint32 id)
+{
+    /**
+     * Raises the next free identifier
+     */
+
+    static_assert(IdPolicy::HasIdIndex, "SetNextId needs the IdIndex policy");
+    Ids.NextId = qMax(Ids.NextId, id);
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+template <class Visitor>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::VisitPreOrder(Visitor &&visitor) const
+{
+    /**
+     * Follows first-child and sibling links; the parent links give the way back up, so no stack is kept
+     */
+
+    qint32 _node = FirstRoot;                             // Current node
+    int _depth = 0;                                       // Depth of the current node
+    while (_node != NoNode) {
+        visitor(int(_node), _depth);
+        if (FirstChildren.at(_node) != NoNode) {
+            _node = FirstChildren.at(_node);
+            _depth++;
+            continue;
+        }
+        while (_node != NoNode && NextSiblings.at(_node) == NoNode) {
+            _node = Parents.at(_node);                    // Subtree done - climb to the next unvisited sibling
+            _depth--;
+        }
+        if (_node != NoNode) {
+            _node = NextSiblings.at(_node);
+        }
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+qint64 A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetMemoryBytes() const
+{
+    /**
+     * Adds the link arrays and each policy's storage
+     * @return Bytes
+     */
+
+    const qint64 _linkBytes = (Parents.capacity() + FirstChildren.capacity() + LastChildren.capacity() +
+                               NextSiblings.capacity()) * qint64(sizeof(qint32));  // Link arrays
+    return _linkBytes + Checks.GetBytes() + Texts.GetBytes() + Attributes.GetBytes() + Ids.GetBytes();
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+qint64 A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::GetTextBytes() const
+{
+    /**
+     * Asks the text storage - per-node offsets or string objects are not included
+     * @return Bytes
+     */
+
+    return Texts.GetTextBytes();
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::UpdateAncestors(int position)
+{
+    /**
+     * Walks up while states change
+     */
+
+    for (qint32 _parent = position; _parent != NoNode; _parent = Parents.at(_parent)) {
+        if (FirstChildren.at(_parent) == NoNode) {
+            break;                                        // Leaf keeps its own state
+        }
+        const Qt::CheckState _state = CalculateCheckState(_parent);
+        if (_state == Checks.Get(_parent)) {
+            break;                                        // Ancestors above are unchanged too
+        }
+        Checks.Set(_parent, _state);
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::RecalculateCheckStates()
+{
+    /**
+     * Aggregates every parent from its children; reverse pre-order visits children before parents
+     */
+
+    QVector<qint32> _order;                               // Live nodes in pre-order
+    _order.reserve(NodeCount);
+    VisitPreOrder([&_order](int position, int) {
+        _order.append(position);
+    });
+    for (int _index = _order.size() - 1; _index >= 0; --_index) {
+        const qint32 _node = _order.at(_index);
+        if (FirstChildren.at(_node) != NoNode) {
+            Checks.Set(_node, CalculateCheckState(_node));
+        }
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+qint32 &A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::FirstLink(int parent)
+{
+    /**
+     * Root items hang off FirstRoot
+     * @return Link
+     */
+
+    return parent == NoNode ? FirstRoot : FirstChildren[parent];
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+qint32 &A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::LastLink(int parent)
+{
+    /**
+     * Root items end at LastRoot
+     * @return Link
+     */
+
+    return parent == NoNode ? LastRoot : LastChildren[parent];
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::Link(int position, int parent, int index)
+{
+    /**
+     * Appends through the tail link; other indexes walk the sibling list to the predecessor
+     */
+
+    qint32 &_first = FirstLink(parent);                   // Head of the sibling list
+    qint32 &_last = LastLink(parent);                     // Tail of the sibling list
+    qint32 _previous = NoNode;                            // Sibling placed before the node - NoNode for the head
+    if (index < 0) {
+        _previous = _last;
+    } else if (index > 0) {
+        _previous = _first;
+        for (int _step = 1; _step < index && _previous != NoNode && NextSiblings.at(_previous) != NoNode; ++_step) {
+            _previous = NextSiblings.at(_previous);
+        }
+    }
+
+    Parents[position] = parent;
+    if (_previous == NoNode) {
+        NextSiblings[position] = _first;
+        _first = position;
+    } else {
+        NextSiblings[position] = NextSiblings.at(_previous);
+        NextSiblings[_previous] = position;
+    }
+    if (NextSiblings.at(position) == NoNode) {
+        _last = position;
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::Unlink(int position)
+{
+    /**
+     * Walks the sibling list to the predecessor and bridges over the node
+     */
+
+    qint32 &_first = FirstLink(Parents.at(position));     // Head of the sibling list
+    qint32 &_last = LastLink(Parents.at(position));       // Tail of the sibling list
+    qint32 _previous = NoNode;                            // Sibling before the node - NoNode for the head
+    if (_first != position) {
+        _previous = _first;
+        while (NextSiblings.at(_previous) != position) {
+            _previous = NextSiblings.at(_previous);
+        }
+    }
+
+    if (_previous == NoNode) {
+        _first = NextSiblings.at(position);
+    } else {
+        NextSiblings[_previous] = NextSiblings.at(position);
+    }
+    if (_last == position) {
+        _last = _previous;
+    }
+    NextSiblings[position] = NoNode;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::RelinkChildren(int parent, const QVector<qint32> &children)
+{
+    /**
+     * Chains the children through their sibling links
+     */
+
+    FirstLink(parent) = children.isEmpty() ? NoNode : children.first();
+    LastLink(parent) = children.isEmpty() ? NoNode : children.last();
+    for (int _index = 0; _index < children.size(); ++_index) {
+        NextSiblings[children.at(_index)] = _index + 1 < children.size() ? children.at(_index + 1) : NoNode;
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+int A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::ReleaseSubtree(int position)
+{
+    /**
+     * Marks every node removed with an explicit stack; links are read before they are cleared
+     * @return Nodes removed
+     */
+
+    int _removedCount = 0;                                // Nodes visited
+    QVector<qint32> _pending;                             // Nodes still to remove
+    _pending.append(position);
+    while (!_pending.isEmpty()) {
+        const qint32 _node = _pending.takeLast();
+        for (qint32 _child = FirstChildren.at(_node); _child != NoNode; _child = NextSiblings.at(_child)) {
+            _pending.append(_child);
+        }
+        Ids.Remove(_node);
+        Texts.Release(_node);
+        Parents[_node] = RemovedNode;
+        FirstChildren[_node] = NoNode;
+        LastChildren[_node] = NoNode;
+        NextSiblings[_node] = NoNode;
+        _removedCount++;
+    }
+
+    NodeCount -= _removedCount;
+    return _removedCount;
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+void A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::SetSubtreeCheckState(int position, Qt::CheckState state)
+{
+    /**
+     * Copies the state to every descendant with an explicit stack
+     */
+
+    if (FirstChildren.at(position) == NoNode) {
+        return;
+    }
+    QVector<qint32> _stack;                               // Pending subtree nodes
+    _stack.append(FirstChildren.at(position));
+    while (!_stack.isEmpty()) {
+        const qint32 _node = _stack.takeLast();
+        Checks.Set(_node, state);
+        if (NextSiblings.at(_node) != NoNode) {
+            _stack.append(NextSiblings.at(_node));
+        }
+        if (FirstChildren.at(_node) != NoNode) {
+            _stack.append(FirstChildren.at(_node));
+        }
+    }
+}
+
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+Qt::CheckState A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy>::CalculateCheckState(int position) const
+{
+    /**
+     * Checked if all children are checked; tri-state returns partial for mixed children,
+     * binary returns unchecked
+     * @return Aggregated state
+     */
+
+    bool _hasChecked = false;                             // Some child checked or partial
+    bool _hasUnchecked = false;                           // Some child not fully checked
+    for (qint32 _child = FirstChildren.at(position); _child != NoNode; _child = NextSiblings.at(_child)) {
+        const Qt::CheckState _state = Checks.Get(_child);
+        _hasChecked = _hasChecked || _state != Qt::Unchecked;
+        _hasUnchecked = _hasUnchecked || _state != Qt::Checked;
+        if (_hasChecked && _hasUnchecked) {
+            break;                                        // Mixed - no need to look further
+        }
+    }
+
+    if (!_hasUnchecked) {
+        return Qt::Checked;
+    }
+    if constexpr (CheckPolicy::IsTriState) {
+        return _hasChecked ? Qt::PartiallyChecked : Qt::Unchecked;
+    } else {
+        return Qt::Unchecked;
+    }
+}
+
+/**
+ * @brief Compact configuration - check bits, pooled read-only texts, no attribute columns and no identifier index
+ * A node costs four links, one text end offset and one check bit: 20 bytes plus its characters once reserved
+ */
+using A_TreeCompactNodeStore = A_TreeNodeStore<A_TreeNodePolicy::BinaryCheck, A_TreeNodePolicy::ReadOnlyText,
+                                               A_TreeNodePolicy::NoAttributes, A_TreeNodePolicy::NoIdIndex>;
+
+/**
+ * @brief Bytes per node, text characters excluded, that A_TreeCompactNodeStore must stay within
+ * The layout is checked here, the reserved capacities by qt_tree_cli --check-budget
+ */
+constexpr int A_TreeCompactNodeBudget = 32;
+
+static_assert(4 * sizeof(qint32) + sizeof(quint32) < A_TreeCompactNodeBudget, "Compact node links and text offset exceed the budget");
+
+#endif // A_TREE_NODE_STORE_H
@@ -0,0 +1,164 @@
+#include "a_tree_node_store_bench.h"
+#include "a_tree_node_store.h"
+#include <QElapsedTimer>
+
+namespace {
+const int CheckStride = 7;                                // Every 7th node is toggled in the check pass
+const int EditStride = 5;                                 // Every 5th node is renamed in the edit pass
+
+/**
+ * @brief Converts an operation count and elapsed time to a rate
+ * @param operations Operations done
+ * @param nanoseconds Elapsed time
+ * @return Operations per second - 0 if nothing was timed
+ */
+double Rate(qint64 operations, qint64 nanoseconds)
+{
+    return nanoseconds > 0 ? double(operations) * 1e9 / double(nanoseconds) : 0.0;
+}
+
+/**
+ * @brief Times one store configuration
+ * @tparam CheckPolicy, TextPolicy, AttributePolicy, IdPolicy A_TreeNodeStore policies
+ * @param name Configuration name
+ * @param nodes Generated tree
+ * @return Measurements
+ */
+template <class CheckPolicy, class TextPolicy, class AttributePolicy, class IdPolicy>
+A_TreeNodeStoreBench::Result Measure(const QString &name, const QVector<A_TreeGenerator::Node> &nodes)
+{
+    A_TreeNodeStoreBench::Result _result;                 // Measurements of this configuration
+    _result.Name = name;
+    const int _nodeCount = nodes.size();
+    if (_nodeCount == 0) {
+        return _result;
+    }
+
+    A_TreeNodeStore<CheckPolicy, TextPolicy, AttributePolicy, IdPolicy> _store;  // Generator order matches store positions
+    QElapsedTimer _timer;
+    _timer.start();
+    _store.Reserve(_nodeCount);
+    for (const A_TreeGenerator::Node &_node : nodes) {
+        _store.AddNode(_node.ParentIndex, _node.Text);
+    }
+    _result.AddsPerSecond = Rate(_nodeCount, _timer.nsecsElapsed());
+    _result.BytesPerNode = double(_store.GetMemoryBytes()) / _nodeCount;
+
+    if constexpr (CheckPolicy::IsCheckable) {
+        _timer.restart();
+        qint64 _checkCount = 0;                           // State changes done
+        for (int _position = 0; _position < _nodeCount; _position += CheckStride) {
+            _store.SetCheckState(_position, _store.GetCheckState(_position) == Qt::Checked ? Qt::Unchecked : Qt::Checked);
+            _checkCount++;
+        }
+        _result.ChecksPerSecond = Rate(_checkCount, _timer.nsecsElapsed());
+    }
+
+    if constexpr (TextPolicy::IsEditable) {
+        _timer.restart();
+        qint64 _editCount = 0;                            // Text changes done
+        for (int _position = 0; _position < _nodeCount; _position += EditStride) {
+            _store.SetText(_position, nodes.at(_nodeCount - 1 - _position).Text);
+            _editCount++;
+        }
+        _result.EditsPerSecond = Rate(_editCount, _timer.nsecsElapsed());
+    }
+
+    if constexpr (AttributePolicy::Columns > 0) {
+        for (int _position = 0; _position < _nodeCount; ++_position) {
+            _store.SetAttribute(0, _position, double(_position));  // Values for the walk to read
+        }
+    }
+
+    _timer.restart();
+    qint64 _visitCount = 0;                               // Nodes reached
+    qint64 _checksum = 0;                                 // Keeps the walk from being optimized away
+    _store.VisitPreOrder([&](int position, int depth) {
+        _checksum += _store.GetText(position).size() + depth + int(_store.GetCheckState(position));
+        if constexpr (AttributePolicy::Columns > 0) {
+            _checksum += qint64(_store.GetAttribute(0, position));
+        }
+        _visitCount++;
+    });
+    _result.VisitsPerSecond = Rate(_visitCount, _timer.nsecsElapsed());
+
+    _timer.restart();
+    for (int _position = 0; _position < _nodeCount; ++_position) {
+        _checksum += _store.FindById(_store.GetId(_position));
+    }
+    _result.LookupsPerSecond = Rate(_nodeCount, _timer.nsecsElapsed());
+
+    if (_checksum == -1) {
+        _result.Name += QStringLiteral("*");              // Never true - uses the checksum
+    }
+    return _result;
+}
+}
+
+QVector<A_TreeNodeStoreBench::Result> A_TreeNodeStoreBench::Run(const QVector<A_TreeGenerator::Node> &nodes)
+{
+    /**
+     * Instantiates each configuration - the policies decide which passes exist at compile time
+     * @return Measurements in configuration order
+     */
+
+    using namespace A_TreeNodePolicy;
+
+    QVector<Result> _results;                             // One entry per configuration
+    _results.append(Measure<NoCheck, ReadOnlyText, NoAttributes, NoIdIndex>("none", nodes));
+    _results.append(Measure<BinaryCheck, ReadOnlyText, NoAttributes, NoIdIndex>("binary", nodes));
+    _results.append(Measure<TriStateCheck, ReadOnlyText, NoAttributes, NoIdIndex>("tri-state", nodes));
+    _results.append(Measure<TriStateCheck, EditableText, NoAttributes, NoIdIndex>("tri-state+edit", nodes));
+    _results.append(Measure<TriStateCheck, EditableText, DoubleAttributes<2>, IdIndex>("tri-state+edit+attr2+ids", nodes));
+    return _results;
+}
+
+double A_TreeNodeStoreBench::MeasureCompactBytesPerNode(const QVector<A_TreeGenerator::Node> &nodes)
+{
+    /**
+     * Reserves like every loader that knows its node count, then toggles every CheckStride-th node
+     * so propagation has run over the check bits before they are counted
+     * @return Bytes per node without text - 0 for an empty tree
+     */
+
+    if (nodes.isEmpty()) {
+        return 0.0;
+    }
+
+    A_TreeCompactNodeStore _store;                        // Generator order matches store positions
+    _store.Reserve(nodes.size());
+    for (const A_TreeGenerator::Node &_node : nodes) {
+        _store.AddNode(_node.ParentIndex, _node.Text);
+    }
+    for (int _position = 0; _position < nodes.size(); _position += CheckStride) {
+        _store.SetCheckState(_position, Qt::Checked);
+    }
+    return double(_store.GetMemoryBytes() - _store.GetTextBytes()) / _store.GetNodeCount();
+}
+
+QString A_TreeNodeStoreBench::FormatTable(const QVector<Result> &results)
+{
+    /**
+     * Right-aligns numbers below a header; rates are in millions per second, "-" marks disabled features
+     * @return Table text
+     */
+
+    auto _formatRate = [](double rate) {
+        return rate > 0 ? QString::number(rate / 1e6, 'f', 2) : QStringLiteral("-");
+    };
+
+    QString _table = QString("%1 %2 %3 %4 %5 %6 %7\n")
+                         .arg("configuration", -26).arg("bytes/node", 10).arg("add M/s", 9).arg("check M/s", 9)
+                         .arg("edit M/s", 9).arg("visit M/s", 9).arg("find M/s", 9);
+    for (const Result &_result : results) {
+        _table += QString("%1 %2 %3 %4 %5 %6 %7\n")
+                      .arg(_result.Name, -26)
+                      .arg(QString::number(_result.BytesPerNode, 'f', 1), 10)
+                      .arg(_formatRate(_result.AddsPerSecond), 9)
+                      .arg(_formatRate(_result.ChecksPerSecond), 9)
+                      .arg(_formatRate(_result.EditsPerSecond), 9)
+                      .arg(_formatRate(_result.VisitsPerSecond), 9)
+                      .arg(_formatRate(_result.LookupsPerSecond), 9);
+    }
+    return _table;
+}
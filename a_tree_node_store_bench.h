@@ -0,0 +1,49 @@
+#ifndef A_TREE_NODE_STORE_BENCH_H
+#define A_TREE_NODE_STORE_BENCH_H
+
+#include <QString>
+#include <QVector>
+#include "a_tree_generator.h"
+
+class A_TreeNodeStoreBench
+{
+public:
+    /**
+     * @brief Measurements of one store configuration
+     */
+    struct Result
+    {
+        QString Name;                // Policy combination
+        double BytesPerNode = 0;     // Heap bytes divided by node count
+        double AddsPerSecond = 0;    // Node insertions
+        double ChecksPerSecond = 0;  // Check state changes with propagation - 0 without check boxes
+        double EditsPerSecond = 0;   // Text changes - 0 for read-only texts
+        double VisitsPerSecond = 0;  // Nodes per second in a pre-order walk reading texts and states
+        double LookupsPerSecond = 0; // Identifier lookups
+    };
+
+    /**
+     * @brief Builds the same tree in every configuration and times the hot operations
+     * Configurations run from fewest to most features: none, binary, tri-state, tri-state editable,
+     * and everything with attribute columns and identifier index
+     * @param nodes Generated tree - parents before children
+     * @return One result per configuration
+     */
+    static QVector<Result> Run(const QVector<A_TreeGenerator::Node> &nodes);
+
+    /**
+     * @brief Builds the tree in A_TreeCompactNodeStore, checks part of it and measures the storage
+     * @param nodes Generated tree - parents before children
+     * @return Heap bytes per node with text characters excluded - compared with A_TreeCompactNodeBudget
+     */
+    static double MeasureCompactBytesPerNode(const QVector<A_TreeGenerator::Node> &nodes);
+
+    /**
+     * @brief Formats results as an aligned table
+     * @param results Measurements
+     * @return Table text with header line
+     */
+    static QString FormatTable(const QVector<Result> &results);
+};
+
+#endif // A_TREE_NODE_STORE_BENCH_H
@@ -0,0 +1,585 @@
+#include "a_tree_shared_store.h"
+#include "a_tree_hashes.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLockFile>
+#include <QThread>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace {
+const quint32 StoreMagic = 0x41545353;                    // "ATSS" - marks an A_Tree shared store
+const quint32 StoreFormatVersion = 2;                     // Layout of control and data segments
+const qint64 MinimumDataBytes = 64 * 1024;                // Smallest data segment
+const int MaxGenerationAttempts = 16;                     // Leftover generations skipped before giving up
+const int ReadTimeoutMilliseconds = 2000;                 // Time a reader waits for a busy writer
+
+/**
+ * @brief Start of a data segment - where the current block table is
+ * Layout: header, then an arena of block payloads and block tables; each publish appends the payloads
+ * of new blocks and a new table, so unchanged blocks are neither rewritten nor copied again by readers
+ */
+struct DataHeader
+{
+    qint64 TableOffset = 0;          // Position of the current block table
+    qint64 ArenaEnd = 0;             // End of the used part of the segment
+    quint32 BlockCount = 0;          // Entries in the block table
+    quint32 NodeCount = 0;           // Nodes over all blocks
+};
+
+/**
+ * @brief Block table entry - one per snapshot block, in pre-order
+ */
+struct BlockEntry
+{
+    quint64 Stamp = 0;               // Identifies the payload content - equal stamps mean equal blocks
+    qint64 Offset = 0;               // Position of the payload
+    quint32 NodeCount = 0;           // Nodes in the block
+    quint32 TextUnits = 0;           // UTF-16 units of all texts in the block
+    quint32 ParentId = 0;            // Block's ParentId
+    quint32 LastId = 0;              // Block's LastId
+    qint32 RunCount = 0;             // Block's RunCount
+    qint32 LeadCount = 0;            // Block's LeadCount
+    quint32 IsOpen = 0;              // Block's IsOpen
+    quint32 Reserved = 0;            // Keeps entries 8-byte aligned
+};
+
+/**
+ * @brief Positions of the arrays inside a block payload, relative to its start
+ * Layout: node identifiers, block-local parent positions, text offsets, check states, UTF-16 texts
+ */
+struct BlockLayout
+{
+    qint64 NodeIds = 0;              // quint32 per node
+    qint64 ParentIndexes = 0;        // qint32 per node - block-local, -1 for top level items
+    qint64 TextOffsets = 0;          // quint32 per node plus one - start of each text in units
+    qint64 CheckStates = 0;          // quint8 per node
+    qint64 Texts = 0;                // UTF-16 code units of all texts
+    qint64 TotalBytes = 0;           // Bytes needed - a multiple of 8, so the next payload stays aligned
+
+    BlockLayout(qint64 nodeCount, qint64 textUnits)
+    {
+        ParentIndexes = NodeIds + nodeCount * qint64(sizeof(quint32));
+        TextOffsets = ParentIndexes + nodeCount * qint64(sizeof(qint32));
+        CheckStates = TextOffsets + (nodeCount + 1) * qint64(sizeof(quint32));
+        Texts = (CheckStates + nodeCount + 1) & ~qint64(1);  // Code units are 2-byte aligned
+        TotalBytes = (Texts + textUnits * qint64(sizeof(ushort)) + 7) & ~qint64(7);
+    }
+};
+
+/**
+ * @brief Counts the UTF-16 units of a block's texts
+ * @param block Snapshot block
+ * @return Code units
+ */
+qint64 CountTextUnits(const A_TreeSnapshot::Block &block)
+{
+    qint64 _textUnits = 0;                                // Sum of text lengths
+    for (const QString &_text : block.Texts) {
+        _textUnits += _text.size();
+    }
+    return _textUnits;
+}
+
+/**
+ * @brief Writes one block payload into a data segment
+ * @param payload Start of the payload - BlockLayout's TotalBytes must fit
+ * @param block Snapshot block
+ * @param textUnits UTF-16 units of the block's texts
+ */
+void WriteBlock(uchar *payload, const A_TreeSnapshot::Block &block, quint32 textUnits)
+{
+    const int _nodeCount = block.NodeIds.size();          // Nodes in the block
+    const BlockLayout _layout(_nodeCount, textUnits);     // Payload positions
+    quint32 *_textOffsets = reinterpret_cast<quint32*>(payload + _layout.TextOffsets);
+    ushort *_texts = reinterpret_cast<ushort*>(payload + _layout.Texts);
+    std::memcpy(payload + _layout.NodeIds, block.NodeIds.constData(), size_t(_nodeCount) * sizeof(quint32));
+    std::memcpy(payload + _layout.ParentIndexes, block.ParentIndexes.constData(), size_t(_nodeCount) * sizeof(qint32));
+    std::memcpy(payload + _layout.CheckStates, block.CheckStates.constData(), size_t(_nodeCount));
+    quint32 _textOffset = 0;                              // Units written so far
+    for (int _index = 0; _index < _nodeCount; ++_index) {
+        const QString &_text = block.Texts.at(_index);
+        _textOffsets[_index] = _textOffset;
+        std::memcpy(_texts + _textOffset, _text.utf16(), size_t(_text.size()) * sizeof(ushort));
+        _textOffset += quint32(_text.size());
+    }
+    _textOffsets[_nodeCount] = _textOffset;
+}
+
+/**
+ * @brief Copies one block payload out of a data segment, taking the texts straight from the segment
+ * Rejects payloads outside the segment and structures the snapshot accessors cannot walk
+ * @param base Start of the data segment
+ * @param segmentBytes Size of the data segment
+ * @param entry Table entry of the block - may be torn
+ * @return Block or nullptr
+ */
+std::shared_ptr<const A_TreeSnapshot::Block> CopyBlock(const uchar *base, qint64 segmentBytes, const BlockEntry &entry)
+{
+    const BlockLayout _layout(entry.NodeCount, entry.TextUnits);  // Payload positions
+    if (entry.NodeCount == 0 || entry.Offset < qint64(sizeof(DataHeader)) || entry.Offset > segmentBytes - _layout.TotalBytes ||
+        entry.RunCount < 1 || (entry.IsOpen && entry.RunCount != 1)) {
+        return nullptr;
+    }
+
+    const int _nodeCount = int(entry.NodeCount);         // Nodes in the block
+    const uchar *_payload = base + entry.Offset;
+    const quint32 *_textOffsets = reinterpret_cast<const quint32*>(_payload + _layout.TextOffsets);
+    const QChar *_texts = reinterpret_cast<const QChar*>(_payload + _layout.Texts);
+    std::shared_ptr<A_TreeSnapshot::Block> _block = std::make_shared<A_TreeSnapshot::Block>();
+    _block->ParentId = entry.ParentId;
+    _block->LastId = entry.LastId;
+    _block->RunCount = entry.RunCount;
+    _block->LeadCount = entry.LeadCount;
+    _block->IsOpen = entry.IsOpen != 0;
+    _block->NodeIds.resize(_nodeCount);
+    _block->ParentIndexes.resize(_nodeCount);
+    _block->CheckStates.resize(_nodeCount);
+    std::memcpy(_block->NodeIds.data(), _payload + _layout.NodeIds, size_t(_nodeCount) * sizeof(quint32));
+    std::memcpy(_block->ParentIndexes.data(), _payload + _layout.ParentIndexes, size_t(_nodeCount) * sizeof(qint32));
+    std::memcpy(_block->CheckStates.data(), _payload + _layout.CheckStates, size_t(_nodeCount));
+
+    int _topCount = 0;                                    // Items with parent -1 - must match RunCount
+    _block->SubtreeEnds.resize(_nodeCount);
+    _block->Texts.reserve(_nodeCount);
+    for (int _index = 0; _index < _nodeCount; ++_index) {
+        const qint32 _parent = _block->ParentIndexes.at(_index);
+        const quint32 _textStart = _textOffsets[_index];
+        const quint32 _textEnd = _textOffsets[_index + 1];
+        if ((_index == 0 ? _parent != -1 : (_parent < -1 || _parent >= _index)) || _textStart > _textEnd || _textEnd > entry.TextUnits) {
+            return nullptr;
+        }
+        _topCount += _parent < 0 ? 1 : 0;
+        _block->SubtreeEnds[_index] = _index + 1;
+        _block->Texts.append(QString(_texts + _textStart, int(_textEnd - _textStart)));
+    }
+    if (_topCount != entry.RunCount) {
+        return nullptr;
+    }
+    for (int _index = _nodeCount - 1; _index > 0; --_index) {
+        const qint32 _parent = _block->ParentIndexes.at(_index);
+        if (_parent >= 0) {
+            qint32 &_parentEnd = _block->SubtreeEnds[_parent];
+            _parentEnd = qMax(_parentEnd, _block->SubtreeEnds.at(_index));  // Children before parents in reverse pre-order
+        }
+    }
+    A_TreeHashes::HashBlock(_block.get());                // Hashes are not published - each reader hashes a new block once
+
+    return _block;
+}
+}
+
+/**
+ * @brief Control segment - lives in shared memory, so only lock-free atomics and plain integers
+ */
+struct A_TreeSharedStore::ControlBlock
+{
+    quint32 Magic;                   // StoreMagic once initialized
+    quint32 FormatVersion;           // StoreFormatVersion
+    std::atomic<quint64> Sequence;   // Seqlock counter - odd while the writer updates, content version = Sequence / 2
+    std::atomic<quint32> Generation; // Data segment generation - 0 before the first publish or after a crashed publish
+    quint64 NextStamp;               // Stamp of the next block payload - written by the writer only, kept across writers
+};
+
+static_assert(std::atomic<quint64>::is_always_lock_free, "Shared seqlock needs lock-free 64-bit atomics");
+
+A_TreeSharedStore::A_TreeSharedStore()
+    : DataGeneration(0)             // Data generation - starts at 0, no data segment attached
+    , ArenaEnd(0)                   // Arena end - starts at 0, nothing written
+    , IsWriterRole(false)           // Role flag - starts false, detached
+{
+}
+
+A_TreeSharedStore::~A_TreeSharedStore()
+{
+    Detach();
+}
+
+bool A_TreeSharedStore::CreateWriter(const QString &key)
+{
+    /**
+     * Takes the key's writer lock, then creates and initializes the control segment, or takes over
+     * a leftover one keeping its sequence so attached readers still see the counter advance.
+     * The lock file names the owning process, so a crashed writer's lock is recognized as stale
+     * @return True on success
+     */
+
+    Detach();
+    std::unique_ptr<QLockFile> _lock(new QLockFile(QDir(QDir::tempPath()).filePath(key + QStringLiteral("_writer.lock"))));
+    if (!_lock->tryLock(0)) {
+        ErrorString = _lock->error() == QLockFile::LockFailedError
+                          ? QStringLiteral("Store %1 already has a writer").arg(key)
+                          : QStringLiteral("Cannot lock store %1").arg(key);
+        return false;
+    }
+
+    Control.setKey(key + QStringLiteral("_control"));
+    if (Control.create(int(sizeof(ControlBlock)))) {
+        new (Control.data()) ControlBlock();              // Fresh segment - construct the atomics
+        ControlBlock *_control = GetControl();
+        _control->Magic = StoreMagic;
+        _control->FormatVersion = StoreFormatVersion;
+        _control->Sequence.store(0, std::memory_order_relaxed);
+        _control->NextStamp = 1;
+        _control->Generation.store(0, std::memory_order_release);
+    } else if (Control.error() != QSharedMemory::AlreadyExists || !Control.attach()) {
+        ErrorString = Control.errorString();
+        return false;
+    } else if (GetControl()->Magic != StoreMagic || GetControl()->FormatVersion != StoreFormatVersion) {
+        ErrorString = QStringLiteral("Segment %1 is not an A_Tree store").arg(Control.key());
+        Control.detach();
+        return false;
+    } else {
+        ControlBlock *_control = GetControl();            // Leftover header
+        const quint64 _sequence = _control->Sequence.load(std::memory_order_relaxed);
+        if (_sequence & 1) {
+            _control->Generation.store(0, std::memory_order_relaxed);  // Writer died mid-publish - content is torn
+            _control->Sequence.store(_sequence + 1, std::memory_order_release);  // Even - readers see an empty store
+        }
+    }
+
+    Key = key;
+    WriterLock = std::move(_lock);
+    IsWriterRole = true;
+    DataGeneration = GetControl()->Generation.load(std::memory_order_acquire);  // Grown past on first publish
+    ErrorString.clear();
+    return true;
+}
+
+bool A_TreeSharedStore::AttachReader(const QString &key)
+{
+    /**
+     * Maps the control segment read-only; data segments are mapped on first read
+     * @return True on success
+     */
+
+    Detach();
+    Control.setKey(key + QStringLiteral("_control"));
+    if (!Control.attach(QSharedMemory::ReadOnly)) {
+        ErrorString = Control.errorString();
+        return false;
+    }
+    if (Control.size() < int(sizeof(ControlBlock)) || GetControl()->Magic != StoreMagic ||
+        GetControl()->FormatVersion != StoreFormatVersion) {
+        ErrorString = QStringLiteral("Segment %1 is not an A_Tree store").arg(Control.key());
+        Control.detach();
+        return false;
+    }
+
+    Key = key;
+    ErrorString.clear();
+    return true;
+}
+
+void A_TreeSharedStore::Detach()
+{
+    /**
+     * Unmaps data and control segments
+     */
+
+    Data.reset();
+    DataGeneration = 0;
+    PublishedBlocks.clear();
+    PublishedPlacements.clear();
+    ArenaEnd = 0;
+    ReadBlocks.clear();
+    if (Control.isAttached()) {
+        Control.detach();
+    }
+    WriterLock.reset();                                   // Next writer may take the key
+    IsWriterRole = false;
+    Key.clear();
+}
+
+bool A_TreeSharedStore::IsWriter() const
+{
+    /**
+     * Gets the role flag
+     * @return True for the writer
+     */
+
+    return IsWriterRole;
+}
+
+bool A_TreeSharedStore::IsAttached() const
+{
+    /**
+     * Gets whether the control segment is mapped
+     * @return True if attached
+     */
+
+    return Control.isAttached();
+}
+
+QString A_TreeSharedStore::GetErrorString() const
+{
+    /**
+     * Gets the last error
+     * @return Error text
+     */
+
+    return ErrorString;
+}
+
+bool A_TreeSharedStore::Publish(const A_TreeSnapshot &snapshot)
+{
+    /**
+     * Seqlock write: the counter turns odd, payloads of blocks not published before and a new block
+     * table are appended to the arena, and the counter turns even again. When the arena is full, all
+     * blocks are written again from the start, into a larger generation if more than half of it is live;
+     * blocks keep their stamps, so readers still do not copy them again
+     * @return True if the content was replaced
+     */
+
+    ControlBlock *_control = GetControl();                // Shared header
+    if (!IsWriterRole || !_control) {
+        return false;
+    }
+
+    const QVector<std::shared_ptr<const A_TreeSnapshot::Block>> &_blocks = snapshot.GetBlocks();
+    const qint64 _tableBytes = qint64(_blocks.size()) * qint64(sizeof(BlockEntry));  // New block table
+    QHash<const A_TreeSnapshot::Block*, Placement> _placements;  // Payload per block of this publish
+    _placements.reserve(_blocks.size());
+    qint64 _liveBytes = qint64(sizeof(DataHeader)) + _tableBytes;  // Segment bytes of a full rewrite
+    qint64 _appendBytes = _tableBytes;                    // Arena bytes of this publish
+    for (const std::shared_ptr<const A_TreeSnapshot::Block> &_block : _blocks) {
+        Placement _placement = PublishedPlacements.value(_block.get());  // Stamp 0 if not published before
+        if (_placement.Stamp == 0) {
+            const qint64 _textUnits = CountTextUnits(*_block);  // Only new blocks are measured
+            if (_textUnits > qint64(UINT_MAX)) {
+                ErrorString = QStringLiteral("Block too large for a shared store");
+                return false;
+            }
+            _placement.TextUnits = quint32(_textUnits);
+            _placement.PayloadBytes = BlockLayout(_block->NodeIds.size(), _textUnits).TotalBytes;
+            _placement.Offset = -1;                       // Not in the arena yet
+            _appendBytes += _placement.PayloadBytes;
+        }
+        _liveBytes += _placement.PayloadBytes;
+        _placements.insert(_block.get(), _placement);
+    }
+    if (_liveBytes > qint64(INT_MAX) / 2) {
+        ErrorString = QStringLiteral("Tree too large for a shared store");
+        return false;
+    }
+
+    const quint64 _sequence = _control->Sequence.load(std::memory_order_relaxed);  // Even - last committed version
+    _control->Sequence.store(_sequence + 1, std::memory_order_relaxed);  // Odd - readers retry
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const bool _isRewrite = !Data || ArenaEnd + _appendBytes > Data->size();  // Arena full - write all blocks again
+    const bool _isPublished = !_isRewrite || (Data && Data->size() >= 2 * _liveBytes) || GrowData(2 * _liveBytes);
+    if (_isPublished) {
+        uchar *_base = static_cast<uchar*>(Data->data()); // Start of the data segment
+        if (_isRewrite) {
+            ArenaEnd = qint64(sizeof(DataHeader));
+        }
+
+        QVector<BlockEntry> _entries(_blocks.size());     // Table being built
+        qint64 _nodeCount = 0;                            // Nodes over all blocks
+        for (int _blockNumber = 0; _blockNumber < _blocks.size(); ++_blockNumber) {
+            const A_TreeSnapshot::Block &_block = *_blocks.at(_blockNumber);
+            Placement &_placement = _placements[&_block];
+            if (_isRewrite || _placement.Offset < 0) {
+                if (_placement.Stamp == 0) {
+                    _placement.Stamp = _control->NextStamp++;  // Kept when the block is written again
+                }
+                _placement.Offset = ArenaEnd;
+                WriteBlock(_base + ArenaEnd, _block, _placement.TextUnits);
+                ArenaEnd += _placement.PayloadBytes;
+            }
+
+            BlockEntry &_entry = _entries[_blockNumber];
+            _entry.Stamp = _placement.Stamp;
+            _entry.Offset = _placement.Offset;
+            _entry.NodeCount = quint32(_block.NodeIds.size());
+            _entry.TextUnits = _placement.TextUnits;
+            _entry.ParentId = _block.ParentId;
+            _entry.LastId = _block.LastId;
+            _entry.RunCount = _block.RunCount;
+            _entry.LeadCount = _block.LeadCount;
+            _entry.IsOpen = _block.IsOpen ? 1 : 0;
+            _nodeCount += _block.NodeIds.size();
+        }
+
+        DataHeader _header;                               // Points readers at the new table
+        _header.TableOffset = ArenaEnd;
+        _header.BlockCount = quint32(_entries.size());
+        _header.NodeCount = quint32(_nodeCount);
+        std::memcpy(_base + ArenaEnd, _entries.constData(), size_t(_tableBytes));
+        ArenaEnd += _tableBytes;
+        _header.ArenaEnd = ArenaEnd;
+        std::memcpy(_base, &_header, sizeof(_header));
+
+        PublishedBlocks = _blocks;                        // Keeps the keys of PublishedPlacements alive
+        PublishedPlacements = _placements;
+    }
+
+    _control->Sequence.store(_sequence + 2, std::memory_order_release);  // Even - content is consistent
+    return _isPublished;
+}
+
+quint64 A_TreeSharedStore::GetSequence() const
+{
+    /**
+     * Reads the counter - readers poll this to detect changes cheaply
+     * @return Sequence counter
+     */
+
+    const ControlBlock *_control = GetControl();
+    return _control ? _control->Sequence.load(std::memory_order_acquire) : 0;
+}
+
+std::shared_ptr<const A_TreeSnapshot> A_TreeSharedStore::Read(quint64 *sequence)
+{
+    /**
+     * Seqlock read: copies the block table and the payloads of blocks not read before, and keeps the
+     * result only if the counter was even and unchanged around it. Blocks whose stamp was read before
+     * are taken from the previous read, so a reader copies only what changed. Positions and sizes are
+     * bounds-checked before copying because a torn table may hold garbage; the structure is validated
+     * once the copy is known to be consistent
+     * @return Snapshot or nullptr
+     */
+
+    ControlBlock *_control = GetControl();                // Shared header
+    if (!_control) {
+        return nullptr;
+    }
+
+    QElapsedTimer _timer;                                 // Bounds waiting for a busy writer
+    _timer.start();
+    while (_timer.elapsed() < ReadTimeoutMilliseconds) {
+        const quint64 _before = _control->Sequence.load(std::memory_order_acquire);  // Counter before copying
+        if (_before & 1) {
+            QThread::msleep(1);                           // Writer is busy
+            continue;
+        }
+        const quint32 _generation = _control->Generation.load(std::memory_order_relaxed);
+        if (_before == 0 || _generation == 0) {
+            if (sequence) {
+                *sequence = _before;
+            }
+            ReadBlocks.clear();
+            return std::make_shared<const A_TreeSnapshot>();  // Nothing published yet, or a crashed writer's content
+        }
+        if ((!Data || _generation != DataGeneration) && !AttachData(_generation)) {
+            QThread::msleep(1);                           // Generation is being replaced
+            continue;
+        }
+
+        const uchar *_base = static_cast<const uchar*>(Data->constData());  // Start of the data segment
+        const qint64 _segmentBytes = Data->size();
+        DataHeader _header;                               // Current table position
+        std::memcpy(&_header, _base, sizeof(_header));
+        if (_header.TableOffset < qint64(sizeof(DataHeader)) ||
+            _header.TableOffset + qint64(_header.BlockCount) * qint64(sizeof(BlockEntry)) > _segmentBytes) {
+            continue;                                     // Torn header - positions cannot be trusted
+        }
+        QVector<BlockEntry> _entries(int(_header.BlockCount));  // Copied table
+        std::memcpy(_entries.data(), _base + _header.TableOffset, size_t(_entries.size()) * sizeof(BlockEntry));
+
+        QVector<std::shared_ptr<const A_TreeSnapshot::Block>> _blocks;  // Blocks of this version
+        _blocks.reserve(_entries.size());
+        QHash<quint64, std::shared_ptr<const A_TreeSnapshot::Block>> _readBlocks;  // Blocks by stamp for the next read
+        bool _isValid = true;                             // Copy is in bounds and well formed
+        for (const BlockEntry &_entry : std::as_const(_entries)) {
+            std::shared_ptr<const A_TreeSnapshot::Block> _block = ReadBlocks.value(_entry.Stamp);
+            if (!_block) {
+                _block = CopyBlock(_base, _segmentBytes, _entry);  // New or rewritten since the last read
+            }
+            if (!_block) {
+                _isValid = false;
+                break;
+            }
+            _blocks.append(_block);
+            _readBlocks.insert(_entry.Stamp, _block);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (_control->Sequence.load(std::memory_order_relaxed) != _before) {
+            continue;                                     // Writer published meanwhile - copy is torn
+        }
+        if (!_isValid) {
+            break;                                        // Consistent but malformed
+        }
+
+        ReadBlocks = _readBlocks;                         // Blocks of older versions are released
+        if (sequence) {
+            *sequence = _before;
+        }
+        return std::make_shared<const A_TreeSnapshot>(_before / 2, _blocks);
+    }
+
+    ErrorString = QStringLiteral("No consistent copy of the shared store");
+    return nullptr;
+}
+
+bool A_TreeSharedStore::AttachData(quint32 generation)
+{
+    /**
+     * Maps a data generation; the previous mapping is released, and the segment is freed once
+     * every process has moved on
+     * @return True on success
+     */
+
+    std::unique_ptr<QSharedMemory> _segment(new QSharedMemory(DataKey(generation)));  // Generation to map
+    if (!_segment->attach(IsWriterRole ? QSharedMemory::ReadWrite : QSharedMemory::ReadOnly)) {
+        return false;
+    }
+
+    Data = std::move(_segment);
+    DataGeneration = generation;
+    return true;
+}
+
+bool A_TreeSharedStore::GrowData(qint64 minimumBytes)
+{
+    /**
+     * Creates the next generation with headroom, so small growth does not replace the segment again.
+     * Runs inside the odd sequence window, so readers never map a half-written generation
+     * @return True on success
+     */
+
+    const qint64 _capacity = qMin(qint64(INT_MAX), qMax(MinimumDataBytes, minimumBytes + minimumBytes / 2));
+    for (quint32 _generation = DataGeneration + 1; _generation <= DataGeneration + MaxGenerationAttempts; ++_generation) {
+        std::unique_ptr<QSharedMemory> _segment(new QSharedMemory(DataKey(_generation)));  // Candidate generation
+        if (!_segment->create(int(_capacity))) {
+            if (_segment->error() != QSharedMemory::AlreadyExists || !_segment->attach() || _segment->size() < minimumBytes) {
+                continue;                                 // Still mapped by readers of an older writer
+            }
+        }
+
+        Data = std::move(_segment);
+        DataGeneration = _generation;
+        GetControl()->Generation.store(_generation, std::memory_order_relaxed);  // Published by the even sequence
+        return true;
+    }
+
+    ErrorString = QStringLiteral("Cannot create a data segment of %1 bytes").arg(_capacity);
+    return false;
+}
+
+QString A_TreeSharedStore::DataKey(quint32 generation) const
+{
+    /**
+     * Builds the key of a data generation
+     * @return Segment key
+     */
+
+    return Key + QStringLiteral("_data_") + QString::number(generation);
+}
+
+A_TreeSharedStore::ControlBlock* A_TreeSharedStore::GetControl() const
+{
+    /**
+     * Maps the control segment to its structure
+     * @return Control block or nullptr
+     */
+
+    if (!Control.isAttached()) {
+        return nullptr;
+    }
+    return static_cast<ControlBlock*>(const_cast<void*>(Control.constData()));
+}
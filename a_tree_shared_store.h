@@ -0,0 +1,144 @@
+#ifndef A_TREE_SHARED_STORE_H
+#define A_TREE_SHARED_STORE_H
+
+#include <QHash>
+#include <QLockFile>
+#include <QSharedMemory>
+#include <QString>
+#include <memory>
+#include "a_tree_snapshot.h"
+
+class A_TreeSharedStore
+{
+public:
+    /**
+     * @brief Constructor for a detached store
+     */
+    A_TreeSharedStore();
+
+    /**
+     * @brief Destructor - detaches from all segments; the last process to detach frees them
+     */
+    ~A_TreeSharedStore();
+
+    /**
+     * @brief Becomes the writer of a store - one writer per key
+     * A control segment left behind by a crashed writer is taken over; content it left half-written reads as empty
+     * @param key Store name shared by writer and readers
+     * @return False if another process writes the store or the control segment cannot be created or attached
+     */
+    bool CreateWriter(const QString &key);
+
+    /**
+     * @brief Attaches read-only to a store created by a writer
+     * @param key Store name
+     * @return False if no writer created the store or the format is unknown
+     */
+    bool AttachReader(const QString &key);
+
+    /**
+     * @brief Detaches from all segments
+     */
+    void Detach();
+
+    /**
+     * @brief Gets whether this instance writes the store
+     * @return True for the writer
+     */
+    bool IsWriter() const;
+
+    /**
+     * @brief Gets whether the store is attached
+     * @return True if attached as writer or reader
+     */
+    bool IsAttached() const;
+
+    /**
+     * @brief Gets the last error
+     * @return Error text - empty if none
+     */
+    QString GetErrorString() const;
+
+    /**
+     * @brief Writes a snapshot as the new store content (writer only)
+     * Readers see either the previous or the new content - the sequence counter is odd while writing.
+     * Only blocks not published before are written, so the cost follows the changed blocks.
+     * The data segment is replaced by a larger generation when it is too small
+     * @param snapshot Tree to publish
+     * @return False if the data segment cannot be grown
+     */
+    bool Publish(const A_TreeSnapshot &snapshot);
+
+    /**
+     * @brief Gets the sequence counter without reading content
+     * @return Committed sequence - even, 0 before the first publish; odd while the writer is busy
+     */
+    quint64 GetSequence() const;
+
+    /**
+     * @brief Copies the current content out of shared memory (reader or writer)
+     * Blocks unchanged since the previous read are shared with the previous snapshot instead of copied.
+     * Retries while the writer is busy or the copy was torn by a concurrent publish
+     * @param sequence Receives the sequence of the copied content - may be nullptr
+     * @return Snapshot of the content - nullptr if no consistent copy could be made
+     */
+    std::shared_ptr<const A_TreeSnapshot> Read(quint64 *sequence = nullptr);
+
+private:
+    /**
+     * @brief Fixed-size header shared by writer and readers
+     */
+    struct ControlBlock;
+
+    /**
+     * @brief Where the payload of a published block is
+     */
+    struct Placement
+    {
+        quint64 Stamp = 0;           // Payload stamp - kept when the payload is written again
+        qint64 Offset = 0;           // Payload position in the data segment
+        qint64 PayloadBytes = 0;     // Payload size
+        quint32 TextUnits = 0;       // UTF-16 units of the block's texts
+    };
+
+    /**
+     * @brief Attaches the data segment of a generation, dropping the previous one
+     * @param generation Data segment generation
+     * @return False if the segment does not exist
+     */
+    bool AttachData(quint32 generation);
+
+    /**
+     * @brief Creates a data segment generation of at least a given size (writer only)
+     * @param minimumBytes Bytes needed for the next publish
+     * @return False if no segment could be created
+     */
+    bool GrowData(qint64 minimumBytes);
+
+    /**
+     * @brief Gets the key of a data segment generation
+     * @param generation Data segment generation
+     * @return Segment key
+     */
+    QString DataKey(quint32 generation) const;
+
+    /**
+     * @brief Gets the control block of the attached store
+     * @return Control block - nullptr if detached
+     */
+    ControlBlock* GetControl() const;
+
+    QString Key;                     // Store name
+    QSharedMemory Control;           // Control segment - magic, sequence and data generation
+    std::unique_ptr<QSharedMemory> Data;  // Data segment of the attached generation - nullptr until attached
+    quint32 DataGeneration;          // Generation of Data
+    std::unique_ptr<QLockFile> WriterLock;  // Per-key lock held while writing - nullptr for readers
+    QVector<std::shared_ptr<const A_TreeSnapshot::Block>> PublishedBlocks;  // Blocks of the last publish - keeps PublishedPlacements keys alive
+    QHash<const A_TreeSnapshot::Block*, Placement> PublishedPlacements;  // Payload of each block of the last publish
+    qint64 ArenaEnd;                 // End of the used part of the data segment (writer)
+    QHash<quint64, std::shared_ptr<const A_TreeSnapshot::Block>> ReadBlocks;  // Blocks of the last read by stamp (reader)
+    bool IsWriterRole;               // Role flag - true for the writer
+    QString ErrorString;             // Last error
+};
+
+#endif // A_TREE_SHARED_STORE_H
@@ -0,0 +1,239 @@
+#include "a_tree_snapshot.h"
+#include <algorithm>
+
+A_TreeSnapshot::A_TreeSnapshot()
+    : Version(0)                    // Version - 0 for the empty snapshot
+{
+    BlockOffsets.append(0);                               // No nodes
+    RootCounts.append(0);
+}
+
+A_TreeSnapshot::A_TreeSnapshot(quint64 version, const QVector<std::shared_ptr<const Block>> &blocks)
+    : Version(version)              // Version - assigned by the publishing tree
+    , Blocks(blocks)                // Blocks - shared, never modified
+{
+    const int _blockCount = Blocks.size();                // Blocks in pre-order
+    BlockOffsets.reserve(_blockCount + 1);
+    BlockOffsets.append(0);
+    RootCounts.reserve(_blockCount + 1);
+    RootCounts.append(0);
+    for (const std::shared_ptr<const Block> &_block : Blocks) {
+        BlockOffsets.append(BlockOffsets.last() + _block->NodeIds.size());  // Prefix sums of block sizes
+        RootCounts.append(RootCounts.last() + (_block->ParentId == 0 ? _block->RunCount : 0));
+    }
+
+    // A block's parent is the top item of the innermost open block still on the stack; open blocks
+    // that are not its parent ended where this block starts
+    ParentPositions.resize(_blockCount);
+    OpenEnds.resize(_blockCount);
+    QVector<int> _openBlocks;                             // Open blocks whose subtree has not ended yet
+    for (int _blockNumber = 0; _blockNumber < _blockCount; ++_blockNumber) {
+        const Block &_block = *Blocks.at(_blockNumber);
+        while (!_openBlocks.isEmpty() && Blocks.at(_openBlocks.last())->NodeIds.first() != _block.ParentId) {
+            OpenEnds[_openBlocks.takeLast()] = BlockOffsets.at(_blockNumber);
+        }
+        ParentPositions[_blockNumber] = _openBlocks.isEmpty() ? -1 : BlockOffsets.at(_openBlocks.last());
+        OpenEnds[_blockNumber] = BlockOffsets.at(_blockNumber + 1);
+        if (_block.IsOpen && !_block.NodeIds.isEmpty()) {
+            _openBlocks.append(_blockNumber);
+        }
+    }
+    for (int _blockNumber : std::as_const(_openBlocks)) {
+        OpenEnds[_blockNumber] = BlockOffsets.last();     // Subtree runs to the end
+    }
+}
+
+quint64 A_TreeSnapshot::GetVersion() const
+{
+    /**
+     * Gets the snapshot version
+     * @return Version number
+     */
+
+    return Version;
+}
+
+int A_TreeSnapshot::GetNodeCount() const
+{
+    /**
+     * Gets the number of nodes over all blocks
+     * @return Node count
+     */
+
+    return BlockOffsets.last();
+}
+
+int A_TreeSnapshot::GetRootCount() const
+{
+    /**
+     * Gets the number of root items
+     * @return Root count
+     */
+
+    return RootCounts.last();
+}
+
+int A_TreeSnapshot::GetRootIndex(int rootNumber) const
+{
+    /**
+     * Finds the root level block by its root count, then steps over the root items before it
+     * @return Node position
+     */
+
+    const int _blockNumber = int(std::upper_bound(RootCounts.constBegin(), RootCounts.constEnd(), rootNumber) - RootCounts.constBegin()) - 1;
+    const Block &_block = *Blocks.at(_blockNumber);
+    int _local = 0;                                       // Block-local position of the root item
+    for (int _root = RootCounts.at(_blockNumber); _root < rootNumber; ++_root) {
+        _local = _block.SubtreeEnds.at(_local);           // Next sibling starts where the subtree ends
+    }
+    return BlockOffsets.at(_blockNumber) + _local;
+}
+
+quint32 A_TreeSnapshot::GetNodeId(int index) const
+{
+    /**
+     * Gets the node identifier at a position
+     * @return Node identifier
+     */
+
+    int _block = FindBlock(index);                        // Block holding the node
+    return Blocks.at(_block)->NodeIds.at(index - BlockOffsets.at(_block));
+}
+
+QString A_TreeSnapshot::GetText(int index) const
+{
+    /**
+     * Gets the display text at a position
+     * @return Item text
+     */
+
+    int _block = FindBlock(index);                        // Block holding the node
+    return Blocks.at(_block)->Texts.at(index - BlockOffsets.at(_block));
+}
+
+Qt::CheckState A_TreeSnapshot::GetCheckState(int index) const
+{
+    /**
+     * Gets the check state at a position
+     * @return Check state
+     */
+
+    int _block = FindBlock(index);                        // Block holding the node
+    return Qt::CheckState(Blocks.at(_block)->CheckStates.at(index - BlockOffsets.at(_block)));
+}
+
+int A_TreeSnapshot::GetParentIndex(int index) const
+{
+    /**
+     * Gets the parent position of a node
+     * @return Parent position or -1 for root items
+     */
+
+    int _block = FindBlock(index);                        // Block holding the node
+    int _localParent = Blocks.at(_block)->ParentIndexes.at(index - BlockOffsets.at(_block));
+    return _localParent < 0 ? ParentPositions.at(_block) : BlockOffsets.at(_block) + _localParent;
+}
+
+int A_TreeSnapshot::GetSubtreeEnd(int index) const
+{
+    /**
+     * Gets the position one past a node's last descendant - later blocks for the top item of an open block
+     * @return Subtree end position
+     */
+
+    int _block = FindBlock(index);                        // Block holding the node
+    const int _local = index - BlockOffsets.at(_block);   // Block-local position
+    if (_local == 0 && Blocks.at(_block)->IsOpen) {
+        return OpenEnds.at(_block);
+    }
+    return BlockOffsets.at(_block) + Blocks.at(_block)->SubtreeEnds.at(_local);
+}
+
+QString A_TreeSnapshot::GetPath(int index, const QString &separator) const
+{
+    /**
+     * Builds the path of a node by walking parent positions, across blocks for split subtrees
+     * @return Path from root item to node
+     */
+
+    QStringList _segments;                                // Texts from node up to root
+    for (int _position = index; _position >= 0; _position = GetParentIndex(_position)) {
+        _segments.prepend(GetText(_position));
+    }
+
+    return _segments.join(separator);
+}
+
+int A_TreeSnapshot::FindPath(const QString &path, const QString &separator) const
+{
+    /**
+     * Walks sibling lists level by level; the next sibling of a node starts where its subtree ends.
+     * A level without a match goes back to the next equally named sibling of the level above, so
+     * every node is visited at most once
+     * @return Node position or -1
+     */
+
+    QStringList _segments;                                // Trimmed segments
+    for (const QString &_segment : path.split(separator, Qt::SkipEmptyParts)) {
+        const QString _trimmed = _segment.trimmed();
+        if (!_trimmed.isEmpty()) {
+            _segments.append(_trimmed);
+        }
+    }
+    if (_segments.isEmpty()) {
+        return -1;
+    }
+
+    QVector<int> _matches;                                // Matched position per level above the current one
+    int _child = 0;                                       // Next candidate in the current sibling list
+    while (true) {
+        const int _level = _matches.size();               // Segment being matched
+        const int _end = _matches.isEmpty() ? GetNodeCount() : GetSubtreeEnd(_matches.last());
+        while (_child < _end && GetText(_child) != _segments.at(_level)) {
+            _child = GetSubtreeEnd(_child);               // Skip to the next sibling
+        }
+
+        if (_child < _end) {
+            if (_level + 1 == _segments.size()) {
+                return _child;                            // Whole path matched
+            }
+            _matches.append(_child);
+            _child++;                                     // First child follows its parent
+            continue;
+        }
+        if (_matches.isEmpty()) {
+            return -1;                                    // No root item leads to the path
+        }
+        _child = GetSubtreeEnd(_matches.takeLast());      // Try the next sibling of the last match
+    }
+}
+
+const QVector<std::shared_ptr<const A_TreeSnapshot::Block>>& A_TreeSnapshot::GetBlocks() const
+{
+    /**
+     * Gets the blocks
+     * @return Blocks in pre-order
+     */
+
+    return Blocks;
+}
+
+int A_TreeSnapshot::GetBlockOffset(int blockNumber) const
+{
+    /**
+     * Gets the prefix sum of block sizes
+     * @return Node position
+     */
+
+    return BlockOffsets.at(blockNumber);
+}
+
+int A_TreeSnapshot::FindBlock(int index) const
+{
+    /**
+     * Binary search over block offsets
+     * @return Block number holding the position
+     */
+
+    return int(std::upper_bound(BlockOffsets.constBegin(), BlockOffsets.constEnd(), index) - BlockOffsets.constBegin()) - 1;
+}
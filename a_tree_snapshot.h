@@ -0,0 +1,154 @@
+#ifndef A_TREE_SNAPSHOT_H
+#define A_TREE_SNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class A_TreeSnapshot
+{
+public:
+    /**
+     * @brief Immutable flattened copy of a run of sibling subtrees
+     * A subtree too large for one block is split: its open block holds the top item and its leading
+     * children, the remaining children follow in later blocks with that item as parent.
+     * Unchanged blocks are shared between snapshot versions
+     */
+    struct Block
+    {
+        quint32 ParentId = 0;                // Parent of the top level items - 0 for root items
+        quint32 LastId = 0;                  // Node identifier of the last top level item
+        qint32 RunCount = 0;                 // Top level items - consecutive siblings, 1 for an open block
+        qint32 LeadCount = 0;                // Children of the top item held by an open block
+        bool IsOpen = false;                 // Top item's subtree continues in later blocks
+        QVector<quint32> NodeIds;            // Node identifiers in pre-order
+        QVector<qint32> ParentIndexes;       // Block-local parent position - -1 for top level items
+        QVector<qint32> SubtreeEnds;         // Block-local position one past each node's subtree - block size for an open top item
+        QVector<quint8> CheckStates;         // Qt::CheckState per node
+        QStringList Texts;                   // Display text per node
+        QVector<quint64> ContentHashes;      // A_TreeHashes content hash per node, set when built - leading children only for an open top item
+        QVector<quint64> StateHashes;        // A_TreeHashes state hash per node, set when built
+    };
+
+    /**
+     * @brief Constructor for an empty snapshot
+     */
+    A_TreeSnapshot();
+
+    /**
+     * @brief Constructor for a snapshot made of blocks
+     * Positions of parents outside a block and ends of open subtrees are resolved once, in O(blocks)
+     * @param version Version number - increases with every published snapshot
+     * @param blocks Blocks in pre-order
+     */
+    A_TreeSnapshot(quint64 version, const QVector<std::shared_ptr<const Block>> &blocks);
+
+    /**
+     * @brief Gets the version of this snapshot
+     * @return Version number - higher is newer
+     */
+    quint64 GetVersion() const;
+
+    /**
+     * @brief Gets the number of nodes
+     * @return Node count over all roots
+     */
+    int GetNodeCount() const;
+
+    /**
+     * @brief Gets the number of root items
+     * @return Root count
+     */
+    int GetRootCount() const;
+
+    /**
+     * @brief Gets the position of a root item
+     * @param rootNumber Root item number - 0 to GetRootCount() - 1
+     * @return Node position in pre-order
+     */
+    int GetRootIndex(int rootNumber) const;
+
+    /**
+     * @brief Gets the node identifier at a position
+     * @param index Node position in pre-order - 0 to GetNodeCount() - 1
+     * @return Node identifier as returned by A_Tree::GetItemId
+     */
+    quint32 GetNodeId(int index) const;
+
+    /**
+     * @brief Gets the display text at a position
+     * @param index Node position in pre-order
+     * @return Item text
+     */
+    QString GetText(int index) const;
+
+    /**
+     * @brief Gets the check state at a position
+     * @param index Node position in pre-order
+     * @return Check state of the item
+     */
+    Qt::CheckState GetCheckState(int index) const;
+
+    /**
+     * @brief Gets the parent position of a node
+     * @param index Node position in pre-order
+     * @return Parent position - -1 for root items
+     */
+    int GetParentIndex(int index) const;
+
+    /**
+     * @brief Gets the end of a node's subtree - descendants occupy (index, end)
+     * @param index Node position in pre-order
+     * @return Position one past the last descendant
+     */
+    int GetSubtreeEnd(int index) const;
+
+    /**
+     * @brief Builds the path from root item to a node
+     * @param index Node position in pre-order
+     * @param separator Separator placed between path segments
+     * @return Joined item texts
+     */
+    QString GetPath(int index, const QString &separator = "/") const;
+
+    /**
+     * @brief Finds a node by path - the first match in pre-order
+     * Segments are trimmed and empty segments skipped; each level scans the sibling list, and when a
+     * level has no match the search continues with later equally named siblings of the level above
+     * @param path Path from root item
+     * @param separator Separator between path segments
+     * @return Node position in pre-order - -1 if no node has this path
+     */
+    int FindPath(const QString &path, const QString &separator = "/") const;
+
+    /**
+     * @brief Gets the blocks for direct sequential access
+     * @return Blocks in pre-order
+     */
+    const QVector<std::shared_ptr<const Block>>& GetBlocks() const;
+
+    /**
+     * @brief Gets the position of a block's first node
+     * @param blockNumber Block number - GetBlocks().size() for the node count
+     * @return Node position in pre-order
+     */
+    int GetBlockOffset(int blockNumber) const;
+
+    /**
+     * @brief Finds the block holding a node position
+     * @param index Node position in pre-order
+     * @return Block number
+     */
+    int FindBlock(int index) const;
+
+private:
+    quint64 Version;                                 // Snapshot version
+    QVector<std::shared_ptr<const Block>> Blocks;    // Blocks - shared with other versions
+    QVector<int> BlockOffsets;                       // First node position per block, plus total count at the end
+    QVector<int> ParentPositions;                    // Position of each block's parent item - -1 for root level blocks
+    QVector<int> OpenEnds;                           // End of the top item's subtree for open blocks - block end otherwise
+    QVector<int> RootCounts;                         // Root items before each block, plus total count at the end
+};
+
+#endif // A_TREE_SNAPSHOT_H
@@ -0,0 +1,696 @@
+#include "a_tree_store.h"
+#include "a_tree_check_rules.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+#include <utility>
+
+namespace {
+const int ParallelChunkSize = 16384;  // Nodes or lines per worker task
+
+/**
+ * @brief Range of work items processed by one worker task, with its private output
+ */
+template <typename Output>
+struct WorkChunk
+{
+    int Begin = 0;                    // First work item
+    int End = 0;                      // One past last work item
+    Output Result;                    // Output of this chunk - merged in chunk order
+};
+
+/**
+ * @brief Splits a work range into chunks for QtConcurrent::blockingMap
+ * @param count Number of work items
+ * @return Chunks covering [0, count)
+ */
+template <typename Output>
+QVector<WorkChunk<Output>> MakeChunks(int count)
+{
+    QVector<WorkChunk<Output>> _chunks;                   // Chunks in order
+    for (int _begin = 0; _begin < count; _begin += ParallelChunkSize) {
+        WorkChunk<Output> _chunk;
+        _chunk.Begin = _begin;
+        _chunk.End = qMin(_begin + ParallelChunkSize, count);
+        _chunks.append(_chunk);
+    }
+    return _chunks;
+}
+
+/**
+ * @brief One parsed line of a path file
+ */
+struct ParsedLine
+{
+    QStringList Segments;             // Path segments - empty for skipped lines
+    int CheckFlag = -1;               // 1 checked, 0 unchecked, -1 not given
+};
+}
+
+A_TreeStore::A_TreeStore()
+{
+}
+
+void A_TreeStore::Clear()
+{
+    /**
+     * Removes all nodes; only the invisible root is left
+     */
+
+    Nodes.Clear();
+    ChildLookup.clear();
+}
+
+int A_TreeStore::GetNodeCount() const
+{
+    /**
+     * Gets the number of live nodes
+     * @return Node count
+     */
+
+    return Nodes.GetNodeCount();
+}
+
+quint32 A_TreeStore::GetIdBound() const
+{
+    /**
+     * Gets one past the largest identifier
+     * @return Identifier bound
+     */
+
+    return Nodes.GetIdBound();
+}
+
+bool A_TreeStore::IsValid(quint32 id) const
+{
+    /**
+     * Checks an identifier
+     * @return True for live nodes
+     */
+
+    return id == RootId || GetPosition(id) != NodeStore::NoNode;
+}
+
+quint32 A_TreeStore::GetParent(quint32 id) const
+{
+    /**
+     * Gets the parent identifier
+     * @return Parent identifier
+     */
+
+    return GetId(Nodes.GetParent(GetPosition(id)));
+}
+
+QString A_TreeStore::GetText(quint32 id) const
+{
+    /**
+     * Gets the node text
+     * @return Text
+     */
+
+    return Nodes.GetText(GetPosition(id));
+}
+
+Qt::CheckState A_TreeStore::GetCheckState(quint32 id) const
+{
+    /**
+     * Gets the node check state
+     * @return Check state
+     */
+
+    return Nodes.GetCheckState(GetPosition(id));
+}
+
+QVector<quint32> A_TreeStore::GetChildren(quint32 id) const
+{
+    /**
+     * Follows the sibling links of the node's first child
+     * @return Child identifiers
+     */
+
+    QVector<quint32> _children;                           // Children in order
+    for (int _child = Nodes.GetFirstChild(GetPosition(id)); _child != NodeStore::NoNode; _child = Nodes.GetNextSibling(_child)) {
+        _children.append(Nodes.GetId(_child));
+    }
+
+    return _children;
+}
+
+QString A_TreeStore::GetPath(quint32 id, const QString &separator) const
+{
+    /**
+     * Builds the path of the node's position
+     * @return Path from root item to node
+     */
+
+    return GetPathAt(GetPosition(id), separator);
+}
+
+QVector<quint32> A_TreeStore::GetPreOrder() const
+{
+    /**
+     * Lists nodes parents first, siblings in order
+     * @return Identifiers in pre-order
+     */
+
+    QVector<quint32> _order;                              // Visited nodes
+    _order.reserve(Nodes.GetNodeCount());
+    Nodes.VisitPreOrder([this, &_order](int position, int) {
+        _order.append(Nodes.GetId(position));
+    });
+
+    return _order;
+}
+
+quint32 A_TreeStore::AddNode(quint32 parentId, const QString &text, int index, quint32 nodeId)
+{
+    /**
+     * Creates a node in the node store, which recalculates checked parents, and indexes it
+     * @return New identifier or 0
+     */
+
+    if (!IsValid(parentId) || (nodeId != 0 && IsValid(nodeId))) {
+        return 0;                                         // Parent gone or identifier in use
+    }
+
+    const int _position = Nodes.InsertNode(GetPosition(parentId), text, index, nodeId);  // New node - starts unchecked like in A_Tree
+    if (_position == NodeStore::NoNode) {
+        return 0;
+    }
+
+    const quint32 _id = Nodes.GetId(_position);          // Requested or next free identifier
+    IndexChild(_id);
+    return _id;
+}
+
+quint32 A_TreeStore::FindChild(quint32 parentId, const QString &text) const
+{
+    /**
+     * Looks up a child through the (parent, text) index
+     * @return Child identifier or 0
+     */
+
+    return ChildLookup.value(qMakePair(parentId, text), 0);
+}
+
+quint32 A_TreeStore::AddPath(const QStringList &segments)
+{
+    /**
+     * Resolves a path segment by segment, creating what is missing
+     * @return Identifier of the final node or 0
+     */
+
+    quint32 _current = RootId;                            // Node of the resolved prefix
+    for (const QString &_segment : segments) {
+        quint32 _next = FindChild(_current, _segment);    // Existing child for this segment
+        _current = _next ? _next : AddNode(_current, _segment);
+    }
+
+    return _current == RootId ? 0 : _current;
+}
+
+void A_TreeStore::RemoveSubtree(quint32 id)
+{
+    /**
+     * Drops the subtree's index entries, then removes it from the node store
+     */
+
+    if (id == RootId || !IsValid(id)) {
+        return;                                           // Nothing to remove
+    }
+
+    UnindexDescendants(id);
+    const quint32 _parentId = GetParent(id);              // Parent losing a child
+    const QString _text = GetText(id);
+    Nodes.RemoveSubtree(GetPosition(id));                 // Parent recalculated by the node store
+    UnindexChild(_parentId, _text, id);
+}
+
+void A_TreeStore::SetText(quint32 id, const QString &text)
+{
+    /**
+     * Renames a node and moves its index entry
+     */
+
+    if (id == RootId || !IsValid(id)) {
+        return;
+    }
+
+    const QString _oldText = GetText(id);                 // Text the entry is filed under
+    Nodes.SetText(GetPosition(id), text);
+    UnindexChild(GetParent(id), _oldText, id);
+    IndexChild(id);
+}
+
+bool A_TreeStore::MoveNode(quint32 id, quint32 parentId, int index)
+{
+    /**
+     * Moves a subtree in the node store and files its index entry under the new parent
+     * @return True if moved
+     */
+
+    if (id == RootId || !IsValid(id) || !IsValid(parentId)) {
+        return false;
+    }
+
+    const quint32 _oldParentId = GetParent(id);           // Parent losing the node
+    if (!Nodes.MoveNode(GetPosition(id), GetPosition(parentId), index)) {
+        return false;                                     // Cannot move into own subtree
+    }
+
+    UnindexChild(_oldParentId, GetText(id), id);
+    IndexChild(id);
+    return true;
+}
+
+void A_TreeStore::SetChildOrder(quint32 parentId, const QVector<quint32> &order)
+{
+    /**
+     * Reorders children to a recorded order
+     */
+
+    if (!IsValid(parentId)) {
+        return;
+    }
+
+    QVector<int> _positions;                              // Listed children as positions
+    _positions.reserve(order.size());
+    for (quint32 _childId : order) {
+        if (_childId != RootId && IsValid(_childId)) {
+            _positions.append(GetPosition(_childId));
+        }
+    }
+    Nodes.SetChildOrder(GetPosition(parentId), _positions);  // Unlisted children keep their relative order
+}
+
+void A_TreeStore::SetCheckState(quint32 id, Qt::CheckState state)
+{
+    /**
+     * Sets a check state and propagates it
+     */
+
+    if (id == RootId || !IsValid(id)) {
+        return;
+    }
+
+    Nodes.SetCheckState(GetPosition(id), state);
+}
+
+void A_TreeStore::SetCheckStates(const QVector<quint32> &ids, Qt::CheckState state)
+{
+    /**
+     * Sets many check states, then recalculates parents once
+     */
+
+    QVector<QPair<int, Qt::CheckState>> _states;          // Valid nodes as positions
+    _states.reserve(ids.size());
+    for (quint32 _id : ids) {
+        if (_id != RootId && IsValid(_id)) {
+            _states.append(qMakePair(GetPosition(_id), state));
+        }
+    }
+
+    Nodes.SetCheckStates(_states);                        // One bottom-up pass instead of one per node
+}
+
+QVector<quint32> A_TreeStore::FindMatching(const QRegularExpression &pattern, const QString &separator) const
+{
+    /**
+     * Tests the path of every node against a pattern
+     * Nodes are split into chunks that are tested on worker threads; the store is only read
+     * @return Matching identifiers in pre-order
+     */
+
+    const QVector<int> _order = GetPreOrderPositions();   // Nodes to test
+    QVector<WorkChunk<QVector<quint32>>> _chunks = MakeChunks<QVector<quint32>>(_order.size());
+
+    QtConcurrent::blockingMap(_chunks, [this, &_order, &pattern, &separator](WorkChunk<QVector<quint32>> &chunk) {
+        for (int _index = chunk.Begin; _index < chunk.End; ++_index) {
+            if (pattern.match(GetPathAt(_order.at(_index), separator)).hasMatch()) {
+                chunk.Result.append(Nodes.GetId(_order.at(_index)));
+            }
+        }
+    });
+
+    QVector<quint32> _matches;                            // Matches of all chunks in order
+    for (const WorkChunk<QVector<quint32>> &_chunk : std::as_const(_chunks)) {
+        _matches += _chunk.Result;
+    }
+
+    return _matches;
+}
+
+QRegularExpression A_TreeStore::CompileGlob(const QString &glob, const QString &separator)
+{
+    /**
+     * Uses the glob dialect of A_Tree's check rules, so patterns behave the same in both tools
+     * @return Compiled expression
+     */
+
+    return A_TreeCheckRules::CompileGlob(glob, separator);
+}
+
+int A_TreeStore::Prune()
+{
+    /**
+     * Drops unchecked subtrees in the node store and re-indexes what is left
+     * @return Nodes removed
+     */
+
+    const int _removedCount = Nodes.RemoveUnchecked();   // Nodes removed
+    RebuildChildLookup();
+    return _removedCount;
+}
+
+int A_TreeStore::Dedupe()
+{
+    /**
+     * Merges duplicate siblings in the node store and re-indexes what is left
+     * @return Nodes merged away
+     */
+
+    const int _mergedCount = Nodes.MergeDuplicateSiblings();  // Duplicates removed
+    RebuildChildLookup();
+    return _mergedCount;
+}
+
+bool A_TreeStore::LoadPathFile(const QString &filePath, const QString &separator)
+{
+    /**
+     * Loads a path file on top of the current nodes
+     * Parsing runs on all cores; insertion runs in file order and reuses the node chain
+     * of the previous path for the shared prefix, so sorted input costs O(1) lookups per line
+     * @return True if the file was read
+     */
+
+    QFile _file(filePath);                                // Input file
+    if (!_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QList<QByteArray> _lines = _file.readAll().split('\n');  // Raw lines
+
+    QVector<WorkChunk<QVector<ParsedLine>>> _chunks = MakeChunks<QVector<ParsedLine>>(_lines.size());
+    QtConcurrent::blockingMap(_chunks, [&_lines, &separator](WorkChunk<QVector<ParsedLine>> &chunk) {
+        chunk.Result.resize(chunk.End - chunk.Begin);
+        for (int _lineIndex = chunk.Begin; _lineIndex < chunk.End; ++_lineIndex) {
+            QString _line = QString::fromUtf8(_lines.at(_lineIndex)).trimmed();
+            if (_line.isEmpty() || _line.startsWith(QLatin1Char('#'))) {
+                continue;                                 // Blank line or comment
+            }
+
+            ParsedLine &_parsed = chunk.Result[_lineIndex - chunk.Begin];
+            int _tab = _line.lastIndexOf(QLatin1Char('\t'));  // Optional check flag column
+            if (_tab >= 0) {
+                QString _flag = _line.mid(_tab + 1).trimmed();
+                if (_flag == QLatin1String("1") || _flag == QLatin1String("0")) {
+                    _parsed.CheckFlag = _flag == QLatin1String("1") ? 1 : 0;
+                    _line = _line.left(_tab);
+                }
+            }
+            for (const QString &_segment : _line.split(separator, Qt::SkipEmptyParts)) {
+                QString _trimmed = _segment.trimmed();
+                if (!_trimmed.isEmpty()) {
+                    _parsed.Segments.append(_trimmed);
+                }
+            }
+        }
+    });
+
+    QVector<quint32> _chain;                              // Node per segment of the previous path
+    QStringList _previous;                                // Previous path
+    QVector<QPair<quint32, bool>> _checkFlags;            // Explicit states in file order
+    for (const WorkChunk<QVector<ParsedLine>> &_chunk : std::as_const(_chunks)) {
+        for (const ParsedLine &_parsed : _chunk.Result) {
+            if (_parsed.Segments.isEmpty()) {
+                continue;
+            }
+
+            int _shared = 0;                              // Length of prefix shared with previous path
+            while (_shared < _parsed.Segments.size() && _shared < _previous.size() &&
+                   _parsed.Segments.at(_shared) == _previous.at(_shared)) {
+                _shared++;
+            }
+            _chain.resize(_shared);
+
+            quint32 _current = _shared > 0 ? _chain.last() : RootId;  // Deepest reused node
+            for (int _depth = _shared; _depth < _parsed.Segments.size(); ++_depth) {
+                quint32 _next = FindChild(_current, _parsed.Segments.at(_depth));
+                _current = _next ? _next : AddNode(_current, _parsed.Segments.at(_depth));
+                _chain.append(_current);
+            }
+            _previous = _parsed.Segments;
+
+            if (_parsed.CheckFlag >= 0) {
+                _checkFlags.append(qMakePair(_current, _parsed.CheckFlag == 1));
+            }
+        }
+    }
+
+    QVector<QPair<int, Qt::CheckState>> _states;          // Explicit states as positions
+    _states.reserve(_checkFlags.size());
+    for (const QPair<quint32, bool> &_flag : std::as_const(_checkFlags)) {
+        _states.append(qMakePair(GetPosition(_flag.first), _flag.second ? Qt::Checked : Qt::Unchecked));
+    }
+    Nodes.SetCheckStates(_states);                        // Later lines override earlier ones, one pass for all parents
+
+    return true;
+}
+
+bool A_TreeStore::SavePathFile(const QString &filePath, const QString &separator) const
+{
+    /**
+     * Writes leaf paths, formatting chunks of leaves on worker threads
+     * @return True if written
+     */
+
+    QVector<int> _leaves;                                 // Leaf positions in pre-order
+    Nodes.VisitPreOrder([this, &_leaves](int position, int) {
+        if (Nodes.GetFirstChild(position) == NodeStore::NoNode) {
+            _leaves.append(position);
+        }
+    });
+
+    QVector<WorkChunk<QByteArray>> _chunks = MakeChunks<QByteArray>(_leaves.size());
+    QtConcurrent::blockingMap(_chunks, [this, &_leaves, &separator](WorkChunk<QByteArray> &chunk) {
+        for (int _index = chunk.Begin; _index < chunk.End; ++_index) {
+            const int _position = _leaves.at(_index);
+            chunk.Result += GetPathAt(_position, separator).toUtf8();
+            if (Nodes.GetCheckState(_position) == Qt::Checked) {
+                chunk.Result += "\t1";
+            }
+            chunk.Result += '\n';
+        }
+    });
+
+    QSaveFile _file(filePath);                            // Output replaced only when complete
+    if (!_file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    for (const WorkChunk<QByteArray> &_chunk : std::as_const(_chunks)) {
+        _file.write(_chunk.Result);
+    }
+
+    return _file.commit();
+}
+
+bool A_TreeStore::LoadJournal(const QString &directoryPath)
+{
+    /**
+     * Rebuilds the tree of an A_Tree journal with the same identifiers
+     * Parents in the snapshot aggregate their children, so only leaf states are applied,
+     * with one recalculation of all parents
+     * @return True if the directory exists
+     */
+
+    QVector<A_TreeJournal::SnapshotNode> _snapshotNodes;  // Recovered snapshot
+    QVector<A_TreeJournal::Record> _records;              // Records after the snapshot
+    quint32 _nextNodeId = 1;
+    if (!A_TreeJournal::Load(directoryPath, &_snapshotNodes, &_nextNodeId, &_records)) {
+        return false;
+    }
+
+    Clear();
+    QVector<QPair<quint32, Qt::CheckState>> _snapshotStates;  // Recorded state per added node
+    _snapshotStates.reserve(_snapshotNodes.size());
+    for (const A_TreeJournal::SnapshotNode &_node : std::as_const(_snapshotNodes)) {
+        quint32 _id = AddNode(_node.ParentId, _node.Text, -1, _node.NodeId);
+        if (_id) {
+            _snapshotStates.append(qMakePair(_id, Qt::CheckState(_node.CheckState)));
+        }
+    }
+    QVector<QPair<int, Qt::CheckState>> _leafStates;      // States of snapshot leaves
+    for (const QPair<quint32, Qt::CheckState> &_state : std::as_const(_snapshotStates)) {
+        const int _position = GetPosition(_state.first);
+        if (Nodes.GetFirstChild(_position) == NodeStore::NoNode) {
+            _leafStates.append(qMakePair(_position, _state.second));
+        }
+    }
+    Nodes.SetCheckStates(_leafStates);
+    Nodes.SetNextId(_nextNodeId);                         // Keep identifiers of deleted nodes unused
+
+    for (const A_TreeJournal::Record &_record : std::as_const(_records)) {
+        ApplyJournalRecord(_record);
+    }
+
+    return true;
+}
+
+int A_TreeStore::GetPosition(quint32 id) const
+{
+    /**
+     * Looks the identifier up in the node store's index
+     * @return Position
+     */
+
+    return id == RootId ? NodeStore::NoNode : Nodes.FindById(id);
+}
+
+quint32 A_TreeStore::GetId(int position) const
+{
+    /**
+     * Maps the "no node" position to the invisible root
+     * @return Identifier
+     */
+
+    return position == NodeStore::NoNode ? RootId : Nodes.GetId(position);
+}
+
+QString A_TreeStore::GetPathAt(int position, const QString &separator) const
+{
+    /**
+     * Walks parents up to the root and joins their texts
+     * @return Path from root item to node
+     */
+
+    QStringList _segments;                                // Texts from node up to root
+    for (int _current = position; _current != NodeStore::NoNode; _current = Nodes.GetParent(_current)) {
+        _segments.prepend(Nodes.GetText(_current));
+    }
+
+    return _segments.join(separator);
+}
+
+QVector<int> A_TreeStore::GetPreOrderPositions() const
+{
+    /**
+     * Collects the node store's pre-order walk
+     * @return Positions in pre-order
+     */
+
+    QVector<int> _order;                                  // Visited positions
+    _order.reserve(Nodes.GetNodeCount());
+    Nodes.VisitPreOrder([&_order](int position, int) {
+        _order.append(position);
+    });
+
+    return _order;
+}
+
+void A_TreeStore::IndexChild(quint32 id)
+{
+    /**
+     * Files a node under (parent, text) if no earlier sibling holds the entry
+     */
+
+    QPair<quint32, QString> _key(GetParent(id), GetText(id));  // Index entry for lookups by text
+    if (!ChildLookup.contains(_key)) {
+        ChildLookup.insert(_key, id);
+    }
+}
+
+void A_TreeStore::UnindexChild(quint32 parentId, const QString &text, quint32 id)
+{
+    /**
+     * Drops a node's index entry, pointing it to another sibling with the same text if any
+     */
+
+    QPair<quint32, QString> _key(parentId, text);         // Entry of this node
+    if (ChildLookup.value(_key, 0) != id) {
+        return;                                           // Entry belongs to another sibling
+    }
+
+    for (int _sibling = Nodes.GetFirstChild(GetPosition(parentId)); _sibling != NodeStore::NoNode;
+         _sibling = Nodes.GetNextSibling(_sibling)) {
+        if (Nodes.GetId(_sibling) != id && Nodes.GetText(_sibling) == text) {
+            ChildLookup.insert(_key, Nodes.GetId(_sibling));  // Promote duplicate
+            return;
+        }
+    }
+    ChildLookup.remove(_key);
+}
+
+void A_TreeStore::UnindexDescendants(quint32 id)
+{
+    /**
+     * Removes the entries held by nodes below a subtree root; whole sibling lists go,
+     * so no sibling is promoted
+     */
+
+    QVector<int> _pending;                                // Containers still to visit
+    _pending.append(GetPosition(id));
+    while (!_pending.isEmpty()) {
+        const int _container = _pending.takeLast();
+        const quint32 _containerId = Nodes.GetId(_container);
+        for (int _child = Nodes.GetFirstChild(_container); _child != NodeStore::NoNode; _child = Nodes.GetNextSibling(_child)) {
+            QPair<quint32, QString> _key(_containerId, Nodes.GetText(_child));
+            if (ChildLookup.value(_key, 0) == Nodes.GetId(_child)) {
+                ChildLookup.remove(_key);
+            }
+            _pending.append(_child);
+        }
+    }
+}
+
+void A_TreeStore::RebuildChildLookup()
+{
+    /**
+     * Indexes every node under (parent, text), first sibling wins
+     */
+
+    ChildLookup.clear();
+    ChildLookup.reserve(Nodes.GetNodeCount());
+    Nodes.VisitPreOrder([this](int position, int) {
+        QPair<quint32, QString> _key(GetId(Nodes.GetParent(position)), Nodes.GetText(position));
+        if (!ChildLookup.contains(_key)) {
+            ChildLookup.insert(_key, Nodes.GetId(position));
+        }
+    });
+}
+
+void A_TreeStore::ApplyJournalRecord(const A_TreeJournal::Record &record)
+{
+    /**
+     * Re-applies one recorded mutation with A_Tree's semantics
+     */
+
+    switch (record.Type) {
+    case A_TreeJournal::AddNode: {
+        quint32 _id = AddNode(record.ParentId, record.Text, record.Index, record.NodeId);
+        Q_UNUSED(_id);
+        break;
+    }
+    case A_TreeJournal::RemoveNode:
+        RemoveSubtree(record.NodeId);
+        break;
+    case A_TreeJournal::SetText:
+        SetText(record.NodeId, record.Text);
+        break;
+    case A_TreeJournal::SetCheckState:
+        SetCheckState(record.NodeId, Qt::CheckState(record.CheckState));
+        break;
+    case A_TreeJournal::MoveNode:
+        MoveNode(record.NodeId, record.ParentId, record.Index);
+        break;
+    case A_TreeJournal::SetChildOrder:
+        SetChildOrder(record.ParentId, record.ChildOrder);
+        break;
+    case A_TreeJournal::ClearAll:
+        Clear();
+        break;
+    case A_TreeJournal::SetExpanded:
+    case A_TreeJournal::SetSortOrder:
+    case A_TreeJournal::SetTreeSortOrder:
+    case A_TreeJournal::ClearSortOrder:
+        break;                                            // View state - not part of the store
+    }
+}
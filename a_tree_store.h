@@ -0,0 +1,285 @@
+#ifndef A_TREE_STORE_H
+#define A_TREE_STORE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
+#include "a_tree_journal.h"
+#include "a_tree_node_store.h"
+
+class A_TreeStore
+{
+public:
+    /**
+     * @brief Identifier of the invisible root node - parent of all root items
+     */
+    static constexpr quint32 RootId = 0;
+
+    /**
+     * @brief Constructor for an empty A_TreeStore
+     */
+    A_TreeStore();
+
+    /**
+     * @brief Removes all nodes
+     */
+    void Clear();
+
+    /**
+     * @brief Gets the number of nodes, excluding the invisible root
+     * @return Live node count
+     */
+    int GetNodeCount() const;
+
+    /**
+     * @brief Gets one past the largest identifier ever assigned
+     * @return Identifier bound
+     */
+    quint32 GetIdBound() const;
+
+    /**
+     * @brief Gets whether an identifier refers to a live node
+     * @param id Node identifier
+     * @return True for live nodes and the invisible root
+     */
+    bool IsValid(quint32 id) const;
+
+    /**
+     * @brief Gets the parent of a node
+     * @param id Node identifier - must be valid
+     * @return Parent identifier - RootId for root items
+     */
+    quint32 GetParent(quint32 id) const;
+
+    /**
+     * @brief Gets the text of a node
+     * @param id Node identifier - must be valid
+     * @return Node text
+     */
+    QString GetText(quint32 id) const;
+
+    /**
+     * @brief Gets the check state of a node
+     * @param id Node identifier - must be valid
+     * @return Check state
+     */
+    Qt::CheckState GetCheckState(quint32 id) const;
+
+    /**
+     * @brief Gets the children of a node in order
+     * @param id Node identifier - must be valid, RootId lists root items
+     * @return Child identifiers
+     */
+    QVector<quint32> GetChildren(quint32 id) const;
+
+    /**
+     * @brief Builds the path from root item to a node
+     * @param id Node identifier - must be valid
+     * @param separator Separator placed between path segments
+     * @return Joined node texts
+     */
+    QString GetPath(quint32 id, const QString &separator = "/") const;
+
+    /**
+     * @brief Gets all nodes in pre-order
+     * @return Node identifiers, parents before children, siblings in order
+     */
+    QVector<quint32> GetPreOrder() const;
+
+    /**
+     * @brief Adds a node under a parent - the parent's check state is recalculated like in A_Tree
+     * @param parentId Parent identifier - RootId for root level
+     * @param text Node text - should not be empty
+     * @param index Child position - -1 appends
+     * @param nodeId Identifier to assign (journal replay) - 0 assigns the next free identifier
+     * @return New node identifier - 0 if the parent is invalid or the identifier is in use
+     */
+    quint32 AddNode(quint32 parentId, const QString &text, int index = -1, quint32 nodeId = 0);
+
+    /**
+     * @brief Finds a child by text through the (parent, text) index
+     * @param parentId Parent identifier
+     * @param text Child text
+     * @return Child identifier - 0 if the parent has no child with this text
+     */
+    quint32 FindChild(quint32 parentId, const QString &text) const;
+
+    /**
+     * @brief Adds a path, creating missing nodes
+     * @param segments Path segments from root item
+     * @return Identifier of the last segment's node - 0 if segments is empty
+     */
+    quint32 AddPath(const QStringList &segments);
+
+    /**
+     * @brief Removes a node with its subtree
+     * @param id Node identifier
+     */
+    void RemoveSubtree(quint32 id);
+
+    /**
+     * @brief Changes the text of a node
+     * @param id Node identifier
+     * @param text New text
+     */
+    void SetText(quint32 id, const QString &text);
+
+    /**
+     * @brief Moves a node with its subtree under a new parent
+     * @param id Node identifier
+     * @param parentId New parent identifier
+     * @param index Child position - -1 appends
+     * @return True if moved - false if invalid or parentId is inside the subtree
+     */
+    bool MoveNode(quint32 id, quint32 parentId, int index = -1);
+
+    /**
+     * @brief Reorders the children of a node
+     * @param parentId Parent identifier
+     * @param order Child identifiers in new order - unlisted children follow in their current order
+     */
+    void SetChildOrder(quint32 parentId, const QVector<quint32> &order);
+
+    /**
+     * @brief Sets a check state with the same propagation as A_Tree
+     * Checked and unchecked states are copied to the subtree, ancestors are recalculated
+     * @param id Node identifier
+     * @param state New check state
+     */
+    void SetCheckState(quint32 id, Qt::CheckState state);
+
+    /**
+     * @brief Sets the check state of many nodes with one recalculation of all ancestors
+     * @param ids Node identifiers - their subtrees receive the state too
+     * @param state Checked or Unchecked
+     */
+    void SetCheckStates(const QVector<quint32> &ids, Qt::CheckState state);
+
+    /**
+     * @brief Finds nodes whose path matches a pattern, testing nodes on all cores
+     * @param pattern Compiled pattern matched against the full path
+     * @param separator Separator used to build paths
+     * @return Matching identifiers in pre-order
+     */
+    QVector<quint32> FindMatching(const QRegularExpression &pattern, const QString &separator = "/") const;
+
+    /**
+     * @brief Compiles a path glob - "*" and "?" stay within one segment, "**" spans segments
+     * @param glob Glob pattern
+     * @param separator Path separator
+     * @return Anchored regular expression
+     */
+    static QRegularExpression CompileGlob(const QString &glob, const QString &separator = "/");
+
+    /**
+     * @brief Removes every unchecked node with its subtree
+     * @return Number of nodes removed
+     */
+    int Prune();
+
+    /**
+     * @brief Merges siblings with identical text, recursively merging their children
+     * A merged leaf is checked if any of its duplicates was checked
+     * @return Number of nodes merged away
+     */
+    int Dedupe();
+
+    /**
+     * @brief Loads paths from a text file - one path per line, optional tab and 1/0 check flag
+     * Lines are parsed on all cores; consecutive paths reuse their common parent prefix
+     * @param filePath Input file
+     * @param separator Path separator
+     * @return True if the file was read
+     */
+    bool LoadPathFile(const QString &filePath, const QString &separator = "/");
+
+    /**
+     * @brief Writes the path of every leaf, followed by a tab and 1 for checked leaves
+     * Lines are formatted on all cores
+     * @param filePath Output file - replaced atomically
+     * @param separator Path separator
+     * @return True if the file was written
+     */
+    bool SavePathFile(const QString &filePath, const QString &separator = "/") const;
+
+    /**
+     * @brief Loads the tree persisted by A_Tree's journal without modifying the journal
+     * @param directoryPath Journal directory
+     * @return True if the directory exists
+     */
+    bool LoadJournal(const QString &directoryPath);
+
+private:
+    /**
+     * @brief Node store configuration - tri-state checks, editable texts and stable identifiers
+     */
+    using NodeStore = A_TreeNodeStore<A_TreeNodePolicy::TriStateCheck, A_TreeNodePolicy::EditableText,
+                                      A_TreeNodePolicy::NoAttributes, A_TreeNodePolicy::IdIndex>;
+
+    /**
+     * @brief Converts an identifier to a node store position
+     * @param id Node identifier
+     * @return Position - NoNode for RootId and unknown identifiers
+     */
+    int GetPosition(quint32 id) const;
+
+    /**
+     * @brief Converts a node store position to an identifier
+     * @param position Position - NoNode for the invisible root
+     * @return Node identifier
+     */
+    quint32 GetId(int position) const;
+
+    /**
+     * @brief Builds the path from root item to a node by position
+     * @param position Node position
+     * @param separator Separator placed between path segments
+     * @return Joined node texts
+     */
+    QString GetPathAt(int position, const QString &separator) const;
+
+    /**
+     * @brief Gets all node positions in pre-order
+     * @return Positions, parents before children, siblings in order
+     */
+    QVector<int> GetPreOrderPositions() const;
+
+    /**
+     * @brief Adds an index entry unless a sibling with the same text already has one
+     * @param id Node identifier
+     */
+    void IndexChild(quint32 id);
+
+    /**
+     * @brief Removes a node's (parent, text) entry, promoting a sibling with the same text
+     * @param parentId Parent the entry is filed under
+     * @param text Text the entry is filed under
+     * @param id Node identifier
+     */
+    void UnindexChild(quint32 parentId, const QString &text, quint32 id);
+
+    /**
+     * @brief Drops the index entries of every descendant of a node
+     * @param id Subtree root identifier
+     */
+    void UnindexDescendants(quint32 id);
+
+    /**
+     * @brief Rebuilds the (parent, text) index from scratch
+     */
+    void RebuildChildLookup();
+
+    /**
+     * @brief Re-applies one journal record
+     * @param record Recorded mutation
+     */
+    void ApplyJournalRecord(const A_TreeJournal::Record &record);
+
+    NodeStore Nodes;                                     // Nodes, links and check states
+    QHash<QPair<quint32, QString>, quint32> ChildLookup; // First child per (parent, text)
+};
+
+#endif // A_TREE_STORE_H
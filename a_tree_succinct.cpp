@@ -0,0 +1,331 @@
+#include "a_tree_succinct.h"
+
+namespace {
+const int BucketSize = 16;                                // Texts per front-coding bucket - the first is stored whole
+}
+
+A_TreeSuccinct::A_TreeSuccinct()
+    : NodeCount(0)                  // Node count - starts at 0, nothing encoded yet
+    , ExpectedChildren(0)           // Announced children - starts at 0, no root items yet
+    , IsMalformed(false)            // Build error flag - starts false, nothing added yet
+{
+}
+
+void A_TreeSuccinct::BeginBuild(int rootCount)
+{
+    /**
+     * Drops the previous encoding and writes the super root's run - one 1 per root item
+     */
+
+    Louds.Clear();
+    Strings.clear();
+    BucketOffsets.clear();
+    PreviousText.clear();
+    CheckedBits.Clear();
+    PartialBits.Clear();
+    NodeCount = 0;
+    ExpectedChildren = qMax(0, rootCount);
+    IsMalformed = false;
+
+    for (int _rootIndex = 0; _rootIndex < rootCount; ++_rootIndex) {
+        Louds.Append(true);
+    }
+    Louds.Append(false);                                  // End of the super root
+}
+
+void A_TreeSuccinct::AddNode(const QString &text, int childCount, Qt::CheckState state)
+{
+    /**
+     * Writes the node's child run and its text; consecutive texts share their common prefix
+     */
+
+    if (ExpectedChildren <= NodeCount) {
+        IsMalformed = true;                               // No parent announced this node
+    }
+
+    for (int _childIndex = 0; _childIndex < childCount; ++_childIndex) {
+        Louds.Append(true);
+    }
+    Louds.Append(false);
+    ExpectedChildren += qMax(0, childCount);
+
+    const QByteArray _text = text.toUtf8();               // Encoded text
+    if (NodeCount % BucketSize == 0) {
+        BucketOffsets.append(Strings.size());
+        AppendVarint(quint32(_text.size()));
+        Strings += _text;
+    } else {
+        const int _limit = qMin(_text.size(), PreviousText.size());  // Longest possible shared prefix
+        int _prefix = 0;                                  // Bytes shared with the previous text
+        while (_prefix < _limit && _text.at(_prefix) == PreviousText.at(_prefix)) {
+            _prefix++;
+        }
+        AppendVarint(quint32(_prefix));
+        AppendVarint(quint32(_text.size() - _prefix));
+        Strings.append(_text.constData() + _prefix, _text.size() - _prefix);
+    }
+    PreviousText = _text;
+
+    CheckedBits.Append(state == Qt::Checked);
+    PartialBits.Append(false);                            // Recalculated by EndBuild
+    NodeCount++;
+}
+
+bool A_TreeSuccinct::EndBuild()
+{
+    /**
+     * Walks the child runs backwards - children have higher numbers than their parent,
+     * so every parent is recalculated after its children
+     * @return True if the tree is complete
+     */
+
+    PreviousText.clear();
+    Strings.squeeze();
+    BucketOffsets.squeeze();
+    Louds.BuildRankIndex();
+    if (IsMalformed || ExpectedChildren != NodeCount) {
+        return false;
+    }
+
+    qint64 _position = Louds.GetSize() - 1;               // Zero ending the current run
+    int _childEnd = NodeCount;                            // One past the current run's last child
+    for (int _owner = NodeCount; _owner >= 0; --_owner) { // LOUDS number - 0 is the super root
+        qint64 _start = _position;                        // First bit of the run
+        while (_start > 0 && Louds.Test(_start - 1)) {
+            _start--;
+        }
+        const int _degree = int(_position - _start);      // Children of this run
+        _childEnd -= _degree;
+        if (_owner > 0 && _degree > 0) {
+            const Qt::CheckState _state = CalculateRangeState(_childEnd, _degree);
+            CheckedBits.Set(_owner - 1, _state == Qt::Checked);
+            PartialBits.Set(_owner - 1, _state == Qt::PartiallyChecked);
+        }
+        _position = _start - 1;
+    }
+
+    return true;
+}
+
+int A_TreeSuccinct::GetNodeCount() const
+{
+    /**
+     * Gets the node count
+     * @return Count
+     */
+
+    return NodeCount;
+}
+
+int A_TreeSuccinct::GetChildCount(int node) const
+{
+    /**
+     * Measures the child run up to its terminating 0
+     * @return Child count
+     */
+
+    return int(Louds.Select0(qint64(node) + 2) - GetRunStart(node));
+}
+
+int A_TreeSuccinct::GetFirstChild(int node) const
+{
+    /**
+     * Every 1 before the run belongs to an earlier node, so their count is the first child's number
+     * @return First child number
+     */
+
+    const qint64 _start = GetRunStart(node);              // First bit of the run
+    if (!Louds.Test(_start)) {
+        return NoNode;                                    // Empty run
+    }
+    return int(Louds.Rank1(_start));
+}
+
+int A_TreeSuccinct::GetParent(int node) const
+{
+    /**
+     * The node's 1 sits in its parent's run; the runs completed before it number the parent
+     * @return Parent number
+     */
+
+    const qint64 _bit = Louds.Select1(qint64(node) + 1);  // The node's 1
+    return int(Louds.Rank0(_bit)) - 1;                    // Super root owns the first run
+}
+
+QString A_TreeSuccinct::GetText(int node) const
+{
+    /**
+     * Starts from the bucket's whole text and applies the prefix-suffix pairs up to the node
+     * @return Node text
+     */
+
+    int _position = BucketOffsets.at(node / BucketSize);  // Read position in Strings
+    const int _length = int(ReadVarint(&_position));
+    QByteArray _text(Strings.constData() + _position, _length);  // Text being rebuilt
+    _position += _length;
+    for (int _index = 1; _index <= node % BucketSize; ++_index) {
+        const int _prefix = int(ReadVarint(&_position));
+        const int _suffix = int(ReadVarint(&_position));
+        _text.truncate(_prefix);
+        _text.append(Strings.constData() + _position, _suffix);
+        _position += _suffix;
+    }
+
+    return QString::fromUtf8(_text);
+}
+
+Qt::CheckState A_TreeSuccinct::GetCheckState(int node) const
+{
+    /**
+     * Reads both overlay bits
+     * @return Check state
+     */
+
+    if (CheckedBits.Test(node)) {
+        return Qt::Checked;
+    }
+    return PartialBits.Test(node) ? Qt::PartiallyChecked : Qt::Unchecked;
+}
+
+void A_TreeSuccinct::SetCheckState(int node, Qt::CheckState state)
+{
+    /**
+     * A single node is a range of one
+     */
+
+    SetRangeCheckState(node, 1, state);
+}
+
+void A_TreeSuccinct::SetRangeCheckState(int first, int count, Qt::CheckState state)
+{
+    /**
+     * Children of a consecutive node range are the 1s between the range's first run start
+     * and last run end, so each level is found with two selects and written with two fills
+     */
+
+    if (count <= 0) {
+        return;
+    }
+
+    int _begin = first;                                   // First node of the current level
+    int _end = first + count;                             // One past the last node of the current level
+    while (_begin < _end) {
+        CheckedBits.Fill(_begin, _end, state == Qt::Checked);
+        PartialBits.Fill(_begin, _end, false);
+        const qint64 _runsBegin = GetRunStart(_begin);    // First child bit of the level
+        const qint64 _runsEnd = Louds.Select0(qint64(_end) + 1);  // Zero ending the level's last run
+        _begin = int(Louds.Rank1(_runsBegin));
+        _end = int(Louds.Rank1(_runsEnd));
+    }
+
+    UpdateAncestors(GetParent(first));
+}
+
+Qt::CheckState A_TreeSuccinct::GetRangeCheckState(int first, int count) const
+{
+    /**
+     * Two range counts over the overlay
+     * @return Aggregated state
+     */
+
+    return CalculateRangeState(first, count);
+}
+
+A_TreeSuccinct::MemoryUsage A_TreeSuccinct::GetMemoryUsage() const
+{
+    /**
+     * Collects the capacities of each part
+     * @return Byte counts
+     */
+
+    MemoryUsage _usage;                                   // Usage being collected
+    _usage.StructureBytes = Louds.GetMemoryBytes();
+    _usage.TextBytes = qint64(Strings.capacity()) + qint64(BucketOffsets.capacity()) * qint64(sizeof(int));
+    _usage.CheckBytes = CheckedBits.GetMemoryBytes() + PartialBits.GetMemoryBytes();
+    return _usage;
+}
+
+qint64 A_TreeSuccinct::GetRunStart(int node) const
+{
+    /**
+     * The run of LOUDS node v starts after the v-th 0; the super root's run starts at 0
+     * @return Bit position
+     */
+
+    return node == NoNode ? 0 : Louds.Select0(qint64(node) + 1) + 1;
+}
+
+void A_TreeSuccinct::UpdateAncestors(int node)
+{
+    /**
+     * Walks up while states change
+     */
+
+    for (int _parent = node; _parent != NoNode; _parent = GetParent(_parent)) {
+        const Qt::CheckState _state = CalculateCheckState(_parent);
+        if (_state == GetCheckState(_parent)) {
+            break;                                        // Ancestors above are unchanged too
+        }
+        CheckedBits.Set(_parent, _state == Qt::Checked);
+        PartialBits.Set(_parent, _state == Qt::PartiallyChecked);
+    }
+}
+
+Qt::CheckState A_TreeSuccinct::CalculateCheckState(int node) const
+{
+    /**
+     * Locates the children's range
+     * @return Aggregated state
+     */
+
+    return CalculateRangeState(GetFirstChild(node), GetChildCount(node));
+}
+
+Qt::CheckState A_TreeSuccinct::CalculateRangeState(int first, int count) const
+{
+    /**
+     * Children are consecutive, so their states are two range counts over the overlay
+     * @return Aggregated state
+     */
+
+    const qint64 _checked = CheckedBits.Count(first, qint64(first) + count);  // Checked children
+    if (_checked == count) {
+        return Qt::Checked;
+    }
+    if (_checked == 0 && PartialBits.Count(first, qint64(first) + count) == 0) {
+        return Qt::Unchecked;
+    }
+    return Qt::PartiallyChecked;
+}
+
+void A_TreeSuccinct::AppendVarint(quint32 value)
+{
+    /**
+     * Writes 7 bits per byte, high bit set on all but the last byte
+     */
+
+    while (value >= 0x80) {
+        Strings.append(char(0x80 | (value & 0x7F)));
+        value >>= 7;
+    }
+    Strings.append(char(value));
+}
+
+quint32 A_TreeSuccinct::ReadVarint(int *position) const
+{
+    /**
+     * Reads bytes until one without the high bit
+     * @return Value
+     */
+
+    quint32 _value = 0;                                   // Value being assembled
+    int _shift = 0;                                       // Bit offset of the next 7 bits
+    for (;;) {
+        const quint8 _byte = quint8(Strings.at((*position)++));
+        _value |= quint32(_byte & 0x7F) << _shift;
+        if (!(_byte & 0x80)) {
+            return _value;
+        }
+        _shift += 7;
+    }
+}
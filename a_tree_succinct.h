@@ -0,0 +1,179 @@
+#ifndef A_TREE_SUCCINCT_H
+#define A_TREE_SUCCINCT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "a_tree_bit_vector.h"
+
+class A_TreeSuccinct
+{
+public:
+    /**
+     * @brief Position meaning "no node" - parent of root items
+     */
+    static constexpr int NoNode = -1;
+
+    /**
+     * @brief Byte counts of the encoding
+     */
+    struct MemoryUsage
+    {
+        qint64 StructureBytes = 0;   // LOUDS bits with rank index
+        qint64 TextBytes = 0;        // Front-coded string table with bucket offsets
+        qint64 CheckBytes = 0;       // Check overlay bitmaps
+    };
+
+    /**
+     * @brief Constructor for an empty tree
+     */
+    A_TreeSuccinct();
+
+    /**
+     * @brief Starts encoding a new tree - nodes follow in breadth-first order
+     * @param rootCount Number of root items
+     */
+    void BeginBuild(int rootCount);
+
+    /**
+     * @brief Appends the next node in breadth-first order
+     * @param text Node text
+     * @param childCount Number of children - they are appended later in the same order
+     * @param state Check state - partial states are recalculated by EndBuild
+     */
+    void AddNode(const QString &text, int childCount, Qt::CheckState state);
+
+    /**
+     * @brief Completes the encoding - builds rank indexes and recalculates parent check states
+     * @return False if the added nodes do not match the announced child counts
+     */
+    bool EndBuild();
+
+    /**
+     * @brief Gets the number of nodes
+     * @return Node count
+     */
+    int GetNodeCount() const;
+
+    /**
+     * @brief Gets the number of children of a node
+     * @param node Node number - NoNode for root items
+     * @return Child count
+     */
+    int GetChildCount(int node) const;
+
+    /**
+     * @brief Gets the first child of a node - siblings have consecutive numbers
+     * @param node Node number - NoNode for root items
+     * @return First child number - NoNode for leaves
+     */
+    int GetFirstChild(int node) const;
+
+    /**
+     * @brief Gets the parent of a node
+     * @param node Node number
+     * @return Parent number - NoNode for root items
+     */
+    int GetParent(int node) const;
+
+    /**
+     * @brief Decodes the text of a node - at most one bucket of the string table is read
+     * @param node Node number
+     * @return Node text
+     */
+    QString GetText(int node) const;
+
+    /**
+     * @brief Gets the check state of a node from the overlay
+     * @param node Node number
+     * @return Check state
+     */
+    Qt::CheckState GetCheckState(int node) const;
+
+    /**
+     * @brief Sets a check state with A_Tree's propagation
+     * Descendants are set level by level - each level of a subtree is one consecutive node range -
+     * and ancestors are recalculated up to the first unchanged one
+     * @param node Node number
+     * @param state Checked or Unchecked
+     */
+    void SetCheckState(int node, Qt::CheckState state);
+
+    /**
+     * @brief Sets a check state on consecutive siblings with A_Tree's propagation
+     * Same as SetCheckState on every node of the range, but each level below is filled once and the
+     * common parent is recalculated once
+     * @param first First node number
+     * @param count Number of siblings - the range must not cross into another parent's children
+     * @param state Checked or Unchecked
+     */
+    void SetRangeCheckState(int first, int count, Qt::CheckState state);
+
+    /**
+     * @brief Gets the state a parent of consecutive siblings would have
+     * @param first First node number
+     * @param count Number of siblings - at least 1
+     * @return Aggregated state by A_Tree's tri-state rules
+     */
+    Qt::CheckState GetRangeCheckState(int first, int count) const;
+
+    /**
+     * @brief Gets the bytes of each part of the encoding
+     * @return Byte counts
+     */
+    MemoryUsage GetMemoryUsage() const;
+
+private:
+    /**
+     * @brief Gets the LOUDS position of a node's child run
+     * @param node Node number - NoNode for root items
+     * @return Position of the first child bit - the run ends at the next 0
+     */
+    qint64 GetRunStart(int node) const;
+
+    /**
+     * @brief Recalculates a parent and its ancestors from their children
+     * @param node First parent - stops at the root or once a state is unchanged
+     */
+    void UpdateAncestors(int node);
+
+    /**
+     * @brief Calculates a parent's state from its children with two range counts
+     * @param node Parent number - must have children
+     * @return Aggregated state
+     */
+    Qt::CheckState CalculateCheckState(int node) const;
+
+    /**
+     * @brief Calculates a parent's state from a consecutive range of children
+     * @param first First child number
+     * @param count Number of children - at least 1
+     * @return Aggregated state
+     */
+    Qt::CheckState CalculateRangeState(int first, int count) const;
+
+    /**
+     * @brief Appends a variable-length unsigned integer to the string table
+     * @param value Value
+     */
+    void AppendVarint(quint32 value);
+
+    /**
+     * @brief Reads a variable-length unsigned integer
+     * @param position Read position - advanced past the value
+     * @return Value
+     */
+    quint32 ReadVarint(int *position) const;
+
+    A_TreeBitVector Louds;           // Child runs in breadth-first order: 1 per child, 0 ends a node - super root first
+    QByteArray Strings;              // Front-coded UTF-8 texts - full text at bucket start, else shared prefix length and suffix
+    QVector<int> BucketOffsets;      // Start of every bucket in Strings
+    QByteArray PreviousText;         // Previous text while building - prefix source
+    A_TreeBitVector CheckedBits;     // Check overlay - set for checked nodes
+    A_TreeBitVector PartialBits;     // Check overlay - set for partially checked nodes
+    int NodeCount;                   // Nodes added
+    qint64 ExpectedChildren;         // Children announced by the super root and added nodes
+    bool IsMalformed;                // Build error flag - true if a node was added before its parent announced it
+};
+
+#endif // A_TREE_SUCCINCT_H
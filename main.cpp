@@ -1,4 +1,6 @@
 #include <QApplication>
+#include <QCommandLineParser>
+#include "a_startup_timings.h"
 #include "mainwindow.h"
 
 /**
@@ -9,10 +11,51 @@
  */
 int main(int argc, char *argv[])
 {
+    A_StartupTimings::Start();     // Startup clock - measures from before the application exists
     QApplication _app(argc, argv); // Qt application instance - manages the GUI application's control flow and main settings
 
+    // Shared tree options - one process publishes, any number of viewers attach
+    QCommandLineParser _parser; // Command line parser - reads the shared tree options
+    QCommandLineOption _shareOption("share", "Publish the tree in shared memory under <key>.", "key");
+    QCommandLineOption _attachOption("attach", "View the tree published under <key> read-only.", "key");
+    QCommandLineOption _serveOption("serve", "Serve queries and batched changes on local socket <name>.", "name");
+    QCommandLineOption _timingsOption("startup-timings", "Print the duration of each startup phase to stderr.");
+    _parser.addHelpOption();
+    _parser.addOption(_shareOption);
+    _parser.addOption(_attachOption);
+    _parser.addOption(_serveOption);
+    _parser.addOption(_timingsOption);
+    _parser.process(_app);
+    A_StartupTimings::SetEnabled(_parser.isSet(_timingsOption));
+    A_StartupTimings::Mark("application");
+
     MainWindow _window; // Main application window instance - primary window containing all UI elements
+    A_StartupTimings::Mark("window created");
+    A_StartupTimings::WatchFirstPaint(&_window);
+
+    // A viewer shows the writer's tree right away; otherwise the previous session's journal is read
+    // before the window is shown, its items are built after the first paint, and sharing and serving
+    // start once the restored tree is complete
+    auto _connectTree = [&_window, &_parser, &_shareOption, &_serveOption]() {
+        if (_parser.isSet(_shareOption)) {
+            _window.ConnectSharedTree(_parser.value(_shareOption), true);
+        }
+        if (_parser.isSet(_serveOption)) {
+            _window.StartIpcServer(_parser.value(_serveOption));
+        }
+    };
+    if (_parser.isSet(_attachOption)) {
+        _window.ConnectSharedTree(_parser.value(_attachOption), false);
+        if (_parser.isSet(_serveOption)) {
+            _window.StartIpcServer(_parser.value(_serveOption));
+        }
+    } else {
+        QObject::connect(&_window, &MainWindow::JournalRestored, &_window, _connectTree);
+        _window.RestoreJournal();
+        A_StartupTimings::Mark("journal read");
+    }
     _window.show(); // Display the main window on screen
+    A_StartupTimings::Mark("shown");
 
     return _app.exec(); // Start the application event loop and return exit code
 }
@@ -0,0 +1,15 @@
+#include <QCoreApplication>
+#include "a_tree_cli.h"
+
+/**
+ * @brief Headless entry point - processes trees without a display
+ * @param argc Command line argument count
+ * @param argv Command line arguments array
+ * @return Exit code (0 = success, 1 = operation failed, 2 = usage error)
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication _app(argc, argv); // Core application instance - no GUI, needed for Qt file and thread services
+
+    return A_TreeCli().Run(_app.arguments()); // Run the operations once, no event loop needed
+}
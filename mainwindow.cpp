@@ -1,6 +1,36 @@
 #include "mainwindow.h"
+#include "a_startup_timings.h"
 #include <QInputDialog>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QComboBox>
+#include <QDoubleSpinBox>
+#include <QFileDialog>
 #include <QMessageBox>
+#include <QSignalBlocker>
+#include <QStandardPaths>
+#include <climits>
+
+namespace {
+
+/**
+ * @brief Formats a byte count with a binary unit
+ * @param bytes Byte count
+ * @return Text such as "12.4 MiB"
+ */
+QString FormatBytes(qint64 bytes)
+{
+    if (bytes < 1024) {
+        return QString("%1 B").arg(bytes);
+    }
+    if (bytes < 1024 * 1024) {
+        return QString("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 MiB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+} // namespace
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -11,17 +41,30 @@ MainWindow::MainWindow(QWidget *parent)
     , ControlLayout(nullptr)        // Control layout pointer - initialized to null, will organize controls horizontally
     , AddRootButton(nullptr)        // Add root button pointer - initialized to null, will create new root items
     , LoadDemoButton(nullptr)       // Load demo button pointer - initialized to null, will load sample data
+    , GenerateButton(nullptr)       // Generate button pointer - initialized to null, will build synthetic trees
+    , ExportButton(nullptr)         // Export button pointer - initialized to null, will export item paths
+    , CheckRulesButton(nullptr)     // Check rules button pointer - initialized to null, will apply pattern rules
     , ClearAllButton(nullptr)       // Clear all button pointer - initialized to null, will remove all items
+    , CancelJobButton(nullptr)      // Cancel job button pointer - initialized to null, will stop subtree jobs
+    , MemoryButton(nullptr)         // Memory button pointer - initialized to null, will show memory usage
     , TitleLabel(nullptr)           // Title label pointer - initialized to null, will display app title
     , EditModeCheckbox(nullptr)     // Edit mode checkbox pointer - initialized to null, will control edit permissions
+    , CompactModeCheckbox(nullptr)  // Compact mode checkbox pointer - initialized to null, will toggle compact mode
+    , FreezeCheckbox(nullptr)       // Freeze checkbox pointer - initialized to null, will freeze and thaw the tree
+    , PagingCheckbox(nullptr)       // Paging checkbox pointer - initialized to null, will toggle range buckets
+    , FilterEdit(nullptr)           // Filter input pointer - initialized to null, will filter tree items as user types
     , StatusLabel(nullptr)          // Status label pointer - initialized to null, will show operation feedback
     , ControlGroup(nullptr)         // Control group pointer - initialized to null, will group control elements
     , RootItemCounter(1)            // Root item counter - starts at 1, increments with each new root item created
     , IsEditModeEnabled(false)      // Edit mode flag - starts disabled, prevents accidental editing
+    , IpcServer(nullptr)            // Local server pointer - initialized to null, created on request
 {
+    SetApplicationStyle();                                // Before the widgets exist - each is polished once
+    A_StartupTimings::Mark("style");
     SetupUserInterface();
-    SetApplicationStyle();
+    A_StartupTimings::Mark("widgets");
     ConnectSignalsAndSlots();
+    A_StartupTimings::Mark("signals");
 
     // Set window properties
     setWindowTitle("Tree Widget Application");
@@ -63,10 +106,28 @@ void MainWindow::SetupUserInterface()
     EditModeCheckbox = new QCheckBox("Enable Edit Mode", this);  // Edit toggle - controls whether items can be edited
     EditModeCheckbox->setChecked(IsEditModeEnabled);       // Set initial state to match internal flag
 
+    CompactModeCheckbox = new QCheckBox("Compact Mode", this);  // Compact toggle - drops optional per-node state
+    CompactModeCheckbox->setChecked(false);
+
+    FreezeCheckbox = new QCheckBox("Freeze", this);       // Freeze toggle - read-only view without per-item objects
+    FreezeCheckbox->setChecked(false);
+
+    PagingCheckbox = new QCheckBox("Page Wide Parents (frozen only)", this);  // Paging toggle - range buckets in the frozen view
+    PagingCheckbox->setChecked(false);
+    PagingCheckbox->setEnabled(false);                    // Live items are never paged - enabled while frozen
+
+    FilterEdit = new QLineEdit(this);                     // Filter input - narrows visible items as user types
+    FilterEdit->setPlaceholderText("Filter items...");    // Hint text shown while empty
+    FilterEdit->setClearButtonEnabled(true);              // Allow one-click reset of the filter
+
     StatusLabel = new QLabel("Ready", this);              // Status display - shows current operation status
     StatusLabel->setObjectName("statusLabel");            // Set object name for styling
 
     ControlLayout->addWidget(EditModeCheckbox);           // Add edit checkbox to control layout
+    ControlLayout->addWidget(CompactModeCheckbox);        // Add compact checkbox next to edit checkbox
+    ControlLayout->addWidget(FreezeCheckbox);             // Add freeze checkbox next to compact checkbox
+    ControlLayout->addWidget(PagingCheckbox);             // Add paging checkbox next to freeze checkbox
+    ControlLayout->addWidget(FilterEdit);                 // Add filter input next to checkboxes
     ControlLayout->addStretch();                          // Add flexible space to push status to right
     ControlLayout->addWidget(StatusLabel);                // Add status label to control layout
 
@@ -84,13 +145,24 @@ void MainWindow::SetupUserInterface()
     // Create control buttons
     AddRootButton = new QPushButton("Add Root Item", this);      // Add root button - creates new root level items
     LoadDemoButton = new QPushButton("Load Demo Data", this);    // Load demo button - populates with sample data
+    GenerateButton = new QPushButton("Generate...", this);       // Generate button - builds a synthetic tree for load tests
+    ExportButton = new QPushButton("Export...", this);           // Export button - streams item paths to a file
+    CheckRulesButton = new QPushButton("Check Rules...", this);  // Check rules button - bulk check by pattern
     ClearAllButton = new QPushButton("Clear All Items", this);   // Clear button - removes all tree items
+    CancelJobButton = new QPushButton("Cancel", this);           // Cancel button - stops long subtree operations
+    CancelJobButton->setEnabled(false);                   // Nothing to cancel yet
+    MemoryButton = new QPushButton("Memory", this);              // Memory button - reports memory usage of the tree
 
     // Add buttons to layout
     ButtonLayout->addWidget(AddRootButton);
     ButtonLayout->addWidget(LoadDemoButton);
+    ButtonLayout->addWidget(GenerateButton);
+    ButtonLayout->addWidget(ExportButton);
+    ButtonLayout->addWidget(CheckRulesButton);
     ButtonLayout->addWidget(ClearAllButton);
+    ButtonLayout->addWidget(MemoryButton);
     ButtonLayout->addStretch();                           // Add flexible space to left-align buttons
+    ButtonLayout->addWidget(CancelJobButton);             // Right-aligned, next to progress in status
 
     MainLayout->addLayout(ButtonLayout);                  // Add button layout to main layout
 }
@@ -153,6 +225,18 @@ void MainWindow::SetApplicationStyle()
         "    spacing: 5px;"                               // Space between checkbox and text
         "}"
 
+        // Filter input styling - dark field with orange focus accent
+        "QLineEdit {"
+        "    background-color: #2c2c2c;"                  // Match window background
+        "    border: 1px solid #555555;"                  // Simple border like group box
+        "    border-radius: 4px;"                         // Slight rounding
+        "    padding: 4px 6px;"                           // Comfortable text padding
+        "}"
+
+        "QLineEdit:focus {"
+        "    border: 1px solid #FF8C00;"                  // Orange accent while typing
+        "}"
+
         // Button styling - original blue theme
         "QPushButton {"
         "    background-color: #3498db;"                  // Original blue background
@@ -184,14 +268,31 @@ void MainWindow::ConnectSignalsAndSlots()
     // Connect button signals to slots
     connect(AddRootButton, &QPushButton::clicked, this, &MainWindow::OnAddRootButtonClicked);
     connect(LoadDemoButton, &QPushButton::clicked, this, &MainWindow::OnLoadDemoButtonClicked);
+    connect(GenerateButton, &QPushButton::clicked, this, &MainWindow::OnGenerateButtonClicked);
+    connect(ExportButton, &QPushButton::clicked, this, &MainWindow::OnExportButtonClicked);
+    connect(CheckRulesButton, &QPushButton::clicked, this, &MainWindow::OnCheckRulesButtonClicked);
     connect(ClearAllButton, &QPushButton::clicked, this, &MainWindow::OnClearAllButtonClicked);
+    connect(CancelJobButton, &QPushButton::clicked, TreeWidget, &A_Tree::CancelSubtreeJobs);
+    connect(MemoryButton, &QPushButton::clicked, this, &MainWindow::OnMemoryButtonClicked);
 
     // Connect checkbox signal to slot
     connect(EditModeCheckbox, &QCheckBox::toggled, this, &MainWindow::OnEditModeToggled);
+    connect(CompactModeCheckbox, &QCheckBox::toggled, this, &MainWindow::OnCompactModeToggled);
+    connect(FreezeCheckbox, &QCheckBox::toggled, this, &MainWindow::OnFreezeToggled);
+    connect(PagingCheckbox, &QCheckBox::toggled, this, &MainWindow::OnPagingToggled);
 
     // Connect tree widget signals to slots
     connect(TreeWidget, &A_Tree::ItemEdited, this, &MainWindow::OnTreeItemEdited);
     connect(TreeWidget, &A_Tree::ItemDeleted, this, &MainWindow::OnTreeItemDeleted);
+    connect(TreeWidget, &A_Tree::FilterApplied, this, &MainWindow::OnTreeFilterApplied);
+    connect(TreeWidget, &A_Tree::SubtreeJobProgress, this, &MainWindow::OnTreeSubtreeJobProgress);
+    connect(TreeWidget, &A_Tree::SubtreeJobFinished, this, &MainWindow::OnTreeSubtreeJobFinished);
+    connect(TreeWidget, &A_Tree::ExportFinished, this, &MainWindow::OnTreeExportFinished);
+    connect(TreeWidget, &A_Tree::SharedTreeUpdated, this, &MainWindow::OnTreeSharedTreeUpdated);
+    connect(TreeWidget, &A_Tree::JournalRestored, this, &MainWindow::OnTreeJournalRestored);
+
+    // Connect filter input to tree filtering
+    connect(FilterEdit, &QLineEdit::textChanged, this, &MainWindow::OnFilterTextChanged);
 }
 
 void MainWindow::OnAddRootButtonClicked()
@@ -229,6 +330,301 @@ void MainWindow::OnLoadDemoButtonClicked()
     StatusLabel->setText("Demo data loaded successfully"); // Update status message
 }
 
+void MainWindow::OnGenerateButtonClicked()
+{
+    /**
+     * Handles Generate button click event
+     * Shows the generator settings, builds the tree and reports build time
+     */
+
+    QDialog _dialog(this);                                // Settings dialog
+    _dialog.setWindowTitle("Generate Synthetic Tree");
+    QFormLayout *_form = new QFormLayout(&_dialog);       // Label and editor per setting
+
+    QSpinBox *_seedEdit = new QSpinBox(&_dialog);         // Random seed
+    _seedEdit->setRange(0, INT_MAX);
+    _seedEdit->setValue(int(qMin<quint32>(GeneratorParameters.Seed, INT_MAX)));
+    QSpinBox *_nodeCountEdit = new QSpinBox(&_dialog);    // Exact item count
+    _nodeCountEdit->setRange(1, 50000000);
+    _nodeCountEdit->setSingleStep(10000);
+    _nodeCountEdit->setValue(GeneratorParameters.NodeCount);
+    QSpinBox *_rootCountEdit = new QSpinBox(&_dialog);    // Root level items
+    _rootCountEdit->setRange(1, 100000);
+    _rootCountEdit->setValue(GeneratorParameters.RootCount);
+    QSpinBox *_maxDepthEdit = new QSpinBox(&_dialog);     // Deepest level
+    _maxDepthEdit->setRange(0, 1000);
+    _maxDepthEdit->setValue(GeneratorParameters.MaxDepth);
+    QDoubleSpinBox *_branchEdit = new QDoubleSpinBox(&_dialog);  // Chance of having children
+    _branchEdit->setRange(0.0, 1.0);
+    _branchEdit->setSingleStep(0.05);
+    _branchEdit->setValue(GeneratorParameters.BranchProbability);
+    QComboBox *_fanOutEdit = new QComboBox(&_dialog);     // Fan-out distribution
+    for (int _distribution = A_TreeGenerator::FixedFanOut; _distribution <= A_TreeGenerator::PowerLawFanOut; ++_distribution) {
+        _fanOutEdit->addItem(A_TreeGenerator::GetDistributionName(A_TreeGenerator::FanOutDistribution(_distribution)));
+    }
+    _fanOutEdit->setCurrentIndex(GeneratorParameters.FanOut);
+    QSpinBox *_fanOutMeanEdit = new QSpinBox(&_dialog);   // Mean children per parent
+    _fanOutMeanEdit->setRange(1, 100000);
+    _fanOutMeanEdit->setValue(GeneratorParameters.FanOutMean);
+    QSpinBox *_fanOutMaxEdit = new QSpinBox(&_dialog);    // Largest sibling list
+    _fanOutMaxEdit->setRange(1, 10000000);
+    _fanOutMaxEdit->setValue(GeneratorParameters.FanOutMax);
+    QSpinBox *_labelMinEdit = new QSpinBox(&_dialog);     // Shortest label
+    _labelMinEdit->setRange(1, 256);
+    _labelMinEdit->setValue(GeneratorParameters.LabelMinLength);
+    QSpinBox *_labelMaxEdit = new QSpinBox(&_dialog);     // Longest label
+    _labelMaxEdit->setRange(1, 256);
+    _labelMaxEdit->setValue(GeneratorParameters.LabelMaxLength);
+    QDoubleSpinBox *_reuseEdit = new QDoubleSpinBox(&_dialog);  // Share of repeated labels
+    _reuseEdit->setRange(0.0, 1.0);
+    _reuseEdit->setSingleStep(0.05);
+    _reuseEdit->setValue(GeneratorParameters.LabelReuseRate);
+
+    _form->addRow("Seed:", _seedEdit);
+    _form->addRow("Items:", _nodeCountEdit);
+    _form->addRow("Root items:", _rootCountEdit);
+    _form->addRow("Maximum depth:", _maxDepthEdit);
+    _form->addRow("Branch probability:", _branchEdit);
+    _form->addRow("Fan-out distribution:", _fanOutEdit);
+    _form->addRow("Fan-out mean:", _fanOutMeanEdit);
+    _form->addRow("Fan-out maximum:", _fanOutMaxEdit);
+    _form->addRow("Label minimum length:", _labelMinEdit);
+    _form->addRow("Label maximum length:", _labelMaxEdit);
+    _form->addRow("Label reuse rate:", _reuseEdit);
+
+    QDialogButtonBox *_buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &_dialog);
+    connect(_buttons, &QDialogButtonBox::accepted, &_dialog, &QDialog::accept);
+    connect(_buttons, &QDialogButtonBox::rejected, &_dialog, &QDialog::reject);
+    _form->addRow(_buttons);
+
+    if (_dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    GeneratorParameters.Seed = quint32(_seedEdit->value());
+    GeneratorParameters.NodeCount = _nodeCountEdit->value();
+    GeneratorParameters.RootCount = _rootCountEdit->value();
+    GeneratorParameters.MaxDepth = _maxDepthEdit->value();
+    GeneratorParameters.BranchProbability = _branchEdit->value();
+    GeneratorParameters.FanOut = A_TreeGenerator::FanOutDistribution(_fanOutEdit->currentIndex());
+    GeneratorParameters.FanOutMean = _fanOutMeanEdit->value();
+    GeneratorParameters.FanOutMax = _fanOutMaxEdit->value();
+    GeneratorParameters.LabelMinLength = _labelMinEdit->value();
+    GeneratorParameters.LabelMaxLength = _labelMaxEdit->value();
+    GeneratorParameters.LabelReuseRate = _reuseEdit->value();
+
+    StatusLabel->setText("Generating items...");
+    StatusLabel->repaint();                               // Visible before the blocking build
+    const A_Tree::SyntheticLoadReport _report = TreeWidget->LoadSyntheticData(GeneratorParameters);
+    StatusLabel->setText(QString("Generated %1 items - generate %2 ms, build %3 ms")
+                             .arg(_report.NodeCount)
+                             .arg(_report.GenerateMilliseconds)
+                             .arg(_report.BuildMilliseconds));
+}
+
+void MainWindow::OnExportButtonClicked()
+{
+    /**
+     * Handles Export button click event
+     * The chosen file type selects the format; the tree stays usable while the file is written
+     */
+
+    const QString _textFilter = "Text paths (*.txt)";     // Filter names double as format choice
+    const QString _csvFilter = "CSV (*.csv)";
+    const QString _jsonFilter = "JSON (*.json)";
+    QString _selectedFilter = _textFilter;                // Filter picked by the user
+    const QString _filePath = QFileDialog::getSaveFileName(this, "Export Items", QString(),
+                                                           _textFilter + ";;" + _csvFilter + ";;" + _jsonFilter,
+                                                           &_selectedFilter);
+    if (_filePath.isEmpty()) {
+        return;
+    }
+
+    const QStringList _filterNames = {"All items", "Checked items", "Unchecked items"};  // In CheckFilter order
+    bool _inputAccepted = false;                          // Flag indicating if user accepted the choice
+    const QString _filterName = QInputDialog::getItem(this, "Export Items", "Items to export:", _filterNames, 0, false,
+                                                      &_inputAccepted);
+    if (!_inputAccepted) {
+        return;
+    }
+
+    A_TreeExporter::Options _options;                     // Export settings
+    _options.Filter = A_TreeExporter::CheckFilter(_filterNames.indexOf(_filterName));
+    if (_selectedFilter == _csvFilter || _filePath.endsWith(".csv", Qt::CaseInsensitive)) {
+        _options.OutputFormat = A_TreeExporter::CsvFormat;
+    } else if (_selectedFilter == _jsonFilter || _filePath.endsWith(".json", Qt::CaseInsensitive)) {
+        _options.OutputFormat = A_TreeExporter::JsonFormat;
+    }
+
+    if (!TreeWidget->ExportToFileAsync(_filePath, _options)) {
+        StatusLabel->setText("An export is already running");
+        return;
+    }
+    if (TreeWidget->IsExportRunning()) {
+        ExportButton->setEnabled(false);                  // Re-enabled when the export finished
+        StatusLabel->setText("Exporting items...");
+    }
+}
+
+void MainWindow::OnTreeExportFinished(bool isSuccess, qint64 writtenCount)
+{
+    /**
+     * Handles the end of an export
+     * @param isSuccess False if the file could not be written
+     * @param writtenCount Number of records written
+     */
+
+    ExportButton->setEnabled(true);
+    StatusLabel->setText(isSuccess ? QString("Exported %1 items").arg(writtenCount) : QString("Export failed"));
+}
+
+bool MainWindow::ConnectSharedTree(const QString &key, bool isWriter)
+{
+    /**
+     * Starts sharing or viewing and locks the controls that would change a viewed tree
+     * @return True on success
+     */
+
+    const bool _isConnected = isWriter ? TreeWidget->ShareTree(key) : TreeWidget->AttachSharedTree(key);
+    if (!_isConnected) {
+        StatusLabel->setText(QString("Shared tree unavailable - %1").arg(TreeWidget->GetSharedTreeError()));
+        return false;
+    }
+
+    if (isWriter) {
+        StatusLabel->setText(QString("Sharing tree as %1").arg(key));
+        return true;
+    }
+
+    SetTreeChangesEnabled(false);                         // Viewer content comes from the writer only
+    setWindowTitle(QString("Tree Widget Application - viewing %1").arg(key));
+    return true;
+}
+
+bool MainWindow::StartIpcServer(const QString &name)
+{
+    /**
+     * Creates the server on first use and listens on the name
+     * @return True on success
+     */
+
+    if (!IpcServer) {
+        IpcServer = new A_TreeIpcServer(TreeWidget, this);  // Served until the window closes
+        connect(IpcServer, &A_TreeIpcServer::TreeChangedByClient, this, &MainWindow::OnIpcTreeChanged);
+    }
+    if (!IpcServer->Listen(name)) {
+        StatusLabel->setText(QString("Local server unavailable - %1").arg(IpcServer->GetErrorString()));
+        return false;
+    }
+
+    StatusLabel->setText(QString("Serving tree on %1").arg(name));
+    return true;
+}
+
+void MainWindow::OnIpcTreeChanged(int opcode)
+{
+    /**
+     * Reports a change made by a local socket client
+     * @param opcode Operation the client applied
+     */
+
+    StatusLabel->setText(opcode == A_TreeIpcServer::ApplyCheckRules ? "Check rules applied by client"
+                                                                     : "Changes applied by client");
+}
+
+void MainWindow::OnTreeSharedTreeUpdated(int nodeCount)
+{
+    /**
+     * Reports a reload from the shared store
+     * @param nodeCount Number of items after the update
+     */
+
+    StatusLabel->setText(QString("Shared tree updated - %1 items").arg(nodeCount));
+}
+
+void MainWindow::RestoreJournal()
+{
+    /**
+     * Persists tree changes across sessions - starts the sliced recovery of the previous session's tree
+     */
+
+    QString _journalPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/journal";  // Journal directory
+    A_StartupTimings::BeginDeferredPhase();               // Report waits for the recovery
+    SetTreeChangesEnabled(false);                         // Changes would act on a partial tree - browsing stays possible
+    StatusLabel->setText("Restoring the previous session...");
+    TreeWidget->EnableJournalInSlices(_journalPath);
+}
+
+void MainWindow::OnTreeJournalRestored(bool isEnabled)
+{
+    /**
+     * Unlocks the controls that change the tree and reports whether changes are saved
+     * @param isEnabled False if the journal directory is not usable
+     */
+
+    A_StartupTimings::EndDeferredPhase("journal restored");
+    SetTreeChangesEnabled(true);
+    StatusLabel->setText(isEnabled ? "Journal enabled - changes are saved automatically"
+                                   : "Journal unavailable - changes are not saved");
+    emit JournalRestored();
+}
+
+void MainWindow::SetTreeChangesEnabled(bool isEnabled)
+{
+    /**
+     * Locks or unlocks the controls that add, remove, check or edit items, or switch the tree's mode
+     * Filtering, export and the memory report only read the tree and are left alone
+     * @param isEnabled True to unlock
+     */
+
+    AddRootButton->setEnabled(isEnabled);
+    LoadDemoButton->setEnabled(isEnabled);
+    GenerateButton->setEnabled(isEnabled);
+    CheckRulesButton->setEnabled(isEnabled);
+    ClearAllButton->setEnabled(isEnabled);
+    EditModeCheckbox->setEnabled(isEnabled);
+    CompactModeCheckbox->setEnabled(isEnabled);
+    FreezeCheckbox->setEnabled(isEnabled);
+}
+
+void MainWindow::OnCheckRulesButtonClicked()
+{
+    /**
+     * Handles Check Rules button click event
+     * One rule per line; the last matching rule decides each leaf
+     */
+
+    bool _inputAccepted = false;                          // Flag indicating if user accepted input dialog
+    const QString _text = QInputDialog::getMultiLineText(
+        this,
+        "Check Rules",                                    // Dialog title
+        "One rule per line - later rules win:\n"
+        "  +GLOB checks, -GLOB unchecks matching leaves (* ? within a segment, ** across)\n"
+        "  label: matches the item text instead of the path, re: takes a regular expression\n"
+        "Example: +Logs/**/*.log and -**/tmp/*",         // Dialog prompt
+        CheckRulesText,                                   // Rules of the previous run
+        &_inputAccepted                                   // Output flag for user acceptance
+        );
+    if (!_inputAccepted) {
+        return;
+    }
+    CheckRulesText = _text;
+
+    QVector<A_TreeCheckRules::Rule> _rules;               // Parsed rules
+    QString _errorMessage;                                // Reason for rejecting the rules
+    if (!A_TreeCheckRules::Parse(_text.split('\n'), &_rules, &_errorMessage)) {
+        StatusLabel->setText(_errorMessage);
+        return;
+    }
+
+    const int _changedCount = TreeWidget->ApplyCheckRules(_rules, "/", &_errorMessage);
+    if (_changedCount < 0) {
+        StatusLabel->setText(QString("Invalid rule - %1").arg(_errorMessage));
+        return;
+    }
+    StatusLabel->setText(QString("Check rules changed %1 items").arg(_changedCount));
+}
+
 void MainWindow::OnClearAllButtonClicked()
 {
     /**
@@ -290,3 +686,146 @@ void MainWindow::OnTreeItemDeleted(const QString &itemText)
 
     StatusLabel->setText(QString("Item deleted: %1").arg(itemText)); // Update status with deleted item info
 }
+
+void MainWindow::OnFilterTextChanged(const QString &text)
+{
+    /**
+     * Handles filter text changes while the user types
+     * Forwards the query to the tree widget which refines visibility incrementally
+     * @param text New filter query
+     */
+
+    TreeWidget->SetFilterText(text);                      // Filter tree by typed text
+}
+
+void MainWindow::OnTreeFilterApplied(int matchCount)
+{
+    /**
+     * Handles filter applied signal from tree widget
+     * Updates status to show how many items matched
+     * @param matchCount Number of matching items
+     */
+
+    if (TreeWidget->GetFilterText().isEmpty()) {
+        StatusLabel->setText("Filter cleared");           // No active filter
+        return;
+    }
+
+    StatusLabel->setText(QString("Filter matches: %1").arg(matchCount));  // Update status with match count
+}
+
+void MainWindow::OnTreeSubtreeJobProgress(int processedCount, int totalCount)
+{
+    /**
+     * Handles progress of a time-sliced subtree job
+     * Shows percentage once the subtree size is known and enables cancelling
+     * @param processedCount Items processed so far
+     * @param totalCount Items in the subtree - 0 while still counting
+     */
+
+    CancelJobButton->setEnabled(TreeWidget->IsSubtreeJobRunning());  // Last slice already finished the job
+    if (totalCount == 0) {
+        StatusLabel->setText("Collecting items...");     // Subtree size not known yet
+        return;
+    }
+
+    StatusLabel->setText(QString("Processing items: %1%").arg(qint64(processedCount) * 100 / totalCount));
+}
+
+void MainWindow::OnTreeSubtreeJobFinished(bool isCancelled)
+{
+    /**
+     * Handles the end of a time-sliced subtree job
+     * @param isCancelled True if the job was cancelled
+     */
+
+    CancelJobButton->setEnabled(TreeWidget->IsSubtreeJobRunning());  // Queued jobs keep the button enabled
+    if (isCancelled) {
+        StatusLabel->setText("Operation cancelled - completed part kept");
+    }
+}
+
+void MainWindow::OnMemoryButtonClicked()
+{
+    /**
+     * Handles Memory button click event
+     * Shows bytes per category and the tree's own bytes per node
+     */
+
+    const A_Tree::MemoryUsage _usage = TreeWidget->GetMemoryUsage();  // Snapshot of current usage
+    QString _report = QString("Nodes: %1\n\n").arg(_usage.NodeCount);
+    _report += QString("Items: %1\n").arg(FormatBytes(_usage.ItemBytes));
+    _report += QString("Texts: %1\n").arg(FormatBytes(_usage.TextBytes));
+    _report += QString("View: %1\n").arg(FormatBytes(_usage.ViewBytes));
+    _report += QString("Node store: %1\n").arg(FormatBytes(_usage.NodeStoreBytes));
+    _report += QString("Indexes: %1\n\n").arg(FormatBytes(_usage.IndexBytes));
+    _report += QString("Total: %1\n").arg(FormatBytes(_usage.TotalBytes));
+    _report += QString("Tree bytes per node, items excluded: %1 (compact budget %2)")
+                   .arg(_usage.OwnBytesPerNode, 0, 'f', 1)
+                   .arg(A_Tree::CompactNodeBudget);
+    if (TreeWidget->IsCompactMode() && _usage.OwnBytesPerNode > A_Tree::CompactNodeBudget) {
+        _report += " - over budget";                      // Enforced for the compact node store only - items are not bounded
+    }
+
+    QMessageBox::information(this, "Memory Usage", _report);
+}
+
+void MainWindow::OnCompactModeToggled(bool checked)
+{
+    /**
+     * Handles Compact Mode checkbox state change
+     * @param checked New checkbox state (true = compact)
+     */
+
+    TreeWidget->SetCompactMode(checked);                  // Releases optional state when entering
+    StatusLabel->setText(checked ? "Compact mode enabled" : "Compact mode disabled");
+}
+
+void MainWindow::OnFreezeToggled(bool checked)
+{
+    /**
+     * Handles Freeze checkbox state change
+     * Controls that add, edit or read items are locked while frozen; paging only applies then
+     * @param checked New checkbox state (true = frozen)
+     */
+
+    const bool _isDone = checked ? TreeWidget->FreezeTree() : TreeWidget->ThawTree();
+    if (!_isDone) {
+        const QSignalBlocker _blocker(FreezeCheckbox);    // Restore without re-entering this slot
+        FreezeCheckbox->setChecked(!checked);
+        StatusLabel->setText(checked ? "Tree cannot be frozen now" : "Tree cannot be thawed");
+        return;
+    }
+
+    AddRootButton->setEnabled(!checked);
+    LoadDemoButton->setEnabled(!checked);
+    GenerateButton->setEnabled(!checked);
+    ExportButton->setEnabled(!checked);
+    CheckRulesButton->setEnabled(!checked);
+    ClearAllButton->setEnabled(!checked);
+    EditModeCheckbox->setEnabled(!checked);
+    CompactModeCheckbox->setEnabled(!checked);
+    FilterEdit->setEnabled(!checked);
+    PagingCheckbox->setEnabled(checked);
+
+    if (checked) {
+        const A_TreeSuccinct::MemoryUsage _usage = TreeWidget->GetFrozenTree()->GetMemoryUsage();
+        StatusLabel->setText(QString("Tree frozen - %1 items in %2")
+                                 .arg(TreeWidget->GetFrozenTree()->GetNodeCount())
+                                 .arg(FormatBytes(_usage.StructureBytes + _usage.TextBytes + _usage.CheckBytes)));
+    } else {
+        StatusLabel->setText("Tree thawed");
+    }
+}
+
+void MainWindow::OnPagingToggled(bool checked)
+{
+    /**
+     * Handles Page Wide Parents checkbox state change
+     * @param checked New checkbox state (true = range buckets)
+     */
+
+    TreeWidget->SetFrozenPageSize(checked ? A_Tree::DefaultPageSize : 0);  // Regroups a frozen view at once
+    StatusLabel->setText(checked ? QString("Frozen parents with more than %1 children are paged").arg(A_Tree::DefaultPageSize)
+                                 : QString("Frozen parents show all children"));
+}
@@ -7,9 +7,11 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QCheckBox>
+#include <QLineEdit>
 #include <QSpinBox>
 #include <QGroupBox>
 #include "a_tree.h"
+#include "a_tree_ipc_server.h"
 
 class MainWindow : public QMainWindow
 {
@@ -27,6 +29,34 @@ public:
      */
     ~MainWindow();
 
+    /**
+     * @brief Shares the tree with viewer processes or follows a shared tree
+     * @param key Shared store name
+     * @param isWriter True to publish this window's tree, false to view another process's tree
+     * @return False if the store cannot be created or attached
+     */
+    bool ConnectSharedTree(const QString &key, bool isWriter);
+
+    /**
+     * @brief Serves tree queries and batched changes to other processes over a local socket
+     * @param name Socket name
+     * @return False if the socket cannot be created
+     */
+    bool StartIpcServer(const QString &name);
+
+    /**
+     * @brief Restores the tree of the previous session from the journal in time slices
+     * Call before show - the journal is read and verified during the call, items are built after the
+     * first paint. The tree can be browsed meanwhile; controls that change it stay locked until JournalRestored
+     */
+    void RestoreJournal();
+
+signals:
+    /**
+     * @brief Signal emitted when RestoreJournal finished, whether or not a journal could be opened
+     */
+    void JournalRestored();
+
 private slots:
     /**
      * @brief Slot triggered when Add Root button is clicked
@@ -40,6 +70,49 @@ private slots:
      */
     void OnLoadDemoButtonClicked();
 
+    /**
+     * @brief Slot triggered when Generate button is clicked
+     * Asks for generator settings and replaces the tree with a synthetic one
+     */
+    void OnGenerateButtonClicked();
+
+    /**
+     * @brief Slot triggered when Export button is clicked
+     * Asks for file, format and items and starts a background export
+     */
+    void OnExportButtonClicked();
+
+    /**
+     * @brief Slot triggered when tree widget signals an export finished
+     * @param isSuccess False if the file could not be written
+     * @param writtenCount Number of records written
+     */
+    void OnTreeExportFinished(bool isSuccess, qint64 writtenCount);
+
+    /**
+     * @brief Slot triggered when Check Rules button is clicked
+     * Asks for include/exclude pattern rules and applies them to all leaves
+     */
+    void OnCheckRulesButtonClicked();
+
+    /**
+     * @brief Slot triggered when a viewed shared tree picked up a new version
+     * @param nodeCount Number of items after the update
+     */
+    void OnTreeSharedTreeUpdated(int nodeCount);
+
+    /**
+     * @brief Slot triggered when the sliced journal recovery finished
+     * @param isEnabled False if the journal directory is not usable
+     */
+    void OnTreeJournalRestored(bool isEnabled);
+
+    /**
+     * @brief Slot triggered when a local socket client changed the tree
+     * @param opcode Operation the client applied
+     */
+    void OnIpcTreeChanged(int opcode);
+
     /**
      * @brief Slot triggered when Clear All button is clicked
      * Removes all items from the tree widget
@@ -64,6 +137,55 @@ private slots:
      */
     void OnTreeItemDeleted(const QString &itemText);
 
+    /**
+     * @brief Slot triggered when the filter text changes
+     * @param text New filter query typed by the user
+     */
+    void OnFilterTextChanged(const QString &text);
+
+    /**
+     * @brief Slot triggered when tree widget signals a filter was applied
+     * @param matchCount Number of items matching the filter query
+     */
+    void OnTreeFilterApplied(int matchCount);
+
+    /**
+     * @brief Slot triggered after every slice of a time-sliced subtree job
+     * @param processedCount Items processed so far
+     * @param totalCount Items in the subtree - 0 while still counting
+     */
+    void OnTreeSubtreeJobProgress(int processedCount, int totalCount);
+
+    /**
+     * @brief Slot triggered when a time-sliced subtree job finished or was cancelled
+     * @param isCancelled True if the job was cancelled
+     */
+    void OnTreeSubtreeJobFinished(bool isCancelled);
+
+    /**
+     * @brief Slot triggered when Memory button is clicked
+     * Shows the tree's memory usage broken down by category
+     */
+    void OnMemoryButtonClicked();
+
+    /**
+     * @brief Slot triggered when Compact Mode checkbox state changes
+     * @param checked True to drop optional per-node state
+     */
+    void OnCompactModeToggled(bool checked);
+
+    /**
+     * @brief Slot triggered when Freeze checkbox state changes
+     * @param checked True to replace items with the read-only succinct encoding
+     */
+    void OnFreezeToggled(bool checked);
+
+    /**
+     * @brief Slot triggered when Page Wide Parents checkbox state changes
+     * @param checked True to group children of wide parents into range buckets in the frozen view
+     */
+    void OnPagingToggled(bool checked);
+
 private:
     /**
      * @brief Sets up the user interface components
@@ -71,6 +193,12 @@ private:
      */
     void SetupUserInterface();
 
+    /**
+     * @brief Locks or unlocks the controls that change the tree
+     * @param isEnabled True to unlock
+     */
+    void SetTreeChangesEnabled(bool isEnabled);
+
     /**
      * @brief Applies dark theme styling to all UI components
      * Sets colors, fonts, and visual appearance for professional look
@@ -93,17 +221,31 @@ private:
     // Control Buttons
     QPushButton *AddRootButton;      // Add Root button - creates new root level items in tree
     QPushButton *LoadDemoButton;     // Load Demo button - populates tree with sample data
+    QPushButton *GenerateButton;     // Generate button - builds a large synthetic tree from a seed
+    QPushButton *ExportButton;       // Export button - writes item paths as text, CSV or JSON
+    QPushButton *CheckRulesButton;   // Check Rules button - checks and unchecks leaves by pattern
     QPushButton *ClearAllButton;     // Clear All button - removes all items from tree
+    QPushButton *CancelJobButton;    // Cancel button - stops running subtree jobs, enabled only while one runs
+    QPushButton *MemoryButton;       // Memory button - shows the tree's memory usage report
 
     // Control Elements
     QLabel *TitleLabel;              // Title label - displays application title
     QCheckBox *EditModeCheckbox;     // Edit mode checkbox - enables/disables item editing (true = editable, false = read-only)
+    QCheckBox *CompactModeCheckbox;  // Compact mode checkbox - trades lookup and filter speed for memory on huge trees
+    QCheckBox *FreezeCheckbox;       // Freeze checkbox - shows the tree read-only from a succinct encoding
+    QCheckBox *PagingCheckbox;       // Paging checkbox - shows wide parents of the frozen tree as range buckets
+    QLineEdit *FilterEdit;           // Filter input - shows only items matching typed text and their ancestors
     QLabel *StatusLabel;             // Status label - shows current operation status and feedback
     QGroupBox *ControlGroup;         // Control group - organizes control elements visually
 
     // State Variables
     int RootItemCounter;             // Root item counter - tracks number of root items created (range: 1 to INT_MAX)
     bool IsEditModeEnabled;          // Edit mode flag - indicates if editing is currently allowed (true = enabled, false = disabled)
+    A_TreeGenerator::Parameters GeneratorParameters;  // Last generator settings - offered again by the next Generate dialog
+    QString CheckRulesText;          // Last rule lines - offered again by the next Check Rules dialog
+
+    // Services
+    A_TreeIpcServer *IpcServer;      // Local socket server - nullptr unless started with StartIpcServer
 };
 
 #endif // MAINWINDOW_H